@@ -0,0 +1,331 @@
+#include "stdafx.h"
+
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <unordered_map>
+
+#include "DeltaPatch.h"
+
+namespace {
+    constexpr uint32_t min_chunk_size = 2 * 1024;
+    constexpr uint32_t avg_chunk_size = 8 * 1024;
+    constexpr uint32_t max_chunk_size = 64 * 1024;
+
+    // Normalized chunking: a stricter mask before the average size and a looser one after it
+    // keeps chunk sizes clustered around avg_chunk_size. Masks use the high bits, which depend
+    // on the last 64 bytes rather than just the last few.
+    constexpr uint64_t mask_small = ~0ull << (64 - 15);
+    constexpr uint64_t mask_large = ~0ull << (64 - 11);
+
+    // Manifests come off the network; refuse sizes no release could have before allocating the output.
+    // A new file may be at most max_file_growth bytes bigger than the one it's patched from.
+    constexpr uint64_t max_file_size = 256 * 1024 * 1024;
+    constexpr uint64_t max_file_growth = 64 * 1024 * 1024;
+
+    // Coalesce adjacent missing chunks into ranges of at most this many bytes
+    constexpr uint64_t max_range_size = 1024 * 1024;
+    constexpr int fetch_attempts = 3;
+
+    constexpr char manifest_magic[] = "GWToolboxDelta 1";
+
+    constexpr uint64_t Mix(uint64_t x)
+    {
+        x ^= x >> 30;
+        x *= 0xBF58476D1CE4E5B9ull;
+        x ^= x >> 27;
+        x *= 0x94D049BB133111EBull;
+        x ^= x >> 31;
+        return x;
+    }
+
+    constexpr auto gear_table = [] {
+        std::array<uint64_t, 256> table{};
+        uint64_t seed = 0x2545F4914F6CDD1Dull;
+        for (auto& value : table) {
+            seed += 0x9E3779B97F4A7C15ull;
+            value = Mix(seed);
+        }
+        return table;
+    }();
+
+    size_t FindCutPoint(const uint8_t* data, size_t size)
+    {
+        if (size <= min_chunk_size) {
+            return size;
+        }
+        size = std::min<size_t>(size, max_chunk_size);
+        const size_t normal_size = std::min<size_t>(size, avg_chunk_size);
+        uint64_t fingerprint = 0;
+        size_t i = min_chunk_size;
+        for (; i < normal_size; i++) {
+            fingerprint = (fingerprint << 1) + gear_table[data[i]];
+            if (!(fingerprint & mask_small)) {
+                return i + 1;
+            }
+        }
+        for (; i < size; i++) {
+            fingerprint = (fingerprint << 1) + gear_table[data[i]];
+            if (!(fingerprint & mask_large)) {
+                return i + 1;
+            }
+        }
+        return size;
+    }
+
+    bool ReadEntireFile(const std::filesystem::path& path, std::vector<uint8_t>& out)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            return false;
+        }
+        out.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        return file.read(reinterpret_cast<char*>(out.data()), static_cast<std::streamsize>(out.size())).good() || out.empty();
+    }
+
+    template <typename T>
+    bool ParseNumber(const std::string_view str, T& out, const int base)
+    {
+        const auto [end, ec] = std::from_chars(str.data(), str.data() + str.size(), out, base);
+        return ec == std::errc() && end == str.data() + str.size();
+    }
+
+    bool ChunkMatches(const std::span<const uint8_t> data, const DeltaPatch::Chunk& chunk)
+    {
+        return data.size() == chunk.length && DeltaPatch::Hash(data) == chunk.hash;
+    }
+}
+
+uint64_t DeltaPatch::Hash(const std::span<const uint8_t> data)
+{
+    uint64_t hash = Mix(0x9E3779B97F4A7C15ull ^ data.size());
+    size_t i = 0;
+    for (; i + 8 <= data.size(); i += 8) {
+        uint64_t word;
+        memcpy(&word, data.data() + i, sizeof(word));
+        hash = Mix(hash ^ word);
+    }
+    if (i < data.size()) {
+        uint64_t word = 0;
+        memcpy(&word, data.data() + i, data.size() - i);
+        hash = Mix(hash ^ word ^ (static_cast<uint64_t>(data.size() - i) << 56));
+    }
+    return Mix(hash);
+}
+
+std::vector<DeltaPatch::Chunk> DeltaPatch::ChunkData(const std::span<const uint8_t> data)
+{
+    std::vector<Chunk> chunks;
+    chunks.reserve(data.size() / avg_chunk_size + 1);
+    size_t offset = 0;
+    while (offset < data.size()) {
+        const auto length = FindCutPoint(data.data() + offset, data.size() - offset);
+        chunks.push_back({offset, static_cast<uint32_t>(length), Hash(data.subspan(offset, length))});
+        offset += length;
+    }
+    return chunks;
+}
+
+DeltaPatch::Manifest DeltaPatch::BuildManifest(const std::span<const uint8_t> data)
+{
+    return {data.size(), Hash(data), ChunkData(data)};
+}
+
+std::string DeltaPatch::SerializeManifest(const Manifest& manifest)
+{
+    std::string out = std::format("{}\nsize {}\nhash {:016x}\n", manifest_magic, manifest.file_size, manifest.file_hash);
+    out.reserve(out.size() + manifest.chunks.size() * 24);
+    for (const auto& chunk : manifest.chunks) {
+        out += std::format("{} {:016x}\n", chunk.length, chunk.hash);
+    }
+    return out;
+}
+
+bool DeltaPatch::ParseManifest(std::string_view text, Manifest& manifest)
+{
+    manifest = {};
+    size_t line_number = 0;
+    uint64_t offset = 0;
+    while (!text.empty()) {
+        const auto eol = text.find('\n');
+        auto line = text.substr(0, eol);
+        text = eol == std::string_view::npos ? std::string_view{} : text.substr(eol + 1);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        if (line.empty()) {
+            continue;
+        }
+        switch (line_number++) {
+            case 0:
+                if (line != manifest_magic) {
+                    return false;
+                }
+                break;
+            case 1:
+                if (!line.starts_with("size ") || !ParseNumber(line.substr(5), manifest.file_size, 10)) {
+                    return false;
+                }
+                break;
+            case 2:
+                if (!line.starts_with("hash ") || !ParseNumber(line.substr(5), manifest.file_hash, 16)) {
+                    return false;
+                }
+                break;
+            default: {
+                const auto space = line.find(' ');
+                Chunk chunk;
+                chunk.offset = offset;
+                if (space == std::string_view::npos
+                    || !ParseNumber(line.substr(0, space), chunk.length, 10)
+                    || !ParseNumber(line.substr(space + 1), chunk.hash, 16)
+                    || chunk.length == 0 || chunk.length > max_chunk_size) {
+                    return false;
+                }
+                offset += chunk.length;
+                manifest.chunks.push_back(chunk);
+            } break;
+        }
+    }
+    return line_number >= 3 && offset == manifest.file_size && manifest.file_size <= max_file_size;
+}
+
+bool DeltaPatch::Apply(const Manifest& manifest, const std::span<const uint8_t> local, const std::filesystem::path& out_path,
+                       const FetchRangeCallback& fetch, std::string& error, ApplyStats* stats, const ProgressCallback& progress)
+{
+    ApplyStats local_stats;
+    if (!stats) {
+        stats = &local_stats;
+    }
+    *stats = {};
+
+    auto partial_path = out_path;
+    partial_path += ".partial";
+
+    if (manifest.file_size > max_file_size || manifest.file_size > local.size() + max_file_growth) {
+        error = std::format("Delta manifest file size {} is out of range", manifest.file_size);
+        return false;
+    }
+    std::vector<uint8_t> output(static_cast<size_t>(manifest.file_size));
+    std::vector<uint8_t> previous;
+    ReadEntireFile(partial_path, previous);
+
+    std::unordered_map<uint64_t, Chunk> local_chunks;
+    for (const auto& chunk : ChunkData(local)) {
+        local_chunks.try_emplace(chunk.hash, chunk);
+    }
+
+    // Work out where every chunk comes from; anything we can't find locally is fetched
+    std::vector<size_t> missing;
+    for (size_t i = 0; i < manifest.chunks.size(); i++) {
+        const auto& chunk = manifest.chunks[i];
+        if (chunk.offset + chunk.length > output.size()) {
+            error = "Delta manifest chunk is out of bounds";
+            return false;
+        }
+        if (chunk.offset + chunk.length <= previous.size()
+            && ChunkMatches(std::span(previous).subspan(chunk.offset, chunk.length), chunk)) {
+            memcpy(output.data() + chunk.offset, previous.data() + chunk.offset, chunk.length);
+            stats->bytes_resumed += chunk.length;
+            continue;
+        }
+        const auto found = local_chunks.find(chunk.hash);
+        if (found != local_chunks.end() && found->second.length == chunk.length) {
+            memcpy(output.data() + chunk.offset, local.data() + found->second.offset, chunk.length);
+            stats->bytes_reused += chunk.length;
+            continue;
+        }
+        missing.push_back(i);
+    }
+    previous.clear();
+    previous.shrink_to_fit();
+
+    // Persist what we have so far; fetched ranges are written into place as they arrive
+    {
+        std::ofstream file(partial_path, std::ios::binary | std::ios::trunc);
+        if (!file.write(reinterpret_cast<const char*>(output.data()), static_cast<std::streamsize>(output.size()))) {
+            error = std::format("Failed to write '{}'", partial_path.string());
+            return false;
+        }
+    }
+    std::fstream partial(partial_path, std::ios::binary | std::ios::in | std::ios::out);
+    if (!partial.is_open()) {
+        error = std::format("Failed to open '{}'", partial_path.string());
+        return false;
+    }
+
+    if (progress) {
+        progress(stats->bytes_reused + stats->bytes_resumed, manifest.file_size);
+    }
+
+    std::string body;
+    for (size_t i = 0; i < missing.size();) {
+        // Coalesce a run of adjacent missing chunks into one range
+        const auto first = i;
+        const auto range_offset = manifest.chunks[missing[i]].offset;
+        uint64_t range_length = manifest.chunks[missing[i]].length;
+        for (i++; i < missing.size(); i++) {
+            const auto& next = manifest.chunks[missing[i]];
+            if (next.offset != range_offset + range_length || range_length + next.length > max_range_size) {
+                break;
+            }
+            range_length += next.length;
+        }
+
+        bool fetched = false;
+        for (int attempt = 0; attempt < fetch_attempts && !fetched; attempt++) {
+            body.clear();
+            if (!fetch(range_offset, range_length, body)) {
+                continue;
+            }
+            const uint8_t* range_data = reinterpret_cast<const uint8_t*>(body.data());
+            if (body.size() == manifest.file_size && body.size() != range_length) {
+                // Server ignored the range and sent the whole file
+                range_data += range_offset;
+            }
+            else if (body.size() != range_length) {
+                continue;
+            }
+            fetched = true;
+            for (size_t j = first; j < i && fetched; j++) {
+                const auto& chunk = manifest.chunks[missing[j]];
+                fetched = ChunkMatches({range_data + (chunk.offset - range_offset), chunk.length}, chunk);
+            }
+            if (fetched) {
+                memcpy(output.data() + range_offset, range_data, static_cast<size_t>(range_length));
+            }
+        }
+        if (!fetched) {
+            error = std::format("Failed to fetch bytes {}-{} after {} attempts", range_offset, range_offset + range_length - 1, fetch_attempts);
+            return false;
+        }
+
+        partial.seekp(static_cast<std::streamoff>(range_offset));
+        partial.write(reinterpret_cast<const char*>(output.data() + range_offset), static_cast<std::streamsize>(range_length));
+        partial.flush();
+        stats->bytes_fetched += range_length;
+        if (progress) {
+            progress(stats->bytes_reused + stats->bytes_resumed + stats->bytes_fetched, manifest.file_size);
+        }
+    }
+    partial.close();
+
+    if (Hash(output) != manifest.file_hash) {
+        // Every chunk verified but the whole doesn't; the partial file can't be trusted for a resume either
+        std::error_code ec;
+        std::filesystem::remove(partial_path, ec);
+        error = "Assembled file does not match the manifest hash";
+        return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(partial_path, out_path, ec);
+    if (ec) {
+        error = std::format("Failed to move '{}' into place: {}", partial_path.string(), ec.message());
+        return false;
+    }
+    return true;
+}
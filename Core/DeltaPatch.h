@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//
+// Content-defined chunking of release binaries, so an update only needs to fetch
+// the parts of the file that actually changed.
+//
+// A release publishes a manifest (see SerializeManifest) next to the binary. The
+// client chunks nothing itself; it looks up every manifest chunk by hash in the
+// file it already has, copies the ones it finds and fetches the rest with ranged
+// requests. Chunk boundaries are content-defined (gear rolling hash), so inserting
+// or removing bytes only disturbs the chunks around the edit.
+//
+// Everything here is plain C++ and independent of the transport.
+//
+namespace DeltaPatch {
+    struct Chunk {
+        uint64_t offset = 0;
+        uint32_t length = 0;
+        uint64_t hash = 0;
+    };
+
+    struct Manifest {
+        uint64_t file_size = 0;
+        uint64_t file_hash = 0;
+        std::vector<Chunk> chunks;
+    };
+
+    uint64_t Hash(std::span<const uint8_t> data);
+
+    // Splits data into content-defined chunks of 2 KiB to 64 KiB (8 KiB on average).
+    std::vector<Chunk> ChunkData(std::span<const uint8_t> data);
+
+    Manifest BuildManifest(std::span<const uint8_t> data);
+    std::string SerializeManifest(const Manifest& manifest);
+    bool ParseManifest(std::string_view text, Manifest& manifest);
+
+    // Fetches [offset, offset + length) of the remote file into out. Returning false counts as a failed attempt.
+    using FetchRangeCallback = std::function<bool(uint64_t offset, uint64_t length, std::string& out)>;
+    using ProgressCallback = std::function<void(uint64_t bytes_done, uint64_t bytes_total)>;
+
+    struct ApplyStats {
+        uint64_t bytes_reused = 0;
+        uint64_t bytes_resumed = 0;
+        uint64_t bytes_fetched = 0;
+    };
+
+    //
+    // Assembles the file described by manifest at out_path.
+    //
+    // The file is built in "<out_path>.partial" first. Chunks that an interrupted earlier run already
+    // wrote there are kept, chunks found in local are copied, and everything else is fetched in coalesced
+    // ranges (retried on failure). Every chunk and the final file are verified against the manifest hashes
+    // before "<out_path>.partial" replaces out_path.
+    //
+    // On failure the partial file is left in place so the next attempt can resume from it.
+    //
+    bool Apply(const Manifest& manifest, std::span<const uint8_t> local, const std::filesystem::path& out_path,
+               const FetchRangeCallback& fetch, std::string& error, ApplyStats* stats = nullptr,
+               const ProgressCallback& progress = nullptr);
+}
@@ -1,5 +1,6 @@
 #include "stdafx.h"
 
+#include <DeltaPatch.h>
 #include <File.h>
 #include <Path.h>
 
@@ -50,6 +51,74 @@ bool Download(std::string& content, const char* url)
     return true;
 }
 
+static bool DownloadRange(std::string& content, const char* url, const uint64_t offset, const uint64_t length)
+{
+    RestClient client;
+    client.SetUrl(url);
+    client.SetFollowLocation(true);
+    client.SetVerifyPeer(false);
+    client.SetTimeoutSec(30);
+    client.SetUserAgent("curl/7.71.1");
+    client.SetHeader(std::format("Range: bytes={}-{}", offset, offset + length - 1).c_str());
+    client.Execute();
+
+    if (!client.IsSuccessful()) {
+        fprintf(stderr, "Failed to download bytes %llu-%llu of '%s'. (Status: %s, StatusCode: %d)\n",
+                offset, offset + length - 1, url, client.GetStatusStr(), client.GetStatusCode());
+        return false;
+    }
+
+    content = std::move(client.GetContent());
+    return true;
+}
+
+// Rebuilds the release dll from the chunks of the installed one that haven't changed, fetching only the rest
+static bool DeltaDownload(const std::filesystem::path& dllpath, const std::string& dll_url, const std::string& manifest_url,
+                          const DeltaPatch::ProgressCallback& progress)
+{
+    std::string manifest_text;
+    if (!Download(manifest_text, manifest_url.c_str())) {
+        return false;
+    }
+    DeltaPatch::Manifest manifest;
+    if (!DeltaPatch::ParseManifest(manifest_text, manifest)) {
+        fprintf(stderr, "Failed to parse delta manifest '%s'\n", manifest_url.c_str());
+        return false;
+    }
+
+    std::vector<uint8_t> current_dll;
+    if (std::ifstream file(dllpath, std::ios::binary); file.is_open()) {
+        current_dll.assign(std::istreambuf_iterator(file), {});
+    }
+
+    const auto fetch = [&dll_url](const uint64_t offset, const uint64_t length, std::string& out) {
+        return DownloadRange(out, dll_url.c_str(), offset, length);
+    };
+    std::string error;
+    DeltaPatch::ApplyStats stats;
+    if (!DeltaPatch::Apply(manifest, current_dll, dllpath, fetch, error, &stats, progress)) {
+        fprintf(stderr, "Delta update failed: %s\n", error.c_str());
+        return false;
+    }
+    fprintf(stderr, "Delta update: reused %llu bytes, resumed %llu bytes, downloaded %llu of %llu bytes\n",
+            stats.bytes_reused, stats.bytes_resumed, stats.bytes_fetched, manifest.file_size);
+    return true;
+}
+
+bool WriteDeltaManifest(const wchar_t* dll_path, const wchar_t* manifest_path)
+{
+    std::vector<uint8_t> dll;
+    if (std::ifstream file(dll_path, std::ios::binary); file.is_open()) {
+        dll.assign(std::istreambuf_iterator(file), {});
+    }
+    if (dll.empty()) {
+        fprintf(stderr, "Failed to read '%ls'\n", dll_path);
+        return false;
+    }
+    const auto manifest = DeltaPatch::SerializeManifest(DeltaPatch::BuildManifest(dll));
+    return WriteEntireFile(manifest_path, manifest.c_str(), manifest.size());
+}
+
 void AsyncDownload(const char* url, AsyncFileDownloader* downloader)
 {
     downloader->SetUrl(url);
@@ -146,6 +215,13 @@ bool DownloadWindow::DownloadAllFiles(std::wstring& error)
     if (!release_dll_asset) {
         return error = L"Failed to find dll in latest release", false;
     }
+    const Asset* release_manifest_asset = nullptr;
+    for (const auto& asset : release.assets) {
+        if (asset.name == release_dll_asset->name + ".delta") {
+            release_manifest_asset = &asset;
+            break;
+        }
+    }
     if (std::filesystem::exists(dllpath)) {
         const auto current_filesize = std::filesystem::file_size(dllpath);
         if (current_filesize == release_dll_asset->size) {
@@ -178,10 +254,25 @@ bool DownloadWindow::DownloadAllFiles(std::wstring& error)
     window.Create();
     window.SetChangelog(release.body.c_str(), release.body.size());
 
+    bool download_complete = false;
+    if (release_manifest_asset && std::filesystem::exists(dllpath)) {
+        const auto progress = [&window](const uint64_t done, const uint64_t total) {
+            SendMessageW(window.m_hProgressBar, PBM_SETPOS, total ? done * 100 / total : 0, 0);
+            window.PollMessages(0);
+        };
+        download_complete = DeltaDownload(dllpath, url, release_manifest_asset->browser_download_url, progress);
+    }
+
     AsyncFileDownloader downloader;
-    AsyncDownload(url.c_str(), &downloader);
+    if (download_complete) {
+        SendMessageW(window.m_hProgressBar, PBM_SETPOS, 100, 0);
+        SetWindowTextW(window.m_hStatusLabel, L"Download complete! Review the release notes above, then click 'Continue' to proceed.");
+        SetWindowTextW(window.m_hCloseButton, L"Continue");
+    }
+    else {
+        AsyncDownload(url.c_str(), &downloader);
+    }
 
-    bool download_complete = false;
     while (!window.ShouldClose()) {
         window.PollMessages(16);
 
@@ -5,6 +5,9 @@
 bool Download(std::string& content, const wchar_t* url);
 bool Download(const wchar_t* path_to_file, const wchar_t* url);
 
+// Writes the DeltaPatch manifest for a release dll; published next to the dll as "<dll name>.delta"
+bool WriteDeltaManifest(const wchar_t* dll_path, const wchar_t* manifest_path);
+
 class DownloadWindow : public Window {
 public:
     DownloadWindow() = default;
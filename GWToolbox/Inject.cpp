@@ -3,6 +3,7 @@
 #include <Str.h>
 
 #include "Inject.h"
+#include "Registry.h"
 
 #define ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
 
@@ -77,6 +78,58 @@ std::vector<Process> GetGuildWars2Processes()
     GetProcessesByWindowClass(processes, L"ArenaNet_Gr_Window_Class");
     return processes;
 }
+// Pattern rvas are cached per Gw.exe build, so later launches only need to verify them
+static bool LoadCachedPatternRvas(const std::wstring& image_key, std::span<ScanPattern> patterns)
+{
+    wchar_t buffer[256];
+    std::wstring error;
+    if (!RegReadStr(L"PatternCache", buffer, _countof(buffer), error)) {
+        return false;
+    }
+    if (!std::wstring_view(buffer).starts_with(image_key)) {
+        return false;
+    }
+    const wchar_t* it = buffer + image_key.size();
+    for (ScanPattern& pattern : patterns) {
+        wchar_t* end;
+        pattern.rva = wcstoul(it, &end, 16);
+        if (end == it) {
+            return false;
+        }
+        it = end;
+    }
+    return true;
+}
+
+static void SaveCachedPatternRvas(const std::wstring& image_key, std::span<const ScanPattern> patterns)
+{
+    std::wstring value = image_key;
+    for (const ScanPattern& pattern : patterns) {
+        value += std::format(L" {:X}", pattern.rva);
+    }
+    std::wstring error;
+    if (!RegWriteStr(L"PatternCache", value.c_str(), error)) {
+        fwprintf(stderr, L"%s\n", error.c_str());
+    }
+}
+
+static bool ResolvePatternRvas(const ProcessScanner& scanner, std::span<ScanPattern> patterns)
+{
+    std::wstring image_key;
+    const bool has_image_key = scanner.GetImageKey(&image_key);
+    if (has_image_key && LoadCachedPatternRvas(image_key, patterns)
+        && std::ranges::all_of(patterns, [&scanner](const ScanPattern& pattern) { return scanner.VerifyPatternRva(pattern); })) {
+        return true;
+    }
+    if (!scanner.FindPatternsRva(patterns)) {
+        return false;
+    }
+    if (has_image_key) {
+        SaveCachedPatternRvas(image_key, patterns);
+    }
+    return true;
+}
+
 std::vector<Process> GetGuildWarsProcesses()
 {
     std::vector<Process> processes;
@@ -97,16 +150,17 @@ InjectReply InjectWindow::AskInjectProcess(Process* target_process)
     uintptr_t charname_rva = 0;
     uintptr_t email_rva = 0;
 
+    ScanPattern patterns[] = {
+        {"\x8B\xF8\x6A\x03\x68\x0F\x00\x00\xC0\x8B\xCF\xE8", "xxxxxxxxxxxx", -0x42}, // charname
+        {"\x33\xC0\x5D\xC2\x10\x00\xCC\x68\x80\x00\x00\x00", "xxxxxxxxxxxx", 0xE},   // email
+    };
     for (int i = 0; i < processes.size(); i++) {
         const ProcessScanner scanner(&processes[i]);
-        if (!scanner.FindPatternRva("\x8B\xF8\x6A\x03\x68\x0F\x00\x00\xC0\x8B\xCF\xE8", "xxxxxxxxxxxx", -0x42, &charname_rva)) {
+        if (!ResolvePatternRvas(scanner, patterns)) {
             continue;
         }
-
-        if (!scanner.FindPatternRva("\x33\xC0\x5D\xC2\x10\x00\xCC\x68\x80\x00\x00\x00", "xxxxxxxxxxxx", 0xE, &email_rva)) {
-            continue;
-        }
-
+        charname_rva = patterns[0].rva;
+        email_rva = patterns[1].rva;
         break;
     }
 
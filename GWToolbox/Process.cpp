@@ -323,20 +323,42 @@ bool GetProcessesByWindowClass(std::vector<Process>& processes, const wchar_t* c
     return true;
 }
 
+namespace {
+    bool MatchesPattern(const uint8_t* bytes, const ScanPattern& pattern, const size_t length)
+    {
+        const auto upattern = reinterpret_cast<const uint8_t*>(pattern.pattern);
+        for (size_t j = 0; j < length; j++) {
+            if (pattern.mask[j] == 'x' && bytes[j] != upattern[j]) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
 ProcessScanner::ProcessScanner(Process* process)
+    : m_process(process)
 {
     ProcessModule module;
     process->GetModule(&module);
 
     m_base = module.base;
     m_size = module.size;
-    m_buffer = new uint8_t[module.size];
-    process->Read(module.base, m_buffer, m_size);
 }
 
-ProcessScanner::~ProcessScanner()
+ProcessScanner::~ProcessScanner() = default;
+
+bool ProcessScanner::ReadImage() const
 {
-    delete[] m_buffer;
+    if (m_buffer.size() == m_size) {
+        return m_size != 0;
+    }
+    m_buffer.resize(m_size);
+    if (!m_process->Read(m_base, m_buffer.data(), m_size)) {
+        m_buffer.clear();
+        return false;
+    }
+    return true;
 }
 
 uintptr_t ProcessScanner::FindPattern(const char* pattern, const char* mask, const int offset) const
@@ -350,19 +372,102 @@ uintptr_t ProcessScanner::FindPattern(const char* pattern, const char* mask, con
 
 bool ProcessScanner::FindPatternRva(const char* pattern, const char* mask, const int offset, uintptr_t* rva) const
 {
-    const size_t length = strlen(mask);
-    const auto upattern = reinterpret_cast<const uint8_t*>(pattern);
+    ScanPattern scan_pattern = {pattern, mask, offset};
+    if (!FindPatternsRva({&scan_pattern, 1})) {
+        return false;
+    }
+    *rva = scan_pattern.rva;
+    return true;
+}
+
+bool ProcessScanner::FindPatternsRva(const std::span<ScanPattern> patterns) const
+{
+    if (!ReadImage()) {
+        return false;
+    }
+    const uint8_t* image = m_buffer.data();
+
+    // Anchor each pattern on whichever of its fixed bytes is rarest in this image;
+    // the scan then only compares patterns at positions holding their anchor byte.
+    size_t histogram[256] = {};
     for (size_t i = 0; i < m_size; i++) {
-        size_t j;
-        for (j = 0; j < length; j++) {
-            if (mask[j] == 'x' && m_buffer[i + j] != upattern[j]) {
-                break;
+        histogram[image[i]]++;
+    }
+    struct Anchored {
+        size_t pattern;
+        size_t anchor; // Index of the anchor byte in the pattern
+        size_t length;
+    };
+    std::vector<Anchored> by_anchor[256];
+    std::vector<bool> found(patterns.size(), false);
+    size_t remaining = 0;
+    for (size_t i = 0; i < patterns.size(); i++) {
+        const auto& pattern = patterns[i];
+        const size_t length = strlen(pattern.mask);
+        size_t anchor = length;
+        for (size_t j = 0; j < length; j++) {
+            const auto byte = static_cast<uint8_t>(pattern.pattern[j]);
+            if (pattern.mask[j] == 'x' && (anchor == length || histogram[byte] < histogram[static_cast<uint8_t>(pattern.pattern[anchor])])) {
+                anchor = j;
             }
         }
-        if (j == length) {
-            *rva = i + offset;
-            return true;
+        if (length > m_size) {
+            continue;
+        }
+        if (anchor == length) {
+            // Nothing but wildcards; matches at the start of the image
+            patterns[i].rva = pattern.offset;
+            found[i] = true;
+            continue;
         }
+        by_anchor[static_cast<uint8_t>(pattern.pattern[anchor])].push_back({i, anchor, length});
+        remaining++;
     }
-    return false;
+
+    for (size_t i = 0; i < m_size && remaining; i++) {
+        for (const auto& anchored : by_anchor[image[i]]) {
+            if (found[anchored.pattern] || i < anchored.anchor) {
+                continue;
+            }
+            const size_t start = i - anchored.anchor;
+            if (start + anchored.length > m_size) {
+                continue;
+            }
+            auto& pattern = patterns[anchored.pattern];
+            if (MatchesPattern(image + start, pattern, anchored.length)) {
+                pattern.rva = start + pattern.offset;
+                found[anchored.pattern] = true;
+                remaining--;
+            }
+        }
+    }
+    return std::ranges::all_of(found, [](const bool f) { return f; });
+}
+
+bool ProcessScanner::VerifyPatternRva(const ScanPattern& pattern) const
+{
+    const size_t length = strlen(pattern.mask);
+    const uintptr_t start = pattern.rva - pattern.offset;
+    if (start > m_size || length > m_size - start) {
+        return false;
+    }
+    if (!m_buffer.empty()) {
+        return MatchesPattern(m_buffer.data() + start, pattern, length);
+    }
+    std::vector<uint8_t> bytes(length);
+    return m_process->Read(m_base + start, bytes.data(), length) && MatchesPattern(bytes.data(), pattern, length);
+}
+
+bool ProcessScanner::GetImageKey(std::wstring* key) const
+{
+    IMAGE_DOS_HEADER dos_header;
+    if (!m_process->Read(m_base, &dos_header, sizeof(dos_header)) || dos_header.e_magic != IMAGE_DOS_SIGNATURE) {
+        return false;
+    }
+    IMAGE_NT_HEADERS32 nt_headers;
+    if (!m_process->Read(m_base + dos_header.e_lfanew, &nt_headers, sizeof(nt_headers)) || nt_headers.Signature != IMAGE_NT_SIGNATURE) {
+        return false;
+    }
+    *key = std::format(L"{:08X}{:08X}{:08X}", nt_headers.FileHeader.TimeDateStamp, nt_headers.OptionalHeader.CheckSum, nt_headers.OptionalHeader.SizeOfImage);
+    return true;
 }
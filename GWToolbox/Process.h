@@ -40,6 +40,13 @@ private:
 bool GetProcessesByName(std::vector<Process>& processes, const wchar_t* name, DWORD rights = PROCESS_ALL_ACCESS);
 bool GetProcessesByWindowClass(std::vector<Process>& processes, const wchar_t* classname, DWORD rights = PROCESS_ALL_ACCESS);
 
+struct ScanPattern {
+    const char* pattern;
+    const char* mask; // 'x' for bytes that must match, anything else for wildcards
+    int offset;       // Added to the address of the match
+    uintptr_t rva = 0; // Result
+};
+
 class ProcessScanner {
 public:
     ProcessScanner(Process* process);
@@ -48,9 +55,20 @@ public:
 
     uintptr_t FindPattern(const char* pattern, const char* mask, int Offset) const;
     bool FindPatternRva(const char* pattern, const char* mask, int offset, uintptr_t* rva) const;
+    // Finds the first match of every pattern in one pass over the image; false if any isn't found
+    bool FindPatternsRva(std::span<ScanPattern> patterns) const;
+    // True if the pattern matches where its rva says, e.g. an rva cached from an earlier scan of the same build.
+    // Only reads the pattern's bytes, not the whole image.
+    bool VerifyPatternRva(const ScanPattern& pattern) const;
+    // Identifies the build of the image from its PE header (timestamp, checksum and size)
+    bool GetImageKey(std::wstring* key) const;
 
 private:
+    // The whole image is only read the first time it's scanned
+    bool ReadImage() const;
+
+    Process* m_process = nullptr;
     uintptr_t m_base = 0;
     size_t m_size = 0;
-    uint8_t* m_buffer = nullptr;
+    mutable std::vector<uint8_t> m_buffer{};
 };
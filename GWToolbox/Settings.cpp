@@ -22,7 +22,9 @@ void PrintUsage(const bool terminate)
             "    /noinstall                 Won't try to install if missing\n"
             "    /localdll                  Check launcher directory for toolbox dll, won't try to install or update\n\n"
 
-            "    /pid <process id>          Process id of the target in which to inject\n"
+            "    /pid <process id>          Process id of the target in which to inject\n\n"
+
+            "    /deltamanifest <dll> <out> Write the delta update manifest for a release dll and exit\n"
     );
 
     if (terminate) {
@@ -84,6 +86,14 @@ void ParseCommandLine()
             }
             settings.pid = static_cast<uint32_t>(pid);
         }
+        else if (wcscmp(arg, L"/deltamanifest") == 0) {
+            if (i + 2 >= argc) {
+                fprintf(stderr, "'/deltamanifest' must be followed by the dll path and the output path\n");
+                PrintUsage(true);
+            }
+            settings.delta_manifest_dll = argv[++i];
+            settings.delta_manifest_out = argv[++i];
+        }
         else if (wcscmp(arg, L"/asadmin") == 0) {
             settings.asadmin = true;
         }
@@ -13,6 +13,8 @@ struct Settings {
     bool noupdate = false;
     bool noinstall = false;
     bool localdll = false;
+    const wchar_t* delta_manifest_dll = nullptr;
+    const wchar_t* delta_manifest_out = nullptr;
     uint32_t pid;
 };
 
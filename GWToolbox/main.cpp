@@ -148,6 +148,10 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
         return 0;
     }
 
+    if (settings.delta_manifest_dll) {
+        return WriteDeltaManifest(settings.delta_manifest_dll, settings.delta_manifest_out) ? 0 : 1;
+    }
+
     if (settings.asadmin && !IsRunningAsAdmin()) {
         RestartWithSameArgs(true);
     }
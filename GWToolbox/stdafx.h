@@ -49,8 +49,10 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <format>
 #include <ranges>
 #include <regex>
+#include <span>
 
 #include <glaze/glaze.hpp>
 
@@ -63,6 +63,95 @@ D3DVelocityArrow::D3DVelocityArrow(const D3DVec2f& pos, const D3DVec2f& velocity
     valid = true;
 }
 
+UINT D3DPrimitiveCount(D3DPRIMITIVETYPE type, size_t vertex_count)
+{
+    switch (type) {
+        case D3DPT_TRIANGLELIST:
+            return vertex_count / 3;
+        case D3DPT_LINELIST:
+            return vertex_count / 2;
+        case D3DPT_LINESTRIP:
+            return vertex_count > 1 ? vertex_count - 1 : 0;
+        case D3DPT_TRIANGLESTRIP:
+        case D3DPT_TRIANGLEFAN:
+            return vertex_count > 2 ? vertex_count - 2 : 0;
+        default:
+            return vertex_count;
+    }
+}
+
+// D3DDynamicVertexRing
+D3DDynamicVertexRing& D3DDynamicVertexRing::Instance()
+{
+    static D3DDynamicVertexRing instance;
+    return instance;
+}
+
+void D3DDynamicVertexRing::InvalidateDeviceObjects()
+{
+    if (buffer) buffer->Release();
+    buffer = nullptr;
+    owner = nullptr;
+    capacity = 0;
+    cursor = 0;
+    generation++;
+}
+
+bool D3DDynamicVertexRing::Reserve(IDirect3DDevice9* device, size_t vertex_count)
+{
+    if (buffer && device == owner && vertex_count <= capacity) 
+        return true;
+    const size_t new_capacity = std::max<size_t>({vertex_count, capacity * 2, 0x4000});
+    InvalidateDeviceObjects();
+    if (FAILED(device->CreateVertexBuffer(new_capacity * sizeof(D3DVertex), D3DUSAGE_DYNAMIC | D3DUSAGE_WRITEONLY, D3DFVF_CUSTOMVERTEX, D3DPOOL_DEFAULT, &buffer, nullptr))) {
+        buffer = nullptr;
+        return false;
+    }
+    owner = device;
+    capacity = new_capacity;
+    return true;
+}
+
+size_t D3DDynamicVertexRing::Append(IDirect3DDevice9* device, const D3DVertex* vertices, size_t vertex_count)
+{
+    if (!vertex_count || !Reserve(device, vertex_count)) return npos;
+
+    DWORD lock_flags = D3DLOCK_NOOVERWRITE;
+    if (cursor + vertex_count > capacity) {
+        // Wrapped; let the driver hand us a fresh buffer rather than waiting on pending draws
+        cursor = 0;
+        lock_flags = D3DLOCK_DISCARD;
+        generation++;
+    }
+    void* ptr = nullptr;
+    if (FAILED(buffer->Lock(cursor * sizeof(D3DVertex), vertex_count * sizeof(D3DVertex), &ptr, lock_flags))) 
+        return npos;
+    memcpy(ptr, vertices, vertex_count * sizeof(D3DVertex));
+    buffer->Unlock();
+    const size_t start = cursor;
+    cursor += vertex_count;
+    return start;
+}
+
+bool D3DDynamicVertexRing::DrawRange(IDirect3DDevice9* device, D3DPRIMITIVETYPE type, size_t start, size_t vertex_count, uint32_t _generation)
+{
+    if (!buffer || device != owner || _generation != generation || start == npos || start + vertex_count > capacity)
+        return false;
+    const UINT primitive_count = D3DPrimitiveCount(type, vertex_count);
+    if (!primitive_count) return true;
+    device->SetFVF(D3DFVF_CUSTOMVERTEX);
+    device->SetStreamSource(0, buffer, 0, sizeof(D3DVertex));
+    device->DrawPrimitive(type, start, primitive_count);
+    return true;
+}
+
+bool D3DDynamicVertexRing::Draw(IDirect3DDevice9* device, D3DPRIMITIVETYPE type, const D3DVertex* vertices, size_t vertex_count)
+{
+    if (!D3DPrimitiveCount(type, vertex_count)) return true;
+    const size_t start = Append(device, vertices, vertex_count);
+    return DrawRange(device, type, start, vertex_count, generation);
+}
+
 D3DVertexBuffer::~D3DVertexBuffer() {
     DEBUG_ASSERT(!buffer);
 }
@@ -71,6 +160,12 @@ D3DVertexBuffer::~D3DVertexBuffer() {
 void D3DVertexBuffer::Initialize(IDirect3DDevice9* device)
 {
     dirty = false;
+    if (dynamic) {
+        count = D3DPrimitiveCount(type, vertices.size());
+        ring_start = D3DDynamicVertexRing::npos; // Geometry changed; copy it into the ring on the next draw
+        initialized = true;
+        return;
+    }
     UploadVertices(device);
     initialized = true;
 }
@@ -132,6 +227,16 @@ void D3DVertexBuffer::Render(IDirect3DDevice9* device)
         initialized = true;
         Initialize(device);
     }
+    if (dynamic) {
+        if (!count) return;
+        auto& ring = D3DDynamicVertexRing::Instance();
+        if (ring_start == D3DDynamicVertexRing::npos || ring_generation != ring.Generation()) {
+            ring_start = ring.Append(device, vertices.data(), vertices.size());
+            ring_generation = ring.Generation();
+        }
+        ring.DrawRange(device, type, ring_start, vertices.size(), ring_generation);
+        return;
+    }
     if (!buffer || !count) return;
     device->SetFVF(D3DFVF_CUSTOMVERTEX);
     device->SetStreamSource(0, buffer, 0, sizeof(D3DVertex));
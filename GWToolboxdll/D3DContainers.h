@@ -49,6 +49,41 @@ struct D3DVelocityArrow : D3DShape<1> {
 };
 
 
+// Number of primitives a draw of vertex_count vertices produces for the given primitive type.
+UINT D3DPrimitiveCount(D3DPRIMITIVETYPE type, size_t vertex_count);
+
+// Shared D3DUSAGE_DYNAMIC vertex buffer for geometry that is rebuilt every few frames.
+// Vertices are appended with D3DLOCK_NOOVERWRITE; the buffer is only discarded when it wraps,
+// so the driver never has to wait for the GPU to finish with a previous draw, and there's
+// no per-renderer managed buffer to re-upload each time the geometry changes.
+// Appended vertices stay where they are until the ring wraps or is recreated, which changes
+// Generation(), so geometry that hasn't changed since it was appended can be redrawn in place.
+class D3DDynamicVertexRing {
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    static D3DDynamicVertexRing& Instance();
+
+    // Copies the vertices into the ring. Returns the index of the first one, or npos on failure.
+    size_t Append(IDirect3DDevice9* device, const D3DVertex* vertices, size_t vertex_count);
+    // Draws vertex_count vertices appended at start. False if the ring has been wrapped or recreated since generation.
+    bool DrawRange(IDirect3DDevice9* device, D3DPRIMITIVETYPE type, size_t start, size_t vertex_count, uint32_t generation);
+    // Appends the vertices and draws them.
+    bool Draw(IDirect3DDevice9* device, D3DPRIMITIVETYPE type, const D3DVertex* vertices, size_t vertex_count);
+    [[nodiscard]] uint32_t Generation() const { return generation; }
+    // The buffer lives in D3DPOOL_DEFAULT; call before the device is reset.
+    void InvalidateDeviceObjects();
+
+private:
+    bool Reserve(IDirect3DDevice9* device, size_t vertex_count);
+
+    IDirect3DDevice9* owner = nullptr;
+    IDirect3DVertexBuffer9* buffer = nullptr;
+    size_t capacity = 0; // in vertices
+    size_t cursor = 0;   // next free vertex
+    uint32_t generation = 0;
+};
+
 class D3DVertexBuffer {
 public:
     virtual ~D3DVertexBuffer();
@@ -79,6 +114,11 @@ protected:
     unsigned long count = 0;
     bool initialized = false;
     bool dirty = true;
+    // Stream vertices through D3DDynamicVertexRing instead of owning a managed buffer.
+    // Use for geometry that's rebuilt every few frames; it's only copied into the ring after a rebuild.
+    bool dynamic = false;
+    size_t ring_start = D3DDynamicVertexRing::npos;
+    uint32_t ring_generation = 0;
     std::vector<D3DVertex> vertices;
 };
 
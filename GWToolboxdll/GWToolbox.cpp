@@ -17,8 +17,10 @@
 #include <GWCA/Managers/RenderMgr.h>
 
 #include <Defines.h>
+#include <D3DContainers.h>
 #include <Utils/GuiUtils.h>
 #include <Utils/TeamBuild.h>
+#include <Utils/TraceProfiler.h>
 #include <GWToolbox.h>
 #include <Logger.h>
 
@@ -62,16 +64,25 @@ namespace {
     utf8::string imgui_inifile;
     bool imgui_inifile_changed = false;
     bool settings_folder_changed = false;
+    ToolboxIni* settings_ini = nullptr;
 
     bool must_self_destruct = false; // is true when toolbox should quit
     GW::HookEntry Update_Entry;
 
     bool profiling_enabled = false;
 
-    uint64_t QpcToMicroseconds(LONGLONG ticks)
+    // Times a module callback, recording it both as the module's last frame time and as a tracer zone
+    template <typename Fn>
+    uint64_t ProfileModuleCall(TraceProfiler::ZoneId& zone_id, const ToolboxModule* module, const char* suffix, Fn&& fn)
     {
-        static LARGE_INTEGER freq = [] { LARGE_INTEGER f; QueryPerformanceFrequency(&f); return f; }();
-        return static_cast<uint64_t>(ticks * 1000000 / freq.QuadPart);
+        if (zone_id == TraceProfiler::InvalidZone) {
+            zone_id = TraceProfiler::RegisterZone(std::format("{}::{}", module->Name(), suffix));
+        }
+        const auto t0 = TraceProfiler::Now();
+        fn();
+        const auto t1 = TraceProfiler::Now();
+        TraceProfiler::Record(zone_id, t0, t1);
+        return TraceProfiler::TicksToMicroseconds(t1 - t0);
     }
     std::recursive_mutex module_management_mutex;
 
@@ -168,6 +179,7 @@ namespace {
 
         GW::Render::SetResetCallback([](IDirect3DDevice9*) {
             ImGui_ImplDX9_InvalidateDeviceObjects();
+            D3DDynamicVertexRing::Instance().InvalidateDeviceObjects();
         });
 
         imgui_initialized = true;
@@ -436,6 +448,7 @@ namespace {
 
     LRESULT CALLBACK WndProc(const HWND hWnd, const UINT Message, const WPARAM wParam, const LPARAM lParam)
     {
+        TB_TRACE_ZONE("GWToolbox::WndProc");
         static bool right_mouse_down = false;
 
         if (Message == WM_CLOSE) {
@@ -721,6 +734,7 @@ const std::vector<ToolboxWidget*>& GWToolbox::GetWidgets()
 void GWToolbox::SetProfilingEnabled(bool enabled)
 {
     profiling_enabled = enabled;
+    TraceProfiler::SetEnabled(enabled);
 }
 
 bool GWToolbox::ShouldDisableToolbox(GW::Constants::MapID map_id)
@@ -874,20 +888,25 @@ bool GWToolbox::SettingsFolderChanged()
 
 ToolboxIni* GWToolbox::OpenSettingsFile(bool fresh)
 {
-    static ToolboxIni* inifile = nullptr;
     const auto full_path = Resources::GetSettingFile(GWTOOLBOX_INI_FILENAME);
-    if (!SettingsFolderChanged() && inifile && !fresh) {
-        return inifile;
+    if (!SettingsFolderChanged() && settings_ini && !fresh) {
+        return settings_ini;
     }
     auto tmp = new ToolboxIni(false, false, false);
-    ASSERT(tmp->LoadIfExists(full_path) == SI_OK);
+    if (std::string pending; Resources::GetPendingIniSave(full_path, pending)) {
+        // A write-behind save hasn't hit the disk yet; start from what it will write
+        tmp->LoadBuffer(pending);
+    }
+    else {
+        ASSERT(tmp->LoadIfExists(full_path) == SI_OK);
+    }
     tmp->location_on_disk = full_path;
-    if (inifile) delete inifile;
-    inifile = tmp;
-    return inifile;
+    if (settings_ini) delete settings_ini;
+    settings_ini = tmp;
+    return settings_ini;
 }
 
-std::filesystem::path GWToolbox::SaveSettings()
+std::filesystem::path GWToolbox::SaveSettings(const bool write_behind)
 {
     const auto ini = OpenSettingsFile(true);
     for (const auto m : modules_enabled) {
@@ -900,7 +919,17 @@ std::filesystem::path GWToolbox::SaveSettings()
         m->SaveSettings(ini);
     }
     ToolboxSettings::LoadModules(ini);
-    ASSERT(Resources::SaveIniToFile(ini->location_on_disk, ini) == 0);
+    if (write_behind) {
+        Resources::SaveIniToFileAsync(ini->location_on_disk, ini, [path = ini->location_on_disk](const std::string& written) {
+            // Unless the settings have been reloaded or changed again since
+            if (settings_ini && settings_ini->location_on_disk == path && settings_ini->Serialize() == written) {
+                settings_ini->MarkSaved();
+            }
+        });
+    }
+    else {
+        ASSERT(Resources::SaveIniToFile(ini->location_on_disk, ini) == 0);
+    }
     const auto dir = ini->location_on_disk.parent_path();
     const auto dirstr = dir.wstring();
     const auto printable = TextUtils::str_replace_all(dirstr, LR"(\\)", L"/");
@@ -970,6 +999,7 @@ bool GWToolbox::CanTerminate()
 
 void GWToolbox::Update(GW::HookStatus*)
 {
+    TB_TRACE_ZONE("GWToolbox::Update");
     static DWORD last_tick_count;
     if (last_tick_count == 0) {
         last_tick_count = GetTickCount();
@@ -999,11 +1029,9 @@ void GWToolbox::Update(GW::HookStatus*)
     // Update loop
     for (const auto m : modules_enabled) {
         if (profiling_enabled) {
-            LARGE_INTEGER t0, t1;
-            QueryPerformanceCounter(&t0);
-            m->Update(delta_f);
-            QueryPerformanceCounter(&t1);
-            m->last_update_time_us_ = QpcToMicroseconds(t1.QuadPart - t0.QuadPart);
+            m->last_update_time_us_ = ProfileModuleCall(m->update_zone_id_, m, "Update", [&] {
+                m->Update(delta_f);
+            });
         } else {
             m->Update(delta_f);
         }
@@ -1033,6 +1061,7 @@ void GWToolbox::Update(GW::HookStatus*)
 
 void GWToolbox::Draw(IDirect3DDevice9* device)
 {
+    TB_TRACE_ZONE("GWToolbox::Draw");
     HookUiRoot();
     switch (gwtoolbox_state) {
         case GWToolboxState::DrawTerminating:
@@ -1104,11 +1133,9 @@ void GWToolbox::Draw(IDirect3DDevice9* device)
             uielement->UpdateLocationAgainstSnappedFrame();
             uielement->DrawBreakoutButton(device);
             if (profiling_enabled) {
-                LARGE_INTEGER t0, t1;
-                QueryPerformanceCounter(&t0);
-                uielement->Draw(device);
-                QueryPerformanceCounter(&t1);
-                uielement->last_draw_time_us_ = QpcToMicroseconds(t1.QuadPart - t0.QuadPart);
+                uielement->last_draw_time_us_ = ProfileModuleCall(uielement->draw_zone_id_, uielement, "Draw", [&] {
+                    uielement->Draw(device);
+                });
             } else {
                 uielement->Draw(device);
             }
@@ -37,7 +37,8 @@ public:
     static bool CanTerminate();
 
     static ToolboxIni* OpenSettingsFile(bool fresh = false);
-    static std::filesystem::path SaveSettings();
+    // write_behind: serialize now but write the file on a worker thread; used for saves that happen mid-session
+    static std::filesystem::path SaveSettings(bool write_behind = false);
     static void ForceTerminate(bool detach_wndproc_handler = true);
     static std::filesystem::path LoadSettings();
     static bool SetSettingsFolder(const std::filesystem::path& path);
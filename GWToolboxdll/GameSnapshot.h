@@ -0,0 +1,159 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifndef GWTOOLBOXDLL_SNAPSHOT_EXPORT
+#  ifdef GWToolboxdll_EXPORTS
+#    define GWTOOLBOXDLL_SNAPSHOT_EXPORT __declspec(dllexport)
+#  else
+#    define GWTOOLBOXDLL_SNAPSHOT_EXPORT __declspec(dllimport)
+#  endif
+#endif
+
+/*
+Read-only tables of game state, published by GWToolbox once per frame while any plugin is loaded, so plugins don't
+have to walk game memory themselves.
+
+This is a plain C interface: structs only ever gain fields at the end, and each table records the row size the host
+was built with, so a plugin built against an older version of this header keeps working with a newer toolbox. Step
+through rows with GW_SNAPSHOT_ROW rather than indexing the row pointer directly.
+
+There are two snapshot buffers; each publish rewrites the older one and then bumps the epoch. During a plugin's
+Update/Draw the current snapshot is stable for the whole frame. Another thread can read without locking, but must
+check afterwards that what it read wasn't being rewritten:
+
+    uint64_t epoch;
+    const GWSnapshot* snapshot = GWToolbox_GetSnapshot(GW_SNAPSHOT_ABI_VERSION, &epoch);
+    ... copy what you need out of snapshot ...
+    if (!GWToolbox_IsSnapshotValid(epoch)) { ... discard the copy and try again }
+
+Each table's rows are allocated once and never move, so a read that races a rewrite sees mixed-up rows rather than
+freed memory. Tables have a fixed maximum number of rows; anything past it isn't published.
+*/
+
+#define GW_SNAPSHOT_ABI_VERSION 1
+
+#define GW_SNAPSHOT_ROW(table, type, index) ((const type*)((const char*)(table).rows + (size_t)(index) * (table).row_size))
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct GWSnapshotTable {
+    const void* rows;
+    uint32_t count;
+    uint32_t row_size;
+} GWSnapshotTable;
+
+// Living agents in the instance
+typedef struct GWSnapshotAgent {
+    uint32_t agent_id;
+    uint32_t login_number; // Non-zero for players
+    float x;
+    float y;
+    uint32_t plane;
+    float rotation; // Radians from east
+    float hp;       // 0 to 1
+    float energy;   // 0 to 1; only known for the controlled character
+    uint32_t max_hp;     // Only known for the controlled character
+    uint32_t max_energy; // Only known for the controlled character
+    uint32_t effects;    // Health bar effect bits, see AgentLiving::effects
+    uint32_t type_map;   // See AgentLiving::type_map
+    uint32_t model_state;
+    uint16_t player_number; // Model/npc id for non-players
+    uint16_t skill;         // Skill being used, or 0
+    uint16_t weapon_type;
+    uint8_t allegiance;
+    uint8_t primary;
+    uint8_t secondary;
+    uint8_t level;
+    uint8_t team_id;
+    uint8_t reserved;
+} GWSnapshotAgent;
+
+typedef enum GWSnapshotPartyMemberType {
+    GWSnapshotPartyMember_Player = 0,
+    GWSnapshotPartyMember_Hero = 1,
+    GWSnapshotPartyMember_Henchman = 2,
+} GWSnapshotPartyMemberType;
+
+// Members of the player's party, in party window order within each type
+typedef struct GWSnapshotPartyMember {
+    uint32_t agent_id; // 0 for a player that isn't in the instance
+    uint32_t login_number; // Players and hero owners
+    uint32_t hero_id;      // Heroes only
+    uint32_t level;        // Heroes and henchmen only
+    uint32_t type;         // GWSnapshotPartyMemberType
+    uint32_t flags;        // GW_SNAPSHOT_PARTY_*
+} GWSnapshotPartyMember;
+
+#define GW_SNAPSHOT_PARTY_CONNECTED 0x1
+#define GW_SNAPSHOT_PARTY_TICKED 0x2
+
+// Effects on party members and the controlled character
+typedef struct GWSnapshotEffect {
+    uint32_t agent_id; // Agent the effect is on
+    uint32_t skill_id;
+    uint32_t effect_id;
+    uint32_t caster_id; // Non-zero for maintained enchantments
+    uint32_t attribute_level;
+    uint32_t time_remaining; // Milliseconds; 0 if the effect has no duration
+    float duration;          // Seconds; 0 if the effect has no duration
+} GWSnapshotEffect;
+
+typedef struct GWSnapshotSkill {
+    uint32_t skill_id;
+    uint32_t recharge; // Milliseconds remaining, 0 if recharged
+    uint32_t adrenaline;
+    uint32_t event;
+} GWSnapshotSkill;
+
+// Skillbars of the controlled character and its heroes
+typedef struct GWSnapshotSkillbar {
+    uint32_t agent_id;
+    uint32_t disabled;
+    GWSnapshotSkill skills[8];
+} GWSnapshotSkillbar;
+
+typedef struct GWSnapshotMap {
+    uint32_t map_id;
+    uint32_t instance_type; // GW::Constants::InstanceType
+    int32_t district;
+    int32_t region;
+    int32_t language;
+    uint32_t instance_time; // Milliseconds
+    uint8_t is_loaded;
+    uint8_t is_hard_mode;
+    uint8_t is_party_defeated;
+    uint8_t reserved;
+} GWSnapshotMap;
+
+typedef struct GWSnapshotInventory {
+    uint32_t gold_character;
+    uint32_t gold_storage;
+    uint32_t bag_slots; // Backpack, belt pouch and both bags
+    uint32_t bag_slots_free;
+} GWSnapshotInventory;
+
+typedef struct GWSnapshot {
+    uint32_t abi_version; // GW_SNAPSHOT_ABI_VERSION the host was built with
+    uint32_t size;        // sizeof(GWSnapshot) the host was built with
+    uint64_t epoch;       // Increases with every publish
+    uint32_t player_agent_id;
+    uint32_t target_agent_id;
+    GWSnapshotMap map;
+    GWSnapshotInventory inventory;
+    GWSnapshotTable agents;    // GWSnapshotAgent
+    GWSnapshotTable party;     // GWSnapshotPartyMember
+    GWSnapshotTable effects;   // GWSnapshotEffect
+    GWSnapshotTable skillbars; // GWSnapshotSkillbar
+} GWSnapshot;
+
+// Latest snapshot, or NULL before the first publish or if abi_version is newer than the host's. epoch_out may be NULL.
+GWTOOLBOXDLL_SNAPSHOT_EXPORT const GWSnapshot* GWToolbox_GetSnapshot(uint32_t abi_version, uint64_t* epoch_out);
+// False once the snapshot returned with this epoch has started being rewritten
+GWTOOLBOXDLL_SNAPSHOT_EXPORT int GWToolbox_IsSnapshotValid(uint64_t epoch);
+
+#ifdef __cplusplus
+}
+#endif
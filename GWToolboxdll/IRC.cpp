@@ -46,69 +46,132 @@
 #endif
 
 
-IRC::IRC()
+bool irc_message::parse(std::string_view line)
 {
-    hooks = nullptr;
-    chan_users = nullptr;
-    connected = false;
-    sentnick = false;
-    sentpass = false;
-    sentuser = false;
-    pending_disconnect = false;
-    cur_nick = nullptr;
+    *this = {};
+    const auto next_token = [&line] {
+        const auto space = line.find(' ');
+        const auto token = line.substr(0, space);
+        line.remove_prefix(space == std::string_view::npos ? line.size() : space + 1);
+        while (line.starts_with(' ')) {
+            line.remove_prefix(1);
+        }
+        return token;
+    };
+    if (line.starts_with('@')) {
+        line.remove_prefix(1);
+        tags = next_token();
+    }
+    if (line.starts_with(':')) {
+        line.remove_prefix(1);
+        prefix = next_token();
+        nick = prefix.substr(0, prefix.find_first_of("!@"));
+        const auto at = prefix.find('@', nick.size());
+        if (nick.size() < prefix.size() && prefix[nick.size()] == '!') {
+            ident = prefix.substr(nick.size() + 1, at == std::string_view::npos ? std::string_view::npos : at - nick.size() - 1);
+        }
+        if (at != std::string_view::npos) {
+            host = prefix.substr(at + 1);
+        }
+    }
+    command = next_token();
+    while (!line.empty() && param_count < max_params) {
+        if (line.starts_with(':') || param_count == max_params - 1) {
+            params[param_count++] = line.starts_with(':') ? line.substr(1) : line;
+            break;
+        }
+        params[param_count++] = next_token();
+    }
+    return !command.empty();
 }
 
-IRC::~IRC()
+std::string_view irc_message::tag(const std::string_view key) const
 {
-    if (hooks) {
-        delete_irc_command_hook(hooks);
-    }
-    if (wsaData.wVersion) {
-        WSACleanup();
-        wsaData = { 0 };
+    auto rest = tags;
+    while (!rest.empty()) {
+        const auto separator = rest.find(';');
+        const auto tag = rest.substr(0, separator);
+        rest.remove_prefix(separator == std::string_view::npos ? rest.size() : separator + 1);
+        if (tag.starts_with(key) && (tag.size() == key.size() || tag[key.size()] == '=')) {
+            return tag.substr(std::min(tag.size(), key.size() + 1));
+        }
     }
+    return {};
 }
 
-void IRC::insert_irc_command_hook(irc_command_hook* hook, const char* cmd_name, int (*function_ptr)(const char*, irc_reply_data*, void*))
+std::string irc_unescape_tag_value(const std::string_view value)
 {
-    if (hook->function) {
-        if (!hook->next) {
-            hook->next = new irc_command_hook;
-            hook->next->function = nullptr;
-            hook->next->irc_command = nullptr;
-            hook->next->next = nullptr;
+    std::string out;
+    out.reserve(value.size());
+    for (size_t i = 0; i < value.size(); i++) {
+        if (value[i] != '\\') {
+            out.push_back(value[i]);
+            continue;
+        }
+        if (++i == value.size()) {
+            break; // A trailing backslash is dropped
+        }
+        switch (value[i]) {
+            case ':':
+                out.push_back(';');
+                break;
+            case 's':
+                out.push_back(' ');
+                break;
+            case 'r':
+                out.push_back('\r');
+                break;
+            case 'n':
+                out.push_back('\n');
+                break;
+            default:
+                out.push_back(value[i]);
+                break;
         }
-        insert_irc_command_hook(hook->next, cmd_name, function_ptr);
-    }
-    else {
-        hook->function = function_ptr;
-        hook->irc_command = new char[strlen(cmd_name) + 1];
-        strcpy(hook->irc_command, cmd_name);
     }
+    return out;
 }
 
-void IRC::hook_irc_command(const char* cmd_name, int (*function_ptr)(const char*, irc_reply_data*, void*))
+std::span<char> irc_line_framer::write_space()
 {
-    if (!hooks) {
-        hooks = new irc_command_hook;
-        hooks->function = nullptr;
-        hooks->irc_command = nullptr;
-        hooks->next = nullptr;
-        insert_irc_command_hook(hooks, cmd_name, function_ptr);
+    if (begin) {
+        memmove(buffer.data(), buffer.data() + begin, end - begin);
+        end -= begin;
+        begin = 0;
     }
-    else {
-        insert_irc_command_hook(hooks, cmd_name, function_ptr);
+    if (end == capacity) {
+        // No line ending in a full buffer; drop what we have and the rest of the line when it arrives
+        end = scanned = 0;
+        discarding = true;
     }
+    return {buffer.data() + end, capacity - end};
+}
+
+void irc_line_framer::commit(const size_t bytes)
+{
+    end += bytes;
+}
+
+IRC::IRC()
+{
+    connected = false;
+    sentnick = false;
+    sentpass = false;
+    sentuser = false;
+    pending_disconnect = false;
 }
 
-void IRC::delete_irc_command_hook(const irc_command_hook* cmd_hook)
+IRC::~IRC()
 {
-    if (cmd_hook->next) {
-        delete_irc_command_hook(cmd_hook->next);
+    if (wsaData.wVersion) {
+        WSACleanup();
+        wsaData = { 0 };
     }
+}
 
-    delete cmd_hook->irc_command;
-    delete cmd_hook;
+void IRC::hook_irc_command(const char* cmd_name, const irc_command_fn function_ptr)
+{
+    hooks.try_emplace(cmd_name, function_ptr);
 }
 
 int IRC::start(const char* server, int port, const char* nick, const char* user, const char* name, const char* pass)
@@ -154,6 +217,9 @@ int IRC::start(const char* server, int port, const char* nick, const char* user,
     freeaddrinfo(servinfo);
 
     connected = true;
+    framer.clear();
+    chan_users.clear();
+    cur_nick = user;
     t = std::thread([&] {
         message_loop();
     });
@@ -207,22 +273,24 @@ int IRC::message_fetch()
     if (!connected) {
         return 1;
     }
-    message_buffer[0] = '\0';
-    const auto ret_len = recv(irc_socket, message_buffer, 1023, 0);
+    const auto space = framer.write_space();
+    const auto ret_len = recv(irc_socket, space.data(), static_cast<int>(space.size()), 0);
     if (ret_len == SOCKET_ERROR) {
         printf("IRC::message_fetch recv failed, %d\n", WSAGetLastError());
         connected = false;
         closesocket(irc_socket);
         return 1;
     }
-    if (!message_buffer[0]) {
+    if (ret_len == 0) {
         printf("IRC::message_fetch message empty; graceful close?\n");
         connected = false;
         closesocket(irc_socket);
         return 1;
     }
-    message_buffer[ret_len] = '\0';
-    split_to_replies(message_buffer);
+    framer.commit(static_cast<size_t>(ret_len));
+    framer.for_each_line([this](const std::string_view line) {
+        parse_irc_reply(line);
+    });
     return 0;
 }
 
@@ -258,461 +326,158 @@ bool IRC::is_connected() const
 
 int IRC::message_loop()
 {
-    while (true) {
-        if (!connected) {
-            continue;
-        }
-        if (pending_disconnect) {
-            return 0;
-        }
+    while (connected && !pending_disconnect) {
         if (message_fetch() != 0) {
             return 1;
         }
     }
+    return 0;
 }
 
-void IRC::split_to_replies(const char* data)
+char IRC::user_flags(const std::string_view channel, const std::string_view nick) const
 {
-    const char* p;
-    while (p = strstr(data, "\r\n")) {
-        *const_cast<char*>(p) = '\0';
-        parse_irc_reply(data);
-        data = p + 2;
+    const auto found_channel = chan_users.find(channel);
+    if (found_channel == chan_users.end()) {
+        return 0;
     }
+    const auto found_user = found_channel->second.find(nick);
+    return found_user == found_channel->second.end() ? 0 : found_user->second;
 }
 
-int IRC::is_op(const char* channel, const char* nick) const
+int IRC::is_op(const std::string_view channel, const std::string_view nick) const
 {
-    const channel_user* cup = chan_users;
-
-    while (cup) {
-        if (!strcmp(cup->channel, channel) && !strcmp(cup->nick, nick)) {
-            return cup->flags & IRC_USER_OP;
-        }
-        cup = cup->next;
-    }
-
-    return 0;
+    return user_flags(channel, nick) & IRC_USER_OP;
 }
 
-int IRC::is_voice(const char* channel, const char* nick) const
+int IRC::is_voice(const std::string_view channel, const std::string_view nick) const
 {
-    const channel_user* cup = chan_users;
-
-    while (cup) {
-        if (!strcmp(cup->channel, channel) && !strcmp(cup->nick, nick)) {
-            return cup->flags & IRC_USER_VOICE;
-        }
-        cup = cup->next;
-    }
-
-    return 0;
+    return user_flags(channel, nick) & IRC_USER_VOICE;
 }
 
-void IRC::parse_irc_reply(const char* data)
+void IRC::update_channel_users(const irc_message& message)
 {
-    char* hostd;
-    char* cmd;
-    char* params;
-    //char buffer[514];
-    irc_reply_data hostd_tmp{};
-    channel_user* cup;
-    char* p;
-    char* chan_temp;
-
-    hostd_tmp.target = nullptr;
-
-    printf("%s\n", data);
-
-    if (data[0] == ':') {
-        hostd = const_cast<char*>(&data[1]);
-        cmd = strchr(hostd, ' ');
-        if (!cmd) {
-            return;
-        }
-        *cmd = '\0';
-        cmd++;
-        params = strchr(cmd, ' ');
-        if (params) {
-            *params = '\0';
-            params++;
-        }
-        hostd_tmp.nick = hostd;
-        hostd_tmp.ident = strchr(hostd, '!');
-        if (hostd_tmp.ident) {
-            *hostd_tmp.ident = '\0';
-            hostd_tmp.ident++;
-            hostd_tmp.host = strchr(hostd_tmp.ident, '@');
-            if (hostd_tmp.host) {
-                *hostd_tmp.host = '\0';
-                hostd_tmp.host++;
+    const auto& command = message.command;
+    if (command == "JOIN") {
+        chan_users[std::string(message.param(0))].try_emplace(std::string(message.nick), static_cast<char>(0));
+    }
+    else if (command == "PART") {
+        if (const auto found = chan_users.find(message.param(0)); found != chan_users.end()) {
+            if (const auto user = found->second.find(message.nick); user != found->second.end()) {
+                found->second.erase(user);
             }
         }
-
-        if (!strcmp(cmd, "JOIN")) {
-            cup = chan_users;
-            if (cup) {
-                while (cup->nick) {
-                    if (!cup->next) {
-                        cup->next = new channel_user;
-                        cup->next->channel = nullptr;
-                        cup->next->flags = 0;
-                        cup->next->next = nullptr;
-                        cup->next->nick = nullptr;
-                    }
-                    cup = cup->next;
-                }
-                cup->channel = new char[strlen(params) + 1];
-                strcpy(cup->channel, params);
-                cup->nick = new char[strlen(hostd_tmp.nick) + 1];
-                strcpy(cup->nick, hostd_tmp.nick);
+    }
+    else if (command == "QUIT") {
+        for (auto& users : chan_users | std::views::values) {
+            if (const auto user = users.find(message.nick); user != users.end()) {
+                users.erase(user);
             }
         }
-        else if (!strcmp(cmd, "PART")) {
-            channel_user* d;
-            channel_user* prev;
-
-            d = nullptr;
-            prev = nullptr;
-            cup = chan_users;
-            while (cup) {
-                if (!strcmp(cup->channel, params) && !strcmp(cup->nick, hostd_tmp.nick)) {
-                    d = cup;
-                    break;
-                }
-                prev = cup;
-                cup = cup->next;
-            }
-            if (d) {
-                if (d == chan_users) {
-                    chan_users = d->next;
-
-                    delete [] d->channel;
-
-                    delete [] d->nick;
-                    delete d;
-                }
-                else {
-                    if (prev) {
-                        prev->next = d->next;
-                    }
-                    chan_users = d->next;
-
-                    delete [] d->channel;
-
-                    delete [] d->nick;
-                    delete d;
-                }
-            }
+    }
+    else if (command == "NICK") {
+        const auto new_nick = message.param(0);
+        if (message.nick == cur_nick) {
+            cur_nick = new_nick;
         }
-        else if (!strcmp(cmd, "QUIT")) {
-            channel_user* d;
-            channel_user* prev;
-
-            d = nullptr;
-            prev = nullptr;
-            cup = chan_users;
-            while (cup) {
-                if (!strcmp(cup->nick, hostd_tmp.nick)) {
-                    d = cup;
-                    if (d == chan_users) {
-                        chan_users = d->next;
-
-                        delete [] d->channel;
-
-                        delete [] d->nick;
-                        delete d;
-                    }
-                    else {
-                        if (prev) {
-                            prev->next = d->next;
-                        }
-
-                        delete [] d->channel;
-
-                        delete [] d->nick;
-                        delete d;
-                    }
-                    break;
-                }
-                prev = cup;
-                cup = cup->next;
+        for (auto& users : chan_users | std::views::values) {
+            if (const auto user = users.find(message.nick); user != users.end()) {
+                const auto flags = user->second;
+                users.erase(user);
+                users[std::string(new_nick)] = flags;
             }
         }
-        else if (!strcmp(cmd, "MODE")) {
-            char* chan;
-            char* changevars;
-            channel_user* cup;
-            channel_user* d;
-            char* tmp;
-            int i;
-            bool plus;
-
-            chan = params;
-            params = strchr(chan, ' ');
-            *params = '\0';
-            params++;
-            changevars = params;
-            params = strchr(changevars, ' ');
-            if (!params) {
-                return;
-            }
-            if (chan[0] != '#') {
-                return;
-            }
-            *params = '\0';
-            params++;
-
-            plus = false;
-            for (i = 0; i < static_cast<signed>(strlen(changevars)); i++) {
-                switch (changevars[i]) {
-                    case '+':
-                        plus = true;
-                        break;
-                    case '-':
-                        plus = false;
-                        break;
-                    case 'o':
-                        tmp = strchr(params, ' ');
-                        if (tmp) {
-                            *tmp = '\0';
-                            tmp++;
-                        }
-                        tmp = params;
-                        if (plus) {
-                            // user has been opped (chan, params)
-                            cup = chan_users;
-                            d = nullptr;
-                            while (cup) {
-                                if (cup->next && cup->channel) {
-                                    if (!strcmp(cup->channel, chan) && !strcmp(cup->nick, tmp)) {
-                                        d = cup;
-                                        break;
-                                    }
-                                }
-                                cup = cup->next;
-                            }
-                            if (d) {
-                                d->flags = d->flags | IRC_USER_OP;
-                            }
-                        }
-                        else {
-                            // user has been deopped (chan, params)
-                            cup = chan_users;
-                            d = nullptr;
-                            while (cup) {
-                                if (!strcmp(cup->channel, chan) && !strcmp(cup->nick, tmp)) {
-                                    d = cup;
-                                    break;
-                                }
-                                cup = cup->next;
-                            }
-                            if (d) {
-                                d->flags = d->flags ^ IRC_USER_OP;
-                            }
-                        }
-                        params = tmp;
-                        break;
-                    case 'v':
-                        tmp = strchr(params, ' ');
-                        if (tmp) {
-                            *tmp = '\0';
-                            tmp++;
-                        }
-                        if (plus) {
-                            // user has been voiced
-                            cup = chan_users;
-                            d = nullptr;
-                            while (cup) {
-                                if (!strcmp(cup->channel, params) && !strcmp(cup->nick, hostd_tmp.nick)) {
-                                    d = cup;
-                                    break;
-                                }
-                                cup = cup->next;
-                            }
-                            if (d) {
-                                d->flags = d->flags | IRC_USER_VOICE;
-                            }
-                        }
-                        else {
-                            // user has been devoiced
-                            cup = chan_users;
-                            d = nullptr;
-                            while (cup) {
-                                if (!strcmp(cup->channel, params) && !strcmp(cup->nick, hostd_tmp.nick)) {
-                                    d = cup;
-                                    break;
-                                }
-                                cup = cup->next;
-                            }
-                            if (d) {
-                                d->flags = d->flags ^ IRC_USER_VOICE;
-                            }
-                        }
-                        params = tmp;
-                        break;
-                    default:
-                        return;
-                }
-                // ------------ END OF MODE ---------------
-            }
+    }
+    else if (command == "MODE") {
+        // MODE #channel +o-v nick1 nick2
+        const auto channel = chan_users.find(message.param(0));
+        if (channel == chan_users.end()) {
+            return;
         }
-        else if (!strcmp(cmd, "353")) {
-            // receiving channel names list
-            if (!chan_users) {
-                chan_users = new channel_user;
-                chan_users->next = nullptr;
-                chan_users->nick = nullptr;
-                chan_users->flags = 0;
-                chan_users->channel = nullptr;
+        bool plus = true;
+        size_t target = 2;
+        for (const auto mode : message.param(1)) {
+            char flag = 0;
+            switch (mode) {
+                case '+':
+                    plus = true;
+                    continue;
+                case '-':
+                    plus = false;
+                    continue;
+                case 'o':
+                    flag = IRC_USER_OP;
+                    break;
+                case 'v':
+                    flag = IRC_USER_VOICE;
+                    break;
+                default:
+                    return; // Don't know whether this mode takes a parameter, so can't tell which nick the next one applies to
             }
-            cup = chan_users;
-            chan_temp = strchr(params, '#');
-            if (chan_temp) {
-                //chan_temp+=3;
-                p = strstr(chan_temp, " :");
-                if (p) {
-                    *p = '\0';
-                    p += 2;
-                    while (strchr(p, ' ')) {
-                        char* tmp;
-
-                        tmp = strchr(p, ' ');
-                        *tmp = '\0';
-                        tmp++;
-                        while (cup->nick) {
-                            if (!cup->next) {
-                                cup->next = new channel_user;
-                                cup->next->channel = nullptr;
-                                cup->next->flags = 0;
-                                cup->next->next = nullptr;
-                                cup->next->nick = nullptr;
-                            }
-                            cup = cup->next;
-                        }
-                        if (p[0] == '@') {
-                            cup->flags = cup->flags | IRC_USER_OP;
-                            p++;
-                        }
-                        else if (p[0] == '+') {
-                            cup->flags = cup->flags | IRC_USER_VOICE;
-                            p++;
-                        }
-                        cup->nick = new char[strlen(p) + 1];
-                        strcpy(cup->nick, p);
-                        cup->channel = new char[strlen(chan_temp) + 1];
-                        strcpy(cup->channel, chan_temp);
-                        p = tmp;
-                    }
-                    while (cup->nick) {
-                        if (!cup->next) {
-                            cup->next = new channel_user;
-                            cup->next->channel = nullptr;
-                            cup->next->flags = 0;
-                            cup->next->next = nullptr;
-                            cup->next->nick = nullptr;
-                        }
-                        cup = cup->next;
-                    }
-                    if (p[0] == '@') {
-                        cup->flags = cup->flags | IRC_USER_OP;
-                        p++;
-                    }
-                    else if (p[0] == '+') {
-                        cup->flags = cup->flags | IRC_USER_VOICE;
-                        p++;
-                    }
-                    cup->nick = new char[strlen(p) + 1];
-                    strcpy(cup->nick, p);
-                    cup->channel = new char[strlen(chan_temp) + 1];
-                    strcpy(cup->channel, chan_temp);
-                }
+            const auto user = channel->second.find(message.param(target++));
+            if (user != channel->second.end()) {
+                user->second = plus ? user->second | flag : user->second & ~flag;
             }
         }
-        else if (!strcmp(cmd, "NOTICE")) {
-            hostd_tmp.target = params;
-            params = strchr(hostd_tmp.target, ' ');
-            if (params) {
-                *params = '\0';
-            }
-            params++;
-#ifdef __IRC_DEBUG__
-            printf("%s >-%s- %s\n", hostd_tmp.nick, hostd_tmp.target, &params[1]);
-#endif
+    }
+    else if (command == "353") {
+        // 353 me = #channel :nick1 @nick2 +nick3
+        if (message.param_count < 2) {
+            return;
         }
-        else if (!strcmp(cmd, "PRIVMSG")) {
-            hostd_tmp.target = params;
-            params = strchr(hostd_tmp.target, ' ');
-            if (!params) {
-                return;
+        auto& users = chan_users[std::string(message.param(message.param_count - 2))];
+        auto names = message.param(message.param_count - 1);
+        while (!names.empty()) {
+            const auto space = names.find(' ');
+            auto name = names.substr(0, space);
+            names.remove_prefix(space == std::string_view::npos ? names.size() : space + 1);
+            char flags = 0;
+            if (name.starts_with('@')) {
+                flags = IRC_USER_OP;
+                name.remove_prefix(1);
             }
-            *params++ = '\0';
-#ifdef __IRC_DEBUG__
-            printf("%s: <%s> %s\n", hostd_tmp.target, hostd_tmp.nick, &params[1]);
-#endif
-        }
-        else if (!strcmp(cmd, "NICK")) {
-            if (!strcmp(hostd_tmp.nick, cur_nick)) {
-                delete [] cur_nick;
-                cur_nick = new char[strlen(params) + 1];
-                strcpy(cur_nick, params);
+            else if (name.starts_with('+')) {
+                flags = IRC_USER_VOICE;
+                name.remove_prefix(1);
+            }
+            if (!name.empty()) {
+                users[std::string(name)] = flags;
             }
         }
-        /* else if (!strcmp(cmd, ""))
-        {
-            #ifdef __IRC_DEBUG__
-            #endif
-        } */
-        call_hook(cmd, params, &hostd_tmp);
-    }
-    else {
-        cmd = const_cast<char*>(data);
-        data = strchr(cmd, ' ');
-        if (!data) {
-            return;
-        }
-        *const_cast<char*>(data) = '\0';
-        params = const_cast<char*>(data + 1);
+    }
+}
 
-        if (!strcmp(cmd, "PING")) {
-            if (!params) {
-                return;
-            }
-            raw("PONG %s\r\n", &params[1]);
+void IRC::parse_irc_reply(const std::string_view line)
+{
+    printf("%.*s\n", static_cast<int>(line.size()), line.data());
+
+    irc_message message;
+    if (!message.parse(line)) {
+        return;
+    }
+    if (message.prefix.empty()) {
+        if (message.command == "PING") {
+            raw("PONG %.*s\r\n", static_cast<int>(message.param(0).size()), message.param(0).data());
 #ifdef __IRC_DEBUG__
             printf("Ping received, pong sent.\n");
 #endif
-            fflush(dataout);
+            return;
         }
-        else if (!strcmp(cmd, "PONG")) {
+        if (message.command == "PONG") {
             pong_recieved = clock();
-            fflush(dataout);
-        }
-        else {
-            hostd_tmp.host = nullptr;
-            hostd_tmp.ident = nullptr;
-            hostd_tmp.nick = nullptr;
-            hostd_tmp.target = nullptr;
-            call_hook(cmd, params, &hostd_tmp);
+            return;
         }
     }
+    else if (message.command == "PONG") {
+        pong_recieved = clock();
+    }
+    update_channel_users(message);
+    call_hook(message);
 }
 
-void IRC::call_hook(const char* irc_command, const char* params, irc_reply_data* hostd)
+void IRC::call_hook(const irc_message& message)
 {
-    if (!hooks) {
-        return;
-    }
-
-    const irc_command_hook* p = hooks;
-    while (p) {
-        if (!strcmp(p->irc_command, irc_command)) {
-            (*p->function)(params, hostd, this);
-            p = nullptr;
-        }
-        else {
-            p = p->next;
-        }
+    if (const auto found = hooks.find(message.command); found != hooks.end()) {
+        found->second(message, this);
     }
 }
 
@@ -820,7 +585,7 @@ int IRC::mode(const char* channel, const char* modes, const char* targets) const
 
 int IRC::mode(const char* modes) const
 {
-    return mode(cur_nick, modes, nullptr);
+    return mode(cur_nick.c_str(), modes, nullptr);
 }
 
 int IRC::nick(const char* newnick) const
@@ -828,7 +593,7 @@ int IRC::nick(const char* newnick) const
     return raw("NICK %s\r\n", newnick);
 }
 
-char* IRC::current_nick() const
+const char* IRC::current_nick() const
 {
-    return cur_nick;
+    return cur_nick.c_str();
 }
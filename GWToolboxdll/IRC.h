@@ -27,8 +27,15 @@
 
 #include <stdio.h>
 #include <WinSock2.h>
+#include <array>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
 #include <thread>
 
+#include <Utils/StringMap.h>
+
 #define __CPIRC_VERSION__   0.1
 #define __IRC_DEBUG__ 0
 
@@ -36,26 +43,92 @@
 #define IRC_USER_HALFOP 2
 #define IRC_USER_OP     4
 
-struct irc_reply_data {
-    char* nick;
-    char* ident;
-    char* host;
-    char* target;
-};
+/*
+One parsed IRC line, IRCv3 message tags included:
 
-struct irc_command_hook {
-    char* irc_command;
-    int (*function)(const char*, irc_reply_data*, void*);
-    irc_command_hook* next;
+    @badge-info=;color=#FF0000;display-name=Foo :foo!foo@foo.tmi.twitch.tv PRIVMSG #bar :hello world
+
+Every field is a view into the line that was parsed, so nothing is copied or allocated; a message is only valid for
+as long as its line is (i.e. during the hook it was passed to). The trailing parameter (the one after " :") is just
+the last param, without its colon.
+*/
+struct irc_message {
+    static constexpr size_t max_params = 15;
+
+    std::string_view tags; // Raw tags, without the leading '@'; see tag()
+    std::string_view prefix;
+    std::string_view nick; // Parts of the prefix; nick is the whole prefix for server messages
+    std::string_view ident;
+    std::string_view host;
+    std::string_view command;
+    std::array<std::string_view, max_params> params{};
+    size_t param_count = 0;
+
+    // False if the line has no command
+    bool parse(std::string_view line);
+
+    [[nodiscard]] std::string_view param(const size_t index) const { return index < param_count ? params[index] : std::string_view{}; }
+    // Escaped value of a tag, or empty if the message doesn't have it; see irc_unescape_tag_value
+    [[nodiscard]] std::string_view tag(std::string_view key) const;
 };
 
-struct channel_user {
-    char* nick;
-    char* channel;
-    char flags;
-    channel_user* next;
+std::string irc_unescape_tag_value(std::string_view value);
+
+/*
+Splits the byte stream from the socket into lines. recv() writes straight into write_space(); complete lines are
+handed out as views into the buffer, and only an incomplete tail is ever moved (to the front, to make room).
+Lines longer than the buffer are dropped.
+*/
+class irc_line_framer {
+public:
+    static constexpr size_t capacity = 16 * 1024; // IRCv3 lines can be up to 8191 bytes of tags + 512
+
+    std::span<char> write_space();
+    void commit(size_t bytes);
+    // Calls fn(line) for every complete line received, without its line ending
+    template <typename Fn>
+    void for_each_line(Fn&& fn);
+    void clear() { begin = end = scanned = 0; discarding = false; }
+
+private:
+    std::array<char, capacity> buffer{};
+    size_t begin = 0;   // Start of the first incomplete line
+    size_t end = 0;     // End of received data
+    size_t scanned = 0; // Bytes from begin already known not to hold a newline
+    bool discarding = false; // Dropping the rest of a line that didn't fit
 };
 
+template <typename Fn>
+void irc_line_framer::for_each_line(Fn&& fn)
+{
+    while (true) {
+        const auto newline = static_cast<const char*>(memchr(buffer.data() + begin + scanned, '\n', end - begin - scanned));
+        if (!newline) {
+            scanned = end - begin;
+            break;
+        }
+        const auto line_end = static_cast<size_t>(newline - buffer.data());
+        std::string_view line(buffer.data() + begin, line_end - begin);
+        begin = line_end + 1;
+        scanned = 0;
+        if (discarding) {
+            discarding = false;
+            continue;
+        }
+        if (line.ends_with('\r')) {
+            line.remove_suffix(1);
+        }
+        if (!line.empty()) {
+            fn(line);
+        }
+    }
+    if (begin == end) {
+        begin = end = 0;
+    }
+}
+
+using irc_command_fn = int (*)(const irc_message&, void*);
+
 class IRC {
 public:
     IRC();
@@ -78,26 +151,25 @@ public:
     int raw(const wchar_t* fmt, ...) const;
     int join(const char* channel) const { return raw("JOIN %s\r\n", channel); }
     int kick(const char* channel, const char* nick) const { return raw("KICK %s %s\r\n", channel, nick); }
-    void hook_irc_command(const char* cmd_name, int (*function_ptr)(const char*, irc_reply_data*, void*));
+    // function is called with the message and this IRC object; only the first function hooked to a command is called
+    void hook_irc_command(const char* cmd_name, irc_command_fn function_ptr);
     int message_loop();
     int message_fetch();
     int ping();
-    int is_op(const char* channel, const char* nick) const;
-    int is_voice(const char* channel, const char* nick) const;
-    char* current_nick() const;
+    int is_op(std::string_view channel, std::string_view nick) const;
+    int is_voice(std::string_view channel, std::string_view nick) const;
+    const char* current_nick() const;
     bool is_connected() const;
 
 private:
     static void error(int err);
-    void call_hook(const char* irc_command, const char* params, irc_reply_data* hostd);
-    /*void call_the_hook(irc_command_hook* hook, char* irc_command, char*params, irc_host_data* hostd);*/
-    void parse_irc_reply(const char* data);
-    void split_to_replies(const char* data);
-    static void insert_irc_command_hook(irc_command_hook* hook, const char* cmd_name, int (*function_ptr)(const char*, irc_reply_data*, void*));
-    static void delete_irc_command_hook(const irc_command_hook* cmd_hook);
+    void call_hook(const irc_message& message);
+    void parse_irc_reply(std::string_view line);
+    void update_channel_users(const irc_message& message);
+    [[nodiscard]] char user_flags(std::string_view channel, std::string_view nick) const;
     // int irc_socket; // This fails when using winsock2.h in Windows. Define as SOCKET to fix?
     SOCKET irc_socket{};
-    char message_buffer[1024] = {0};
+    irc_line_framer framer;
     bool connected;
     bool pending_disconnect;
     bool sentnick;
@@ -106,10 +178,10 @@ private:
     WSADATA wsaData = {0};
     clock_t ping_sent = 0;
     clock_t pong_recieved = 0;
-    char* cur_nick;
+    std::string cur_nick;
     FILE* dataout{};
     FILE* datain{};
-    channel_user* chan_users;
-    irc_command_hook* hooks;
+    StringMap<StringMap<char>> chan_users; // channel -> nick -> IRC_USER_* flags
+    StringMap<irc_command_fn> hooks;
     std::thread t;
 };
@@ -1,5 +1,8 @@
 #include "stdafx.h"
 
+#include <atomic>
+#include <condition_variable>
+
 #include <GWCA/Utilities/Debug.h>
 #include <GWCA/Managers/ChatMgr.h>
 #include <GWCA/Managers/GameThreadMgr.h>
@@ -78,12 +81,184 @@ namespace {
         const std::string buf = TextUtils::VStrPrintf(format, argv);
         if (!buf.empty()) _chatlog(log_type, TextUtils::StringToWString(buf).c_str());
     }
-    void PrintTimestamp()
+    // === Log file writer ===
+    // Callers only format their line into a thread-local buffer and append it to pending_lines;
+    // the writer thread timestamps the lines and does the file I/O (and rotation) off the game thread.
+    constexpr size_t max_pending_bytes = 4 * 1024 * 1024; // Past this, the logging thread drains the queue itself
+    constexpr size_t max_logfile_bytes = 16 * 1024 * 1024; // Past this, log.txt is moved to log.1.txt and started again
+
+    struct PendingLine {
+        std::chrono::system_clock::time_point time;
+        uint32_t size; // Bytes of text following this header, including the null terminator
+        bool wide;
+    };
+
+    std::atomic<bool> logging = false;
+    std::mutex pending_mutex;
+    std::condition_variable pending_cv;
+    std::vector<char> pending_lines; // PendingLine headers, each followed by its text
+    bool writer_stopping = false;
+    std::thread writer_thread;
+
+    // Guards logfile and the write order; timed so a crash can't hang on a writer that faulted mid-write
+    std::timed_mutex write_mutex;
+    std::vector<char> writing_lines;
+    size_t logfile_bytes = 0;
+
+    void RotateLogFile()
+    {
+#ifndef _DEBUG
+        const auto path = Resources::GetPath(L"log.txt");
+        // stdout has to let go of log.txt before it can be moved
+        fflush(logfile);
+        logfile_bytes = 0;
+        // A failed freopen closes stdout anyway, so logfile can't be written to until a reopen succeeds
+        if (!_wfreopen(L"NUL", L"w", stdout)) {
+            logfile = _wfreopen(path.c_str(), L"a", stdout);
+            return;
+        }
+        const bool moved = MoveFileExW(path.c_str(), Resources::GetPath(L"log.1.txt").c_str(), MOVEFILE_REPLACE_EXISTING);
+        // Carry on at the end of log.txt if it couldn't be moved, rather than losing what's in it
+        logfile = _wfreopen(path.c_str(), moved ? L"w" : L"a", stdout);
+#endif
+    }
+
+    // Caller holds write_mutex
+    void WriteLines(const std::vector<char>& lines)
+    {
+        if (!logfile) {
+            return;
+        }
+        for (size_t offset = 0; offset < lines.size();) {
+            PendingLine line;
+            memcpy(&line, lines.data() + offset, sizeof(line));
+            const char* text = lines.data() + offset + sizeof(line);
+            offset += sizeof(line) + line.size;
+
+            const auto now = std::chrono::floor<std::chrono::milliseconds>(line.time);
+            const auto ms = now.time_since_epoch().count() % 1000;
+            int written = fprintf(logfile, "[%s] ", TextUtils::TimeToString(std::chrono::system_clock::to_time_t(now), true, static_cast<int>(ms)).c_str());
+            bool ends_with_newline;
+            if (line.wide) {
+                const auto wtext = reinterpret_cast<const wchar_t*>(text);
+                const auto length = line.size / sizeof(wchar_t) - 1;
+                written += fwprintf(logfile, L"%s", wtext);
+                ends_with_newline = length && wtext[length - 1] == L'\n';
+            }
+            else {
+                const auto length = line.size - 1;
+                written += fprintf(logfile, "%s", text);
+                ends_with_newline = length && text[length - 1] == '\n';
+            }
+            if (!ends_with_newline) {
+                written += fprintf(logfile, "\n");
+            }
+            logfile_bytes += static_cast<size_t>(std::max(written, 0));
+        }
+        if (logfile_bytes > max_logfile_bytes) {
+            RotateLogFile();
+        }
+    }
+
+    // Caller holds write_mutex; taking it before pending_mutex keeps batches in order
+    void DrainPendingLines()
+    {
+        {
+            std::lock_guard lock(pending_mutex);
+            std::swap(pending_lines, writing_lines);
+        }
+        WriteLines(writing_lines);
+        writing_lines.clear();
+    }
+
+    void WriterThread()
+    {
+        while (true) {
+            {
+                std::unique_lock lock(pending_mutex);
+                pending_cv.wait(lock, [] { return writer_stopping || !pending_lines.empty(); });
+                if (writer_stopping && pending_lines.empty()) {
+                    return;
+                }
+            }
+            std::lock_guard lock(write_mutex);
+            DrainPendingLines();
+            if (logfile) {
+                fflush(logfile);
+            }
+        }
+    }
+
+    void EnqueueLine(const void* text, const size_t size, const bool wide)
+    {
+        const PendingLine line = {std::chrono::system_clock::now(), static_cast<uint32_t>(size), wide};
+        bool queue_full;
+        {
+            std::lock_guard lock(pending_mutex);
+            const auto offset = pending_lines.size();
+            pending_lines.resize(offset + sizeof(line) + size);
+            memcpy(pending_lines.data() + offset, &line, sizeof(line));
+            memcpy(pending_lines.data() + offset + sizeof(line), text, size);
+            queue_full = pending_lines.size() > max_pending_bytes;
+        }
+        if (queue_full) {
+            // The writer can't keep up; write on this thread rather than grow without bound
+            std::lock_guard lock(write_mutex);
+            DrainPendingLines();
+            return;
+        }
+        pending_cv.notify_one();
+    }
+
+    void VLogLine(const char* format, const va_list argv)
+    {
+        thread_local std::vector<char> buffer;
+        va_list argv2;
+        va_copy(argv2, argv);
+        const int len = _vscprintf(format, argv2);
+        va_end(argv2);
+        if (len < 0) {
+            return;
+        }
+        buffer.resize(len + 1);
+        vsnprintf(buffer.data(), buffer.size(), format, argv);
+        EnqueueLine(buffer.data(), buffer.size(), false);
+    }
+
+    void VLogLineW(const wchar_t* format, const va_list argv)
+    {
+        thread_local std::vector<wchar_t> buffer;
+        va_list argv2;
+        va_copy(argv2, argv);
+        const int len = _vscwprintf(format, argv2);
+        va_end(argv2);
+        if (len < 0) {
+            return;
+        }
+        buffer.resize(len + 1);
+        vswprintf(buffer.data(), buffer.size(), format, argv);
+        EnqueueLine(buffer.data(), buffer.size() * sizeof(wchar_t), true);
+    }
+
+    void StartWriter()
     {
-        if (!logfile) return;
-        const auto now = std::chrono::floor<std::chrono::milliseconds>(std::chrono::system_clock::now());
-        const auto ms = now.time_since_epoch().count() % 1000;
-        fprintf(logfile, "[%s] ", TextUtils::TimeToString(std::chrono::system_clock::to_time_t(now), true, static_cast<int>(ms)).c_str());
+        writer_stopping = false;
+        writer_thread = std::thread(WriterThread);
+        logging = true;
+    }
+
+    void StopWriter()
+    {
+        logging = false;
+        if (!writer_thread.joinable()) {
+            return;
+        }
+        {
+            std::lock_guard lock(pending_mutex);
+            writer_stopping = true;
+        }
+        pending_cv.notify_one();
+        writer_thread.join();
     }
 
 
@@ -93,7 +268,9 @@ namespace {
     void OnLogWithArguments(uint32_t severity, const wchar_t* format, va_list argList)
     {
         GW::Hook::EnterHook();
-        vfwprintf(logfile, format, argList);
+        if (logging) {
+            VLogLineW(format, argList);
+        }
         LogWithArguments_Ret(severity, format, argList);
         GW::Hook::LeaveHook();
     }
@@ -111,12 +288,20 @@ namespace {
 
 static void GWCALogHandler(
     [[maybe_unused]] void* context,
-    [[maybe_unused]] const GW::LogLevel level,
+    const GW::LogLevel level,
     const char* msg,
     [[maybe_unused]] const char* file,
     [[maybe_unused]] const unsigned int line,
     [[maybe_unused]] const char* function)
 {
+#ifdef _DEBUG
+    constexpr auto min_level = GW::LEVEL_TRACE;
+#else
+    constexpr auto min_level = GW::LEVEL_INFO;
+#endif
+    if (level < min_level) {
+        return;
+    }
     Log::Log("[GWCA] %s", msg);
 }
 
@@ -162,6 +347,7 @@ bool Log::InitializeLog()
         return false;
     }
 #endif
+    StartWriter();
 
     return true;
 }
@@ -184,6 +370,9 @@ void Log::Terminate()
 {
     GW::RegisterLogHandler(nullptr, nullptr);
     GW::RegisterPanicHandler(nullptr, nullptr);
+    StopWriter();
+    std::lock_guard lock(write_mutex);
+    DrainPendingLines();
 
 #ifdef _DEBUG
     if (stdout_file) {
@@ -208,38 +397,33 @@ void Log::Terminate()
 
 void Log::Log(const char* msg, ...)
 {
-    if (!logfile) {
+    if (!logging) {
         return;
     }
-    PrintTimestamp();
-
     va_list args;
     va_start(args, msg);
-    vfprintf(logfile, msg, args);
+    VLogLine(msg, args);
     va_end(args);
-    if (msg[strlen(msg) - 1] != '\n') {
-        fprintf(logfile, "\n");
-    }
 }
 
 void Log::LogW(const wchar_t* msg, ...)
 {
-    if (!logfile) {
+    if (!logging) {
         return;
     }
-    PrintTimestamp();
-
     va_list args;
     va_start(args, msg);
-    vfwprintf(logfile, msg, args);
+    VLogLineW(msg, args);
     va_end(args);
-    if (msg[wcslen(msg) - 1] != '\n') {
-        fprintf(logfile, "\n");
-    }
 }
 
 void Log::FlushFile()
 {
+    std::unique_lock lock(write_mutex, std::chrono::seconds(1));
+    if (!lock) {
+        return;
+    }
+    DrainPendingLines();
     if (logfile) {
         fflush(logfile);
     }
@@ -55,6 +55,7 @@
 #include <Modules/DialogModule.h>
 #include <Modules/Resources.h>
 #include <Utils/TextUtils.h>
+#include <Utils/TernaryTrie.h>
 
 #include "QuestModule.h"
 #include <Utils/ToolboxUtils.h>
@@ -235,6 +236,25 @@ namespace {
     {
         return wcscmp(str, L"nearest") == 0 || wcscmp(str, L"closest") == 0;
     }
+
+    // Parses an [on|off|toggle] argument (or 1/0) against the current value. False if arg isn't one of those.
+    bool ParseToggleArg(const wchar_t* arg, const bool current, bool* out)
+    {
+        enum class ToggleArg { On, Off, Toggle };
+        static const TernaryTrie<ToggleArg> toggle_args = {
+            {L"on", ToggleArg::On},
+            {L"1", ToggleArg::On},
+            {L"off", ToggleArg::Off},
+            {L"0", ToggleArg::Off},
+            {L"toggle", ToggleArg::Toggle},
+        };
+        const auto found = toggle_args.Find(arg);
+        if (!found) {
+            return false;
+        }
+        *out = *found == ToggleArg::Toggle ? !current : *found == ToggleArg::On;
+        return true;
+    }
  
 
     typedef std::unordered_map<uint32_t, std::wstring> FlaggableHeroNames;
@@ -353,29 +373,19 @@ namespace {
         if (argc < 2) {
             return Log::Error(chat_tab_syntax);
         }
-        uint32_t channel = 0xff;
-        if (wcscmp(argv[1], L"all") == 0) {
-            channel = 0;
-        }
-        else if (wcscmp(argv[1], L"guild") == 0) {
-            channel = 2;
-        }
-        else if (wcscmp(argv[1], L"team") == 0) {
-            channel = 3;
-        }
-        else if (wcscmp(argv[1], L"trade") == 0) {
-            channel = 4;
-        }
-        else if (wcscmp(argv[1], L"alliance") == 0) {
-            channel = 1;
-        }
-        else if (wcscmp(argv[1], L"whisper") == 0) {
-            channel = 5;
-        }
-        else {
+        static const TernaryTrie<uint32_t> chat_tabs = {
+            {L"all", 0},
+            {L"alliance", 1},
+            {L"guild", 2},
+            {L"team", 3},
+            {L"trade", 4},
+            {L"whisper", 5},
+        };
+        const auto found = chat_tabs.Find(argv[1]);
+        if (!found) {
             return Log::Error(chat_tab_syntax);
         }
-        channel |= 0x8000;
+        const uint32_t channel = *found | 0x8000;
         GW::GameThread::Enqueue([channel] {
             // See OnChatUI_Callback for intercept
             SendUIMessage(GW::UI::UIMessage::kAppendMessageToChat, (void*)L"", (void*)channel);
@@ -574,8 +584,9 @@ namespace {
 
         if (argc > 2) {
             // Setting value
-            if (wcscmp(argv[2], L"toggle") == 0) {
-                SetPreference(pref, !GetPreference(pref));
+            bool enabled;
+            if (ParseToggleArg(argv[2], GetPreference(pref) != 0, &enabled)) {
+                SetPreference(pref, enabled ? 1 : 0);
                 return;
             }
             uint32_t value = 0xff;
@@ -594,8 +605,9 @@ namespace {
 
         if (argc > 2) {
             // Setting value
-            if (wcscmp(argv[2], L"toggle") == 0) {
-                GW::UI::SetUIFeature(pref, !GW::UI::GetUIFeature(pref));
+            bool enabled;
+            if (ParseToggleArg(argv[2], GW::UI::GetUIFeature(pref) != 0, &enabled)) {
+                GW::UI::SetUIFeature(pref, enabled ? 1 : 0);
                 return;
             }
             uint32_t value = 0xff;
@@ -754,6 +766,20 @@ namespace {
     };
 
     std::vector<CmdAlias*> cmd_aliases;
+    // Aliases by name, in cmd_aliases order. Rebuilt by RebuildAliasIndex() whenever cmd_aliases changes.
+    TernaryTrie<std::vector<CmdAlias*>> alias_index;
+    // Names of the commands registered in Initialize()
+    TernaryTrie<GW::Chat::ChatCommandCallback> command_index;
+
+    void RebuildAliasIndex()
+    {
+        alias_index.clear();
+        for (const auto alias : cmd_aliases) {
+            if (*alias->alias_wstr) {
+                alias_index[alias->alias_wstr].push_back(alias);
+            }
+        }
+    }
 
     void sort_cmd_aliases()
     {
@@ -766,6 +792,7 @@ namespace {
             }
             return strcmp(a->alias_cstr, b->alias_cstr) < 0;
         });
+        RebuildAliasIndex();
     }
 
     GW::HookEntry OnSentChat_HookEntry;
@@ -781,9 +808,14 @@ namespace {
         if (channel != GW::Chat::CHANNEL_COMMAND || status->blocked) {
             return;
         }
-        for (const auto alias : cmd_aliases) {
-            const auto sent_alias = TextUtils::ToLower(&message[1]);
-            if (wcscmp(alias->alias_wstr, sent_alias.c_str()) == 0 && !alias->processing && wcslen(alias->command_wstr) > 1) {
+        const auto sent_alias = TextUtils::ToLower(&message[1]);
+        const auto matching_aliases = alias_index.Find(sent_alias);
+        if (!matching_aliases) {
+            return;
+        }
+        // Copied; an alias can run commands that edit the alias list
+        for (const auto alias : std::vector(*matching_aliases)) {
+            if (!alias->processing && wcslen(alias->command_wstr) > 1) {
                 status->blocked = true;
                 alias->processing = true;
                 std::wstring tmp;
@@ -1228,11 +1260,9 @@ const GW::AgentTargetFlags AnyLivingNpc = GW::TargetFilter::AnyLiving & ~GW::Age
                     if (argc < 2)
                         return Log::WarningW(L"Invalid syntax for %s\n%s", setting_name, ChatCommandSyntax().c_str());
                     auto current_val = (bool*)setting_ptr;
-                    bool new_val = !*current_val;
-                    if (wcscmp(argv[1], L"on") == 0 || wcscmp(argv[1], L"1") == 0)
-                        new_val = true;
-                    if (wcscmp(argv[1], L"off") == 0 || wcscmp(argv[1], L"0") == 0)
-                        new_val = false;
+                    bool new_val;
+                    if (!ParseToggleArg(argv[1], *current_val, &new_val))
+                        new_val = !*current_val;
                     if (*current_val == new_val)
                         return;
                     *current_val = new_val;
@@ -1255,12 +1285,29 @@ const GW::AgentTargetFlags AnyLivingNpc = GW::TargetFilter::AnyLiving & ~GW::Age
 
     void CHAT_CMD_FUNC(CmdSettingViaChatCommand)
     {
-        const auto found = argc > 1 ? settings_via_chat_commands.find(argv[1]) : settings_via_chat_commands.end();
-
-        if (found == settings_via_chat_commands.end()) {
+        if (argc < 2) {
             Log::WarningW(L"Failed to find setting");
             return;
         }
+        auto found = settings_via_chat_commands.find(argv[1]);
+        if (found == settings_via_chat_commands.end()) {
+            // Accept an unambiguous prefix of a setting name
+            const std::wstring_view prefix = argv[1];
+            std::vector<const std::wstring*> candidates;
+            for (auto it = settings_via_chat_commands.lower_bound(argv[1]); it != settings_via_chat_commands.end() && it->first.starts_with(prefix); ++it) {
+                candidates.push_back(&it->first);
+            }
+            if (candidates.size() != 1) {
+                std::wstring names;
+                for (const auto name : candidates) {
+                    names += names.empty() ? L"" : L", ";
+                    names += *name;
+                }
+                Log::WarningW(candidates.empty() ? L"Failed to find setting" : L"Ambiguous setting name; did you mean %s?", names.c_str());
+                return;
+            }
+            found = settings_via_chat_commands.find(*candidates[0]);
+        }
         found->second->ChatCommandCallback(status, message, argc, argv);
     }
 
@@ -1632,6 +1679,7 @@ void ChatCommands::CreateAlias(const wchar_t* alias, const wchar_t* message)
         strcpy(alias_obj->alias_cstr, alias_cstr.c_str());
         wcscpy(alias_obj->alias_wstr, alias);
         cmd_aliases.push_back(alias_obj);
+        alias_index[alias_obj->alias_wstr].push_back(alias_obj);
     }
 
     const auto message_cstr = TextUtils::WStringToString(message);
@@ -1653,6 +1701,23 @@ void ChatCommands::RemoveSettingChatCommand(const wchar_t* setting_name)
     }
 }
 
+std::vector<std::wstring> ChatCommands::GetCommandCompletions(const std::wstring_view prefix)
+{
+    std::vector<std::wstring> out;
+    const auto add = [&out](const std::wstring& name, const auto&) {
+        out.push_back(name);
+        return true;
+    };
+    command_index.ForEachWithPrefix(prefix, add);
+    const auto commands_end = static_cast<std::ptrdiff_t>(out.size());
+    alias_index.ForEachWithPrefix(prefix, add);
+    // Both runs are sorted; an alias can share its name with a command
+    std::ranges::inplace_merge(out, out.begin() + commands_end);
+    const auto [first, last] = std::ranges::unique(out);
+    out.erase(first, last);
+    return out;
+}
+
 void ChatCommands::DrawHelp()
 {
     DrawChatCommandsHelp();
@@ -1708,6 +1773,7 @@ void ChatCommands::DrawSettingsInternal()
         if (found != cmd_aliases.end()) {
             cmd_aliases.erase(found);
             delete alias;
+            RebuildAliasIndex();
         }
     };
 
@@ -1719,6 +1785,7 @@ void ChatCommands::DrawSettingsInternal()
         ImGui::PushItemWidth(avail_w * .3f);
         if (ImGui::InputText("###cmd_alias", alias->alias_cstr, _countof(CmdAlias::alias_cstr))) {
             swprintf(alias->alias_wstr, _countof(CmdAlias::alias_wstr), L"%S", alias->alias_cstr);
+            RebuildAliasIndex();
         }
         if (ImGui::IsItemHovered()) {
             ImGui::SetTooltip("Alias for this command");
@@ -1759,6 +1826,7 @@ void ChatCommands::LoadSettings(ToolboxIni* ini)
         delete it;
     }
     cmd_aliases.clear();
+    alias_index.clear();
     const auto section_name = "Chat Command Aliases";
 
     TNamesDepend entries;
@@ -1912,6 +1980,7 @@ void ChatCommands::Initialize()
 
     for (auto& it : chat_commands) {
         GW::Chat::CreateCommand(&ChatCmd_HookEntry, it.first, it.second);
+        command_index[it.first] = it.second;
     }
     getPrefCommandOptions();
 }
@@ -1924,6 +1993,7 @@ void ChatCommands::Terminate()
     settings_via_chat_commands.clear();
     GW::Chat::DeleteCommand(&ChatCmd_HookEntry);
     chat_commands.clear();
+    command_index.clear();
     if (FocusChatTab_Func) {
         GW::Hook::RemoveHook(FocusChatTab_Func);
     }
@@ -2407,25 +2477,18 @@ void CHAT_CMD_FUNC(ChatCommands::CmdTB)
 
 GW::UI::WindowID CHAT_CMD_FUNC(ChatCommands::MatchingGWWindow)
 {
-    const std::map<GW::UI::WindowID, const wchar_t*> gw_windows = {
-        {GW::UI::WindowID_Compass, L"compass"},
-        {GW::UI::WindowID_HealthBar, L"healthbar"},
-        {GW::UI::WindowID_EnergyBar, L"energybar"},
-        {GW::UI::WindowID_ExperienceBar, L"experiencebar"},
-        {GW::UI::WindowID_Chat, L"chat"}
+    static const TernaryTrie<GW::UI::WindowID> gw_windows = {
+        {L"compass", GW::UI::WindowID_Compass},
+        {L"healthbar", GW::UI::WindowID_HealthBar},
+        {L"energybar", GW::UI::WindowID_EnergyBar},
+        {L"experiencebar", GW::UI::WindowID_ExperienceBar},
+        {L"chat", GW::UI::WindowID_Chat}
     };
     if (argc < 2) {
         return GW::UI::WindowID_Count;
     }
-    const std::wstring arg = TextUtils::ToLower(argv[1]);
-    if (!arg.empty() && arg != L"all") {
-        for (const auto& [window_id, window_name] : gw_windows) {
-            if (wcscmp(window_name, arg.c_str()) == 0) {
-                return window_id;
-            }
-        }
-    }
-    return GW::UI::WindowID_Count;
+    const auto found = gw_windows.Find(TextUtils::ToLower(argv[1]));
+    return found ? *found : GW::UI::WindowID_Count;
 }
 
 std::vector<ToolboxUIElement*> CHAT_CMD_FUNC(ChatCommands::MatchingWindows)
@@ -2809,28 +2872,19 @@ void CHAT_CMD_FUNC(ChatCommands::CmdVolume)
             value = argv[1];
             break;
         case 3: {
-            const wchar_t* pref_str = argv[1];
-            if (wcscmp(pref_str, L"master") == 0) {
-                pref = GW::UI::NumberPreference::VolMaster;
-            }
-            else if (wcscmp(pref_str, L"music") == 0) {
-                pref = GW::UI::NumberPreference::VolMusic;
-            }
-            else if (wcscmp(pref_str, L"background") == 0) {
-                pref = GW::UI::NumberPreference::VolBackground;
-            }
-            else if (wcscmp(pref_str, L"effects") == 0) {
-                pref = GW::UI::NumberPreference::VolEffect;
-            }
-            else if (wcscmp(pref_str, L"dialog") == 0) {
-                pref = GW::UI::NumberPreference::VolDialog;
-            }
-            else if (wcscmp(pref_str, L"ui") == 0) {
-                pref = GW::UI::NumberPreference::VolUi;
-            }
-            else {
+            static const TernaryTrie<GW::UI::NumberPreference> volume_prefs = {
+                {L"master", GW::UI::NumberPreference::VolMaster},
+                {L"music", GW::UI::NumberPreference::VolMusic},
+                {L"background", GW::UI::NumberPreference::VolBackground},
+                {L"effects", GW::UI::NumberPreference::VolEffect},
+                {L"dialog", GW::UI::NumberPreference::VolDialog},
+                {L"ui", GW::UI::NumberPreference::VolUi},
+            };
+            const auto found = volume_prefs.Find(argv[1]);
+            if (!found) {
                 return Log::Error(syntax);
             }
+            pref = *found;
             value = argv[2];
             break;
         }
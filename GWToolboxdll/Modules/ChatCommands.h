@@ -36,6 +36,9 @@ public:
 
     static void CreateAlias(const wchar_t* from, const wchar_t* to);
 
+    // Toolbox chat commands and aliases whose name starts with prefix (no leading '/'), sorted. Used for Tab completion.
+    static std::vector<std::wstring> GetCommandCompletions(std::wstring_view prefix);
+
     // Update. Will always be called every frame.
     void Update(float delta) override;
 
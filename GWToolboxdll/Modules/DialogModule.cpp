@@ -11,6 +11,7 @@
 #include <GWCA/Utilities/Scanner.h>
 #include <GWCA/Utilities/Hooker.h>
 
+#include <Utils/EncStr.h>
 #include <Utils/GuiUtils.h>
 #include <Modules/DialogModule.h>
 #include <Logger.h>
@@ -409,8 +410,8 @@ uint32_t DialogModule::AcceptFirstAvailableBounty() {
     
     // NB: Be careful - GW allows you to grab factions blessings more than once!
 
-    const wchar_t* luxon_priest = L"\x3F69\xBAA2\xF307\x2CC1";
-    const wchar_t* kurzick_priest = L"\x3E98\xDA05\xAA38\x45D";
+    static const EncStr::Pattern luxon_priest(L"\x3F69\xBAA2\xF307\x2CC1");
+    static const EncStr::Pattern kurzick_priest(L"\x3E98\xDA05\xAA38\x45D");
 
     const auto agent_name = GW::Agents::GetAgentEncName(GW::Agents::GetAgentByID(GetDialogAgent()));
     if (!agent_name)
@@ -421,13 +422,13 @@ uint32_t DialogModule::AcceptFirstAvailableBounty() {
     };
 
     // NB: Be careful - GW allows you to grab factions blessings more than once!
-    if (wcscmp(agent_name, luxon_priest) == 0) {
+    if (luxon_priest.Match(agent_name)) {
         if (has_bounty(GW::Constants::SkillID::Blessing_of_the_Luxons))
             return 0;
         SendDialogs({ 0x85, 0x86, 0x2, 0x84 });
         return 1;
     }
-    if (wcscmp(agent_name, kurzick_priest) == 0) {
+    if (kurzick_priest.Match(agent_name)) {
         if (has_bounty(GW::Constants::SkillID::Blessing_of_the_Kurzicks))
             return 0;
         // Interested > Thanks || Lets talk this over > Bribe > Thanks
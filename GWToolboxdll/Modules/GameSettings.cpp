@@ -44,6 +44,7 @@
 
 #include <GWCA/Utilities/Hooker.h>
 
+#include <Utils/EncStr.h>
 #include <Utils/GuiUtils.h>
 #include <Utils/ToolboxUtils.h>
 
@@ -1140,6 +1141,12 @@ namespace {
 
     bool mission_prompted = false;
 
+    bool IsWeAreReadyButton(const GW::UI::DialogButtonInfo* btn)
+    {
+        static const EncStr::Pattern we_are_ready(GW::EncStrings::WeAreReady);
+        return btn->message && we_are_ready.Match(btn->message);
+    }
+
     // We've just asked the game to enter mission; check (and prompt) if we should really be in NM or HM instead
     void CheckPromptBeforeEnterMission(GW::HookStatus* status)
     {
@@ -1155,9 +1162,7 @@ namespace {
             mission_prompted = true;
             result && GW::PartyMgr::SetHardMode(!GW::PartyMgr::GetIsPartyInHardMode());
             const auto buttons = DialogModule::GetDialogButtons();
-            const auto button = std::ranges::find_if(buttons, [](GW::UI::DialogButtonInfo* btn) {
-                return btn->message && wcscmp(btn->message, GW::EncStrings::WeAreReady) == 0;
-            });
+            const auto button = std::ranges::find_if(buttons, IsWeAreReadyButton);
             GW::Map::EnterChallenge() || (button != buttons.end() && GW::Agents::SendDialog((*button)->dialog_id));
         };
         const char* confirm_text = nullptr;
@@ -1199,7 +1204,7 @@ namespace {
                 const auto dialog_id = (uint32_t)wParam;
                 const auto& buttons = DialogModule::GetDialogButtons();
                 const auto button = std::ranges::find_if(buttons, [dialog_id](GW::UI::DialogButtonInfo* btn) {
-                    return btn->dialog_id == dialog_id && btn->message && wcscmp(btn->message, GW::EncStrings::WeAreReady) == 0;
+                    return btn->dialog_id == dialog_id && IsWeAreReadyButton(btn);
                 });
                 if (button == buttons.end())
                     break;
@@ -1285,11 +1290,13 @@ namespace {
 
     void OnDialogButton(GW::UI::DialogButtonInfo* packet)
     {
-        if (auto_open_locked_chest_with_key && wcscmp(packet->message, L"\x8101\x7F88\x10A\x8101\x13BE\x1") == 0) {
+        static const EncStr::Pattern use_key_button(L"\x8101\x7F88\x10A\x8101\x13BE\x1");
+        static const EncStr::Pattern use_lockpick_button(L"\x8101\x7f88\x010a\x8101\x730e\x1");
+        if (auto_open_locked_chest_with_key && use_key_button.Match(packet->message)) {
             // Auto use key
             DialogModule::SendDialog(packet->dialog_id);
         }
-        if (auto_open_locked_chest && wcscmp(packet->message, L"\x8101\x7f88\x010a\x8101\x730e\x1") == 0) {
+        if (auto_open_locked_chest && use_lockpick_button.Match(packet->message)) {
             // Auto use lockpick
             DialogModule::SendDialog(packet->dialog_id);
         }
@@ -1381,8 +1388,9 @@ namespace {
             } break;
             break;
             case GW::UI::UIMessage::kPartyShowConfirmDialog: {
+                static const EncStr::Pattern characters_from_another_campaign(L"\x8101\x05d2");
                 const auto packet = static_cast<GW::UI::UIPacket::kPartyShowConfirmDialog*>(wParam);
-                if (skip_characters_from_another_campaign_prompt && wcscmp(packet->prompt_enc_str, L"\x8101\x05d2") == 0) {
+                if (skip_characters_from_another_campaign_prompt && packet->prompt_enc_str && characters_from_another_campaign.Match(packet->prompt_enc_str)) {
                     // "Yes" to skip the confirm prompt
                     GW::UI::ButtonClick(GW::UI::GetChildFrame(GW::UI::GetFrameByLabel(L"Party"), 1, 10, 6));
                 }
@@ -2484,8 +2492,10 @@ void GameSettings::OnPartyPlayerJoined(const GW::HookStatus*, const GW::Packet::
 // Block overhead arrow marker for zaishen scout
 void GameSettings::OnAgentMarker(GW::HookStatus*, GW::Packet::StoC::GenericValue* pak)
 {
+    static const EncStr::Pattern zaishen_scout(L"\x8102\x6ED9\xD94E\xBF68\x4409");
     const GW::Agent* a = GW::Agents::GetAgentByID(pak->agent_id);
-    if (a && wcscmp(GW::Agents::GetAgentEncName(a), L"\x8102\x6ED9\xD94E\xBF68\x4409") == 0) {
+    const auto name = a ? GW::Agents::GetAgentEncName(a) : nullptr;
+    if (name && zaishen_scout.Match(name)) {
         pak->value_id = 12;
     }
 }
@@ -2589,7 +2599,9 @@ void GameSettings::OnServerMessage(const GW::HookStatus*, GW::Packet::StoC::Mess
     const wchar_t* msg = GetMessageCore();
     // 0x8101 0x641F 0x86C3 0xE149 0x53E8 0x101 0x107 = You have been in this map for n minutes.
     // 0x8101 0x641E 0xE7AD 0xEF64 0x1676 0x101 0x107 0x102 0x107 = You have been in this map for n hours and n minutes.
-    if (wmemcmp(msg, L"\x8101\x641F\x86C3\xE149\x53E8", 5) == 0 || wmemcmp(msg, L"\x8101\x641E\xE7AD\xEF64\x1676", 5) == 0) {
+    static const EncStr::Pattern age_minutes(L"\x8101\x641F\x86C3\xE149\x53E8", EncStr::Pattern::Prefix);
+    static const EncStr::Pattern age_hours(L"\x8101\x641E\xE7AD\xEF64\x1676", EncStr::Pattern::Prefix);
+    if (age_minutes.Match(msg) || age_hours.Match(msg)) {
         GW::Chat::SendChat('/', L"age2");
     }
 }
@@ -2644,11 +2656,14 @@ void GameSettings::OnWriteChat(GW::HookStatus* status, GW::UI::UIMessage, void*
     if (msg->channel != GW::Chat::Channel::CHANNEL_GLOBAL) {
         return;
     }
-    if (wmemcmp(L"\x846\x107", msg->message, 2) != 0) {
+    // 0x846 0x107 <path> 0x1 = Screenshot saved to <path>
+    static const EncStr::Pattern screenshot_saved(L"\x846\x107\x7F\x1", EncStr::Pattern::Prefix);
+    EncStr::Pattern::Captures captures;
+    if (!screenshot_saved.Match(msg->message, &captures)) {
         return;
     }
     status->blocked = true;
-    std::wstring file_path(&msg->message[2],wcsstr(&msg->message[2],L"\x1"));
+    const std::wstring file_path(captures[0]);
     std::wstring new_message = std::format(L"\x846\x107<quote>[{};file://{}]\x1",file_path,file_path);
     is_redirecting = true;
     WriteChatEnc(static_cast<GW::Chat::Channel>(msg->channel), new_message.c_str());
@@ -106,13 +106,15 @@ namespace {
 
         uint8_t* image_bytes = asset.data.data();
         size_t image_size = asset.data.size();
+        if (image_size < 4)
+            return 0;
 
+        ArenaNetFileParser::ArenaNetFile anet_file;
         if (strncmp((char*)image_bytes, "ffna", 4) == 0) {
-            const auto anet_file = (ArenaNetFileParser::ArenaNetFile*)&asset;
-            if (!anet_file->isValid())
+            if (!anet_file.parse(asset.data))
                 return 0;
-            const auto chunk = (ArenaNetFileParser::UnknownChunk*)anet_file->FindChunk(ArenaNetFileParser::ChunkType::FA3_InlineTextureDXT3);
-            if (!chunk) 
+            const auto chunk = (ArenaNetFileParser::UnknownChunk*)anet_file.FindChunk(ArenaNetFileParser::ChunkType::FA3_InlineTextureDXT3);
+            if (!(chunk && chunk->chunk_size >= 4))
                 return 0;
             image_bytes = chunk->data;
             image_size = chunk->chunk_size;
@@ -7,6 +7,8 @@
 
 #include <Modules/InventoryManager.h>
 
+#include <Utils/EncStr.h>
+
 namespace {
     GetItemDescriptionCallback GetItemDescription_Func = nullptr, GetItemDescription_Ret = nullptr;
 
@@ -25,39 +27,18 @@ namespace {
     constexpr wchar_t PREFIX_ONLY = 0xa30;
     constexpr wchar_t SUFFIX_ONLY = 0xa33;
 
-    const wchar_t* GetSuffixModName(const GW::Item* item, size_t* out_len) {
-        if (!item->complete_name_enc)
-            return nullptr;
-        auto found = wcschr(item->complete_name_enc, SUFFIX_AND_PREFIX);
-        if (found) {
-            found = wcschr(found, 0x10c) + 1;
-            *out_len = wcschr(found, 0x1) - found;
-            return found;
-        }
-        found = wcschr(item->complete_name_enc, SUFFIX_ONLY);
-        if (found) {
-            found = wcschr(found, 0x10b) + 1;
-            *out_len = wcschr(found, 0x1) - found;
-            return found;
-        }
-        return nullptr;
-    }
-    const wchar_t* GetPrefixModName(const GW::Item* item, size_t* out_len) {
-        if (!item->complete_name_enc)
-            return nullptr;
-        auto found = wcschr(item->complete_name_enc, SUFFIX_AND_PREFIX);
-        if (found) {
-            found = wcschr(found, 0x10b) + 1;
-            *out_len = wcschr(found, 0x1) - found;
-            return found;
+    // Mod names are nested string arguments of the name template in the item's complete name:
+    // SUFFIX_AND_PREFIX <name> <prefix> <suffix>, PREFIX_ONLY <name> <prefix>, SUFFIX_ONLY <name> <suffix>
+    std::wstring_view GetModName(const EncStr::String& complete_name, const bool prefix)
+    {
+        const EncStr::Arg* found = nullptr;
+        if (const auto segment = EncStr::FindSegment(complete_name, {&SUFFIX_AND_PREFIX, 1})) {
+            found = segment->FindArg(prefix ? EncStr::StringArg2 : EncStr::StringArg3);
         }
-        found = wcschr(item->complete_name_enc, PREFIX_ONLY);
-        if (found) {
-            found = wcschr(found, 0x10b) + 1;
-            *out_len = wcschr(found, 0x1) - found;
-            return found;
+        else if (const auto segment_one_mod = EncStr::FindSegment(complete_name, {prefix ? &PREFIX_ONLY : &SUFFIX_ONLY, 1})) {
+            found = segment_one_mod->FindArg(EncStr::StringArg2);
         }
-        return nullptr;
+        return found ? found->text : std::wstring_view{};
     }
 }
 std::wstring ItemDescriptionHandler::GetItemDescription(const GW::Item* _item) {
@@ -70,38 +51,33 @@ std::wstring ItemDescriptionHandler::GetItemEncNameWithoutMods(const GW::Item* _
 
     auto item = (InventoryManager::Item*)_item;
 
-    size_t prefix_name_len = 0;
-    const wchar_t* prefix_mod_name = nullptr;
-    size_t suffix_name_len = 0;
-    const wchar_t* suffix_mod_name = nullptr;
+    const auto complete_name = item->complete_name_enc ? EncStr::Parse(item->complete_name_enc) : std::nullopt;
+    std::wstring_view prefix_mod_name;
+    std::wstring_view suffix_mod_name;
 
-    if (!item->IsPrefixUpgradable()) {
+    if (complete_name && !item->IsPrefixUpgradable()) {
         // Weapon prefix can't be modified; this is part of the item name
-        prefix_mod_name = GetPrefixModName(item, &prefix_name_len);
+        prefix_mod_name = GetModName(*complete_name, true);
     }
-    if (!item->IsSuffixUpgradable()) {
+    if (complete_name && !item->IsSuffixUpgradable()) {
         // Weapon suffix can't be modified; this is part of the item name
-        suffix_mod_name = GetSuffixModName(item, &suffix_name_len);
+        suffix_mod_name = GetModName(*complete_name, false);
     }
-
-    std::wstring out;
-    if (prefix_mod_name && suffix_mod_name) {
-        out = std::format(L"{}\x10a{}\x1\x10b{}\x1\x10c{}\x1", SUFFIX_AND_PREFIX, item->name_enc, 
-            std::wstring(prefix_mod_name, prefix_name_len), 
-            std::wstring(suffix_mod_name, suffix_name_len));
+    if (prefix_mod_name.empty() && suffix_mod_name.empty()) {
+        return item->name_enc;
     }
-    else if (prefix_mod_name) {
-        out = std::format(L"{}\x10a{}\x1\x10b{}\x1", PREFIX_ONLY, item->name_enc,
-            std::wstring(prefix_mod_name, prefix_name_len));
+
+    EncStr::Builder out;
+    if (!prefix_mod_name.empty() && !suffix_mod_name.empty()) {
+        out.Encoded({&SUFFIX_AND_PREFIX, 1}).Nested(EncStr::StringArg1, item->name_enc).Nested(EncStr::StringArg2, prefix_mod_name).Nested(EncStr::StringArg3, suffix_mod_name);
     }
-    else if (suffix_mod_name) {
-        out = std::format(L"{}\x10a{}\x1\x10b{}\x1", SUFFIX_ONLY, item->name_enc,
-            std::wstring(suffix_mod_name, suffix_name_len));
+    else if (!prefix_mod_name.empty()) {
+        out.Encoded({&PREFIX_ONLY, 1}).Nested(EncStr::StringArg1, item->name_enc).Nested(EncStr::StringArg2, prefix_mod_name);
     }
     else {
-        out = item->name_enc;
+        out.Encoded({&SUFFIX_ONLY, 1}).Nested(EncStr::StringArg1, item->name_enc).Nested(EncStr::StringArg2, suffix_mod_name);
     }
-    return out;
+    return out.str();
 }
 void ItemDescriptionHandler::Initialize()
 {
@@ -20,6 +20,7 @@
 #include <Modules/PriceCheckerModule.h>
 #include <Windows/DailyQuestsWindow.h>
 
+#include <Utils/EncStr.h>
 #include <Utils/GuiUtils.h>
 #include <Utils/TextUtils.h>
 
@@ -45,6 +46,7 @@ namespace {
 
     // Trader price info
     bool show_trader_prices = true;
+    bool show_trader_price_trend = true;
     constexpr Color price_color_default = GW::Chat::TextColor::ColorItemBasic;
     Color price_color = price_color_default;
     uint32_t high_price_threshold = 1000;
@@ -66,64 +68,53 @@ namespace {
         return info ? info->enc_name : nullptr;
     }
 
-    std::wstring EncodedLiteral(const std::wstring_view str)
+    EncStr::Builder& BeginColour(EncStr::Builder& out, const Color col)
     {
-        return std::format(L"\x108\x107{}\x1", str);
+        wchar_t col_str[12];
+        swprintf(col_str, _countof(col_str), L"%u", col);
+        return out.BeginColour(col_str);
     }
-    const auto EncodedNewLine = L"\x2\x102\x2";
-    const auto EncodedNewParagraph = EncodedLiteral(L"<brx>");
-    const auto EncodedColorEndTag = EncodedLiteral(L"</c>");
 
-    void NewLineIfNotEmpty(std::wstring& enc_str)
+    // Starts a new tooltip paragraph after whatever is already in the description
+    EncStr::Builder& BeginParagraph(EncStr::Builder& out, const Color col)
     {
-        if (!enc_str.empty()) enc_str += EncodedNewLine;
+        out.Text(L"<brx>");
+        return BeginColour(out, col);
     }
 
-    std::wstring EncodedColouredString(const std::wstring_view str, const uint32_t col)
+    void AppendCurrencyString(EncStr::Builder& out, uint32_t price, bool abbreviated, uint32_t high_threshold, Color high_threshold_color)
     {
-        const auto col_str = std::format(L"<c={}>", col);
-        return std::format(L"{}\x2{}\x2{}", EncodedLiteral(col_str), str, EncodedColorEndTag);
-    }
-    std::wstring EncodedColouredString(const std::wstring_view str, const wchar_t* col)
-    {
-        const auto col_str = std::format(L"<c={}>", col);
-        return std::format(L"{}\x2{}\x2{}", EncodedLiteral(col_str), str, EncodedColorEndTag);
-    }
-
-    std::wstring EncodedCurrencyString(uint32_t price, bool abbreviated, uint32_t high_threshold, Color high_threshold_color)
-    {
-        std::wstring currency_string;
+        const bool highlight = price > high_threshold;
+        if (highlight) {
+            BeginColour(out, high_threshold_color);
+        }
         if (abbreviated) {
-            std::wstring unencoded;
             if (price > 999) {
-                unencoded = TextUtils::FormatFloat((float)(price / 1000.f), 3) + L"k";
+                out.Text(TextUtils::FormatFloat((float)(price / 1000.f), 3) + L"k");
             }
             else {
-                unencoded = std::format(L"{}g", price);
+                out.Text(std::format(L"{}g", price));
             }
-            currency_string = EncodedLiteral(unencoded);
         }
         else {
             const uint32_t plat = price / 1000;
             const uint32_t gold = price % 1000;
             if (price == 0) {
-                currency_string = L"\xAC2\x100";
+                out.Encoded(L"\xAC2").Number(EncStr::NumberArg1, 0);
             }
             else if (plat > 0 && gold > 0) {
-                currency_string = std::format(L"\xAC4\x101{}\x102{}", (wchar_t)(0x100 + plat), (wchar_t)(0x100 + gold));
+                out.Encoded(L"\xAC4").Number(EncStr::NumberArg1, plat).Number(EncStr::NumberArg2, gold);
             }
             else if (gold > 0) {
-                currency_string = std::format(L"\xAC2\x101{}", (wchar_t)(0x100 + gold));
+                out.Encoded(L"\xAC2").Number(EncStr::NumberArg1, gold);
             }
             else {
-                currency_string = std::format(L"\xAC3\x101{}", (wchar_t)(0x100 + plat));
+                out.Encoded(L"\xAC3").Number(EncStr::NumberArg1, plat);
             }
         }
-
-        if (price > high_threshold) {
-            currency_string = EncodedColouredString(currency_string, high_threshold_color);
+        if (highlight) {
+            out.EndColour();
         }
-        return currency_string;
     }
 
     // -------------------------------------------------------------------------
@@ -138,36 +129,38 @@ namespace {
         const auto formula = GW::Items::GetItemFormula(item);
         if (!(formula && formula->material_cost_count)) return;
 
-        std::vector<std::wstring> common_materials;
-        std::vector<std::wstring> rare_materials;
+        std::vector<GW::Constants::MaterialSlot> common_materials;
+        std::vector<GW::Constants::MaterialSlot> rare_materials;
         for (size_t i = 0; i < formula->material_cost_count; i++) {
             const auto material_id = formula->material_cost_buffer[i].material;
-            const auto name = material_name_from_slot(material_id);
-            if (!name) continue;
+            if (!material_name_from_slot(material_id)) continue;
             auto* write_to = material_id > GW::Constants::MaterialSlot::Feather ? &rare_materials : &common_materials;
-            write_to->push_back(name);
-            if (show_trader_value_for_mats) {
-                const auto sell_price = PriceCheckerModule::GetTraderSellPrice(material_id);
-                if (sell_price) {
-                    write_to->back().append(std::format(L"\x2{}\x2{}\x2{}", EncodedLiteral(L" ("), EncodedCurrencyString(sell_price,true,high_price_threshold,high_price_color), EncodedLiteral(L")")));
-                }
-            }
+            write_to->push_back(material_id);
         }
         if (common_materials.empty() && rare_materials.empty()) return;
 
-        std::wstring items;
-        static auto encoded_sep = std::format(L"\x2{}\x2",EncodedLiteral(L", "));
-        if (!common_materials.empty()) {
-            NewLineIfNotEmpty(items);
-            items += std::format(L"{}\x2{}", EncodedLiteral(L"Common Materials: "), TextUtils::Join(common_materials, encoded_sep));
-        }
-        if (!rare_materials.empty()) {
-            NewLineIfNotEmpty(items);
-            items += std::format(L"{}\x2{}", EncodedLiteral(L"Rare Materials: "), TextUtils::Join(rare_materials, encoded_sep));
-        }
-
-        if (!description.empty()) description += L"\x2";
-        description += EncodedNewParagraph + L"\x2" + EncodedColouredString(items, salvage_color);
+        EncStr::Builder out(description);
+        BeginParagraph(out, salvage_color);
+        bool first_line = true;
+        const auto append_materials = [&](const wchar_t* label, const std::vector<GW::Constants::MaterialSlot>& materials) {
+            if (materials.empty()) return;
+            if (!first_line) out.NewLine();
+            first_line = false;
+            out.Text(label);
+            for (size_t i = 0; i < materials.size(); i++) {
+                if (i) out.Text(L", ");
+                out.Encoded(material_name_from_slot(materials[i]));
+                if (!show_trader_value_for_mats) continue;
+                if (const auto sell_price = PriceCheckerModule::GetTraderSellPrice(materials[i])) {
+                    out.Text(L" (");
+                    AppendCurrencyString(out, sell_price, true, high_price_threshold, high_price_color);
+                    out.Text(L")");
+                }
+            }
+        };
+        append_materials(L"Common Materials: ", common_materials);
+        append_materials(L"Rare Materials: ", rare_materials);
+        out.EndColour();
     }
 
     // -------------------------------------------------------------------------
@@ -182,8 +175,8 @@ namespace {
         static std::wstring last_nicholas_text;
 
         auto append = [&](std::wstring text) {
-            if (!description.empty()) description += L"\x2";
-            description += EncodedNewParagraph + L"\x2" + EncodedColouredString(EncodedLiteral(text), nicholas_color);
+            EncStr::Builder out(description);
+            BeginParagraph(out, nicholas_color).Text(text).EndColour();
             last_nicholas_text = text;
         };
 
@@ -239,11 +232,13 @@ namespace {
 
 
 
-    std::wstring PrintPrice(const uint32_t price, const char* name = nullptr)
+    void AppendPrice(EncStr::Builder& out, const uint32_t price, const char* name = nullptr, const PriceHistory::Trend* trend = nullptr)
     {
-        const auto subject = EncodedLiteral(name && *name ? TextUtils::StringToWString(name) : L"Trader Value");
-        const auto currency = EncodedCurrencyString(price, false, high_price_threshold, high_price_color);
-        return std::format(L"{}\x2{}\x2{}", subject, EncodedLiteral(L": "), currency);
+        out.Text(name && *name ? TextUtils::StringToWString(name) : L"Trader Value").Text(L": ");
+        AppendCurrencyString(out, price, false, high_price_threshold, high_price_color);
+        if (trend && trend->sample_count > 1) {
+            out.Text(std::format(L" (7d: {:+.0f}%, \xB1{:.0f}%)", trend->change * 100.f, trend->volatility * 100.f));
+        }
     }
 
     void AppendPriceInfo(const uint32_t item_id, std::wstring& description)
@@ -255,21 +250,23 @@ namespace {
         std::string second_item_name;
         const auto price_first = PriceCheckerModule::GetPriceByItem(item, &first_item_name, 0);
         const auto price_second = PriceCheckerModule::GetPriceByItem(item, &second_item_name, 1);
-        if (!price_first && !price_second) return;
+        const bool show_second = price_second > 0 && first_item_name != second_item_name;
+        if (!price_first && !show_second) return;
 
-        std::wstring prices_out;
+        PriceHistory::Trend trend;
+        const auto get_trend = [&](const unsigned int mod_start_index) {
+            return show_trader_price_trend && PriceCheckerModule::GetPriceTrend(item, &trend, mod_start_index) ? &trend : nullptr;
+        };
+        EncStr::Builder out(description);
+        BeginParagraph(out, price_color);
         if (price_first > 0) {
-            if (!prices_out.empty()) prices_out += EncodedNewLine;
-            prices_out.append(PrintPrice(price_first, first_item_name.empty() ? nullptr : first_item_name.c_str()));
-        }
-        if (price_second > 0 && first_item_name != second_item_name) {
-            if (!prices_out.empty()) prices_out += EncodedNewLine;
-            prices_out.append(PrintPrice(price_second, second_item_name.empty() ? nullptr : second_item_name.c_str()));
+            AppendPrice(out, price_first, first_item_name.empty() ? nullptr : first_item_name.c_str(), get_trend(0));
         }
-        if (!prices_out.empty()) {
-            if (!description.empty()) description += L"\x2";
-            description += EncodedNewParagraph + L"\x2" + EncodedColouredString(prices_out, price_color);
+        if (show_second) {
+            if (price_first > 0) out.NewLine();
+            AppendPrice(out, price_second, second_item_name.empty() ? nullptr : second_item_name.c_str(), get_trend(1));
         }
+        out.EndColour();
     }
 
         // Check and re-render item tooltips if modifier key held
@@ -419,6 +416,7 @@ void ItemTooltipModule::SaveSettings(ToolboxIni* ini)
     SAVE_BOOL(show_nicholas_info);
     SAVE_COLOR(nicholas_color);
     SAVE_BOOL(show_trader_prices);
+    SAVE_BOOL(show_trader_price_trend);
     SAVE_COLOR(price_color);
     SAVE_FLOAT(high_price_threshold);
     SAVE_BOOL(disable_item_descriptions_in_outpost);
@@ -436,6 +434,7 @@ void ItemTooltipModule::LoadSettings(ToolboxIni* ini)
     LOAD_BOOL(show_nicholas_info);
     LOAD_COLOR(nicholas_color);
     LOAD_BOOL(show_trader_prices);
+    LOAD_BOOL(show_trader_price_trend);
     LOAD_COLOR(price_color);
     LOAD_UINT(high_price_threshold);
     LOAD_BOOL(disable_item_descriptions_in_outpost);
@@ -546,6 +545,7 @@ void ItemTooltipModule::DrawSettingsInternal()
         ImGui::SameLine();
         bool reset_price = false;
         if (ImGui::ConfirmButton("Reset##price", &reset_price)) price_color = price_color_default;
+        ImGui::CheckboxWithHelp("Show 7 day price trend", &show_trader_price_trend, "Change and volatility of the trader price over the last 7 days.\nToolbox records the prices it fetches, so this only covers days you've played.");
 
 
 
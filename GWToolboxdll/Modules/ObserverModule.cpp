@@ -85,142 +85,25 @@ void ObserverModule::Initialize()
     is_explorable = GW::Map::GetInstanceType() == GW::Constants::InstanceType::Explorable;
     is_observer = GW::Map::GetIsObserving();
 
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::InstanceLoadInfo>(&InstanceLoadInfo_Entry, [this](const GW::HookStatus* status, const GW::Packet::StoC::InstanceLoadInfo* packet) -> void {
-        HandleInstanceLoadInfo(status, packet);
+    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::InstanceLoadInfo>(&InstanceLoadInfo_Entry, [this](const GW::HookStatus*, const GW::Packet::StoC::InstanceLoadInfo* packet) -> void {
+        QueuePacket(QueuedPacket::InstanceLoadInfo, packet->map_id, (packet->is_explorable ? 1 : 0) | (packet->is_observer ? 2 : 0));
     });
 
     GW::StoC::RegisterPacketCallback<GW::Packet::StoC::JumboMessage>(&JumboMessage_Entry, [this](const GW::HookStatus*, const GW::Packet::StoC::JumboMessage* packet) -> void {
-        if (!IsActive()) {
-            return;
-        }
-        if (!InitializeObserverSession()) {
-            return;
-        }
-        HandleJumboMessage(packet->type, packet->value);
+        QueuePacket(QueuedPacket::JumboMessage, packet->value, packet->type);
     });
 
     // Hook for countdown start - this fires twice: once at map load, once when match actually starts
     GW::StoC::RegisterPacketCallback(&CountdownStart_Entry, GAME_SMSG_INSTANCE_COUNTDOWN, [this](GW::HookStatus*, GW::Packet::StoC::PacketBase*) -> void {
-        if (!IsActive()) {
-            return;
-        }
-        
-        const uint32_t instance_time = GW::Map::GetInstanceTime();
-        
-        if (!first_countdown_seen) {
-            // First countdown at map load - reset data for new match
-            Reset();
-            first_countdown_seen = true;
-            if (!InitializeObserverSession(observed_map_id)) {
-                return;
-            }
-        } else {
-            // Second countdown - this is the actual match start
-            match_start_instance_time = instance_time;
-            // Capture the map at match start - use the map from InitializeObserverSession which uses the correct map
-            if (map && !match_start_map) {
-                const auto map_id = map->map_id;
-                const GW::AreaInfo* area_info = GW::Map::GetMapInfo(map_id);
-                if (area_info) {
-                    match_start_map = new ObservableMap(map_id, *area_info);
-                }
-            }
-        }
-    });
-
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::AgentState>(&AgentState_Entry, [this](const GW::HookStatus*, const GW::Packet::StoC::AgentState* packet) -> void {
-        if (!IsActive()) {
-            return;
-        }
-        if (!InitializeObserverSession()) {
-            return;
-        }
-        HandleAgentState(packet->agent_id, packet->state);
+        QueuePacket(QueuedPacket::CountdownStart, GW::Map::GetInstanceTime());
     });
 
     GW::StoC::RegisterPacketCallback<GW::Packet::StoC::AgentAdd>(&AgentAdd_Entry, [this](const GW::HookStatus*, const GW::Packet::StoC::AgentAdd* packet) -> void {
-        if (!IsActive()) {
-            return;
-        }
-        if (!InitializeObserverSession()) {
-            return;
-        }
-        HandleAgentAdd(packet->agent_id);
-    });
-
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::AgentProjectileLaunched>(&AgentProjectileLaunched_Entry, [this](const GW::HookStatus*, const GW::Packet::StoC::AgentProjectileLaunched* packet) -> void {
-        if (!IsActive()) {
-            return;
-        }
-        if (!InitializeObserverSession()) {
-            return;
-        }
-        HandleAgentProjectileLaunched(packet);
-    });
-
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::GenericModifier>(&GenericModifier_Entry, [this](const GW::HookStatus*, const GW::Packet::StoC::GenericModifier* packet) -> void {
-        if (!IsActive()) {
-            return;
-        }
-        if (!InitializeObserverSession()) {
-            return;
-        }
-
-        const uint32_t value_id = packet->type;
-        const uint32_t caster_id = packet->cause_id;
-        const uint32_t target_id = packet->target_id;
-        const float value = packet->value;
-        constexpr bool no_target = false;
-        HandleGenericPacket(value_id, caster_id, target_id, value, no_target);
+        QueuePacket(QueuedPacket::AgentAdd, packet->agent_id);
     });
 
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::GenericValueTarget>(&GenericValueTarget_Entry, [this](const GW::HookStatus*, const GW::Packet::StoC::GenericValueTarget* packet) -> void {
-        if (!IsActive()) {
-            return;
-        }
-        if (!InitializeObserverSession()) {
-            return;
-        }
-
-        const uint32_t value_id = packet->Value_id;
-        const uint32_t caster_id = packet->caster;
-        const uint32_t target_id = packet->target;
-        const uint32_t value = packet->value;
-        constexpr bool no_target = false;
-        HandleGenericPacket(value_id, caster_id, target_id, value, no_target);
-    });
-
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::GenericValue>(&GenericValue_Entry, [this](const GW::HookStatus*, const GW::Packet::StoC::GenericValue* packet) -> void {
-        if (!IsActive()) {
-            return;
-        }
-        if (!InitializeObserverSession()) {
-            return;
-        }
-
-        const uint32_t value_id = packet->value_id;
-        const uint32_t caster_id = packet->agent_id;
-        constexpr uint32_t target_id = NO_AGENT;
-        const uint32_t value = packet->value;
-        constexpr bool no_target = true;
-        HandleGenericPacket(value_id, caster_id, target_id, value, no_target);
-    });
-
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::GenericFloat>(&GenericFloat_Entry, [this](const GW::HookStatus*, const GW::Packet::StoC::GenericFloat* packet) -> void {
-        if (!IsActive()) {
-            return;
-        }
-        if (!InitializeObserverSession()) {
-            return;
-        }
-
-        const uint32_t value_id = packet->type;
-        const uint32_t caster_id = packet->agent_id;
-        constexpr uint32_t target_id = NO_AGENT;
-        const float value = packet->value;
-        constexpr bool no_target = true;
-        HandleGenericPacket(value_id, caster_id, target_id, value, no_target);
-    });
+    // Damage, skill, attack, projectile and agent state packets, in arrival order
+    combat_events.Subscribe();
 
     if (IsActive() && !observer_session_initialized) {
         InitializeObserverSession();
@@ -233,6 +116,7 @@ void ObserverModule::Terminate()
 {
     ToolboxModule::Terminate();
     GW::Chat::DeleteCommand(&ChatCmd_HookEntry);
+    combat_events.Unsubscribe();
     Reset();
 
     // TODO: Clear stoc callbacks
@@ -247,16 +131,53 @@ const bool ObserverModule::IsActive() const
 }
 
 
+// Queue a packet to be handled in order with the combat events. Runs on the packet thread.
+void ObserverModule::QueuePacket(const QueuedPacket packet, const uint32_t agent_id, const uint32_t target_id)
+{
+    combat_events.Push({.type = CombatEventType::Marker, .agent_id = agent_id, .target_id = target_id, .value = static_cast<uint32_t>(packet)});
+}
+
+
+// Handle a packet queued by QueuePacket
+void ObserverModule::HandleQueuedPacket(const CombatEvent& event)
+{
+    const auto packet = static_cast<QueuedPacket>(event.value);
+    if (packet == QueuedPacket::InstanceLoadInfo) {
+        return HandleInstanceLoadInfo(static_cast<GW::Constants::MapID>(event.agent_id), event.target_id & 1, event.target_id & 2);
+    }
+    if (!IsActive()) {
+        return;
+    }
+    switch (packet) {
+        case QueuedPacket::JumboMessage:
+            if (InitializeObserverSession()) {
+                HandleJumboMessage(static_cast<uint8_t>(event.target_id), event.agent_id);
+            }
+            break;
+        case QueuedPacket::CountdownStart:
+            HandleCountdownStart(event.agent_id);
+            break;
+        case QueuedPacket::AgentAdd:
+            if (InitializeObserverSession()) {
+                HandleAgentAdd(event.agent_id);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+
 // Handle InstanceLoadInfo Packet
-void ObserverModule::HandleInstanceLoadInfo(const GW::HookStatus*, const GW::Packet::StoC::InstanceLoadInfo* packet)
+void ObserverModule::HandleInstanceLoadInfo(const GW::Constants::MapID map_id, const bool explorable, const bool observer)
 {
-    is_explorable = packet->is_explorable;
-    is_observer = packet->is_observer;
+    is_explorable = explorable;
+    is_observer = observer;
 
     const bool is_active = IsActive();
     
     // Store the observed map ID (this is the actual match map in observer mode, not your physical location)
-    observed_map_id = static_cast<GW::Constants::MapID>(packet->map_id);
+    observed_map_id = map_id;
 
     if (is_active) {
         // Reset countdown flag for new map
@@ -272,6 +193,29 @@ void ObserverModule::HandleInstanceLoadInfo(const GW::HookStatus*, const GW::Pac
 }
 
 
+// Handle the countdown packet
+void ObserverModule::HandleCountdownStart(const uint32_t instance_time)
+{
+    if (!first_countdown_seen) {
+        // First countdown at map load - reset data for new match
+        Reset();
+        first_countdown_seen = true;
+        InitializeObserverSession(observed_map_id);
+        return;
+    }
+    // Second countdown - this is the actual match start
+    match_start_instance_time = instance_time;
+    // Capture the map at match start - use the map from InitializeObserverSession which uses the correct map
+    if (map && !match_start_map) {
+        const auto map_id = map->map_id;
+        const GW::AreaInfo* area_info = GW::Map::GetMapInfo(map_id);
+        if (area_info) {
+            match_start_map = new ObservableMap(map_id, *area_info);
+        }
+    }
+}
+
+
 // Handle a JumboMessage packet
 void ObserverModule::HandleJumboMessage(const uint8_t type, const uint32_t value)
 {
@@ -295,135 +239,67 @@ void ObserverModule::HandleJumboMessage(const uint8_t type, const uint32_t value
 }
 
 
-// Handle a GenericPacket of type float
-void ObserverModule::HandleGenericPacket(const uint32_t value_id, const uint32_t caster_id, const uint32_t target_id, const float value, const bool)
+// Handle a decoded damage/skill/attack packet
+void ObserverModule::HandleCombatEvent(const CombatEvent& event)
 {
-    switch (value_id) {
-        case GW::Packet::StoC::GenericValueID::damage:
-            HandleDamageDone(caster_id, target_id, value, false);
+    const auto skill_id = static_cast<GW::Constants::SkillID>(event.value);
+    switch (event.type) {
+        case CombatEventType::Damage:
+            HandleDamageDone(event.agent_id, event.target_id, event.amount, event.IsCritical());
             break;
-
-        case GW::Packet::StoC::GenericValueID::critical:
-            HandleDamageDone(caster_id, target_id, value, true);
+        case CombatEventType::Heal:
+            HandleHealingDone(event.agent_id, event.target_id, event.amount);
             break;
-
-        case GW::Packet::StoC::GenericValueID::armorignoring:
-            // Check if it's healing (positive) or damage (negative)
-            if (value >= 0) {
-                HandleHealingDone(caster_id, target_id, value);
-            }
-            else {
-                HandleDamageDone(caster_id, target_id, value, false);
-            }
+        case CombatEventType::KnockedDown:
+            HandleKnockedDown(event.agent_id, event.amount);
             break;
-
-        case GW::Packet::StoC::GenericValueID::knocked_down:
-            HandleKnockedDown(caster_id, value);
+        case CombatEventType::AttackFinished:
+            HandleAttackFinished(event.agent_id);
             break;
-    }
-}
-
-// Handle a Generic Packet of type uint32_t
-void ObserverModule::HandleGenericPacket(const uint32_t value_id, const uint32_t caster_id, const uint32_t target_id, const uint32_t value, const bool no_target)
-{
-    switch (value_id) {
-        case GW::Packet::StoC::GenericValueID::melee_attack_finished:
-            HandleAttackFinished(caster_id);
+        case CombatEventType::AttackStopped:
+            HandleAttackStopped(event.agent_id);
             break;
-
-        case GW::Packet::StoC::GenericValueID::attack_stopped:
-            HandleAttackStopped(caster_id);
+        case CombatEventType::AttackStarted:
+            HandleAttackStarted(event.agent_id, event.target_id);
             break;
-
-        case GW::Packet::StoC::GenericValueID::attack_started: {
-            // swap target and caster for skill_activated
-            // log
-            uint32_t _caster_id;
-            uint32_t _target_id;
-            if (no_target) {
-                // do nothing... caster is correct in this case
-                _caster_id = caster_id;
-                _target_id = target_id; // 0
-            }
-            else {
-                // caster and target are swapped
-                _caster_id = target_id;
-                _target_id = caster_id;
-            }
-            // handle
-            HandleAttackStarted(_caster_id, _target_id);
+        case CombatEventType::Interrupted:
+            HandleInterrupted(event.agent_id);
             break;
-        }
-
-        case GW::Packet::StoC::GenericValueID::interrupted:
-            HandleInterrupted(caster_id);
+        case CombatEventType::AttackSkillFinished:
+            HandleAttackSkillFinished(event.agent_id);
             break;
-
-        case GW::Packet::StoC::GenericValueID::attack_skill_finished:
-            HandleAttackSkillFinished(caster_id);
+        case CombatEventType::InstantSkillActivated:
+            HandleInstantSkillActivated(event.agent_id, event.target_id, skill_id);
             break;
-
-        case GW::Packet::StoC::GenericValueID::instant_skill_activated:
-            HandleInstantSkillActivated(caster_id, target_id, static_cast<GW::Constants::SkillID>(value));
-            break;
-
-        case GW::Packet::StoC::GenericValueID::attack_skill_stopped:
-            HandleAttackSkillStopped(caster_id);
+        case CombatEventType::AttackSkillStopped:
+            HandleAttackSkillStopped(event.agent_id);
             break;
-
-        case GW::Packet::StoC::GenericValueID::attack_skill_activated: {
-            // swap target and caster for skill_activated
-            // log
-            uint32_t _caster_id;
-            uint32_t _target_id;
-            if (no_target) {
-                // do nothing... caster is correct in this case
-                _caster_id = caster_id;
-                _target_id = target_id; // 0
-            }
-            else {
-                // caster and target are swapped
-                _caster_id = target_id;
-                _target_id = caster_id;
-            }
-            // handle
-            HandleAttackSkillStarted(_caster_id, _target_id, static_cast<GW::Constants::SkillID>(value));
+        case CombatEventType::AttackSkillActivated:
+            HandleAttackSkillStarted(event.agent_id, event.target_id, skill_id);
             break;
-        }
-
-        case GW::Packet::StoC::GenericValueID::skill_finished:
-            HandleSkillFinished(caster_id);
+        case CombatEventType::SkillFinished:
+            HandleSkillFinished(event.agent_id);
             break;
-
-        case GW::Packet::StoC::GenericValueID::skill_stopped:
-            HandleSkillStopped(caster_id);
+        case CombatEventType::SkillStopped:
+            HandleSkillStopped(event.agent_id);
             break;
-
-        case GW::Packet::StoC::GenericValueID::skill_activated: {
+        case CombatEventType::SkillActivated:
             // TODO: do location effecs cause entry here?
             // if so, Isle of the Dead, Burning Isle, Isle of Meditation,
             // Frozen Isle, Isle of Weeping Stone, etc... might slow down
             // our application by coming in here 10,000 times
             // TODO: verify whether we need to check for NO_AGENT on caster,
             // or for no living agent...
-
-            // swap target and caster for skill_activated
-            // log
-            uint32_t _caster_id;
-            uint32_t _target_id;
-            if (no_target) {
-                // do nothing... caster is correct in this case
-                _caster_id = caster_id;
-                _target_id = target_id; // 0
-            }
-            else {
-                // caster and target are swapped
-                _caster_id = target_id;
-                _target_id = caster_id;
-            }
-            HandleSkillActivated(_caster_id, _target_id, static_cast<GW::Constants::SkillID>(value));
+            HandleSkillActivated(event.agent_id, event.target_id, skill_id);
+            break;
+        case CombatEventType::ProjectileLaunched:
+            HandleAgentProjectileLaunched(event.agent_id);
+            break;
+        case CombatEventType::AgentState:
+            HandleAgentState(event.agent_id, event.value);
+            break;
+        default:
             break;
-        }
     }
 }
 
@@ -801,12 +677,9 @@ void ObserverModule::HandleAgentAdd(const uint32_t)
 
 // Handle AgentProjectileLaunched Packet
 // can be used to determine when a ranged attack has finished
-void ObserverModule::HandleAgentProjectileLaunched(const GW::Packet::StoC::AgentProjectileLaunched* packet)
+void ObserverModule::HandleAgentProjectileLaunched(const uint32_t agent_id)
 {
-    if (!packet) {
-        return;
-    }
-    ObservableAgent* agent = GetObservableAgentById(packet->agent_id);
+    ObservableAgent* agent = GetObservableAgentById(agent_id);
     // ensure the projectile was from an attack we're currently undertaking
     if (!agent || !agent->current_target_action || !agent->current_target_action->is_attack) {
         return;
@@ -1589,7 +1462,18 @@ void ObserverModule::DrawSettingsInternal()
 
 void ObserverModule::Update(const float)
 {
-    if (!IsActive()) {
+    // Always drain, so the queue doesn't fill up while we're inactive. A queued InstanceLoadInfo can change IsActive().
+    combat_events.Drain([this](const CombatEvent& event) {
+        if (event.type == CombatEventType::Marker) {
+            HandleQueuedPacket(event);
+        }
+        else if (IsActive() && InitializeObserverSession()) {
+            HandleCombatEvent(event);
+        }
+    });
+    const bool active = IsActive();
+
+    if (!active) {
         party_sync_timer = 0;
         health_snapshot_timer = 0;
         return;
@@ -13,6 +13,7 @@
 #include <GWCA/Utilities/Hook.h>
 
 #include <ToolboxModule.h>
+#include <Utils/CombatEvents.h>
 
 constexpr auto NO_SKILL = static_cast<GW::Constants::SkillID>(0);
 constexpr auto NO_AGENT = 0;
@@ -657,11 +658,22 @@ private:
     bool is_explorable = false;
     GW::Constants::MapID observed_map_id = static_cast<GW::Constants::MapID>(0); // Map ID from InstanceLoadInfo packet (actual match map in observer mode)
 
+    // Other packets are queued in combat_events as a CombatEventType::Marker, so everything is handled in arrival order
+    enum class QueuedPacket : uint32_t {
+        InstanceLoadInfo, // agent_id: map id, target_id: 1 if explorable | 2 if observing
+        JumboMessage,     // agent_id: value, target_id: type
+        CountdownStart,   // agent_id: instance time
+        AgentAdd          // agent_id: agent id
+    };
+    void QueuePacket(QueuedPacket packet, uint32_t agent_id, uint32_t target_id = 0);
+    void HandleQueuedPacket(const CombatEvent& event);
+
     // packet handlers
 
-    void HandleInstanceLoadInfo(const GW::HookStatus* status, const GW::Packet::StoC::InstanceLoadInfo* packet);
+    void HandleInstanceLoadInfo(GW::Constants::MapID map_id, bool explorable, bool observer);
     void HandleJumboMessage(uint8_t type, uint32_t value);
-    void HandleAgentProjectileLaunched(const GW::Packet::StoC::AgentProjectileLaunched* packet);
+    void HandleCountdownStart(uint32_t instance_time);
+    void HandleAgentProjectileLaunched(uint32_t agent_id);
 
     // generic handlers
 
@@ -689,11 +701,7 @@ private:
     void HandleSkillStopped(uint32_t agent_id);
     void HandleSkillActivated(uint32_t caster_id, uint32_t target_id, GW::Constants::SkillID skill_id);
 
-    void HandleGenericPacket(uint32_t value_id, uint32_t caster_id,
-                             uint32_t target_id, float value, bool no_target);
-
-    void HandleGenericPacket(uint32_t value_id, uint32_t caster_id,
-                             uint32_t target_id, uint32_t value, bool no_target);
+    void HandleCombatEvent(const CombatEvent& event);
 
     // Update the state of the module based on an Action & Stage
     // return false means action was not assigned and may need freeing by the caller
@@ -742,11 +750,6 @@ private:
     GW::HookEntry JumboMessage_Entry;
     GW::HookEntry InstanceLoadInfo_Entry;
     GW::HookEntry CountdownStart_Entry;
-    GW::HookEntry AgentState_Entry;
     GW::HookEntry AgentAdd_Entry;
-    GW::HookEntry AgentProjectileLaunched_Entry;
-    GW::HookEntry GenericModifier_Entry;
-    GW::HookEntry GenericValueTarget_Entry;
-    GW::HookEntry GenericValue_Entry;
-    GW::HookEntry GenericFloat_Entry;
+    CombatEvents::Subscriber combat_events;
 };
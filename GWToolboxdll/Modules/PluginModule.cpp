@@ -11,7 +11,9 @@
 #include <string>
 
 #include "GWCA/Managers/UIMgr.h"
+#include "Utils/GameSnapshotPublisher.h"
 #include "Utils/TextUtils.h"
+#include "Utils/TraceProfiler.h"
 
 namespace {
     std::wstring pluginsfoldername;
@@ -235,6 +237,10 @@ void PluginModule::Draw(IDirect3DDevice9* device)
         }
 
         if (plugin->instance->GetVisiblePtr() && *plugin->instance->GetVisiblePtr()) {
+            if (TraceProfiler::IsEnabled() && plugin->draw_zone_id == TraceProfiler::InvalidZone) {
+                plugin->draw_zone_id = TraceProfiler::RegisterZone(std::format("{}::Draw", plugin->path.stem().string()));
+            }
+            const TraceProfiler::ScopedZone zone(plugin->draw_zone_id);
             plugin->instance->Draw(device);
         }
     }
@@ -296,10 +302,19 @@ void PluginModule::Update(const float delta)
             L"Plugins are NOT permitted by ArenaNet.", nullptr, true);
         message_displayed = true;
     }
+    if (!plugins_loaded.empty()) {
+        GameSnapshotPublisher::Publish();
+    }
     for (const auto plugin : plugins_loaded) {
         if (!plugin->initialized)
             continue;
-        plugin->instance->Update(delta);
+        if (TraceProfiler::IsEnabled() && plugin->update_zone_id == TraceProfiler::InvalidZone) {
+            plugin->update_zone_id = TraceProfiler::RegisterZone(std::format("{}::Update", plugin->path.stem().string()));
+        }
+        {
+            const TraceProfiler::ScopedZone zone(plugin->update_zone_id);
+            plugin->instance->Update(delta);
+        }
         if (plugin->terminating) {
             if (UnloadPlugin(plugin)) {
                 break; // plugins_loaded vector changed, skip a frame
@@ -18,6 +18,8 @@ public:
         bool initialized = false;
         bool terminating = false;
         bool visible = false;
+        TraceProfiler::ZoneId update_zone_id = TraceProfiler::InvalidZone;
+        TraceProfiler::ZoneId draw_zone_id = TraceProfiler::InvalidZone;
     };
 
     static PluginModule& Instance()
@@ -2,6 +2,8 @@
 
 #include <ToolboxModule.h>
 
+#include <Utils/PriceHistory.h>
+
 namespace GW {
     struct Item;
 }
@@ -30,9 +32,9 @@ public:
 
     void DrawSettingsInternal() override;
 
-    // Fetch (and cache) prices from kamadan.gwtoolbox.com.
-    // Returns the current price map; triggers a background refresh if stale.
-    static const std::unordered_map<std::string, uint32_t>& FetchPrices();
+    // Fetch (and cache) prices from kamadan.gwtoolbox.com if the last fetch is stale.
+    // Each fetch is also appended to the local price history.
+    static void FetchPrices();
 
     // Returns the trader sell price for the given item or material slot.
     // May return the fixed merchant price instead when in Melandru's Accord.
@@ -48,4 +50,10 @@ public:
     static uint32_t GetPriceByItem(const GW::Item* item,
         std::string* item_name_out = nullptr,
         unsigned int mod_start_index = 0);
+
+    // Trend of the trader price over the last few days, from the locally recorded price history.
+    // Returns false if nothing has been recorded for the item in that time.
+    static bool GetPriceTrend(const GW::Item* item, PriceHistory::Trend* out,
+        unsigned int mod_start_index = 0, uint32_t days = 7);
+    static bool GetPriceTrend(GW::Constants::MaterialSlot material, PriceHistory::Trend* out, uint32_t days = 7);
 };
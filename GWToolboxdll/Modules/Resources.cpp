@@ -25,6 +25,7 @@
 #include <GWCA/Constants/Constants.h>
 #include <Modules/Resources.h>
 #include <Utils/GuiUtils.h>
+#include <Utils/TraceProfiler.h>
 
 #pragma warning(push) // Save current warning state
 #pragma warning(disable : 4189) // local variable is initialized but not referenced
@@ -159,6 +160,37 @@ namespace {
     IDirect3DTexture9* empty_texture_ptr = nullptr;
     bool should_stop = false;
 
+    // Write-behind ini saves, newest content per path. ini_write_mutex serialises the actual file writes.
+    std::mutex pending_ini_saves_mutex;
+    std::map<std::filesystem::path, std::shared_ptr<const std::string>> pending_ini_saves;
+    std::mutex ini_write_mutex;
+
+    int WriteFileAtomically(const std::filesystem::path& absolute_path, const std::string& content)
+    {
+        auto tmp_file = std::filesystem::path(absolute_path);
+        tmp_file += ".tmp";
+        {
+            std::ofstream file(tmp_file, std::ios::binary | std::ios::trunc);
+            if (!(file.is_open() && file.write(content.data(), static_cast<std::streamsize>(content.size())))) {
+                return -1;
+            }
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmp_file, absolute_path, ec);
+        if (ec.value() != 0) {
+            return ec.value();
+        }
+        if (!(!exists(tmp_file) && exists(absolute_path))) {
+            return -1; // rename failed
+        }
+        return 0;
+    }
+
+    bool IniNeedsSaving(const std::filesystem::path& absolute_path, const ToolboxIni* ini)
+    {
+        return ini->IsDirty() || ini->location_on_disk != absolute_path || !exists(absolute_path);
+    }
+
     // snprintf error message, pass to callback as a failure. Used internally.
     void trigger_failure_callback(const std::function<void(bool, const std::wstring&)>& callback, const wchar_t* format, ...)
     {
@@ -206,6 +238,7 @@ namespace {
                         std::function<void()> func = thread_jobs.front();
                         thread_jobs.pop();
                         worker_mutex.unlock();
+                        TB_TRACE_ZONE("Resources::WorkerJob");
                         func();
                     }
                 }
@@ -643,6 +676,23 @@ bool Resources::Download(const std::string& url, std::string& response, int& sta
     return true;
 }
 
+bool Resources::DownloadRange(const std::string& url, const uint64_t offset, const uint64_t length, std::string& response)
+{
+    RestClient r;
+    InitRestClient(&r);
+    r.SetUrl(url.c_str());
+    r.SetHeader(std::format("Range: bytes={}-{}", offset, offset + length - 1).c_str());
+    r.Execute();
+    response = std::move(r.GetContent());
+    if (!r.IsSuccessful()) {
+        if (response.empty()) {
+            response = std::format("Failed to download {} (bytes {}-{}), curl status {} {}", url, offset, offset + length - 1, r.GetStatusCode(), r.GetStatusStr());
+        }
+        return false;
+    }
+    return true;
+}
+
 void Resources::Download(const std::string& url, AsyncLoadMbCallback callback, void* context)
 {
     EnqueueWorkerTask([url, callback, context] {
@@ -874,20 +924,71 @@ int Resources::LoadIniFromFile(const std::filesystem::path& absolute_path, Toolb
 
 int Resources::SaveIniToFile(const std::filesystem::path& absolute_path, const ToolboxIni* ini)
 {
-    auto tmp_file = std::filesystem::path(absolute_path);
-    tmp_file += ".tmp";
-    if (ini->SaveFile(tmp_file.c_str()) != SI_OK) {
-        return -1;
+    std::lock_guard write_lock(ini_write_mutex);
+    bool has_pending;
+    {
+        // This write supersedes anything still queued for the same file
+        std::lock_guard lock(pending_ini_saves_mutex);
+        has_pending = pending_ini_saves.erase(absolute_path) > 0;
     }
-    std::error_code ec;
-    std::filesystem::rename(tmp_file, absolute_path, ec);
-    if (ec.value() != 0) {
-        return ec.value();
+    if (!has_pending && !IniNeedsSaving(absolute_path, ini)) {
+        return 0;
     }
-    if (!(!exists(tmp_file) && exists(absolute_path))) {
-        return -1; // rename failed
+    const auto res = WriteFileAtomically(absolute_path, ini->Serialize());
+    if (res == 0) {
+        ini->MarkSaved();
+    }
+    return res;
+}
+
+void Resources::SaveIniToFileAsync(const std::filesystem::path& absolute_path, const ToolboxIni* ini, std::function<void(const std::string& written)> on_saved)
+{
+    {
+        std::lock_guard lock(pending_ini_saves_mutex);
+        if (!pending_ini_saves.contains(absolute_path) && !IniNeedsSaving(absolute_path, ini)) {
+            return;
+        }
+        pending_ini_saves[absolute_path] = std::make_shared<const std::string>(ini->Serialize());
     }
-    return 0;
+    EnqueueWorkerTask([absolute_path, on_saved = std::move(on_saved)] {
+        std::lock_guard write_lock(ini_write_mutex);
+        std::shared_ptr<const std::string> content;
+        {
+            std::lock_guard lock(pending_ini_saves_mutex);
+            const auto found = pending_ini_saves.find(absolute_path);
+            if (found == pending_ini_saves.end()) {
+                return; // Already written by a newer save
+            }
+            content = found->second;
+        }
+        if (const auto res = WriteFileAtomically(absolute_path, *content); res != 0) {
+            // Left queued, so that the next save of this path writes it and reloads still see it
+            Log::LogW(L"Failed to save %s (%d)", absolute_path.wstring().c_str(), res);
+            return;
+        }
+        {
+            std::lock_guard lock(pending_ini_saves_mutex);
+            if (const auto found = pending_ini_saves.find(absolute_path); found != pending_ini_saves.end() && found->second == content) {
+                pending_ini_saves.erase(found);
+            }
+        }
+        if (on_saved) {
+            EnqueueMainTask([on_saved, content] {
+                on_saved(*content);
+            });
+        }
+    });
+}
+
+bool Resources::GetPendingIniSave(const std::filesystem::path& absolute_path, std::string& content)
+{
+    std::lock_guard lock(pending_ini_saves_mutex);
+    const auto found = pending_ini_saves.find(absolute_path);
+    if (found == pending_ini_saves.end()) {
+        return false;
+    }
+    content = *found->second;
+    return true;
 }
 
 void Resources::DxUpdate(IDirect3DDevice9* device)
@@ -901,6 +1002,7 @@ void Resources::DxUpdate(IDirect3DDevice9* device)
         const std::function<void(IDirect3DDevice9*)> func = std::move(dx_jobs.front());
         dx_jobs.pop();
         dx_mutex.unlock();
+        TB_TRACE_ZONE("Resources::DxJob");
         func(device);
     }
 }
@@ -915,6 +1017,7 @@ void Resources::Update(float)
     const auto func = std::move(main_jobs.front());
     main_jobs.pop();
     main_mutex.unlock();
+    TB_TRACE_ZONE("Resources::MainJob");
     func();
 }
 
@@ -52,7 +52,15 @@ public:
     static void SaveFileDialog(std::function<void(const char*)> callback, const char* filterList = nullptr, const char* defaultPath = nullptr);
 
     static int LoadIniFromFile(const std::filesystem::path& absolute_path, ToolboxIni* inifile);
+    // Writes via a temp file swap. Skips the write if the ini hasn't changed since it was loaded from absolute_path.
     static int SaveIniToFile(const std::filesystem::path& absolute_path, const ToolboxIni* inifile);
+    // As SaveIniToFile, but only serializes on the calling thread; the write happens on a worker thread.
+    // If several saves to the same path are queued, only the newest content is written. The ini isn't marked as saved
+    // here, because it may have changed or been freed by the time the write finishes: on_saved is called on the main
+    // loop with the content that reached the disk. A failed write stays queued, and the next save of the path retries it.
+    static void SaveIniToFileAsync(const std::filesystem::path& absolute_path, const ToolboxIni* inifile, std::function<void(const std::string& written)> on_saved = nullptr);
+    // Content of a queued SaveIniToFileAsync that hasn't reached the disk yet, if any.
+    static bool GetPendingIniSave(const std::filesystem::path& absolute_path, std::string& content);
 
     static std::filesystem::path GetComputerFolderPath();
     static std::filesystem::path GetSettingsFolderName();
@@ -146,6 +154,8 @@ public:
 
     // download to memory, blocking. If an error occurs, details are held in response string
     static bool Download(const std::string& url, std::string& response, int& statusCode);
+    // download bytes [offset, offset + length) to memory using a Range request, blocking. A server that ignores the range responds with the whole file.
+    static bool DownloadRange(const std::string& url, uint64_t offset, uint64_t length, std::string& response);
     // download to memory, async, calls callback on completion. If an error occurs, details are held in response string
     static void Download(const std::string& url, AsyncLoadMbCallback callback, void* context = nullptr);
     // download to memory, async, calls callback on completion and caches the response locally for the duration specified. If an error occurs, details are held in response string
@@ -181,13 +181,21 @@ namespace {
         ArenaNetFileParser::ArenaNetFile asset;
         if (!asset.readFromDat(file_id)) return false;
 
-        auto animations_chunk = (ArenaNetFileParser::FileNamesChunk*)asset.FindChunk(ArenaNetFileParser::ChunkType::BBC_FileReferences);
+        // Copied out, because reading the next file replaces the chunk it points into
+        const auto read_first_filename = [&asset](const ArenaNetFileParser::FileNamesChunk* chunk) {
+            if (!(chunk && chunk->count() > 0)) return false;
+            wchar_t filename[4]{};
+            std::copy_n(chunk->filenames[0].filename, _countof(chunk->filenames[0].filename), filename);
+            return asset.readFromDat(filename);
+        };
+
+        auto animations_chunk = asset.FindChunkAs<ArenaNetFileParser::FileNamesChunk>(ArenaNetFileParser::ChunkType::BBC_FileReferences);
         if (!animations_chunk) {
-            animations_chunk = (ArenaNetFileParser::FileNamesChunk*)asset.FindChunk(ArenaNetFileParser::ChunkType::BBD_AnimationRefs);
-            if (!(animations_chunk && asset.readFromDat(animations_chunk->filenames[0].filename))) return false;
-            animations_chunk = (ArenaNetFileParser::FileNamesChunk*)asset.FindChunk(ArenaNetFileParser::ChunkType::BBC_FileReferences);
+            animations_chunk = asset.FindChunkAs<ArenaNetFileParser::FileNamesChunk>(ArenaNetFileParser::ChunkType::BBD_AnimationRefs);
+            if (!read_first_filename(animations_chunk)) return false;
+            animations_chunk = asset.FindChunkAs<ArenaNetFileParser::FileNamesChunk>(ArenaNetFileParser::ChunkType::BBC_FileReferences);
         }
-        if (!(animations_chunk && asset.readFromDat(animations_chunk->filenames[0].filename))) return false;
+        if (!read_first_filename(animations_chunk)) return false;
         if (asset.getFFNAType() != 8) return false;
         const auto soundtracks_chunk = (ArenaNetFileParser::FileNamesChunkWithoutLength*)asset.FindChunk(ArenaNetFileParser::ChunkType::Type8_AssetRefs);
         if (!(soundtracks_chunk && soundtracks_chunk->num_filenames() > 0)) return false;
@@ -288,7 +288,7 @@ void ToolboxSettings::DrawSettingsInternal()
     ImGui::Columns(static_cast<int>(cols), "global_enable_cols", false);
     for (auto& m : optional_modules) {
         if (ImGui::Checkbox(m.name, &m.enabled)) {
-            GWToolbox::SaveSettings();
+            GWToolbox::SaveSettings(true);
             const auto p = &m;
             GW::GameThread::Enqueue([p]() {
                 GWToolbox::ToggleModule(*p->toolbox_module, p->enabled);
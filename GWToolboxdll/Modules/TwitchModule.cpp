@@ -133,9 +133,9 @@ namespace {
     }
 
 
-    void WriteChat(const wchar_t* message, const char* nick = nullptr)
+    void WriteChat(const wchar_t* message, const std::string_view nick = {})
     {
-        const auto sender = nick ? std::format("{} @ {}", nick, irc_alias) : irc_alias;
+        const auto sender = !nick.empty() ? std::format("{} @ {}", nick, irc_alias) : irc_alias;
         std::wstring sender_ws = TextUtils::StringToWString(sender);
         auto message_ws = new wchar_t[255];
         size_t message_len = 0;
@@ -173,84 +173,86 @@ namespace {
         });
     }
 
-    // ReSharper disable once CppParameterMayBeConstPtrOrRef
-    int OnJoin(const char* params, irc_reply_data* hostd, void*)
+    int OnJoin(const irc_message& message, void*)
     {
-        if (!params[0] || !show_messages) {
+        const auto channel = message.param(0);
+        if (channel.size() < 2 || !show_messages) {
             return 0; // Empty msg
         }
-        wchar_t buf[600];
-        if (strcmp(hostd->nick, irc_username.c_str()) == 0) {
-            if (strcmp(&params[1], irc_username.c_str()) == 0) {
+        // irc_username is padded with nulls for the settings input
+        const std::string_view username = irc_username.c_str();
+        if (message.nick == username) {
+            if (channel.substr(1) == username) {
                 WriteChat(L"Connected");
                 return 0;
             }
-            swprintf(buf, 599, L"Connected to %s as %S", TextUtils::StringToWString(&params[1]).c_str(), irc_username.c_str());
-            WriteChat(buf);
+            const auto text = std::format(L"Connected to {} as {}", TextUtils::StringToWString(channel.substr(1)), TextUtils::StringToWString(username));
+            WriteChat(text.c_str());
             return 0;
         }
         if (!notify_on_user_join) {
             return 0;
         }
-        swprintf(buf, 599, L"%s joined the channel.", TextUtils::StringToWString(hostd->nick).c_str());
-        WriteChat(buf);
+        const auto text = std::format(L"{} joined the channel.", TextUtils::StringToWString(message.nick));
+        WriteChat(text.c_str());
         return 0;
     }
 
-    // ReSharper disable once CppParameterMayBeConstPtrOrRef
-    int OnLeave(const char* params, irc_reply_data* hostd, void*)
+    int OnLeave(const irc_message& message, void*)
     {
-        if (!params[0] || !show_messages || !notify_on_user_leave) {
+        if (message.param(0).empty() || !show_messages || !notify_on_user_leave) {
             return 0; // Empty msg
         }
-
-        wchar_t buf[600];
-        swprintf(buf, 599, L"%s left the channel.", TextUtils::StringToWString(hostd->nick).c_str());
-        WriteChat(buf);
+        const auto text = std::format(L"{} left the channel.", TextUtils::StringToWString(message.nick));
+        WriteChat(text.c_str());
         return 0;
     }
 
-    // ReSharper disable once CppParameterMayBeConstPtrOrRef
-    int OnConnected(const char* params, irc_reply_data*, void* wparam)
+    int OnConnected(const irc_message& message, void* wparam)
     {
         const auto conn = static_cast<IRC*>(wparam);
         // Set the username to be the connected name.
-        irc_username = params;
-        irc_username.erase(irc_username.find_first_of(' '));
+        irc_username = message.param(0);
         // Channel == username. This could be changed to connect to other Twitch channels/IRC channels.
         if (irc_channel[0] == 0) {
             irc_channel = irc_username;
         }
         char buf[128];
-        Log::Log("%s: Connected %s", irc_alias.c_str(), params);
+        Log::Log("%s: Connected %s", irc_alias.c_str(), irc_username.c_str());
         sprintf(buf, "#%s", irc_channel.c_str());
         conn->join(buf);
-        conn->raw("CAP REQ :twitch.tv/membership twitch.tv/commands\r\n");
+        conn->raw("CAP REQ :twitch.tv/membership twitch.tv/commands twitch.tv/tags\r\n");
         return 0;
     }
 
-    // ReSharper disable once CppParameterMayBeConstPtrOrRef
-    int OnMessage(const char* params, irc_reply_data* hostd, void*)
+    void ShowMessage(const std::string_view nick, const std::string_view text)
     {
-        if (!params[0] || !show_messages) {
-            return 0; // Empty msg
+        if (text.empty() || !show_messages) {
+            return; // Empty msg
         }
-        const std::wstring message_ws = TextUtils::StringToWString(&params[1]);
-        WriteChat(message_ws.c_str(), hostd->nick);
-        Log::Log("Message from %s: %s", hostd->nick, &params[1]);
+        const std::wstring message_ws = TextUtils::StringToWString(text);
+        WriteChat(message_ws.c_str(), nick);
+        Log::Log("Message from %.*s: %.*s", static_cast<int>(nick.size()), nick.data(), static_cast<int>(text.size()), text.data());
+    }
+
+    int OnMessage(const irc_message& message, void*)
+    {
+        // Twitch sends the capitalised name in a tag
+        const auto display_name = irc_unescape_tag_value(message.tag("display-name"));
+        ShowMessage(display_name.empty() ? message.nick : display_name, message.param(1));
         return 0;
     }
 
-    // ReSharper disable once CppParameterMayBeConstPtrOrRef
-    int OnNotice(const char* params, irc_reply_data*, void* conn)
+    int OnNotice(const irc_message& message, void* conn)
     {
-        Log::Log("NOTICE: %s\n", params);
-        if (strcmp(params, "Login authentication failed") == 0) {
+        const auto text = message.param(message.param_count - 1);
+        Log::Log("NOTICE: %.*s\n", static_cast<int>(text.size()), text.data());
+        if (text == "Login authentication failed") {
             Log::Error("Twitch Failed to connect - Invalid Oauth token");
             static_cast<IRC*>(conn)->disconnect();
             return 0;
         }
-        if (params[1] && strcmp(&params[1], "Invalid NICK") == 0) {
+        if (text == "Invalid NICK") {
             Log::Error("Twitch Failed to connect - Invalid Username");
             static_cast<IRC*>(conn)->disconnect();
             return 0;
@@ -299,10 +301,7 @@ namespace {
                 Log::Error("Failed to send message");
             }
             else {
-                irc_reply_data d{};
-                d.nick = const_cast<char*>(irc_username.c_str());
-                content.insert(0, ":");
-                OnMessage(content.c_str(), &d, &irc_conn);
+                ShowMessage(irc_username.c_str(), content);
             }
             status->blocked = true;
         });
@@ -1,5 +1,7 @@
 #include "stdafx.h"
 
+#include <DeltaPatch.h>
+
 #include <Utils/GuiUtils.h>
 #include <GWToolbox.h>
 #include <Logger.h>
@@ -96,6 +98,13 @@ namespace {
                     continue; // This release doesn't have a dll download.
                 }
                 release->download_url = asset.browser_download_url;
+                release->delta_manifest_url.clear();
+                const auto manifest_name = asset.name + ".delta";
+                for (const auto& manifest_asset : js.assets) {
+                    if (manifest_asset.name == manifest_name) {
+                        release->delta_manifest_url = manifest_asset.browser_download_url;
+                    }
+                }
                 release->version = js.tag_name.substr(0, version_number_len);
                 if (js.prerelease) {
                     release->version += js.tag_name.substr(version_number_len + 1);
@@ -129,6 +138,43 @@ namespace {
         return update_available_text;
     }
 
+    // Rebuilds the new dll from the chunks of the current one that haven't changed, fetching only the rest.
+    // Interrupted downloads resume from "<dll>.partial" on the next attempt.
+    bool DeltaUpdate(const std::filesystem::path& dll_path, const std::filesystem::path& current_dll_path, std::string& error)
+    {
+        if (latest_release.delta_manifest_url.empty()) {
+            error = "release has no delta manifest";
+            return false;
+        }
+        std::string manifest_text;
+        if (!Resources::Download(latest_release.delta_manifest_url, manifest_text)) {
+            error = manifest_text;
+            return false;
+        }
+        DeltaPatch::Manifest manifest;
+        if (!DeltaPatch::ParseManifest(manifest_text, manifest)) {
+            error = "failed to parse delta manifest";
+            return false;
+        }
+
+        std::vector<uint8_t> current_dll;
+        if (std::ifstream file(current_dll_path, std::ios::binary); file.is_open()) {
+            current_dll.assign(std::istreambuf_iterator(file), {});
+        }
+
+        const auto& url = latest_release.download_url;
+        DeltaPatch::ApplyStats stats;
+        const auto fetch = [&url](const uint64_t offset, const uint64_t length, std::string& out) {
+            return Resources::DownloadRange(url, offset, length, out);
+        };
+        if (!DeltaPatch::Apply(manifest, current_dll, dll_path, fetch, error, &stats)) {
+            return false;
+        }
+        Log::Log("Delta update: reused %llu bytes, resumed %llu bytes, downloaded %llu of %llu bytes\n",
+                 stats.bytes_reused, stats.bytes_resumed, stats.bytes_fetched, manifest.file_size);
+        return true;
+    }
+
     void DoUpdate()
     {
         Log::Warning("Downloading update...");
@@ -170,10 +216,16 @@ namespace {
         DeleteFileW(dllold.c_str());
         MoveFileW(dllfile, dllold.c_str());
 
-        // 2. download new dll
-        Resources::Instance().Download(
-            dllfile, latest_release.download_url,
-            [wdll = std::wstring(dllfile), dllold](const bool success, const std::wstring& error) -> void {
+        // 2. download new dll, patching the old one if the release has a delta manifest
+        Resources::EnqueueWorkerTask([wdll = std::wstring(dllfile), dllold] {
+            std::string delta_error;
+            bool success = DeltaUpdate(wdll, dllold, delta_error);
+            std::wstring error;
+            if (!success) {
+                Log::Log("Delta update not applied (%s), downloading the full dll\n", delta_error.c_str());
+                success = Resources::Download(wdll, latest_release.download_url, error);
+            }
+            Resources::EnqueueMainTask([wdll, dllold, success, error] {
                 if (success) {
                     step = Success;
                     Log::WarningW(L"Update successful, please restart toolbox.");
@@ -184,6 +236,7 @@ namespace {
                     step = Done;
                 }
             });
+        });
     }
 }
 
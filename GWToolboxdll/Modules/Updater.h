@@ -6,6 +6,7 @@ struct GWToolboxRelease {
     std::string body;
     std::string version;
     std::string download_url;
+    std::string delta_manifest_url; // DeltaPatch manifest for download_url, if the release has one
     uintmax_t size = 0;
 };
 
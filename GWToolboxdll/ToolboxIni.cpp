@@ -28,25 +28,29 @@ static std::string_view trim(std::string_view s) {
 // ===========================================================================
 
 std::vector<FastIniEntry>* FastIniSection::find(std::string_view key) {
-    auto it = keys.find(std::string(key));
+    auto it = keys.find(key);
     return it != keys.end() ? &it->second : nullptr;
 }
 
 const std::vector<FastIniEntry>* FastIniSection::find(std::string_view key) const {
-    auto it = keys.find(std::string(key));
+    auto it = keys.find(key);
     return it != keys.end() ? &it->second : nullptr;
 }
 
 std::pair<FastIniEntry&, bool> FastIniSection::findOrCreate(std::string_view key, bool multiKey) {
-    auto [it, inserted] = keys.try_emplace(std::string(key));
+    auto it = keys.find(key);
+    if (it == keys.end())
+        it = keys.emplace(std::string(key), std::vector<FastIniEntry>{}).first;
     auto& vec = it->second;
-    if (inserted || vec.empty()) {
+    if (vec.empty()) {
         vec.emplace_back();
+        MarkDirty();
         return {vec.back(), true};
     }
     if (multiKey) {
         // Append a new slot for this duplicate key
         vec.emplace_back();
+        MarkDirty();
         return {vec.back(), false}; // section existed, key existed → SI_UPDATED
     }
     // Single-key mode: overwrite the first value
@@ -121,34 +125,36 @@ bool FastIniSection::GetBool(std::string_view key, bool def) const {
 // FastIniSection – typed setters (always write the first/only value)
 // ===========================================================================
 
-SI_Error FastIniSection::SetValue(std::string_view key, const char* value) {
+// Only touches the stored text (and dirties the section) when it actually changes,
+// so re-saving unchanged settings costs a lookup and a compare.
+SI_Error FastIniSection::assign(std::string_view key, std::string_view raw, FastIniCachedValue cached) {
     auto [e, inserted] = findOrCreate(key);
-    e.raw    = value ? value : "";
-    e.cached = std::monostate{};
+    if (e.raw != raw) {
+        e.raw.assign(raw);
+        MarkDirty();
+    }
+    e.cached = cached;
     return inserted ? SI_INSERTED : SI_UPDATED;
 }
 
+SI_Error FastIniSection::SetValue(std::string_view key, const char* value) {
+    return assign(key, value ? value : "", std::monostate{});
+}
+
 SI_Error FastIniSection::SetLong(std::string_view key, long value) {
-    auto [e, inserted] = findOrCreate(key);
-    e.raw    = std::to_string(value);
-    e.cached = value;
-    return inserted ? SI_INSERTED : SI_UPDATED;
+    char buf[32];
+    auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+    return assign(key, std::string_view(buf, static_cast<size_t>(ptr - buf)), value);
 }
 
 SI_Error FastIniSection::SetDouble(std::string_view key, double value, int precision) {
-    auto [e, inserted] = findOrCreate(key);
     char buf[64];
-    std::snprintf(buf, sizeof(buf), "%.*g", precision, value);
-    e.raw    = buf;
-    e.cached = value;
-    return inserted ? SI_INSERTED : SI_UPDATED;
+    const int len = std::snprintf(buf, sizeof(buf), "%.*g", precision, value);
+    return assign(key, std::string_view(buf, len > 0 ? static_cast<size_t>(len) : 0), value);
 }
 
 SI_Error FastIniSection::SetBool(std::string_view key, bool value) {
-    auto [e, inserted] = findOrCreate(key);
-    e.raw    = value ? "true" : "false";
-    e.cached = value;
-    return inserted ? SI_INSERTED : SI_UPDATED;
+    return assign(key, value ? "true" : "false", value);
 }
 
 // ===========================================================================
@@ -169,7 +175,11 @@ bool FastIniSection::HasKey(std::string_view key) const {
 }
 
 bool FastIniSection::Delete(std::string_view key) {
-    return keys.erase(std::string(key)) > 0;
+    auto it = keys.find(key);
+    if (it == keys.end()) return false;
+    keys.erase(it);
+    MarkDirty();
+    return true;
 }
 
 void FastIniSection::GetAllKeys(TNamesDepend& out) const {
@@ -178,6 +188,22 @@ void FastIniSection::GetAllKeys(TNamesDepend& out) const {
             out.push_back(SI_Entry(k.c_str()));
 }
 
+const std::string& FastIniSection::SerializedBody() const {
+    if (m_bodyValid) return m_body;
+    size_t total = 0;
+    for (auto& [k, vec] : keys)
+        for (auto& e : vec)
+            total += k.size() + 1 + e.raw.size() + 1; // key=value\n
+    m_body.clear();
+    m_body.reserve(total);
+    for (auto& [k, vec] : keys)
+        for (auto& e : vec) {
+            m_body += k; m_body += '='; m_body += e.raw; m_body += '\n';
+        }
+    m_bodyValid = true;
+    return m_body;
+}
+
 // ===========================================================================
 // ToolboxIni – I/O
 // ===========================================================================
@@ -222,16 +248,16 @@ void ToolboxIni::LoadBuffer(std::string_view buf) {
         parseSection(sec, sp.text);
     }
     // Reset() already dirtied the cache; no need to dirty again here.
+    // Freshly parsed content matches its source, so nothing is dirty.
+    MarkSaved();
 }
 
-SI_Error ToolboxIni::SaveFile(const std::filesystem::path& path, bool addUtf8BOM) const {
-    // Pre-calculate total size to avoid reallocations.
+std::string ToolboxIni::Serialize(bool addUtf8BOM) const {
+    // Pre-calculate total size to avoid reallocations. Clean sections reuse their cached body.
     size_t total = addUtf8BOM ? 3 : 0;
     for (auto& [secName, sec] : m_sections) {
         total += 1 + secName.size() + 2; // '[' + name + "]\n"
-        for (auto& [k, vec] : sec.keys)
-            for (auto& e : vec)
-                total += k.size() + 1 + e.raw.size() + 1; // key=value\n
+        total += sec.SerializedBody().size();
         total += 1; // blank line between sections
     }
 
@@ -246,12 +272,25 @@ SI_Error ToolboxIni::SaveFile(const std::filesystem::path& path, bool addUtf8BOM
 
     for (auto& [secName, sec] : m_sections) {
         buf += '['; buf += secName; buf += "]\n";
-        for (auto& [k, vec] : sec.keys)
-            for (auto& e : vec) {
-                buf += k; buf += '='; buf += e.raw; buf += '\n';
-            }
+        buf += sec.SerializedBody();
         buf += '\n';
     }
+    return buf;
+}
+
+bool ToolboxIni::IsDirty() const {
+    if (m_structureDirty) return true;
+    return std::ranges::any_of(m_sections, [](const auto& it) { return it.second.IsDirty(); });
+}
+
+void ToolboxIni::MarkSaved() const {
+    m_structureDirty = false;
+    for (auto& [_, sec] : m_sections)
+        sec.m_dirty = false;
+}
+
+SI_Error ToolboxIni::SaveFile(const std::filesystem::path& path, bool addUtf8BOM) const {
+    const std::string buf = Serialize(addUtf8BOM);
 
 #ifdef _WIN32
     std::FILE* f = _wfopen(path.c_str(), L"wb");
@@ -265,6 +304,7 @@ SI_Error ToolboxIni::SaveFile(const std::filesystem::path& path, bool addUtf8BOM
 }
 
 void ToolboxIni::Reset() {
+    m_structureDirty = m_structureDirty || !m_sections.empty();
     m_sections.clear();
     m_sectionNameCache.clear();
     m_sectionCacheDirty = true;
@@ -345,11 +385,13 @@ void ToolboxIni::parseSection(FastIniSection& sec, std::string_view text) const
                     }
                 }
                 if (!k.empty()) {
-                    auto [it, inserted] = sec.keys.try_emplace(std::string(k));
-                    if (inserted || m_multiKey)
-                        it->second.emplace_back(std::string(v));
+                    auto it = sec.keys.find(k);
+                    if (it == sec.keys.end())
+                        sec.keys.emplace(std::string(k), std::vector<FastIniEntry>{}).first->second.emplace_back(v);
+                    else if (m_multiKey || it->second.empty())
+                        it->second.emplace_back(v);
                     else
-                        it->second[0] = FastIniEntry(std::string(v)); // overwrite in single-key mode
+                        it->second[0] = FastIniEntry(v); // overwrite in single-key mode
                 }
             }
         }
@@ -396,18 +438,28 @@ bool ToolboxIni::LoadFileRaw(const std::filesystem::path& path)
 // ===========================================================================
 
 FastIniSection* ToolboxIni::GetSection(std::string_view name) {
-    auto it = m_sections.find(std::string(name));
+    auto it = m_sections.find(name);
     return it != m_sections.end() ? &it->second : nullptr;
 }
 
 const FastIniSection* ToolboxIni::GetSection(std::string_view name) const {
-    auto it = m_sections.find(std::string(name));
+    auto it = m_sections.find(name);
     return it != m_sections.end() ? &it->second : nullptr;
 }
 
 FastIniSection& ToolboxIni::GetOrCreateSection(std::string_view name) {
-    auto [it, inserted] = m_sections.emplace(std::string(name), FastIniSection{});
-    if (inserted) m_sectionCacheDirty = true;
+    bool inserted = false;
+    return sectionForWrite(name, inserted);
+}
+
+FastIniSection& ToolboxIni::sectionForWrite(std::string_view name, bool& inserted) {
+    auto it = m_sections.find(name);
+    inserted = it == m_sections.end();
+    if (inserted) {
+        it = m_sections.emplace(std::string(name), FastIniSection{}).first;
+        m_sectionCacheDirty = true;
+        m_structureDirty = true;
+    }
     return it->second;
 }
 
@@ -430,30 +482,26 @@ bool ToolboxIni::GetBoolValue(const char* section, const char* key, bool def) co
 
 SI_Error ToolboxIni::SetValue(const char* section, const char* key, const char* value,
                                const char*, bool) {
-    auto [sec, secInserted] = m_sections.try_emplace(std::string(section));
-    if (secInserted) m_sectionCacheDirty = true;
-    SI_Error r = sec->second.SetValue(key, value);
+    bool secInserted = false;
+    SI_Error r = sectionForWrite(section, secInserted).SetValue(key, value);
     return secInserted ? SI_INSERTED : r;
 }
 SI_Error ToolboxIni::SetLongValue(const char* section, const char* key, long value,
                                    const char*, bool, bool) {
-    auto [sec, secInserted] = m_sections.try_emplace(std::string(section));
-    if (secInserted) m_sectionCacheDirty = true;
-    SI_Error r = sec->second.SetLong(key, value);
+    bool secInserted = false;
+    SI_Error r = sectionForWrite(section, secInserted).SetLong(key, value);
     return secInserted ? SI_INSERTED : r;
 }
 SI_Error ToolboxIni::SetDoubleValue(const char* section, const char* key, double value,
                                      const char*, bool) {
-    auto [sec, secInserted] = m_sections.try_emplace(std::string(section));
-    if (secInserted) m_sectionCacheDirty = true;
-    SI_Error r = sec->second.SetDouble(key, value);
+    bool secInserted = false;
+    SI_Error r = sectionForWrite(section, secInserted).SetDouble(key, value);
     return secInserted ? SI_INSERTED : r;
 }
 SI_Error ToolboxIni::SetBoolValue(const char* section, const char* key, bool value,
                                    const char*, bool) {
-    auto [sec, secInserted] = m_sections.try_emplace(std::string(section));
-    if (secInserted) m_sectionCacheDirty = true;
-    SI_Error r = sec->second.SetBool(key, value);
+    bool secInserted = false;
+    SI_Error r = sectionForWrite(section, secInserted).SetBool(key, value);
     return secInserted ? SI_INSERTED : r;
 }
 
@@ -477,6 +525,7 @@ bool ToolboxIni::Delete(const char* section, const char* key, bool) {
     if (key == nullptr) {
         m_sections.erase(it);
         m_sectionCacheDirty = true;
+        m_structureDirty = true;
         return true;
     }
     return it->second.Delete(key);
@@ -11,6 +11,8 @@
 #include <variant>
 #include <vector>
 
+#include <Utils/StringMap.h>
+
 // ---------------------------------------------------------------------------
 // ToolboxIni – a fast INI parser designed for GWToolbox++.
 //
@@ -30,6 +32,11 @@
 //    and the typed getters address [0] directly.
 //  - GetAllSections is O(n) on first call after a structural change, then
 //    O(n) copy-only on repeated calls (no map traversal).
+//  - Maps use transparent hashing, so lookups by const char*/string_view
+//    never build a temporary std::string; only inserting a new key does.
+//  - Setters only dirty a section when the stored text actually changes.
+//    Each section caches its serialized body, so saving re-serializes just
+//    the dirty sections, and IsDirty() lets callers skip the write entirely.
 // ---------------------------------------------------------------------------
 
 // ---------------------------------------------------------------------------
@@ -92,7 +99,7 @@ struct FastIniEntry {
 // element, multi-value keys have more.
 // ---------------------------------------------------------------------------
 struct FastIniSection {
-    std::unordered_map<std::string, std::vector<FastIniEntry>> keys;
+    StringMap<std::vector<FastIniEntry>> keys;
 
     // Typed getters – operate on the first value for the key.
     const char* GetValue (std::string_view key, const char* def = "")   const;
@@ -113,7 +120,22 @@ struct FastIniSection {
     bool Delete(std::string_view key);
     void GetAllKeys(TNamesDepend& out) const;
 
+    // Changed since the last ToolboxIni::MarkSaved(). Call MarkDirty() after editing `keys` directly.
+    bool IsDirty() const { return m_dirty; }
+    void MarkDirty() { m_dirty = true; m_bodyValid = false; }
+
+    // "key=value\n" lines for this section; cached until the section changes.
+    const std::string& SerializedBody() const;
+
 private:
+    friend class ToolboxIni;
+
+    mutable bool        m_dirty     = false;
+    mutable bool        m_bodyValid = false;
+    mutable std::string m_body;
+
+    SI_Error assign(std::string_view key, std::string_view raw, FastIniCachedValue cached);
+
     // Returns {first entry, wasNewKey}. Appends if multiKey, replaces if not.
     std::pair<FastIniEntry&, bool> findOrCreate(std::string_view key, bool multiKey = false);
     std::vector<FastIniEntry>*       find(std::string_view key);
@@ -142,6 +164,13 @@ public:
     void LoadBuffer(std::string_view buf);
 
     SI_Error SaveFile(const std::filesystem::path& path, bool addUtf8BOM = false) const;
+    // The document as it would be written by SaveFile.
+    std::string Serialize(bool addUtf8BOM = false) const;
+
+    // True if anything changed since the document was loaded or last marked as saved, or if it never was.
+    bool IsDirty() const;
+    // Call once the current contents have been written to location_on_disk.
+    void MarkSaved() const;
 
     void Reset();
 
@@ -181,8 +210,11 @@ public:
     FastIniSection&       GetOrCreateSection(std::string_view name);
 
 private:
-    std::unordered_map<std::string, FastIniSection> m_sections;
-    bool                                            m_multiKey = false;
+    StringMap<FastIniSection> m_sections;
+    bool                       m_multiKey = false;
+    // Sections added or removed since the last load/save. A document that has never been loaded or saved doesn't
+    // match anything on disk, so it starts out dirty.
+    mutable bool               m_structureDirty = true;
 
     // Cache for GetAllSections – rebuilt lazily after any structural change.
     // Stores const char* into m_sections key strings, which are stable for
@@ -192,6 +224,7 @@ private:
     mutable bool                     m_sectionCacheDirty = true;
 
     void rebuildSectionCache() const;
+    FastIniSection& sectionForWrite(std::string_view name, bool& inserted);
 
     struct SectionSpan { std::string name; std::string_view text; };
     static std::vector<SectionSpan> splitSections(std::string_view buf);
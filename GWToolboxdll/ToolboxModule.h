@@ -1,5 +1,7 @@
 #pragma once
 
+#include <Utils/TraceProfiler.h>
+
 using SectionDrawCallback = std::function<void(const std::string& section, bool is_showing)>;
 class ToolboxModule;
 class ToolboxIni;
@@ -87,6 +89,9 @@ public:
 
     uint64_t last_update_time_us_ = 0;
     uint64_t last_draw_time_us_ = 0;
+    // Tracer zones for Update()/Draw(), registered the first time the module is profiled
+    TraceProfiler::ZoneId update_zone_id_ = TraceProfiler::InvalidZone;
+    TraceProfiler::ZoneId draw_zone_id_ = TraceProfiler::InvalidZone;
 
 protected:
     // Weighting used to decide where to position the DrawSettingInternal() for this module. Useful when more than 1 module has the same SettingsName().
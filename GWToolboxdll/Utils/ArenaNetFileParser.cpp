@@ -59,12 +59,29 @@ namespace ArenaNetFileParser {
         file_id = FileHashToFileId(file_hash);
         data_size = 0;
         data.clear();
-        if (!GwDatTextureModule::ReadDatFile(file_hash, &bytes, stream_id)) return false;
-        return parse(bytes);
+        // Parse even if the read fails, so nothing is left indexed from the previous file
+        const bool read = GwDatTextureModule::ReadDatFile(file_hash, &bytes, stream_id);
+        return parse(bytes) && read;
+    }
+    bool ArenaNetFile::parse(std::vector<uint8_t>& _data)
+    {
+        chunks.clear();
+        if (!GameAssetFile::parse(_data))
+            return false;
+        size_t offset = 5;
+        while (offset + sizeof(Chunk) <= data_size) {
+            Chunk header;
+            memcpy(&header, &data[offset], sizeof(header));
+            if (header.chunk_size > data_size - offset - sizeof(Chunk))
+                break;
+            chunks.push_back({header.chunk_id, static_cast<uint32_t>(offset), header.chunk_size});
+            offset += sizeof(Chunk) + header.chunk_size;
+        }
+        return true;
     }
     const uint8_t ArenaNetFile::getFFNAType() const
     {
-        return (uint8_t)data[4];
+        return data_size > 4 ? data[4] : 0;
     }
     const bool ArenaNetFile::isValid() {
         return GameAssetFile::isValid() && strncmp(fileType(), "ffna", 4) == 0;
@@ -72,18 +89,23 @@ namespace ArenaNetFileParser {
     const bool ATexFile::isValid() { 
         return GameAssetFile::isValid() && strncmp(fileType(), "ATEX", 4) == 0; 
     }
-    const Chunk* ArenaNetFile::FindChunk(ChunkType chunk_type)
+    const ChunkEntry* ArenaNetFile::FindEntry(ChunkType chunk_type) const
     {
-        ASSERT(isValid());
-        size_t offset = 5;
-        // Parse chunk headers and record their locations
-        while (offset < data_size) {
-            const auto chunk = (Chunk*)&data[offset];
-            if (chunk->chunk_id == chunk_type)
-                return chunk;
-            offset += chunk->chunk_size + 8;
+        const auto found = std::ranges::find(chunks, chunk_type, &ChunkEntry::chunk_id);
+        return found == chunks.end() ? nullptr : &*found;
+    }
+    const Chunk* ArenaNetFile::FindChunk(ChunkType chunk_type) const
+    {
+        const auto entry = FindEntry(chunk_type);
+        return entry ? reinterpret_cast<const Chunk*>(data.data() + entry->offset) : nullptr;
+    }
+    std::vector<std::span<const uint8_t>> ArenaNetFile::FindChunks(ChunkType chunk_type) const
+    {
+        std::vector<std::span<const uint8_t>> out;
+        for (const auto& entry : chunks) {
+            if (entry.chunk_id == chunk_type)
+                out.emplace_back(data.data() + entry.offset + sizeof(Chunk), entry.size);
         }
-        return nullptr;
+        return out;
     }
 }
-
@@ -1,5 +1,7 @@
 #pragma once
+#include <algorithm>
 #include <cstdint>
+#include <span>
 #include <vector>
 
 // ArenaNet File Format (FFNA) Parser
@@ -218,6 +220,8 @@ enum class ChunkType : uint32_t {
         uint32_t num_filenames;
         FileName filenames[];
         // FileName array follows...
+        // num_filenames, capped to what fits in the chunk
+        size_t count() const { return std::min<size_t>(num_filenames, (chunk_size - 8) / sizeof(FileName)); }
     };
     struct FileNamesChunkWithoutLength : Chunk {
         FileName filenames[];
@@ -250,17 +254,42 @@ enum class ChunkType : uint32_t {
         bool readFromDat(const uint32_t file_id, uint32_t stream_id = 0);
     };
 
+    // Where a chunk sits in an ArenaNetFile
+    struct ChunkEntry {
+        ChunkType chunk_id;
+        uint32_t offset; // Of the chunk header, from the start of the file
+        uint32_t size;   // Chunk::chunk_size
+    };
+
     struct ArenaNetFile : GameAssetFile {
 
         // Copy parent constructors
         ArenaNetFile() : GameAssetFile() {}
         ArenaNetFile(std::vector<uint8_t>& _data) : ArenaNetFile() { parse(_data); }
 
+        // Also indexes the chunk headers, once; a chunk that runs past the end of the file ends the index
+        bool parse(std::vector<uint8_t>& _data) override;
+
         const uint8_t getFFNAType() const;
 
         const bool isValid() override;
-        // Get chunk by type
-        const Chunk* FindChunk(ChunkType chunk_type);
+        // Get chunk by type; the first one if there are several
+        const Chunk* FindChunk(ChunkType chunk_type) const;
+        // Get chunk by type as T, or nullptr if it's too short to hold a T
+        template <typename T>
+        const T* FindChunkAs(const ChunkType chunk_type) const
+        {
+            const auto entry = FindEntry(chunk_type);
+            return entry && sizeof(Chunk) + entry->size >= sizeof(T) ? reinterpret_cast<const T*>(data.data() + entry->offset) : nullptr;
+        }
+        // Data (not including id or size fields) of every chunk of this type, in file order
+        std::vector<std::span<const uint8_t>> FindChunks(ChunkType chunk_type) const;
+        const std::vector<ChunkEntry>& GetChunks() const { return chunks; }
+
+    private:
+        const ChunkEntry* FindEntry(ChunkType chunk_type) const;
+
+        std::vector<ChunkEntry> chunks;
     };
 
     struct ATexFile : GameAssetFile {
@@ -0,0 +1,273 @@
+#include "stdafx.h"
+
+#include <bit>
+
+#include <GWCA/Managers/StoCMgr.h>
+#include <GWCA/Packets/StoC.h>
+#include <GWCA/Utilities/Hook.h>
+
+#include <Utils/CombatEvents.h>
+
+namespace {
+    using namespace GW::Packet::StoC;
+    using CombatEvents::PacketKind;
+    using CombatEvents::RawPacket;
+    using CombatEvents::Subscriber;
+
+    std::mutex subscribers_mutex;
+    std::vector<Subscriber*> subscribers;
+
+    GW::HookEntry GenericValue_Entry;
+    GW::HookEntry GenericValueTarget_Entry;
+    GW::HookEntry GenericFloat_Entry;
+    GW::HookEntry GenericModifier_Entry;
+    GW::HookEntry AgentProjectileLaunched_Entry;
+    GW::HookEntry AgentState_Entry;
+
+    float BitsToFloat(const uint32_t bits)
+    {
+        return std::bit_cast<float>(bits);
+    }
+
+    uint32_t FloatToBits(const float value)
+    {
+        return std::bit_cast<uint32_t>(value);
+    }
+
+    // Value ids where GenericValueTarget's "caster" field is the victim and "target" is the one acting
+    bool IsActionValueId(const uint32_t value_id)
+    {
+        switch (value_id) {
+            case GenericValueID::attack_started:
+            case GenericValueID::attack_skill_activated:
+            case GenericValueID::attack_skill_finished:
+            case GenericValueID::instant_skill_activated:
+            case GenericValueID::skill_activated:
+            case GenericValueID::skill_finished:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool DecodeValue(const RawPacket& packet, CombatEvent& out)
+    {
+        switch (packet.value_id) {
+            case GenericValueID::melee_attack_finished:
+                out.type = CombatEventType::AttackFinished;
+                break;
+            case GenericValueID::attack_stopped:
+                out.type = CombatEventType::AttackStopped;
+                break;
+            case GenericValueID::attack_started:
+                out.type = CombatEventType::AttackStarted;
+                break;
+            case GenericValueID::add_effect:
+                out.type = CombatEventType::EffectAdded;
+                break;
+            case GenericValueID::remove_effect:
+                out.type = CombatEventType::EffectRemoved;
+                break;
+            case GenericValueID::interrupted:
+                out.type = CombatEventType::Interrupted;
+                break;
+            case GenericValueID::attack_skill_finished:
+                out.type = CombatEventType::AttackSkillFinished;
+                break;
+            case GenericValueID::instant_skill_activated:
+                out.type = CombatEventType::InstantSkillActivated;
+                break;
+            case GenericValueID::attack_skill_stopped:
+                out.type = CombatEventType::AttackSkillStopped;
+                break;
+            case GenericValueID::attack_skill_activated:
+                out.type = CombatEventType::AttackSkillActivated;
+                break;
+            case GenericValueID::energygain:
+                out.type = CombatEventType::EnergyGained;
+                break;
+            case GenericValueID::skill_finished:
+                out.type = CombatEventType::SkillFinished;
+                break;
+            case GenericValueID::skill_stopped:
+                out.type = CombatEventType::SkillStopped;
+                break;
+            case GenericValueID::skill_activated:
+                out.type = CombatEventType::SkillActivated;
+                break;
+            default:
+                return false;
+        }
+        out.value = packet.bits;
+        out.agent_id = packet.agent_id;
+        out.target_id = packet.other_id;
+        if (packet.kind == PacketKind::GenericValueTarget && IsActionValueId(packet.value_id)) {
+            std::swap(out.agent_id, out.target_id);
+        }
+        return true;
+    }
+
+    bool DecodeFloat(const RawPacket& packet, CombatEvent& out)
+    {
+        out.amount = BitsToFloat(packet.bits);
+        out.agent_id = packet.agent_id;
+        out.target_id = packet.other_id;
+        switch (packet.value_id) {
+            case GenericValueID::armorignoring:
+                out.flags |= CombatEvent::ArmorIgnoring;
+                [[fallthrough]];
+            case GenericValueID::damage:
+            case GenericValueID::critical:
+                if (packet.value_id == GenericValueID::critical) {
+                    out.flags |= CombatEvent::Critical;
+                }
+                if (out.amount == 0.f) {
+                    return false;
+                }
+                out.type = out.amount < 0.f ? CombatEventType::Damage : CombatEventType::Heal;
+                return true;
+            case GenericValueID::casttime:
+                out.type = CombatEventType::CastTime;
+                return true;
+            case GenericValueID::energy_spent:
+                out.type = CombatEventType::EnergySpent;
+                return true;
+            case GenericValueID::knocked_down:
+                out.type = CombatEventType::KnockedDown;
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    void OnGenericValue(GW::HookStatus*, const GenericValue* packet)
+    {
+        CombatEvents::Publish({PacketKind::GenericValue, packet->value_id, packet->agent_id, 0, packet->value});
+    }
+
+    void OnGenericValueTarget(GW::HookStatus*, const GenericValueTarget* packet)
+    {
+        CombatEvents::Publish({PacketKind::GenericValueTarget, packet->Value_id, packet->caster, packet->target, packet->value});
+    }
+
+    void OnGenericFloat(GW::HookStatus*, const GenericFloat* packet)
+    {
+        CombatEvents::Publish({PacketKind::GenericFloat, packet->type, packet->agent_id, 0, FloatToBits(packet->value)});
+    }
+
+    void OnGenericModifier(GW::HookStatus*, const GenericModifier* packet)
+    {
+        CombatEvents::Publish({PacketKind::GenericModifier, packet->type, packet->cause_id, packet->target_id, FloatToBits(packet->value)});
+    }
+
+    void OnAgentProjectileLaunched(GW::HookStatus*, const AgentProjectileLaunched* packet)
+    {
+        CombatEvents::Publish({PacketKind::ProjectileLaunched, 0, packet->agent_id, 0, packet->is_attack});
+    }
+
+    void OnAgentState(GW::HookStatus*, const AgentState* packet)
+    {
+        CombatEvents::Publish({PacketKind::AgentState, 0, packet->agent_id, 0, packet->state});
+    }
+
+    void RegisterHooks()
+    {
+        constexpr int altitude = 0x8000; // After the game has handled the packet
+        GW::StoC::RegisterPacketCallback<GenericValue>(&GenericValue_Entry, OnGenericValue, altitude);
+        GW::StoC::RegisterPacketCallback<GenericValueTarget>(&GenericValueTarget_Entry, OnGenericValueTarget, altitude);
+        GW::StoC::RegisterPacketCallback<GenericFloat>(&GenericFloat_Entry, OnGenericFloat, altitude);
+        GW::StoC::RegisterPacketCallback<GenericModifier>(&GenericModifier_Entry, OnGenericModifier, altitude);
+        GW::StoC::RegisterPacketCallback<AgentProjectileLaunched>(&AgentProjectileLaunched_Entry, OnAgentProjectileLaunched, altitude);
+        GW::StoC::RegisterPacketCallback<AgentState>(&AgentState_Entry, OnAgentState, altitude);
+    }
+
+    void RemoveHooks()
+    {
+        GW::StoC::RemoveCallbacks(&GenericValue_Entry);
+        GW::StoC::RemoveCallbacks(&GenericValueTarget_Entry);
+        GW::StoC::RemoveCallbacks(&GenericFloat_Entry);
+        GW::StoC::RemoveCallbacks(&GenericModifier_Entry);
+        GW::StoC::RemoveCallbacks(&AgentProjectileLaunched_Entry);
+        GW::StoC::RemoveCallbacks(&AgentState_Entry);
+    }
+}
+
+bool CombatEvents::Decode(const RawPacket& packet, CombatEvent& out)
+{
+    out = {};
+    switch (packet.kind) {
+        case PacketKind::GenericValue:
+        case PacketKind::GenericValueTarget:
+            return DecodeValue(packet, out);
+        case PacketKind::GenericFloat:
+        case PacketKind::GenericModifier:
+            return DecodeFloat(packet, out);
+        case PacketKind::ProjectileLaunched:
+            out.type = CombatEventType::ProjectileLaunched;
+            out.agent_id = packet.agent_id;
+            out.value = packet.bits;
+            return true;
+        case PacketKind::AgentState:
+            out.type = CombatEventType::AgentState;
+            out.agent_id = packet.agent_id;
+            out.value = packet.bits;
+            return true;
+    }
+    return false;
+}
+
+void CombatEvents::Publish(const RawPacket& packet)
+{
+    CombatEvent event;
+    if (!Decode(packet, event)) {
+        return;
+    }
+    std::lock_guard lock(subscribers_mutex);
+    for (const auto subscriber : subscribers) {
+        if (subscriber->Wants(event.type)) {
+            subscriber->Push(event);
+        }
+    }
+}
+
+CombatEvents::Subscriber::~Subscriber()
+{
+    Unsubscribe();
+}
+
+void CombatEvents::Subscriber::Subscribe()
+{
+    std::lock_guard lock(subscribers_mutex);
+    if (subscribed) {
+        return;
+    }
+    subscribed = true;
+    if (subscribers.empty()) {
+        RegisterHooks();
+    }
+    subscribers.push_back(this);
+}
+
+void CombatEvents::Subscriber::Unsubscribe()
+{
+    std::lock_guard lock(subscribers_mutex);
+    if (!subscribed) {
+        return;
+    }
+    subscribed = false;
+    std::erase(subscribers, this);
+    if (subscribers.empty()) {
+        RemoveHooks();
+    }
+}
+
+void CombatEvents::Subscriber::Push(const CombatEvent& event)
+{
+    const auto h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= capacity) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    events[h & (capacity - 1)] = event;
+    head.store(h + 1, std::memory_order_release);
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/*
+One place that turns the combat-related StoC packets into typed events.
+
+GenericValue, GenericValueTarget, GenericFloat and GenericModifier carry a value id that says what the other fields
+mean (and for some ids, that caster and target are swapped). Each packet is decoded exactly once here and the
+resulting CombatEvent is pushed to every subscriber's queue. Subscribers drain their queue from their own Update,
+so packet handling stays cheap and consumers don't need locks.
+
+A subscriber that handles other packets whose effect depends on the order of events (e.g. resetting totals on map
+load) should Push() a Marker from that packet's handler and act on it when it's drained, rather than acting straight
+away and getting ahead of events still in the queue.
+
+    CombatEvents::Subscriber events{CombatEvents::TypeMask(CombatEventType::Damage, CombatEventType::Heal)};
+    events.Subscribe();             // Initialize()
+    events.Drain([](const CombatEvent& e) { ... }); // Update()
+    events.Unsubscribe();           // Terminate()
+*/
+
+enum class CombatEventType : uint8_t {
+    Damage,               // amount: fraction of target's max hp (negative)
+    Heal,                 // amount: fraction of target's max hp (positive)
+    AttackStarted,        // agent attacks target
+    AttackFinished,
+    AttackStopped,
+    SkillActivated,       // value: skill id. Cast start.
+    InstantSkillActivated,// value: skill id
+    AttackSkillActivated, // value: skill id
+    SkillFinished,
+    SkillStopped,
+    AttackSkillFinished,
+    AttackSkillStopped,
+    Interrupted,          // Follows <action>Stopped
+    CastTime,             // amount: non-standard cast time of the skill about to be activated, in seconds
+    EffectAdded,          // value: effect id
+    EffectRemoved,        // value: effect id
+    EnergyGained,         // value: raw packet value
+    EnergySpent,          // amount: fraction of max energy
+    KnockedDown,          // amount: duration in seconds
+    ProjectileLaunched,   // value: 1 if the projectile is a ranged attack
+    AgentState,           // value: agent state flags
+    Marker,               // value and other fields: up to the subscriber. Never published; see Push()
+    Count
+};
+
+struct CombatEvent {
+    CombatEventType type = CombatEventType::Count;
+    uint8_t flags = 0;      // CombatEvent::Critical etc
+    uint32_t agent_id = 0;  // Who acted: attacker, caster, healer, or the agent the value is about
+    uint32_t target_id = 0; // Who was acted on; 0 if the packet had no target
+    uint32_t value = 0;
+    float amount = 0.f;
+
+    static constexpr uint8_t Critical = 1 << 0;
+    static constexpr uint8_t ArmorIgnoring = 1 << 1;
+
+    [[nodiscard]] bool IsCritical() const { return flags & Critical; }
+    [[nodiscard]] bool IsArmorIgnoring() const { return flags & ArmorIgnoring; }
+};
+static_assert(sizeof(CombatEvent) == 20);
+
+namespace CombatEvents {
+    // Which packet a RawPacket came from; the decoder needs it to know field order and value type
+    enum class PacketKind : uint8_t {
+        GenericValue,
+        GenericValueTarget,
+        GenericFloat,
+        GenericModifier,
+        ProjectileLaunched,
+        AgentState,
+    };
+
+    // The fields every combat packet boils down to. agent_id is the packet's agent/caster/cause field and other_id
+    // its target field, as GWCA names them; for most GenericValueTarget ids those names are backwards, which Decode sorts out.
+    struct RawPacket {
+        PacketKind kind;
+        uint32_t value_id = 0;
+        uint32_t agent_id = 0;
+        uint32_t other_id = 0;
+        uint32_t bits = 0; // uint32_t value, or the bits of a float value
+    };
+
+    // Returns false if the packet isn't something we publish. Pure; touches no game state.
+    bool Decode(const RawPacket& packet, CombatEvent& out);
+
+    using TypeMaskBits = uint32_t;
+    static_assert(static_cast<size_t>(CombatEventType::Count) <= 32);
+
+    template <typename... Types>
+    constexpr TypeMaskBits TypeMask(Types... types)
+    {
+        return ((TypeMaskBits{1} << static_cast<uint32_t>(types)) | ...);
+    }
+    constexpr TypeMaskBits AllTypes = (TypeMaskBits{1} << static_cast<uint32_t>(CombatEventType::Count)) - 1;
+
+    // Single producer (packet thread), single consumer (the owner's Update)
+    class Subscriber {
+    public:
+        explicit Subscriber(const TypeMaskBits _mask = AllTypes)
+            : mask(_mask) {}
+        ~Subscriber();
+        Subscriber(const Subscriber&) = delete;
+        Subscriber& operator=(const Subscriber&) = delete;
+
+        // Hooks the packets on first subscription
+        void Subscribe();
+        void Unsubscribe();
+
+        // Pops every queued event in packet order
+        template <typename Fn>
+        size_t Drain(Fn&& fn)
+        {
+            auto t = tail.load(std::memory_order_relaxed);
+            const auto h = head.load(std::memory_order_acquire);
+            const auto count = h - t;
+            for (; t != h; t++) {
+                fn(events[t & (capacity - 1)]);
+            }
+            tail.store(t, std::memory_order_release);
+            return count;
+        }
+
+        [[nodiscard]] uint64_t GetDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+        // Queues an event as if it came from a packet; used by Publish and for replaying recorded packets
+        void Push(const CombatEvent& event);
+
+        [[nodiscard]] bool Wants(const CombatEventType type) const { return mask & (TypeMaskBits{1} << static_cast<uint32_t>(type)); }
+
+    private:
+        static constexpr uint32_t capacity = 1 << 12;
+        std::array<CombatEvent, capacity> events{};
+        std::atomic<uint32_t> head = 0;
+        std::atomic<uint32_t> tail = 0;
+        std::atomic<uint64_t> dropped = 0;
+        TypeMaskBits mask;
+        bool subscribed = false;
+    };
+
+    // Decodes a packet and queues the event for every subscriber that wants it
+    void Publish(const RawPacket& packet);
+}
@@ -0,0 +1,175 @@
+#include "stdafx.h"
+
+#include <Utils/CompletionMatrix.h>
+
+#include <algorithm>
+#include <bit>
+
+uint32_t CompletionMatrix::AddRow()
+{
+    if (!free_rows.empty()) {
+        const auto row = free_rows.back();
+        free_rows.pop_back();
+        return row;
+    }
+    const auto row = row_count++;
+    if (row_count > words_per_column * 64) {
+        GrowRows(row_count);
+    }
+    return row;
+}
+
+void CompletionMatrix::RemoveRow(const uint32_t row)
+{
+    if (row >= row_count || std::ranges::contains(free_rows, row)) {
+        return;
+    }
+    for (uint32_t category = 0; category < categories.size(); category++) {
+        ClearRow(category, row);
+    }
+    free_rows.push_back(row);
+}
+
+void CompletionMatrix::Clear()
+{
+    for (auto& category : categories) {
+        category.words.clear();
+        category.columns = 0;
+    }
+    free_rows.clear();
+    row_count = 0;
+    words_per_column = 1;
+}
+
+void CompletionMatrix::GrowRows(const uint32_t row_capacity)
+{
+    const uint32_t new_words_per_column = (row_capacity + 63) / 64;
+    for (auto& category : categories) {
+        std::vector<uint64_t> words(static_cast<size_t>(category.columns) * new_words_per_column, 0);
+        for (uint32_t column = 0; column < category.columns; column++) {
+            std::copy_n(&category.words[static_cast<size_t>(column) * words_per_column], words_per_column, &words[static_cast<size_t>(column) * new_words_per_column]);
+        }
+        category.words = std::move(words);
+    }
+    words_per_column = new_words_per_column;
+}
+
+const uint64_t* CompletionMatrix::Column(const uint32_t category, const uint32_t column) const
+{
+    const auto& cat = categories[category];
+    return column < cat.columns ? &cat.words[static_cast<size_t>(column) * words_per_column] : nullptr;
+}
+
+uint64_t* CompletionMatrix::Column(const uint32_t category, const uint32_t column)
+{
+    auto& cat = categories[category];
+    if (column >= cat.columns) {
+        cat.columns = column + 1;
+        cat.words.resize(static_cast<size_t>(cat.columns) * words_per_column, 0);
+    }
+    return &cat.words[static_cast<size_t>(column) * words_per_column];
+}
+
+void CompletionMatrix::Set(const uint32_t category, const uint32_t row, const uint32_t column, const bool value)
+{
+    ASSERT(category < categories.size() && row < row_count);
+    if (!value && !Column(category, column)) {
+        return; // Nothing to clear
+    }
+    auto& word = Column(category, column)[row / 64];
+    const uint64_t bit = 1ull << (row % 64);
+    word = value ? word | bit : word & ~bit;
+}
+
+void CompletionMatrix::Merge(const uint32_t category, const uint32_t row, const std::span<const uint32_t> bits)
+{
+    ASSERT(category < categories.size() && row < row_count);
+    // Make room for the highest column first, rather than growing once per word
+    for (size_t i = bits.size(); i-- > 0;) {
+        if (bits[i]) {
+            Column(category, static_cast<uint32_t>(i * 32 + std::bit_width(bits[i]) - 1));
+            break;
+        }
+    }
+    const uint64_t row_bit = 1ull << (row % 64);
+    auto& cat = categories[category];
+    for (size_t i = 0; i < bits.size(); i++) {
+        for (auto word = bits[i]; word; word &= word - 1) {
+            const auto column = i * 32 + std::countr_zero(word);
+            cat.words[column * words_per_column + row / 64] |= row_bit;
+        }
+    }
+}
+
+void CompletionMatrix::ClearRow(const uint32_t category, const uint32_t row)
+{
+    auto& cat = categories[category];
+    const uint64_t keep = ~(1ull << (row % 64));
+    for (size_t i = row / 64; i < cat.words.size(); i += words_per_column) {
+        cat.words[i] &= keep;
+    }
+}
+
+bool CompletionMatrix::Get(const uint32_t category, const uint32_t row, const uint32_t column) const
+{
+    const auto words = Column(category, column);
+    return words && row < row_count && (words[row / 64] >> (row % 64) & 1);
+}
+
+void CompletionMatrix::SetRow(RowMask& mask, const uint32_t row)
+{
+    if (row / 64 < mask.size()) {
+        mask[row / 64] |= 1ull << (row % 64);
+    }
+}
+
+bool CompletionMatrix::HasRow(const RowMask& mask, const uint32_t row)
+{
+    return row / 64 < mask.size() && (mask[row / 64] >> (row % 64) & 1);
+}
+
+size_t CompletionMatrix::CountRows(const RowMask& mask)
+{
+    size_t count = 0;
+    for (const auto word : mask) {
+        count += std::popcount(word);
+    }
+    return count;
+}
+
+void CompletionMatrix::RowsWith(const std::span<const uint32_t> category_ids, const uint32_t column, const RowMask& among, RowMask& out) const
+{
+    ASSERT(among.size() == words_per_column);
+    out = among;
+    for (const auto category : category_ids) {
+        const auto words = Column(category, column);
+        for (uint32_t w = 0; w < words_per_column; w++) {
+            out[w] &= words ? words[w] : 0;
+        }
+    }
+}
+
+void CompletionMatrix::RowsWithout(const std::span<const uint32_t> category_ids, const uint32_t column, const RowMask& among, RowMask& out) const
+{
+    RowsWith(category_ids, column, among, out);
+    for (uint32_t w = 0; w < words_per_column; w++) {
+        out[w] = among[w] & ~out[w];
+    }
+}
+
+size_t CompletionMatrix::Count(const std::span<const uint32_t> category_ids, const std::span<const uint32_t> columns, const RowMask& among) const
+{
+    ASSERT(among.size() == words_per_column);
+    size_t count = 0;
+    for (const auto column : columns) {
+        for (uint32_t w = 0; w < words_per_column; w++) {
+            auto word = among[w];
+            for (const auto category : category_ids) {
+                const auto words = Column(category, column);
+                word &= words ? words[w] : 0;
+            }
+            count += std::popcount(word);
+        }
+    }
+    return count;
+}
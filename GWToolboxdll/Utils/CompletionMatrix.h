@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/*
+Bit matrix of what each character has completed, one matrix per category (missions, skills, vanquishes...).
+
+Bits are stored column-major: every achievement (column) is a run of words with one bit per character (row), so
+"which characters have done X" is a handful of word ANDs however many characters there are, and account-wide
+totals are popcounts over those words. Rows are handed out by AddRow() and reused once removed; columns grow as
+higher achievement indexes are set.
+
+    auto among = matrix.MakeMask();
+    matrix.SetRow(among, cc->matrix_row);
+    matrix.RowsWith(categories, skill_id, among, done);
+*/
+class CompletionMatrix {
+public:
+    using RowMask = std::vector<uint64_t>;
+
+    explicit CompletionMatrix(size_t category_count) : categories(category_count) {}
+
+    uint32_t AddRow();
+    void RemoveRow(uint32_t row);
+    void Clear();
+
+    void Set(uint32_t category, uint32_t row, uint32_t column, bool value = true);
+    // ORs a bit array (bit n of the array is column n) into the row
+    void Merge(uint32_t category, uint32_t row, std::span<const uint32_t> bits);
+    void ClearRow(uint32_t category, uint32_t row);
+    [[nodiscard]] bool Get(uint32_t category, uint32_t row, uint32_t column) const;
+
+    // Empty mask sized for the current rows; masks go stale when AddRow() needs more words, so don't keep them
+    [[nodiscard]] RowMask MakeMask() const { return RowMask(words_per_column, 0); }
+    static void SetRow(RowMask& mask, uint32_t row);
+    [[nodiscard]] static bool HasRow(const RowMask& mask, uint32_t row);
+    [[nodiscard]] static size_t CountRows(const RowMask& mask);
+
+    // Rows in among that have the column set in every one of the categories
+    void RowsWith(std::span<const uint32_t> categories, uint32_t column, const RowMask& among, RowMask& out) const;
+    // Rows in among that are missing the column in at least one of the categories
+    void RowsWithout(std::span<const uint32_t> categories, uint32_t column, const RowMask& among, RowMask& out) const;
+    // Number of (row, column) pairs across among and columns that are set in every one of the categories
+    [[nodiscard]] size_t Count(std::span<const uint32_t> categories, std::span<const uint32_t> columns, const RowMask& among) const;
+
+private:
+    struct Category {
+        std::vector<uint64_t> words; // words_per_column words per column
+        uint32_t columns = 0;
+    };
+
+    [[nodiscard]] const uint64_t* Column(uint32_t category, uint32_t column) const;
+    uint64_t* Column(uint32_t category, uint32_t column);
+    void GrowRows(uint32_t row_capacity);
+
+    std::vector<Category> categories;
+    std::vector<uint32_t> free_rows;
+    uint32_t row_count = 0;
+    uint32_t words_per_column = 1;
+};
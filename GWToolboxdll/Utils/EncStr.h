@@ -0,0 +1,566 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+Parsing and building of GW encoded strings, without touching the game.
+
+An encoded string is one or more segments joined by Concat (0x2). A segment is a string id, optionally followed by
+more words (some ids carry a key), then the segment's arguments:
+
+    0x101-0x106, 0x10d-0x10f <number>     numeric argument
+    0x107-0x109 <text> 0x1                literal text argument
+    0x10a-0x10c <encoded string> 0x1      nested string argument
+
+Ids, keys and numbers are made of words: chars >= 0x100 holding value + 0x100, where every char but the last of a
+multi-char word has 0x8000 set. A key word that happens to equal an argument marker can't be told apart from one;
+the game never sends any.
+
+Everything here is header-only and works on views into the caller's buffer; nothing is copied until a Builder writes.
+
+    EncStr::Tokenizer tokens(message);                         // Spans, one at a time
+    const auto ast = EncStr::Parse(message);                   // Segments and arguments, for digging into nested strings
+    static const EncStr::Pattern age(L"\x8101\x641F\x86C3\xE149\x53E8", EncStr::Pattern::Prefix);
+    age.Match(message);                                        // Precompiled template match, no allocations
+    EncStr::Builder b; b.Text(L"Hello").NewLine().Encoded(name_enc); // Reusable output buffer
+*/
+namespace EncStr {
+    constexpr wchar_t End = 0x1;
+    constexpr wchar_t Concat = 0x2;
+    constexpr wchar_t WordBase = 0x100;
+    constexpr wchar_t WordMore = 0x8000;
+    constexpr uint32_t WordRange = 0x7f00;
+
+    constexpr wchar_t LiteralStringId = 0x108; // Segment that prints its first literal argument
+    constexpr wchar_t NewLineStringId = 0x102;
+
+    constexpr wchar_t NumberArg1 = 0x101;
+    constexpr wchar_t NumberArg2 = 0x102;
+    constexpr wchar_t NumberArg3 = 0x103;
+    constexpr wchar_t LiteralArg1 = 0x107;
+    constexpr wchar_t LiteralArg2 = 0x108;
+    constexpr wchar_t LiteralArg3 = 0x109;
+    constexpr wchar_t StringArg1 = 0x10a;
+    constexpr wchar_t StringArg2 = 0x10b;
+    constexpr wchar_t StringArg3 = 0x10c;
+
+    // Stands in for an argument's value in a Pattern template: a number, a literal's text, or a whole nested string
+    constexpr wchar_t Any = 0x7f;
+
+    enum class ArgKind : uint8_t { None, Number, Literal, String };
+
+    constexpr ArgKind GetArgKind(const wchar_t marker)
+    {
+        if (marker >= 0x101 && marker <= 0x106) return ArgKind::Number;
+        if (marker >= 0x107 && marker <= 0x109) return ArgKind::Literal;
+        if (marker >= 0x10a && marker <= 0x10c) return ArgKind::String;
+        if (marker >= 0x10d && marker <= 0x10f) return ArgKind::Number;
+        return ArgKind::None;
+    }
+
+    constexpr bool IsWordChar(const wchar_t c) { return c >= WordBase; }
+
+    // Value of a word; the view must hold exactly one word
+    constexpr uint32_t DecodeWord(const std::wstring_view word)
+    {
+        uint32_t value = 0;
+        for (const auto c : word) {
+            value = value * WordRange + ((c & ~WordMore) - WordBase);
+        }
+        return value;
+    }
+
+    inline void AppendWord(std::wstring& out, uint32_t value)
+    {
+        wchar_t chars[8];
+        size_t count = 0;
+        do {
+            chars[count++] = static_cast<wchar_t>(value % WordRange + WordBase);
+            value /= WordRange;
+        } while (value);
+        while (count--) {
+            out.push_back(count ? static_cast<wchar_t>(chars[count] | WordMore) : chars[count]);
+        }
+    }
+
+    enum class TokenKind : uint8_t {
+        StringId,    // text: the id's words; value: decoded id
+        Key,         // text: words between the id and its arguments
+        Number,      // marker; text: the number's words; value: decoded number
+        Literal,     // marker; text: the literal's text
+        ColourBegin, // A literal "<c=...>"; text: the whole tag
+        ColourEnd,   // A literal "</c>"
+        StringBegin, // marker; the nested string's tokens follow, up to StringEnd
+        StringEnd,
+        Concat,
+    };
+
+    struct Token {
+        TokenKind kind = TokenKind::StringId;
+        wchar_t marker = 0;
+        std::wstring_view text;
+        uint32_t value = 0;
+    };
+
+    // Colour inside a ColourBegin tag, e.g. "@ItemRare" for "<c=@ItemRare>"
+    constexpr std::wstring_view GetColour(const Token& token)
+    {
+        return token.kind == TokenKind::ColourBegin ? token.text.substr(3, token.text.size() - 4) : std::wstring_view{};
+    }
+
+    class Tokenizer {
+    public:
+        // Stops at the first null char, if any. With allow_any, Any is accepted where a number or nested string is
+        // expected; used to compile Patterns.
+        explicit Tokenizer(const std::wstring_view _str, const bool _allow_any = false)
+            : str(_str.substr(0, _str.find(L'\0'))), allow_any(_allow_any) {}
+
+        // False at the end of the string, or once it's found to be malformed (see Failed).
+        bool Next(Token& token)
+        {
+            if (failed) return false;
+            if (pos >= str.size()) {
+                failed = depth != 0;
+                return false;
+            }
+            token = {};
+            const auto c = str[pos];
+            if (c == Concat) {
+                pos++;
+                state = State::SegmentStart;
+                token.kind = TokenKind::Concat;
+                return true;
+            }
+            if (c == End) {
+                if (!depth) return Fail();
+                depth--;
+                pos++;
+                state = State::Args;
+                token.kind = TokenKind::StringEnd;
+                return true;
+            }
+            switch (state) {
+                case State::SegmentStart:
+                    if (!ReadWord(token)) return Fail();
+                    token.kind = TokenKind::StringId;
+                    state = State::AfterId;
+                    return true;
+                case State::AfterId:
+                    state = State::Args;
+                    if (IsWordChar(c) && GetArgKind(c) == ArgKind::None) {
+                        const auto start = pos;
+                        while (pos < str.size() && IsWordChar(str[pos]) && GetArgKind(str[pos]) == ArgKind::None) {
+                            if (!ReadWord(token)) return Fail();
+                        }
+                        token = {TokenKind::Key, 0, str.substr(start, pos - start)};
+                        return true;
+                    }
+                    break;
+                case State::Args:
+                    break;
+            }
+            token.marker = c;
+            pos++;
+            switch (GetArgKind(c)) {
+                case ArgKind::Number:
+                    if (!ReadWord(token)) return Fail();
+                    token.kind = TokenKind::Number;
+                    return true;
+                case ArgKind::Literal: {
+                    const auto end = str.find(End, pos);
+                    if (end == std::wstring_view::npos) return Fail();
+                    token.text = str.substr(pos, end - pos);
+                    pos = end + 1;
+                    token.kind = TokenKind::Literal;
+                    if (token.text == L"</c>") {
+                        token.kind = TokenKind::ColourEnd;
+                    }
+                    else if (token.text.size() > 4 && token.text.starts_with(L"<c=") && token.text.ends_with(L'>')) {
+                        token.kind = TokenKind::ColourBegin;
+                    }
+                    return true;
+                }
+                case ArgKind::String:
+                    depth++;
+                    state = State::SegmentStart;
+                    token.kind = TokenKind::StringBegin;
+                    return true;
+                default:
+                    return Fail();
+            }
+        }
+
+        [[nodiscard]] bool Failed() const { return failed; }
+        // Index of the next unread char
+        [[nodiscard]] size_t Offset() const { return pos; }
+
+    private:
+        enum class State : uint8_t { SegmentStart, AfterId, Args };
+
+        std::wstring_view str;
+        size_t pos = 0;
+        uint32_t depth = 0;
+        State state = State::SegmentStart;
+        bool allow_any = false;
+        bool failed = false;
+
+        bool Fail()
+        {
+            failed = true;
+            return false;
+        }
+
+        bool ReadWord(Token& token)
+        {
+            const auto start = pos;
+            if (allow_any && pos < str.size() && str[pos] == Any) {
+                pos++;
+            }
+            else {
+                do {
+                    if (pos >= str.size() || !IsWordChar(str[pos])) return false;
+                } while (str[pos++] & WordMore);
+            }
+            token.text = str.substr(start, pos - start);
+            token.value = token.text.front() == Any ? 0 : DecodeWord(token.text);
+            return true;
+        }
+    };
+
+    // -------------------------------------------------------------------------
+    // AST
+    // -------------------------------------------------------------------------
+
+    struct Segment;
+
+    struct String {
+        std::vector<Segment> segments; // Joined by Concat; empty segments are kept so the string round-trips
+    };
+
+    struct Arg {
+        wchar_t marker = 0;
+        ArgKind kind = ArgKind::None;
+        std::wstring_view text; // Number's words, literal text, or the raw nested string
+        uint32_t number = 0;
+        String nested;
+    };
+
+    struct Segment {
+        std::wstring_view id;
+        std::wstring_view key;
+        std::vector<Arg> args;
+
+        [[nodiscard]] uint32_t IdValue() const { return id.empty() ? 0 : DecodeWord(id); }
+
+        [[nodiscard]] const Arg* FindArg(const wchar_t marker) const
+        {
+            for (const auto& arg : args) {
+                if (arg.marker == marker) return &arg;
+            }
+            return nullptr;
+        }
+    };
+
+    namespace detail {
+        inline bool ParseString(Tokenizer& tokens, String& out, const std::wstring_view source, const bool nested)
+        {
+            out.segments.emplace_back();
+            Token token;
+            while (tokens.Next(token)) {
+                auto& segment = out.segments.back();
+                switch (token.kind) {
+                    case TokenKind::StringId:
+                        segment.id = token.text;
+                        break;
+                    case TokenKind::Key:
+                        segment.key = token.text;
+                        break;
+                    case TokenKind::Number:
+                        segment.args.push_back({token.marker, ArgKind::Number, token.text, token.value});
+                        break;
+                    case TokenKind::Literal:
+                    case TokenKind::ColourBegin:
+                    case TokenKind::ColourEnd:
+                        segment.args.push_back({token.marker, ArgKind::Literal, token.text});
+                        break;
+                    case TokenKind::StringBegin: {
+                        const auto start = tokens.Offset();
+                        auto& arg = segment.args.emplace_back(token.marker, ArgKind::String);
+                        if (!ParseString(tokens, arg.nested, source, true)) return false;
+                        arg.text = source.substr(start, tokens.Offset() - 1 - start);
+                    } break;
+                    case TokenKind::StringEnd:
+                        return nested;
+                    case TokenKind::Concat:
+                        out.segments.emplace_back();
+                        break;
+                }
+            }
+            return !tokens.Failed() && !nested;
+        }
+    }
+
+    // Views in the result point into encoded.
+    inline std::optional<String> Parse(const std::wstring_view encoded)
+    {
+        Tokenizer tokens(encoded);
+        String out;
+        if (!detail::ParseString(tokens, out, encoded, false)) return std::nullopt;
+        return out;
+    }
+
+    inline void Serialize(const String& str, std::wstring& out)
+    {
+        for (size_t i = 0; i < str.segments.size(); i++) {
+            const auto& segment = str.segments[i];
+            if (i) out.push_back(Concat);
+            out.append(segment.id);
+            out.append(segment.key);
+            for (const auto& arg : segment.args) {
+                out.push_back(arg.marker);
+                switch (arg.kind) {
+                    case ArgKind::Number:
+                        out.append(arg.text);
+                        break;
+                    case ArgKind::Literal:
+                        out.append(arg.text);
+                        out.push_back(End);
+                        break;
+                    case ArgKind::String:
+                        Serialize(arg.nested, out);
+                        out.push_back(End);
+                        break;
+                    default:
+                        break;
+                }
+            }
+        }
+    }
+
+    // First segment with this id, searching nested strings depth first
+    inline const Segment* FindSegment(const String& str, const std::wstring_view id)
+    {
+        for (const auto& segment : str.segments) {
+            if (segment.id == id) return &segment;
+            for (const auto& arg : segment.args) {
+                if (arg.kind != ArgKind::String) continue;
+                if (const auto found = FindSegment(arg.nested, id)) return found;
+            }
+        }
+        return nullptr;
+    }
+
+    // -------------------------------------------------------------------------
+    // Builder
+    // -------------------------------------------------------------------------
+
+    // Writes encoded strings into a buffer that keeps its capacity between uses. Segments written at the same
+    // nesting level are joined with Concat automatically; argument calls apply to the last segment written.
+    class Builder {
+    public:
+        Builder() = default;
+        // Appends to an existing encoded string instead of the builder's own buffer
+        explicit Builder(std::wstring& target)
+            : out(&target) { open.back() = !target.empty(); }
+        Builder(const Builder&) = delete;
+        Builder& operator=(const Builder&) = delete;
+
+        Builder& Clear()
+        {
+            out->clear();
+            open.assign(1, false);
+            return *this;
+        }
+
+        [[nodiscard]] const std::wstring& str() const { return *out; }
+        [[nodiscard]] bool empty() const { return out->empty(); }
+
+        // Segment with the given id value
+        Builder& Id(const uint32_t id)
+        {
+            BeginSegment();
+            AppendWord(*out, id);
+            return *this;
+        }
+        // Already encoded string, e.g. an item's name_enc
+        Builder& Encoded(const std::wstring_view encoded)
+        {
+            if (encoded.empty()) return *this;
+            BeginSegment();
+            out->append(encoded);
+            return *this;
+        }
+        // Plain text
+        Builder& Text(const std::wstring_view text)
+        {
+            BeginSegment();
+            out->push_back(LiteralStringId);
+            return Literal(LiteralArg1, text);
+        }
+        Builder& NewLine()
+        {
+            BeginSegment();
+            out->push_back(NewLineStringId);
+            return *this;
+        }
+        // Segments up to EndColour are drawn in this colour, e.g. L"@ItemRare" or a decimal ARGB value
+        Builder& BeginColour(const std::wstring_view colour)
+        {
+            BeginSegment();
+            out->push_back(LiteralStringId);
+            out->push_back(LiteralArg1);
+            out->append(L"<c=");
+            out->append(colour);
+            out->append(L">");
+            out->push_back(End);
+            return *this;
+        }
+        Builder& EndColour() { return Text(L"</c>"); }
+
+        Builder& Number(const wchar_t marker, const uint32_t value)
+        {
+            out->push_back(marker);
+            AppendWord(*out, value);
+            return *this;
+        }
+        Builder& Literal(const wchar_t marker, const std::wstring_view text)
+        {
+            out->push_back(marker);
+            out->append(text);
+            out->push_back(End);
+            return *this;
+        }
+        Builder& BeginString(const wchar_t marker)
+        {
+            out->push_back(marker);
+            open.push_back(false);
+            return *this;
+        }
+        Builder& EndString()
+        {
+            if (open.size() > 1) open.pop_back();
+            out->push_back(End);
+            return *this;
+        }
+        // Nested string argument holding an already encoded string
+        Builder& Nested(const wchar_t marker, const std::wstring_view encoded) { return BeginString(marker).Encoded(encoded).EndString(); }
+
+    private:
+        std::wstring buffer;
+        std::wstring* out = &buffer;
+        std::vector<bool> open = {false}; // Per nesting level: whether a segment has been written yet
+
+        void BeginSegment()
+        {
+            if (open.back()) out->push_back(Concat);
+            open.back() = true;
+        }
+    };
+
+    inline std::wstring Literal(const std::wstring_view text)
+    {
+        Builder builder;
+        builder.Text(text);
+        return builder.str();
+    }
+
+    // -------------------------------------------------------------------------
+    // Pattern
+    // -------------------------------------------------------------------------
+
+    // An encoded template compiled once and matched token by token. Ids, keys, markers and literal text must be equal;
+    // an argument whose value is Any matches any value and is captured, e.g. L"\x846\x107\x7F\x1" captures the text.
+    class Pattern {
+    public:
+        enum Mode : uint8_t {
+            Exact,  // The whole subject must match
+            Prefix, // The subject may carry on after the template
+        };
+        static constexpr size_t max_captures = 8;
+        using Captures = std::array<std::wstring_view, max_captures>;
+
+        explicit Pattern(const std::wstring_view encoded_template, const Mode _mode = Exact)
+            : source(encoded_template), mode(_mode)
+        {
+            Tokenizer tokens(source, true);
+            Token token;
+            size_t captures = 0;
+            while (tokens.Next(token)) {
+                Step step{token.kind, token.marker, static_cast<uint32_t>(token.text.data() ? token.text.data() - source.data() : 0), static_cast<uint32_t>(token.text.size())};
+                switch (token.kind) {
+                    case TokenKind::Number:
+                    case TokenKind::Literal:
+                        step.any = token.text == std::wstring_view(&Any, 1);
+                        break;
+                    case TokenKind::StringBegin: {
+                        // "<marker> Any End" matches any nested string
+                        const auto offset = tokens.Offset();
+                        if (offset + 1 < source.size() && source[offset] == Any && source[offset + 1] == End) {
+                            Token skipped;
+                            tokens.Next(skipped);
+                            tokens.Next(skipped);
+                            step.any = true;
+                        }
+                    } break;
+                    default:
+                        break;
+                }
+                captures += step.any;
+                steps.push_back(step);
+            }
+            valid = !tokens.Failed() && captures <= max_captures;
+        }
+
+        [[nodiscard]] bool IsValid() const { return valid; }
+
+        bool Match(const std::wstring_view subject, Captures* captures = nullptr) const
+        {
+            if (!valid) return false;
+            Tokenizer tokens(subject);
+            Token token;
+            size_t capture = 0;
+            for (const auto& step : steps) {
+                if (!tokens.Next(token)) return false;
+                // Colour tags are literals as far as matching goes
+                const auto kind = token.kind == TokenKind::ColourBegin || token.kind == TokenKind::ColourEnd ? TokenKind::Literal : token.kind;
+                const auto step_kind = step.kind == TokenKind::ColourBegin || step.kind == TokenKind::ColourEnd ? TokenKind::Literal : step.kind;
+                if (kind != step_kind || token.marker != step.marker) return false;
+                if (!step.any) {
+                    if (token.text != std::wstring_view(source).substr(step.offset, step.length)) return false;
+                    continue;
+                }
+                auto captured = token.text;
+                if (kind == TokenKind::StringBegin) {
+                    const auto start = tokens.Offset();
+                    for (uint32_t depth = 1; depth;) {
+                        if (!tokens.Next(token)) return false;
+                        depth += token.kind == TokenKind::StringBegin;
+                        depth -= token.kind == TokenKind::StringEnd;
+                    }
+                    captured = subject.substr(start, tokens.Offset() - 1 - start);
+                }
+                if (captures) (*captures)[capture] = captured;
+                capture++;
+            }
+            return mode == Prefix || (!tokens.Next(token) && !tokens.Failed());
+        }
+
+    private:
+        struct Step {
+            TokenKind kind;
+            wchar_t marker;
+            uint32_t offset; // Into source
+            uint32_t length;
+            bool any = false;
+        };
+        std::wstring source;
+        std::vector<Step> steps;
+        Mode mode;
+        bool valid = false;
+    };
+}
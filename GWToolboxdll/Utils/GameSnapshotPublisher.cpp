@@ -0,0 +1,277 @@
+#include "stdafx.h"
+
+#include <GWCA/GameContainers/Array.h>
+#include <GWCA/GameEntities/Agent.h>
+#include <GWCA/GameEntities/Item.h>
+#include <GWCA/GameEntities/Party.h>
+#include <GWCA/GameEntities/Skill.h>
+#include <GWCA/Managers/AgentMgr.h>
+#include <GWCA/Managers/EffectMgr.h>
+#include <GWCA/Managers/ItemMgr.h>
+#include <GWCA/Managers/MapMgr.h>
+#include <GWCA/Managers/PartyMgr.h>
+#include <GWCA/Managers/SkillbarMgr.h>
+
+#include <GameSnapshot.h>
+#include <Utils/GameSnapshotPublisher.h>
+
+#include <atomic>
+
+namespace {
+    // Rows are kept in vectors reserved once and only ever cleared. A plugin thread may still be following the row
+    // pointers of the snapshot a buffer last held while it's rewritten; it has to find the same memory there, so the
+    // vectors must never reallocate, and collecting stops when one is full.
+    constexpr size_t max_agents = 4096;
+    constexpr size_t max_party_members = 64;
+    constexpr size_t max_effects = 2048;
+    constexpr size_t max_skillbars = 64;
+
+    struct SnapshotBuffer {
+        SnapshotBuffer()
+        {
+            agents.reserve(max_agents);
+            party.reserve(max_party_members);
+            effects.reserve(max_effects);
+            skillbars.reserve(max_skillbars);
+        }
+
+        GWSnapshot root{};
+        std::vector<GWSnapshotAgent> agents;
+        std::vector<GWSnapshotPartyMember> party;
+        std::vector<GWSnapshotEffect> effects;
+        std::vector<GWSnapshotSkillbar> skillbars;
+    };
+
+    SnapshotBuffer buffers[2];
+    // Snapshot epoch e lives in buffers[e & 1], and is rewritten when epoch e + 2 is published
+    std::atomic<uint64_t> published_epoch = 0;
+    std::atomic<uint64_t> writing_epoch = 0;
+
+    template <typename T>
+    bool IsFull(const std::vector<T>& rows)
+    {
+        return rows.size() == rows.capacity();
+    }
+
+    template <typename T>
+    GWSnapshotTable ToTable(const std::vector<T>& rows)
+    {
+        return {rows.data(), static_cast<uint32_t>(rows.size()), static_cast<uint32_t>(sizeof(T))};
+    }
+
+    void CollectAgents(std::vector<GWSnapshotAgent>& out)
+    {
+        const auto agents = GW::Agents::GetAgentArray();
+        if (!agents) {
+            return;
+        }
+        for (const auto agent : *agents) {
+            const auto living = agent ? agent->GetAsAgentLiving() : nullptr;
+            if (!living) {
+                continue;
+            }
+            if (IsFull(out)) {
+                return;
+            }
+            out.push_back({
+                .agent_id = living->agent_id,
+                .login_number = living->login_number,
+                .x = living->pos.x,
+                .y = living->pos.y,
+                .plane = living->pos.zplane,
+                .rotation = living->rotation_angle,
+                .hp = living->hp,
+                .energy = living->energy,
+                .max_hp = living->max_hp,
+                .max_energy = living->max_energy,
+                .effects = living->effects,
+                .type_map = living->type_map,
+                .model_state = living->model_state,
+                .player_number = living->player_number,
+                .skill = living->skill,
+                .weapon_type = living->weapon_type,
+                .allegiance = static_cast<uint8_t>(living->allegiance),
+                .primary = static_cast<uint8_t>(living->primary),
+                .secondary = static_cast<uint8_t>(living->secondary),
+                .level = living->level,
+                .team_id = living->team_id,
+            });
+        }
+    }
+
+    void CollectParty(std::vector<GWSnapshotPartyMember>& out)
+    {
+        const auto party = GW::PartyMgr::GetPartyInfo();
+        if (!party) {
+            return;
+        }
+        for (const auto& player : party->players) {
+            if (IsFull(out)) {
+                return;
+            }
+            uint32_t flags = 0;
+            flags |= player.connected() ? GW_SNAPSHOT_PARTY_CONNECTED : 0;
+            flags |= player.ticked() ? GW_SNAPSHOT_PARTY_TICKED : 0;
+            out.push_back({
+                .agent_id = GW::Agents::GetAgentIdByLoginNumber(player.login_number),
+                .login_number = player.login_number,
+                .type = GWSnapshotPartyMember_Player,
+                .flags = flags,
+            });
+        }
+        for (const auto& hero : party->heroes) {
+            if (IsFull(out)) {
+                return;
+            }
+            out.push_back({
+                .agent_id = hero.agent_id,
+                .login_number = hero.owner_player_id,
+                .hero_id = static_cast<uint32_t>(hero.hero_id),
+                .level = hero.level,
+                .type = GWSnapshotPartyMember_Hero,
+            });
+        }
+        for (const auto& henchman : party->henchmen) {
+            if (IsFull(out)) {
+                return;
+            }
+            out.push_back({
+                .agent_id = henchman.agent_id,
+                .level = henchman.level,
+                .type = GWSnapshotPartyMember_Henchman,
+            });
+        }
+    }
+
+    void CollectEffects(std::vector<GWSnapshotEffect>& out)
+    {
+        const auto party_effects = GW::Effects::GetPartyEffectsArray();
+        if (!(party_effects && party_effects->valid())) {
+            return;
+        }
+        for (const auto& agent_effects : *party_effects) {
+            for (const auto& effect : agent_effects.effects) {
+                if (IsFull(out)) {
+                    return;
+                }
+                out.push_back({
+                    .agent_id = agent_effects.agent_id,
+                    .skill_id = static_cast<uint32_t>(effect.skill_id),
+                    .effect_id = effect.effect_id,
+                    .caster_id = effect.agent_id,
+                    .attribute_level = effect.attribute_level,
+                    .time_remaining = effect.duration > 0.f ? effect.GetTimeRemaining() : 0,
+                    .duration = effect.duration,
+                });
+            }
+        }
+    }
+
+    void CollectSkillbars(std::vector<GWSnapshotSkillbar>& out)
+    {
+        const auto skillbars = GW::SkillbarMgr::GetSkillbarArray();
+        if (!(skillbars && skillbars->valid())) {
+            return;
+        }
+        for (const auto& skillbar : *skillbars) {
+            if (!skillbar.IsValid()) {
+                continue;
+            }
+            if (IsFull(out)) {
+                return;
+            }
+            auto& row = out.emplace_back();
+            row.agent_id = skillbar.agent_id;
+            row.disabled = skillbar.disabled;
+            for (size_t i = 0; i < _countof(row.skills); i++) {
+                const auto& skill = skillbar.skills[i];
+                row.skills[i] = {static_cast<uint32_t>(skill.skill_id), skill.GetRecharge(), skill.adrenaline_a, skill.event};
+            }
+        }
+    }
+
+    GWSnapshotMap CollectMap()
+    {
+        return {
+            .map_id = static_cast<uint32_t>(GW::Map::GetMapID()),
+            .instance_type = static_cast<uint32_t>(GW::Map::GetInstanceType()),
+            .district = GW::Map::GetDistrict(),
+            .region = static_cast<int32_t>(GW::Map::GetRegion()),
+            .language = static_cast<int32_t>(GW::Map::GetLanguage()),
+            .instance_time = GW::Map::GetInstanceTime(),
+            .is_loaded = GW::Map::GetIsMapLoaded(),
+            .is_hard_mode = GW::PartyMgr::GetIsPartyInHardMode(),
+            .is_party_defeated = GW::PartyMgr::GetIsPartyDefeated(),
+        };
+    }
+
+    GWSnapshotInventory CollectInventory()
+    {
+        GWSnapshotInventory inventory = {
+            .gold_character = GW::Items::GetGoldAmountOnCharacter(),
+            .gold_storage = GW::Items::GetGoldAmountInStorage(),
+        };
+        for (auto bag_id = GW::Constants::Bag::Backpack; bag_id <= GW::Constants::Bag::Bag_2; ++bag_id) {
+            const auto bag = GW::Items::GetBag(bag_id);
+            if (!(bag && bag->items.valid())) {
+                continue;
+            }
+            for (const auto item : bag->items) {
+                inventory.bag_slots++;
+                inventory.bag_slots_free += item ? 0 : 1;
+            }
+        }
+        return inventory;
+    }
+}
+
+void GameSnapshotPublisher::Publish()
+{
+    const auto epoch = published_epoch.load(std::memory_order_relaxed) + 1;
+    // Readers of the snapshot this buffer last held see this before any of the rewrite
+    writing_epoch.store(epoch, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    auto& buffer = buffers[epoch & 1];
+    buffer.agents.clear();
+    buffer.party.clear();
+    buffer.effects.clear();
+    buffer.skillbars.clear();
+    CollectAgents(buffer.agents);
+    CollectParty(buffer.party);
+    CollectEffects(buffer.effects);
+    CollectSkillbars(buffer.skillbars);
+
+    auto& root = buffer.root;
+    root.abi_version = GW_SNAPSHOT_ABI_VERSION;
+    root.size = sizeof(GWSnapshot);
+    root.epoch = epoch;
+    root.player_agent_id = GW::Agents::GetControlledCharacterId();
+    root.target_agent_id = GW::Agents::GetTargetId();
+    root.map = CollectMap();
+    root.inventory = CollectInventory();
+    root.agents = ToTable(buffer.agents);
+    root.party = ToTable(buffer.party);
+    root.effects = ToTable(buffer.effects);
+    root.skillbars = ToTable(buffer.skillbars);
+
+    published_epoch.store(epoch, std::memory_order_release);
+}
+
+const GWSnapshot* GWToolbox_GetSnapshot(const uint32_t abi_version, uint64_t* epoch_out)
+{
+    const auto epoch = published_epoch.load(std::memory_order_acquire);
+    if (epoch_out) {
+        *epoch_out = epoch;
+    }
+    if (!epoch || abi_version > GW_SNAPSHOT_ABI_VERSION) {
+        return nullptr;
+    }
+    return &buffers[epoch & 1].root;
+}
+
+int GWToolbox_IsSnapshotValid(const uint64_t epoch)
+{
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return epoch && writing_epoch.load(std::memory_order_relaxed) < epoch + 2;
+}
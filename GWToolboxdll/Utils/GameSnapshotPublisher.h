@@ -0,0 +1,12 @@
+#pragma once
+
+/*
+Fills the GWSnapshot tables exported to plugins (see GameSnapshot.h).
+
+PluginModule calls Publish() from Update, before any plugin's Update, and only while plugins are loaded; nothing is
+collected otherwise. Must be called on the game thread.
+*/
+
+namespace GameSnapshotPublisher {
+    void Publish();
+}
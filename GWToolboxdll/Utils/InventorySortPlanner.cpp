@@ -0,0 +1,217 @@
+#include "stdafx.h"
+
+#include "InventorySortPlanner.h"
+
+#include <algorithm>
+#include <tuple>
+#include <unordered_map>
+
+namespace {
+    using namespace InventorySortPlanner;
+
+    constexpr uint32_t NoClass = UINT32_MAX;
+    constexpr uint32_t NoSlot = UINT32_MAX;
+
+    uint64_t PairKey(const uint32_t have, const uint32_t want)
+    {
+        return static_cast<uint64_t>(have) << 32 | want;
+    }
+}
+
+void InventorySortPlanner::ApplyMove(Snapshot& slots, const Move& move, const uint32_t max_stack)
+{
+    auto& from = slots[move.from];
+    auto& to = slots[move.to];
+    if (move.from == move.to || from.item_id == EmptySlot) {
+        return;
+    }
+    if (to.item_id != EmptySlot && from.stack_key && from.stack_key == to.stack_key) {
+        const auto quantity = move.quantity ? std::min(move.quantity, from.quantity) : from.quantity;
+        const auto moved = std::min(quantity, max_stack - std::min(max_stack, to.quantity));
+        to.quantity += moved;
+        from.quantity -= moved;
+        if (!from.quantity) {
+            from = {};
+        }
+        return;
+    }
+    std::swap(from, to);
+}
+
+std::vector<Move> InventorySortPlanner::PlanMerges(const Snapshot& slots, const uint32_t max_stack)
+{
+    // Group partial stacks by stack key, keeping groups in the order they're first seen
+    std::vector<std::vector<uint32_t>> groups;
+    std::unordered_map<uint64_t, size_t> group_by_key;
+    for (uint32_t i = 0; i < slots.size(); i++) {
+        const auto& slot = slots[i];
+        if (slot.item_id == EmptySlot || !slot.stack_key || !slot.quantity || slot.quantity >= max_stack) {
+            continue;
+        }
+        const auto [found, inserted] = group_by_key.try_emplace(slot.stack_key, groups.size());
+        if (inserted) {
+            groups.emplace_back();
+        }
+        groups[found->second].push_back(i);
+    }
+
+    std::vector<Move> moves;
+    std::vector<uint32_t> quantities;
+    for (auto& group : groups) {
+        if (group.size() < 2) {
+            continue;
+        }
+        std::ranges::stable_sort(group, [&slots](const uint32_t a, const uint32_t b) {
+            return slots[a].quantity > slots[b].quantity;
+        });
+        quantities.clear();
+        for (const auto slot : group) {
+            quantities.push_back(slots[slot].quantity);
+        }
+
+        // Fill the largest stacks from the smallest ones
+        size_t dst = 0;
+        size_t src = group.size() - 1;
+        while (dst < src) {
+            const auto space = max_stack - quantities[dst];
+            if (!space) {
+                dst++;
+                continue;
+            }
+            const auto to_move = std::min(space, quantities[src]);
+            moves.push_back({group[src], group[dst], slots[group[src]].item_id, to_move});
+            quantities[dst] += to_move;
+            quantities[src] -= to_move;
+            if (!quantities[src]) {
+                src--;
+            }
+            if (quantities[dst] >= max_stack) {
+                dst++;
+            }
+        }
+    }
+    return moves;
+}
+
+std::vector<Move> InventorySortPlanner::PlanSort(const Snapshot& initial)
+{
+    auto slots = initial;
+    const auto slot_count = static_cast<uint32_t>(slots.size());
+
+    std::vector<uint32_t> order;
+    for (uint32_t i = 0; i < slot_count; i++) {
+        if (slots[i].item_id != EmptySlot) {
+            order.push_back(i);
+        }
+    }
+    const auto sort_key = [&slots](const uint32_t slot) {
+        return std::tie(slots[slot].sort_key, slots[slot].stack_key);
+    };
+    std::ranges::stable_sort(order, [&sort_key](const uint32_t a, const uint32_t b) {
+        return sort_key(a) < sort_key(b);
+    });
+
+    // Items with equal keys form a class; slot k wants the class of the k-th item in sorted order
+    std::vector<uint32_t> have(slot_count, NoClass);
+    std::vector<uint32_t> want(slot_count, NoClass);
+    uint32_t class_count = 0;
+    for (uint32_t k = 0; k < order.size(); k++) {
+        if (!k || sort_key(order[k]) != sort_key(order[k - 1])) {
+            class_count++;
+        }
+        have[order[k]] = class_count - 1;
+        want[k] = class_count - 1;
+    }
+
+    // Misplaced items by class, and by (class, class wanted where the item sits). Entries are validated when taken.
+    std::vector<std::vector<uint32_t>> misplaced_by_class(class_count);
+    std::unordered_map<uint64_t, std::vector<uint32_t>> misplaced_by_pair;
+    const auto index_slot = [&](const uint32_t slot) {
+        if (have[slot] == NoClass || have[slot] == want[slot]) {
+            return;
+        }
+        misplaced_by_class[have[slot]].push_back(slot);
+        misplaced_by_pair[PairKey(have[slot], want[slot])].push_back(slot);
+    };
+    const auto take = [&have, &want](std::vector<uint32_t>& list, const uint32_t cls, const uint32_t wanted) {
+        while (!list.empty()) {
+            const auto slot = list.back();
+            list.pop_back();
+            if (have[slot] == cls && want[slot] != cls && (wanted == NoSlot || want[slot] == wanted)) {
+                return slot;
+            }
+        }
+        return NoSlot;
+    };
+    for (uint32_t i = 0; i < slot_count; i++) {
+        index_slot(i);
+    }
+
+    std::vector<Move> moves;
+    const auto move = [&](const uint32_t from, const uint32_t to) {
+        moves.push_back({from, to, slots[from].item_id, 0});
+        std::swap(slots[from], slots[to]);
+        std::swap(have[from], have[to]);
+        index_slot(from);
+        index_slot(to);
+    };
+
+    for (uint32_t start = 0; start < order.size(); start++) {
+        // Follow the cycle through each slot we empty or swap into
+        for (auto slot = start; slot != NoSlot && have[slot] != want[slot];) {
+            const auto cls = want[slot];
+            // Prefer an item sitting where this slot's occupant belongs; the swap then settles both slots
+            auto source = take(misplaced_by_pair[PairKey(cls, have[slot])], cls, have[slot]);
+            if (source == NoSlot) {
+                source = take(misplaced_by_class[cls], cls, NoSlot);
+            }
+            if (source == NoSlot) {
+                break;
+            }
+            const auto& occupant = slots[slot];
+            if (occupant.item_id != EmptySlot && occupant.stack_key && occupant.stack_key == slots[source].stack_key) {
+                // Same item under a different sort key: moving onto it would merge, not swap. Park it in an empty slot first.
+                auto scratch = NoSlot;
+                for (uint32_t i = slot_count; i-- > 0 && scratch == NoSlot;) {
+                    if (slots[i].item_id == EmptySlot) {
+                        scratch = i;
+                    }
+                }
+                if (scratch == NoSlot) {
+                    return moves;
+                }
+                move(slot, scratch);
+            }
+            move(source, slot);
+            slot = want[source] != NoClass && have[source] != want[source] ? source : NoSlot;
+        }
+    }
+    return moves;
+}
+
+std::vector<Step> InventorySortPlanner::BuildSteps(const Snapshot& initial, const std::vector<Move>& moves, const uint32_t max_stack)
+{
+    // A move goes in the step after the last one that touched either of its slots
+    std::vector<size_t> next_free_step(initial.size(), 0);
+    std::vector<Step> steps;
+    for (const auto& move : moves) {
+        const auto step = std::max(next_free_step[move.from], next_free_step[move.to]);
+        if (step == steps.size()) {
+            steps.emplace_back();
+        }
+        steps[step].moves.push_back(move);
+        next_free_step[move.from] = next_free_step[move.to] = step + 1;
+    }
+
+    auto slots = initial;
+    for (auto& step : steps) {
+        for (const auto& move : step.moves) {
+            ApplyMove(slots, move, max_stack);
+        }
+        for (const auto& move : step.moves) {
+            step.expected.emplace_back(move.from, slots[move.from]);
+            step.expected.emplace_back(move.to, slots[move.to]);
+        }
+    }
+    return steps;
+}
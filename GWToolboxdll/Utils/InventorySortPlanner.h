@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/*
+Move planning for InventorySorting.
+
+Works on a flat snapshot of the slots being sorted (every slot of every bag in the range, in order) and never touches
+game state, so a plan can be built and checked anywhere. Moves follow the game's rules: moving onto an empty slot
+moves the item, moving onto a different item swaps the two, and moving onto the same stackable item tops it up.
+*/
+namespace InventorySortPlanner {
+    constexpr uint32_t EmptySlot = 0;
+    constexpr uint32_t DefaultMaxStack = 250;
+
+    struct SlotItem {
+        uint32_t item_id = EmptySlot;
+        uint32_t quantity = 0;
+        uint32_t sort_key = 0;  // Lower sorts first
+        uint64_t stack_key = 0; // Items with the same non-zero stack key stack together; 0 = not stackable
+    };
+    using Snapshot = std::vector<SlotItem>;
+
+    struct Move {
+        uint32_t from = 0;
+        uint32_t to = 0;
+        uint32_t item_id = EmptySlot; // Item expected in the from slot when the move is sent
+        uint32_t quantity = 0;        // 0 = whole stack
+    };
+
+    // Applies one move to the snapshot the way the game would.
+    void ApplyMove(Snapshot& slots, const Move& move, uint32_t max_stack = DefaultMaxStack);
+
+    // Tops up partial stacks from the smallest stacks of the same item; afterwards each item has at most one partial stack.
+    std::vector<Move> PlanMerges(const Snapshot& slots, uint32_t max_stack = DefaultMaxStack);
+
+    // Moves that leave the items ordered by (sort_key, stack_key) from slot 0, with empty slots last.
+    // Items with equal keys are interchangeable, so anything already in a slot its key may occupy stays put.
+    // Every move settles at least one slot and closing a swap cycle settles two.
+    std::vector<Move> PlanSort(const Snapshot& slots);
+
+    // A batch of moves that touch disjoint slots and can be sent together, plus the slot contents once they've landed.
+    struct Step {
+        std::vector<Move> moves;
+        std::vector<std::pair<uint32_t, SlotItem>> expected;
+    };
+
+    // Packs moves into as few steps as possible without reordering any two moves that share a slot.
+    std::vector<Step> BuildSteps(const Snapshot& slots, const std::vector<Move>& moves, uint32_t max_stack = DefaultMaxStack);
+}
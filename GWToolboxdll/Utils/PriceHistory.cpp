@@ -0,0 +1,89 @@
+#include "stdafx.h"
+
+#include "PriceHistory.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    void WriteVarint(uint64_t value, std::string& out)
+    {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    bool ReadVarint(std::string_view& data, uint64_t& value)
+    {
+        value = 0;
+        for (uint32_t shift = 0; shift < 64; shift += 7) {
+            if (data.empty()) {
+                return false;
+            }
+            const auto byte = static_cast<uint8_t>(data.front());
+            data.remove_prefix(1);
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+void PriceHistory::Encode(const Sample& sample, std::string& out)
+{
+    WriteVarint(static_cast<uint64_t>(std::max<time_t>(sample.time, 0)), out);
+    WriteVarint(sample.price, out);
+}
+
+std::vector<PriceHistory::Sample> PriceHistory::Decode(std::string_view data, size_t* valid_size)
+{
+    const auto size = data.size();
+    std::vector<Sample> samples;
+    uint64_t time = 0;
+    uint64_t price = 0;
+    size_t valid = 0;
+    while (ReadVarint(data, time) && ReadVarint(data, price)) {
+        samples.push_back({static_cast<time_t>(time), static_cast<uint32_t>(price)});
+        valid = size - data.size();
+    }
+    if (valid_size) {
+        *valid_size = valid;
+    }
+    // Clients appending to the same file can interleave slightly out of order
+    std::ranges::stable_sort(samples, {}, &Sample::time);
+    return samples;
+}
+
+PriceHistory::Trend PriceHistory::GetTrend(const std::span<const Sample> samples, const time_t since)
+{
+    Trend trend;
+    const auto first = std::ranges::lower_bound(samples, since, {}, &Sample::time);
+    const auto window = samples.subspan(static_cast<size_t>(first - samples.begin()));
+    if (window.empty()) {
+        return trend;
+    }
+    trend.sample_count = window.size();
+    trend.first_price = window.front().price;
+    trend.last_price = window.back().price;
+    if (trend.first_price) {
+        trend.change = (static_cast<float>(trend.last_price) - trend.first_price) / trend.first_price;
+    }
+
+    double sum = 0.0;
+    for (const auto& sample : window) {
+        sum += sample.price;
+    }
+    const auto mean = sum / window.size();
+    double variance = 0.0;
+    for (const auto& sample : window) {
+        variance += (sample.price - mean) * (sample.price - mean);
+    }
+    if (mean > 0.0) {
+        trend.volatility = static_cast<float>(std::sqrt(variance / window.size()) / mean);
+    }
+    return trend;
+}
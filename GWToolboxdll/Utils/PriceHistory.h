@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+Compact on-disk price history for PriceCheckerModule.
+
+A history file is a plain sequence of samples. Each sample is two LEB128 varints: seconds since the epoch, then the
+price. Samples don't depend on the ones before them, so several clients can append to the same file; a sample is
+7-9 bytes, and they're sorted by time when the file is read.
+*/
+namespace PriceHistory {
+    struct Sample {
+        time_t time = 0;
+        uint32_t price = 0;
+    };
+
+    struct Trend {
+        uint32_t first_price = 0; // Oldest price in the window
+        uint32_t last_price = 0;
+        float change = 0.f;       // (last - first) / first
+        float volatility = 0.f;   // Standard deviation of the prices in the window over their mean
+        size_t sample_count = 0;
+    };
+
+    // Appends the encoding of sample to out
+    void Encode(const Sample& sample, std::string& out);
+
+    // Decodes a whole file, oldest sample first. A truncated last record (e.g. from a crash mid-write) is ignored;
+    // valid_size is set to the size of the data up to the end of the last whole record.
+    std::vector<Sample> Decode(std::string_view data, size_t* valid_size = nullptr);
+
+    // Trend over the samples taken at or after since; sample_count is 0 if there are none.
+    Trend GetTrend(std::span<const Sample> samples, time_t since);
+}
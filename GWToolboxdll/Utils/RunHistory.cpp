@@ -0,0 +1,396 @@
+#include "stdafx.h"
+
+#include <Utils/RunHistory.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace {
+    constexpr uint32_t file_magic = 0x4C52544F; // "OTRL"
+    constexpr uint32_t file_version = 1;
+
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+    };
+
+    // Followed by the run name, then split_count splits
+    struct RecordHeader {
+        uint32_t size; // Bytes after this header
+        uint32_t utc_start;
+        uint32_t instance_start;
+        uint32_t duration;
+        uint16_t name_length;
+        uint16_t split_count;
+    };
+
+    // Followed by the objective name
+    struct SplitHeader {
+        uint32_t status;
+        uint32_t start;
+        uint32_t done;
+        uint32_t duration;
+        uint16_t indent;
+        uint16_t name_length;
+    };
+
+    template <typename T>
+    void AppendPod(std::string& out, const T& value)
+    {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    template <typename T>
+    bool ReadPod(std::string_view& in, T& value)
+    {
+        if (in.size() < sizeof(value)) {
+            return false;
+        }
+        memcpy(&value, in.data(), sizeof(value));
+        in.remove_prefix(sizeof(value));
+        return true;
+    }
+
+    bool ReadString(std::string_view& in, const size_t length, std::string& value)
+    {
+        if (in.size() < length) {
+            return false;
+        }
+        value.assign(in.data(), length);
+        in.remove_prefix(length);
+        return true;
+    }
+
+    std::string SerializeRun(const RunHistory::Run& run)
+    {
+        const auto name_length = static_cast<uint16_t>(std::min<size_t>(run.name.size(), UINT16_MAX));
+        const auto split_count = static_cast<uint16_t>(std::min<size_t>(run.splits.size(), UINT16_MAX));
+        std::string out;
+        out.reserve(sizeof(RecordHeader) + name_length + split_count * (sizeof(SplitHeader) + 32));
+        AppendPod(out, RecordHeader{0, run.utc_start, run.instance_start, run.duration, name_length, split_count});
+        out.append(run.name.data(), name_length);
+        for (size_t i = 0; i < split_count; i++) {
+            const auto& split = run.splits[i];
+            const auto split_name_length = static_cast<uint16_t>(std::min<size_t>(split.name.size(), UINT16_MAX));
+            AppendPod(out, SplitHeader{split.status, split.start, split.done, split.duration, static_cast<uint16_t>(split.indent), split_name_length});
+            out.append(split.name.data(), split_name_length);
+        }
+        const auto size = static_cast<uint32_t>(out.size() - sizeof(RecordHeader));
+        memcpy(out.data(), &size, sizeof(size));
+        return out;
+    }
+
+    // Cuts a partly written record off the end of the file, unless another client has appended since it was read as
+    // observed_size bytes. The file is opened without FILE_SHARE_WRITE, so nobody is appending to it meanwhile.
+    bool TruncateTornRecord(const std::filesystem::path& path, const uint64_t observed_size, const uint64_t valid_size)
+    {
+        const HANDLE handle = CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER size;
+        const LARGE_INTEGER end{.QuadPart = static_cast<LONGLONG>(valid_size)};
+        const bool ok = GetFileSizeEx(handle, &size)
+                        && static_cast<uint64_t>(size.QuadPart) == observed_size
+                        && SetFilePointerEx(handle, end, nullptr, FILE_BEGIN)
+                        && SetEndOfFile(handle);
+        CloseHandle(handle);
+        return ok;
+    }
+
+    // Reads the whole record at offset
+    bool ReadRun(std::ifstream& file, const uint64_t offset, RunHistory::Run& run)
+    {
+        RecordHeader header;
+        file.seekg(static_cast<std::streamoff>(offset));
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+            return false;
+        }
+        std::string body(header.size, '\0');
+        if (!file.read(body.data(), header.size)) {
+            return false;
+        }
+        std::string_view in = body;
+        run.utc_start = header.utc_start;
+        run.instance_start = header.instance_start;
+        run.duration = header.duration;
+        if (!ReadString(in, header.name_length, run.name)) {
+            return false;
+        }
+        run.splits.resize(header.split_count);
+        for (auto& split : run.splits) {
+            SplitHeader split_header;
+            if (!(ReadPod(in, split_header) && ReadString(in, split_header.name_length, split.name))) {
+                return false;
+            }
+            split.status = split_header.status;
+            split.start = split_header.start;
+            split.done = split_header.done;
+            split.duration = split_header.duration;
+            split.indent = split_header.indent;
+        }
+        return true;
+    }
+}
+
+bool RunHistory::Open(const std::filesystem::path& _path)
+{
+    std::lock_guard lock(mutex);
+    path.clear();
+    file_size = 0;
+    offsets.clear();
+    offsets_by_utc_start.clear();
+    run_names.clear();
+
+    std::error_code ec;
+    if (!std::filesystem::exists(_path, ec)) {
+        std::ofstream out(_path, std::ios::binary);
+        const FileHeader header{file_magic, file_version};
+        if (!out.write(reinterpret_cast<const char*>(&header), sizeof(header))) {
+            return false;
+        }
+    }
+    const auto size = std::filesystem::file_size(_path, ec);
+    std::ifstream file(_path, std::ios::binary);
+    FileHeader header;
+    if (ec || !file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != file_magic || header.version != file_version) {
+        return false;
+    }
+
+    const auto offset = IndexRecords(file, sizeof(header), size);
+    file.close();
+    if (offset != size) {
+        // If it can't be cut off (another client may be part way through writing it), Append() picks up from offset
+        TruncateTornRecord(_path, size, offset);
+    }
+    path = _path;
+    file_size = offset;
+    return true;
+}
+
+uint64_t RunHistory::IndexRecords(std::ifstream& file, uint64_t offset, const uint64_t size)
+{
+    RecordHeader record;
+    std::string name;
+    Run run;
+    while (offset + sizeof(record) <= size) {
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(offset));
+        if (!file.read(reinterpret_cast<char*>(&record), sizeof(record))
+            || record.name_length > record.size
+            || offset + sizeof(record) + record.size > size) {
+            break;
+        }
+        name.resize(record.name_length);
+        if (!file.read(name.data(), record.name_length)) {
+            break;
+        }
+        offsets.push_back(offset);
+        offsets_by_utc_start[record.utc_start] = offset;
+        auto found = run_names.find(name);
+        if (found == run_names.end()) {
+            found = run_names.emplace(name, RunName{}).first;
+        }
+        found->second.offsets.push_back(offset);
+        if (found->second.splits_loaded && ReadRun(file, offset, run)) {
+            IndexSplits(found->second, run);
+        }
+        offset += sizeof(record) + record.size;
+    }
+    return offset;
+}
+
+bool RunHistory::IsOpen() const
+{
+    std::lock_guard lock(mutex);
+    return !path.empty();
+}
+
+size_t RunHistory::size() const
+{
+    std::lock_guard lock(mutex);
+    return offsets.size();
+}
+
+bool RunHistory::Contains(const uint32_t utc_start) const
+{
+    std::lock_guard lock(mutex);
+    return offsets_by_utc_start.contains(utc_start);
+}
+
+bool RunHistory::Append(const Run& run)
+{
+    const auto record = SerializeRun(run);
+    std::lock_guard lock(mutex);
+    if (path.empty()) {
+        return false;
+    }
+    // No FILE_SHARE_WRITE, so no other client can append until this one is done
+    const HANDLE handle = CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size;
+    bool ok = GetFileSizeEx(handle, &size);
+    const auto offset = ok ? static_cast<uint64_t>(size.QuadPart) : 0;
+    if (ok && offset > file_size) {
+        // Another client has appended since this one last did
+        std::ifstream file(path, std::ios::binary);
+        file_size = IndexRecords(file, file_size, offset);
+    }
+    // A partly written record left by another client is cut off by the next Open(); don't append after it
+    ok = ok && offset == file_size && !offsets_by_utc_start.contains(run.utc_start);
+    if (ok) {
+        const LARGE_INTEGER end{.QuadPart = static_cast<LONGLONG>(offset)};
+        DWORD written = 0;
+        ok = SetFilePointerEx(handle, end, nullptr, FILE_BEGIN)
+             && WriteFile(handle, record.data(), static_cast<DWORD>(record.size()), &written, nullptr)
+             && written == record.size();
+        if (!ok) {
+            // Don't leave part of a record for the next one to be appended after; nobody else has written past offset
+            SetFilePointerEx(handle, end, nullptr, FILE_BEGIN);
+            SetEndOfFile(handle);
+        }
+    }
+    CloseHandle(handle);
+    if (!ok) {
+        return false;
+    }
+    file_size += record.size();
+    offsets.push_back(offset);
+    offsets_by_utc_start[run.utc_start] = offset;
+    auto found = run_names.find(run.name);
+    if (found == run_names.end()) {
+        found = run_names.emplace(run.name, RunName{}).first;
+    }
+    found->second.offsets.push_back(offset);
+    if (found->second.splits_loaded) {
+        IndexSplits(found->second, run);
+    }
+    return true;
+}
+
+std::vector<RunHistory::Run> RunHistory::ReadLatest(const size_t count) const
+{
+    std::lock_guard lock(mutex);
+    std::vector<Run> runs;
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return runs;
+    }
+    const auto first = offsets.size() - std::min(count, offsets.size());
+    runs.reserve(offsets.size() - first);
+    for (auto i = first; i < offsets.size(); i++) {
+        if (!ReadRun(file, offsets[i], runs.emplace_back())) {
+            runs.pop_back();
+        }
+    }
+    return runs;
+}
+
+void RunHistory::LoadSplits(const std::string_view run_name)
+{
+    // The file is read without holding the lock, so that queries on the render thread aren't held up
+    std::vector<uint64_t> to_read;
+    std::filesystem::path file_path;
+    {
+        std::lock_guard lock(mutex);
+        const auto found = run_names.find(run_name);
+        if (found == run_names.end() || found->second.splits_loaded) {
+            return;
+        }
+        to_read = found->second.offsets;
+        file_path = path;
+    }
+    RunName loaded;
+    {
+        std::ifstream file(file_path, std::ios::binary);
+        Run run;
+        for (const auto offset : to_read) {
+            if (ReadRun(file, offset, run)) {
+                IndexSplits(loaded, run);
+            }
+        }
+    }
+
+    std::lock_guard lock(mutex);
+    const auto found = run_names.find(run_name);
+    if (found == run_names.end() || found->second.splits_loaded) {
+        return;
+    }
+    auto& entry = found->second;
+    // Runs appended while reading weren't indexed by Append()
+    if (entry.offsets.size() > to_read.size()) {
+        std::ifstream file(path, std::ios::binary);
+        Run run;
+        for (auto i = to_read.size(); i < entry.offsets.size(); i++) {
+            if (ReadRun(file, entry.offsets[i], run)) {
+                IndexSplits(loaded, run);
+            }
+        }
+    }
+    entry.splits = std::move(loaded.splits);
+    entry.splits_loaded = true;
+}
+
+bool RunHistory::SplitsLoaded(const std::string_view run_name) const
+{
+    std::lock_guard lock(mutex);
+    const auto found = run_names.find(run_name);
+    return found != run_names.end() && found->second.splits_loaded;
+}
+
+void RunHistory::IndexSplits(RunName& run_name, const Run& run)
+{
+    for (const auto& split : run.splits) {
+        if (split.done == time_unknown) {
+            continue;
+        }
+        auto found = run_name.splits.find(split.name);
+        if (found == run_name.splits.end()) {
+            found = run_name.splits.emplace(split.name, std::vector<uint32_t>{}).first;
+        }
+        auto& times = found->second;
+        times.insert(std::ranges::upper_bound(times, split.done), split.done);
+    }
+}
+
+const std::vector<uint32_t>* RunHistory::FindSplits(const std::string_view run_name, const std::string_view objective) const
+{
+    const auto found_name = run_names.find(run_name);
+    if (found_name == run_names.end()) {
+        return nullptr;
+    }
+    const auto found = found_name->second.splits.find(objective);
+    return found == found_name->second.splits.end() ? nullptr : &found->second;
+}
+
+size_t RunHistory::SplitCount(const std::string_view run_name, const std::string_view objective) const
+{
+    std::lock_guard lock(mutex);
+    const auto times = FindSplits(run_name, objective);
+    return times ? times->size() : 0;
+}
+
+uint32_t RunHistory::BestSplit(const std::string_view run_name, const std::string_view objective) const
+{
+    return PercentileSplit(run_name, objective, 0.f);
+}
+
+uint32_t RunHistory::MedianSplit(const std::string_view run_name, const std::string_view objective) const
+{
+    return PercentileSplit(run_name, objective, 50.f);
+}
+
+uint32_t RunHistory::PercentileSplit(const std::string_view run_name, const std::string_view objective, const float percentile) const
+{
+    std::lock_guard lock(mutex);
+    const auto times = FindSplits(run_name, objective);
+    if (!times || times->empty()) {
+        return time_unknown;
+    }
+    const auto rank = static_cast<size_t>(std::ceil(std::clamp(percentile, 0.f, 100.f) / 100.f * static_cast<float>(times->size())));
+    return (*times)[std::clamp<size_t>(rank, 1, times->size()) - 1];
+}
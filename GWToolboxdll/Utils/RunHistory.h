@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <Utils/StringMap.h>
+
+/*
+Append-only log of objective timer runs, with an index of split times per run name (map) and objective.
+
+Open() only reads each record's fixed header and run name, so startup cost doesn't depend on how many splits are
+stored. The split index for a run name is filled the first time LoadSplits() is called for it; until then its
+queries return time_unknown. Split times are "done" times in ms since the run started, kept sorted per objective.
+
+A record that was only partly written (e.g. the game crashed mid-append) is cut off the end of the log on Open().
+Every member is safe to call from any thread; file access is serialised behind one lock. Other clients can append to
+the same log: Append() holds the file open for writing exclusively, and first indexes any runs they've added.
+*/
+class RunHistory {
+public:
+    static constexpr uint32_t time_unknown = std::numeric_limits<uint32_t>::max();
+
+    struct Split {
+        std::string name;
+        uint32_t status = 0;
+        uint32_t start = time_unknown;
+        uint32_t done = time_unknown;
+        uint32_t duration = time_unknown;
+        uint32_t indent = 0;
+    };
+
+    struct Run {
+        std::string name;
+        uint32_t instance_start = 0;
+        uint32_t utc_start = 0;
+        uint32_t duration = time_unknown;
+        std::vector<Split> splits;
+    };
+
+    // Indexes the log at path, creating it if it doesn't exist. False if the file can't be opened or isn't a run log.
+    bool Open(const std::filesystem::path& path);
+    [[nodiscard]] bool IsOpen() const;
+    // Number of runs in the log
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] bool Contains(uint32_t utc_start) const;
+
+    bool Append(const Run& run);
+    // The last count runs appended, oldest first
+    [[nodiscard]] std::vector<Run> ReadLatest(size_t count) const;
+
+    // Reads every run with this name into the split index; a no-op if it has already been loaded
+    void LoadSplits(std::string_view run_name);
+    [[nodiscard]] bool SplitsLoaded(std::string_view run_name) const;
+
+    // Number of runs with this name that completed the objective
+    [[nodiscard]] size_t SplitCount(std::string_view run_name, std::string_view objective) const;
+    [[nodiscard]] uint32_t BestSplit(std::string_view run_name, std::string_view objective) const;
+    [[nodiscard]] uint32_t MedianSplit(std::string_view run_name, std::string_view objective) const;
+    // Nearest-rank percentile (0 to 100) of the objective's split times
+    [[nodiscard]] uint32_t PercentileSplit(std::string_view run_name, std::string_view objective, float percentile) const;
+
+private:
+    struct RunName {
+        std::vector<uint64_t> offsets; // File offset of every record with this name, in log order
+        bool splits_loaded = false;
+        StringMap<std::vector<uint32_t>> splits; // Objective name -> sorted split times
+    };
+
+    // Indexes the records from offset up to size; returns the end of the last whole record. Must hold the lock.
+    uint64_t IndexRecords(std::ifstream& file, uint64_t offset, uint64_t size);
+    [[nodiscard]] const std::vector<uint32_t>* FindSplits(std::string_view run_name, std::string_view objective) const;
+    static void IndexSplits(RunName& run_name, const Run& run);
+
+    mutable std::mutex mutex;
+    std::filesystem::path path;
+    uint64_t file_size = 0;
+    std::vector<uint64_t> offsets; // Every record, in log order
+    std::unordered_map<uint32_t, uint64_t> offsets_by_utc_start;
+    StringMap<RunName> run_names;
+};
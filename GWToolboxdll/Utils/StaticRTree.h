@@ -0,0 +1,223 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <queue>
+#include <utility>
+#include <vector>
+
+/*
+Read-only 2D R-tree, packed bottom-up with Sort-Tile-Recursive.
+
+Built once from a list of (box, value) pairs and never modified afterwards; rebuild it if the data changes.
+Nodes live in one flat array, so a query is a handful of cache-friendly box tests per level instead of a scan
+over every entry.
+
+    StaticRTree<MapID> tree;
+    tree.Build(std::move(entries));
+    tree.QueryPoint(x, y, [](const auto& box, MapID id) { ... return true; }); // return false to stop early
+*/
+template <typename T>
+class StaticRTree {
+public:
+    struct Box {
+        float min_x = 0.f;
+        float min_y = 0.f;
+        float max_x = 0.f;
+        float max_y = 0.f;
+
+        [[nodiscard]] bool Contains(const float x, const float y) const { return x >= min_x && x < max_x && y >= min_y && y < max_y; }
+        [[nodiscard]] bool Overlaps(const Box& other) const { return min_x <= other.max_x && other.min_x <= max_x && min_y <= other.max_y && other.min_y <= max_y; }
+        [[nodiscard]] float CenterX() const { return (min_x + max_x) * .5f; }
+        [[nodiscard]] float CenterY() const { return (min_y + max_y) * .5f; }
+
+        // Squared distance from a point to the nearest edge; 0 if inside
+        [[nodiscard]] float DistanceSq(const float x, const float y) const
+        {
+            const float dx = x < min_x ? min_x - x : x > max_x ? x - max_x : 0.f;
+            const float dy = y < min_y ? min_y - y : y > max_y ? y - max_y : 0.f;
+            return dx * dx + dy * dy;
+        }
+
+        void Expand(const Box& other)
+        {
+            min_x = std::min(min_x, other.min_x);
+            min_y = std::min(min_y, other.min_y);
+            max_x = std::max(max_x, other.max_x);
+            max_y = std::max(max_y, other.max_y);
+        }
+    };
+    using Entry = std::pair<Box, T>;
+
+    void Build(std::vector<Entry> new_entries)
+    {
+        entries = std::move(new_entries);
+        nodes.clear();
+        leaf_count = 0;
+        if (entries.empty()) {
+            return;
+        }
+        SortTileRecursive(entries, [](const Entry& e) -> const Box& { return e.first; });
+
+        std::vector<Node> level;
+        for (uint32_t i = 0; i < entries.size(); i += node_capacity) {
+            level.push_back(MakeNode(i, std::min<uint32_t>(node_capacity, static_cast<uint32_t>(entries.size()) - i), [this](const uint32_t child) -> const Box& {
+                return entries[child].first;
+            }));
+        }
+        leaf_count = static_cast<uint32_t>(level.size());
+        while (true) {
+            if (level.size() > 1) {
+                SortTileRecursive(level, [](const Node& n) -> const Box& { return n.box; });
+            }
+            const auto offset = static_cast<uint32_t>(nodes.size());
+            nodes.insert(nodes.end(), level.begin(), level.end());
+            if (level.size() == 1) {
+                break;
+            }
+            std::vector<Node> parents;
+            for (uint32_t i = 0; i < level.size(); i += node_capacity) {
+                parents.push_back(MakeNode(offset + i, std::min<uint32_t>(node_capacity, static_cast<uint32_t>(level.size()) - i), [this](const uint32_t child) -> const Box& {
+                    return nodes[child].box;
+                }));
+            }
+            level = std::move(parents);
+        }
+    }
+
+    void clear()
+    {
+        entries.clear();
+        nodes.clear();
+        leaf_count = 0;
+    }
+
+    [[nodiscard]] bool empty() const { return entries.empty(); }
+    [[nodiscard]] size_t size() const { return entries.size(); }
+    [[nodiscard]] const std::vector<Entry>& GetEntries() const { return entries; }
+
+    // Calls fn(box, value) for every entry whose box overlaps the query box; fn returns false to stop early.
+    template <typename Fn>
+    void Query(const Box& query, Fn&& fn) const
+    {
+        Visit([&query](const Box& box) { return box.Overlaps(query); }, fn);
+    }
+
+    // Calls fn(box, value) for every entry whose box contains the point; fn returns false to stop early.
+    template <typename Fn>
+    void QueryPoint(const float x, const float y, Fn&& fn) const
+    {
+        Visit([x, y](const Box& box) { return box.DistanceSq(x, y) == 0.f; }, [x, y, &fn](const Box& box, const T& value) {
+            return !box.Contains(x, y) || fn(box, value);
+        });
+    }
+
+    // Closest entry to the point that passes filter(box, value), by distance to its box. nullptr if none.
+    template <typename Filter>
+    const Entry* Nearest(const float x, const float y, Filter&& filter, float* distance_out = nullptr) const
+    {
+        if (nodes.empty()) {
+            return nullptr;
+        }
+        // Best-first: (squared distance, index); indexes with the top bit set are entries, otherwise nodes
+        using Candidate = std::pair<float, uint32_t>;
+        constexpr uint32_t entry_bit = 0x80000000;
+        std::priority_queue<Candidate, std::vector<Candidate>, std::greater<>> queue;
+        const auto root = static_cast<uint32_t>(nodes.size() - 1);
+        queue.emplace(nodes[root].box.DistanceSq(x, y), root);
+        while (!queue.empty()) {
+            const auto [distance, index] = queue.top();
+            queue.pop();
+            if (index & entry_bit) {
+                const auto& entry = entries[index & ~entry_bit];
+                if (!filter(entry.first, entry.second)) {
+                    continue;
+                }
+                if (distance_out) {
+                    *distance_out = std::sqrt(distance);
+                }
+                return &entry;
+            }
+            const auto& node = nodes[index];
+            for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                if (index < leaf_count) {
+                    queue.emplace(entries[i].first.DistanceSq(x, y), i | entry_bit);
+                }
+                else {
+                    queue.emplace(nodes[i].box.DistanceSq(x, y), i);
+                }
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    static constexpr uint32_t node_capacity = 8;
+
+    struct Node {
+        Box box;
+        uint32_t first = 0; // First child; an index into entries for leaves, into nodes otherwise
+        uint32_t count = 0;
+    };
+
+    std::vector<Entry> entries;
+    std::vector<Node> nodes; // Leaves first, root last
+    uint32_t leaf_count = 0;
+
+    template <typename GetBox>
+    static Node MakeNode(const uint32_t first, const uint32_t count, GetBox&& get_box)
+    {
+        Node node{get_box(first), first, count};
+        for (uint32_t i = first + 1; i < first + count; i++) {
+            node.box.Expand(get_box(i));
+        }
+        return node;
+    }
+
+    // Orders items so that each run of node_capacity is a compact tile: vertical slices by x, then runs by y
+    template <typename Item, typename GetBox>
+    static void SortTileRecursive(std::vector<Item>& items, GetBox&& get_box)
+    {
+        const auto node_count = (items.size() + node_capacity - 1) / node_capacity;
+        const auto slice_count = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(node_count))));
+        const auto slice_size = slice_count * node_capacity;
+        std::ranges::sort(items, [&get_box](const Item& a, const Item& b) {
+            return get_box(a).CenterX() < get_box(b).CenterX();
+        });
+        for (size_t i = 0; i < items.size(); i += slice_size) {
+            const auto end = items.begin() + std::min(items.size(), i + slice_size);
+            std::sort(items.begin() + i, end, [&get_box](const Item& a, const Item& b) {
+                return get_box(a).CenterY() < get_box(b).CenterY();
+            });
+        }
+    }
+
+    template <typename Accept, typename Fn>
+    void Visit(Accept&& accept, Fn&& fn) const
+    {
+        if (nodes.empty()) {
+            return;
+        }
+        uint32_t stack[64];
+        uint32_t depth = 0;
+        stack[depth++] = static_cast<uint32_t>(nodes.size() - 1);
+        while (depth) {
+            const auto& node = nodes[stack[--depth]];
+            if (!accept(node.box)) {
+                continue;
+            }
+            const bool is_leaf = static_cast<uint32_t>(&node - nodes.data()) < leaf_count;
+            for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                if (is_leaf) {
+                    if (accept(entries[i].first) && !fn(entries[i].first, entries[i].second)) {
+                        return;
+                    }
+                }
+                else {
+                    stack[depth++] = i;
+                }
+            }
+        }
+    }
+};
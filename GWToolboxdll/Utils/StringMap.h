@@ -0,0 +1,21 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/*
+std::string keyed hash map that can be looked up with a std::string_view or const char* without building a
+std::string for the key first:
+
+    StringMap<uint32_t> ids;
+    const auto found = ids.find(std::string_view(name, name_len));
+*/
+struct StringHash {
+    using is_transparent = void;
+    size_t operator()(const std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+};
+
+template <typename T>
+using StringMap = std::unordered_map<std::string, T, StringHash, std::equal_to<>>;
@@ -472,6 +472,20 @@ void TeamBuild::ResetEncodedCache() const
     encoded_cache_.reset();
 }
 
+void TeamBuild::CacheEncoded(const std::span<TeamBuild* const> tbuilds)
+{
+    std::vector<const TeamBuild*> uncached;
+    for (const auto* tbuild : tbuilds) {
+        if (!tbuild->encoded_cache_.has_value())
+            uncached.push_back(tbuild);
+    }
+    if (uncached.empty())
+        return;
+    auto encoded = TeamBuildEncoder::TeamBuildsToEncoded(uncached);
+    for (size_t i = 0; i < uncached.size(); i++)
+        uncached[i]->encoded_cache_ = std::move(encoded[i]);
+}
+
 void TeamBuild::Send(bool one_by_one) const
 {
     if (!name.empty())
@@ -3,6 +3,7 @@
 #include <functional>
 #include <optional>
 #include <set>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -118,6 +119,9 @@ struct TeamBuild {
     // Invalidate the encoded teambuild cache (call when build codes or hero IDs change).
     void ResetEncodedCache() const;
 
+    // Fills the encoded cache of every team build in tbuilds that doesn't have one yet, in one batch.
+    static void CacheEncoded(std::span<TeamBuild* const> tbuilds);
+
 private:
     int editing_build_idx_ = -1; // which build row is expanded (player-builds layout)
     bool send_all_confirming_ = false;
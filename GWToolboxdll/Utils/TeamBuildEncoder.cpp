@@ -3,6 +3,9 @@
 #include <algorithm>
 #include <cstring>
 #include <format>
+#include <memory>
+#include <mutex>
+#include <span>
 
 #include <GWCA/GameEntities/Skill.h>
 #include <GWCA/Managers/MapMgr.h>
@@ -339,7 +342,7 @@ namespace TeamBuildEncoder {
     }
 
 
-    std::vector<SkillID> GetAccessibleSkills(Profession primary, Profession secondary, bool is_hero, const GW::SkillbarMgr::SkillTemplate* tmpl = nullptr)
+    static std::vector<SkillID> BuildAccessibleSkills(Profession primary, Profession secondary, bool is_hero, const GW::SkillbarMgr::SkillTemplate* tmpl = nullptr)
     {
         Attribute pri_attrs[5], sec_attrs[5];
         int pri_count = GetProfAttributes(primary, pri_attrs, 5);
@@ -408,6 +411,57 @@ namespace TeamBuildEncoder {
         return result;
     }
 
+    // Per profession-pair/hero tables, built on first use and kept for the lifetime of the dll.
+    // Skill constant data never changes at runtime, so encoding/decoding team builds only pays
+    // for the skill table walk once per combination.
+    struct AccessibleSkillTable {
+        std::vector<SkillID> skills;
+        // 1-based position of each skill in `skills`, 0 if not accessible
+        std::array<uint16_t, static_cast<size_t>(SkillID::Count)> index_by_skill{};
+
+        [[nodiscard]] uint32_t IndexOf(const SkillID skill_id) const
+        {
+            const auto id = static_cast<size_t>(skill_id);
+            return id < index_by_skill.size() ? index_by_skill[id] : 0u;
+        }
+        [[nodiscard]] SkillID At(const uint32_t one_based_index) const
+        {
+            return one_based_index == 0 || one_based_index > skills.size() ? SkillID::No_Skill : skills[one_based_index - 1];
+        }
+    };
+
+    static const AccessibleSkillTable& GetAccessibleSkillTable(Profession primary, Profession secondary, bool is_hero)
+    {
+        static std::unique_ptr<AccessibleSkillTable> tables[11][11][2];
+        static std::mutex tables_mutex;
+
+        static const AccessibleSkillTable empty_table;
+        const auto pri = static_cast<size_t>(primary);
+        const auto sec = static_cast<size_t>(secondary);
+        if (pri >= 11 || sec >= 11) 
+            return empty_table;
+
+        std::lock_guard lock(tables_mutex);
+        auto& table = tables[pri][sec][is_hero ? 1 : 0];
+        if (table) 
+            return *table;
+
+        auto built = std::make_unique<AccessibleSkillTable>();
+        built->skills = BuildAccessibleSkills(primary, secondary, is_hero);
+        for (size_t i = 0; i < built->skills.size(); i++) {
+            built->index_by_skill[static_cast<size_t>(built->skills[i])] = static_cast<uint16_t>(i + 1);
+        }
+        if (built->skills.empty()) 
+            return empty_table; // Skill constant data not available yet; don't cache the empty result
+        table = std::move(built);
+        return *table;
+    }
+
+    std::vector<SkillID> GetAccessibleSkills(Profession primary, Profession secondary)
+    {
+        return GetAccessibleSkillTable(primary, secondary, false).skills;
+    }
+
     // ---------------------------------------------------------------------------
     // Shared hero write/read for EncodedTeamBuild
     //
@@ -477,14 +531,13 @@ namespace TeamBuildEncoder {
             bw.write(values[i], 4);
 
         // --- Skills ---
-        const auto accessible = GetAccessibleSkills(primary, secondary, is_hero);
+        const auto& accessible = GetAccessibleSkillTable(primary, secondary, is_hero);
 
         uint32_t max_idx = 0;
         for (int i = 0; i < 8; i++) {
             const auto skill_id = tmpl.skills[i];
             if (skill_id == SkillID::No_Skill) continue;
-            const auto it = std::find(accessible.begin(), accessible.end(), skill_id);
-            if (it != accessible.end()) max_idx = std::max(max_idx, static_cast<uint32_t>(it - accessible.begin()) + 1);
+            max_idx = std::max(max_idx, accessible.IndexOf(skill_id));
         }
 
         const uint32_t wide = max_idx > 255 ? 1u : 0u;
@@ -497,8 +550,7 @@ namespace TeamBuildEncoder {
                 bw.write(0, skill_bits);
                 continue;
             }
-            const auto it = std::find(accessible.begin(), accessible.end(), skill_id);
-            bw.write(it != accessible.end() ? static_cast<uint32_t>(it - accessible.begin()) + 1 : 0u, skill_bits);
+            bw.write(accessible.IndexOf(skill_id), skill_bits);
         }
     }
 
@@ -541,11 +593,10 @@ namespace TeamBuildEncoder {
         tmpl.attributes_count = attr_idx;
 
         // --- Skills ---
-        const auto accessible = GetAccessibleSkills(primary, secondary, is_hero);
+        const auto& accessible = GetAccessibleSkillTable(primary, secondary, is_hero);
         const int skill_bits = br.read(1) ? 9 : 8;
         for (int i = 0; i < 8; i++) {
-            const uint32_t idx = br.read(skill_bits);
-            tmpl.skills[i] = (idx == 0 || idx > accessible.size()) ? SkillID::No_Skill : accessible[idx - 1];
+            tmpl.skills[i] = accessible.At(br.read(skill_bits));
         }
 
         return br.ok;
@@ -555,10 +606,8 @@ namespace TeamBuildEncoder {
     // EncodedTeamBuild
     // ---------------------------------------------------------------------------
 
-    EncodedTeamBuild TeamBuildToEncoded(const TeamHeroBuild& tbuild)
+    static EncodedTeamBuild TeamBuildToEncoded(const TeamHeroBuild& tbuild, const uint32_t magic)
     {
-        const uint32_t magic = GetEncodedMagic();
-
         BitWriter bw;
         bw.write(magic, 4);
         auto build_count_pos = bw.pos;
@@ -580,6 +629,22 @@ namespace TeamBuildEncoder {
         return BytesToEncoded(bw.buf, magic);
     }
 
+    EncodedTeamBuild TeamBuildToEncoded(const TeamHeroBuild& tbuild)
+    {
+        return TeamBuildToEncoded(tbuild, GetEncodedMagic());
+    }
+
+    std::vector<EncodedTeamBuild> TeamBuildsToEncoded(std::span<const TeamHeroBuild* const> tbuilds)
+    {
+        const uint32_t magic = GetEncodedMagic();
+        std::vector<EncodedTeamBuild> result;
+        result.reserve(tbuilds.size());
+        for (const auto* tbuild : tbuilds) {
+            result.push_back(tbuild ? TeamBuildToEncoded(*tbuild, magic) : EncodedTeamBuild{});
+        }
+        return result;
+    }
+
     bool EncodedToTeamBuild(const EncodedTeamBuild& encoded, TeamHeroBuild& out)
     {
         const uint32_t magic = DetectMagic(encoded);
@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include <array>
+#include <span>
 
 #include <GWCA/Constants/Skills.h>
 #include <GWCA/Constants/Constants.h>
@@ -89,6 +90,9 @@ namespace TeamBuildEncoder {
     // Returns false on failure.
     bool              EncodedToTeamBuild(const EncodedTeamBuild& encoded, TeamHeroBuild& out);
 
+    // Batch variant for encoding a whole list of team builds at once; entries that fail to encode come back empty.
+    std::vector<EncodedTeamBuild> TeamBuildsToEncoded(std::span<const TeamHeroBuild* const> tbuilds);
+
     // Returns true if the wstring looks like one of our EncodedTeamBuilds.
     bool              IsEncodedTeamBuild(const EncodedTeamBuild& encoded);
 
@@ -161,6 +165,7 @@ namespace TeamBuildEncoder {
 
     // Returns the deterministic sorted skill list accessible to a primary/secondary combo.
     // Excludes PvP skills. Includes PvE skills. Profession-matched only (no no-profession skills).
+    // Tables are built once per profession pair on first use and cached.
     std::vector<GW::Constants::SkillID> GetAccessibleSkills(
         GW::Constants::Profession primary,
         GW::Constants::Profession secondary);
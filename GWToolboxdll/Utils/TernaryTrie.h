@@ -0,0 +1,200 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/*
+Ternary search trie mapping wide-string keys to values.
+
+Lookups cost one character comparison per node on the path, with no hashing or allocation, and every key sharing a
+prefix lives under one node, so prefix completion is a walk of that subtree. Nodes live in one flat array; there is
+no erase, so rebuild the trie (clear() and insert again) when keys are removed.
+
+    static const TernaryTrie<uint32_t> channels = {{L"all", 0}, {L"guild", 2}};
+    if (const auto channel = channels.Find(argv[1])) { ... }
+    channels.ForEachWithPrefix(L"gu", [](const std::wstring& key, uint32_t value) { ... return true; }); // return false to stop early
+*/
+template <typename T>
+class TernaryTrie {
+public:
+    TernaryTrie() = default;
+
+    TernaryTrie(const std::initializer_list<std::pair<std::wstring_view, T>> entries)
+    {
+        for (const auto& [key, value] : entries) {
+            (*this)[key] = value;
+        }
+    }
+
+    // Value for key, default constructing it if the key is new. key must not be empty.
+    T& operator[](const std::wstring_view key)
+    {
+        const auto index = FindOrCreateNode(key);
+        if (nodes[index].value == none) {
+            nodes[index].value = static_cast<uint32_t>(values.size());
+            values.emplace_back();
+        }
+        return values[nodes[index].value];
+    }
+
+    [[nodiscard]] const T* Find(const std::wstring_view key) const
+    {
+        const auto index = FindNode(key);
+        return index == none || nodes[index].value == none ? nullptr : &values[nodes[index].value];
+    }
+
+    [[nodiscard]] T* Find(const std::wstring_view key)
+    {
+        return const_cast<T*>(std::as_const(*this).Find(key));
+    }
+
+    // Calls fn(key, value) for every key starting with prefix, in key order; fn returns false to stop early.
+    template <typename Fn>
+    void ForEachWithPrefix(const std::wstring_view prefix, Fn&& fn) const
+    {
+        if (nodes.empty()) {
+            return;
+        }
+        std::wstring key(prefix);
+        uint32_t start = root;
+        if (!prefix.empty()) {
+            const auto index = FindNode(prefix);
+            if (index == none) {
+                return;
+            }
+            if (nodes[index].value != none && !fn(std::as_const(key), values[nodes[index].value])) {
+                return;
+            }
+            start = nodes[index].eq;
+        }
+        // Entries are (node, depth of its character in the key, whether its lower branch has been visited)
+        struct Pending {
+            uint32_t node;
+            uint32_t depth;
+            bool visit_self;
+        };
+        std::vector<Pending> stack;
+        if (start != none) {
+            stack.push_back({start, static_cast<uint32_t>(key.size()), false});
+        }
+        while (!stack.empty()) {
+            const auto [index, depth, visit_self] = stack.back();
+            stack.pop_back();
+            const auto& node = nodes[index];
+            if (!visit_self) {
+                if (node.hi != none) {
+                    stack.push_back({node.hi, depth, false});
+                }
+                stack.push_back({index, depth, true});
+                if (node.lo != none) {
+                    stack.push_back({node.lo, depth, false});
+                }
+                continue;
+            }
+            key.resize(depth);
+            key.push_back(node.c);
+            if (node.value != none && !fn(std::as_const(key), values[node.value])) {
+                return;
+            }
+            if (node.eq != none) {
+                stack.push_back({node.eq, depth + 1, false});
+            }
+        }
+    }
+
+    void clear()
+    {
+        nodes.clear();
+        values.clear();
+        root = none;
+    }
+
+    [[nodiscard]] bool empty() const { return values.empty(); }
+    [[nodiscard]] size_t size() const { return values.size(); }
+
+private:
+    static constexpr uint32_t none = 0xffffffff;
+
+    struct Node {
+        wchar_t c = 0;
+        uint32_t lo = none; // Keys with a smaller character at this position
+        uint32_t eq = none; // Next character of keys that match this one
+        uint32_t hi = none;
+        uint32_t value = none; // Index into values if a key ends here
+    };
+
+    std::vector<Node> nodes;
+    std::vector<T> values;
+    uint32_t root = none;
+
+    uint32_t NewNode(const wchar_t c)
+    {
+        nodes.push_back({c});
+        return static_cast<uint32_t>(nodes.size() - 1);
+    }
+
+    [[nodiscard]] uint32_t FindNode(const std::wstring_view key) const
+    {
+        if (key.empty()) {
+            return none;
+        }
+        uint32_t index = root;
+        size_t i = 0;
+        while (index != none) {
+            const auto& node = nodes[index];
+            if (key[i] < node.c) {
+                index = node.lo;
+            }
+            else if (key[i] > node.c) {
+                index = node.hi;
+            }
+            else if (++i == key.size()) {
+                return index;
+            }
+            else {
+                index = node.eq;
+            }
+        }
+        return none;
+    }
+
+    uint32_t FindOrCreateNode(const std::wstring_view key)
+    {
+        if (root == none) {
+            root = NewNode(key[0]);
+        }
+        uint32_t index = root;
+        size_t i = 0;
+        while (true) {
+            const auto c = key[i];
+            if (c < nodes[index].c) {
+                if (nodes[index].lo == none) {
+                    const auto child = NewNode(c);
+                    nodes[index].lo = child;
+                }
+                index = nodes[index].lo;
+            }
+            else if (c > nodes[index].c) {
+                if (nodes[index].hi == none) {
+                    const auto child = NewNode(c);
+                    nodes[index].hi = child;
+                }
+                index = nodes[index].hi;
+            }
+            else if (++i == key.size()) {
+                return index;
+            }
+            else {
+                if (nodes[index].eq == none) {
+                    const auto child = NewNode(key[i]);
+                    nodes[index].eq = child;
+                }
+                index = nodes[index].eq;
+            }
+        }
+    }
+};
@@ -0,0 +1,131 @@
+#include "stdafx.h"
+
+#include <Utils/TerrainHeightfield.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    constexpr uint32_t file_magic = 0x44464854; // "THFD"
+    constexpr uint32_t file_version = 2;
+
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t map_id;
+        uint32_t tile_count;
+        uint64_t source_hash;
+    };
+
+    uint64_t TileKey(const uint32_t plane, const int32_t tile_x, const int32_t tile_y)
+    {
+        return static_cast<uint64_t>(plane) << 32 | static_cast<uint64_t>(static_cast<uint16_t>(tile_x)) << 16 | static_cast<uint16_t>(tile_y);
+    }
+
+    // Floor division, so cells left of/below the origin land in the right tile
+    int32_t FloorDiv(const int32_t value, const int32_t divisor)
+    {
+        const auto quotient = value / divisor;
+        return value % divisor < 0 ? quotient - 1 : quotient;
+    }
+}
+
+const TerrainHeightfield::Tile* TerrainHeightfield::GetOrBakeTile(const uint32_t plane, const int32_t tile_x, const int32_t tile_y, const QueryFn& query, uint32_t& query_budget)
+{
+    const auto key = TileKey(plane, tile_x, tile_y);
+    if (const auto found = tiles.find(key); found != tiles.end()) {
+        return &found->second;
+    }
+    if (query_budget < queries_per_tile) {
+        return nullptr;
+    }
+    query_budget -= queries_per_tile;
+    Tile tile;
+    const auto origin_x = static_cast<float>(tile_x * static_cast<int32_t>(tile_cells)) * cell_size;
+    const auto origin_y = static_cast<float>(tile_y * static_cast<int32_t>(tile_cells)) * cell_size;
+    for (uint32_t y = 0; y < samples_per_side; y++) {
+        for (uint32_t x = 0; x < samples_per_side; x++) {
+            tile.samples[y * samples_per_side + x] = query(origin_x + x * cell_size, origin_y + y * cell_size, plane);
+        }
+    }
+    dirty = true;
+    return &tiles.emplace(key, tile).first->second;
+}
+
+bool TerrainHeightfield::Sample(const GW::GamePos& point, float& out, const QueryFn& query, uint32_t& query_budget)
+{
+    const auto grid_x = point.x / cell_size;
+    const auto grid_y = point.y / cell_size;
+    const auto cell_x = static_cast<int32_t>(std::floor(grid_x));
+    const auto cell_y = static_cast<int32_t>(std::floor(grid_y));
+    const auto tile_x = FloorDiv(cell_x, static_cast<int32_t>(tile_cells));
+    const auto tile_y = FloorDiv(cell_y, static_cast<int32_t>(tile_cells));
+    const auto tile = GetOrBakeTile(point.zplane, tile_x, tile_y, query, query_budget);
+    if (!tile) {
+        return false;
+    }
+    const auto local_x = static_cast<uint32_t>(cell_x - tile_x * static_cast<int32_t>(tile_cells));
+    const auto local_y = static_cast<uint32_t>(cell_y - tile_y * static_cast<int32_t>(tile_cells));
+    const auto* row0 = &tile->samples[local_y * samples_per_side + local_x];
+    const auto* row1 = row0 + samples_per_side;
+    const auto [lowest, highest] = std::minmax({row0[0], row0[1], row1[0], row1[1]});
+    if (highest - lowest > max_blend_step) {
+        out = query(point.x, point.y, point.zplane);
+        return true;
+    }
+    const auto fx = grid_x - static_cast<float>(cell_x);
+    const auto fy = grid_y - static_cast<float>(cell_y);
+    const auto top = row0[0] + (row0[1] - row0[0]) * fx;
+    const auto bottom = row1[0] + (row1[1] - row1[0]) * fx;
+    out = top + (bottom - top) * fy;
+    return true;
+}
+
+bool TerrainHeightfield::SampleAltitude(const std::span<const GW::GamePos> points, const std::span<float> out, const QueryFn& query, uint32_t& query_budget)
+{
+    ASSERT(out.size() >= points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+        if (!Sample(points[i], out[i], query, query_budget)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string TerrainHeightfield::Serialize() const
+{
+    std::string out;
+    out.reserve(sizeof(FileHeader) + tiles.size() * (sizeof(uint64_t) + sizeof(Tile)));
+    const FileHeader header{file_magic, file_version, map_id, static_cast<uint32_t>(tiles.size()), source_hash};
+    out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const auto& [key, tile] : tiles) {
+        out.append(reinterpret_cast<const char*>(&key), sizeof(key));
+        out.append(reinterpret_cast<const char*>(tile.samples.data()), sizeof(tile.samples));
+    }
+    return out;
+}
+
+bool TerrainHeightfield::Deserialize(const std::string_view data)
+{
+    tiles.clear();
+    dirty = false;
+    FileHeader header;
+    if (data.size() < sizeof(header)) {
+        return false;
+    }
+    memcpy(&header, data.data(), sizeof(header));
+    constexpr auto record_size = sizeof(uint64_t) + sizeof(Tile::samples);
+    if (header.magic != file_magic || header.version != file_version || header.map_id != map_id || header.source_hash != source_hash
+        || (data.size() - sizeof(header)) / record_size < header.tile_count) {
+        return false;
+    }
+    tiles.reserve(header.tile_count);
+    auto record = data.data() + sizeof(header);
+    for (uint32_t i = 0; i < header.tile_count; i++, record += record_size) {
+        uint64_t key;
+        memcpy(&key, record, sizeof(key));
+        memcpy(tiles[key].samples.data(), record + sizeof(key), sizeof(Tile::samples));
+    }
+    return true;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <GWCA/GameContainers/GamePos.h>
+
+/*
+Per-map grid of terrain altitudes, one layer per pathing plane, baked lazily from the game's altitude query.
+
+The grid is split into tiles of tile_cells x tile_cells cells; a tile is baked with one query per grid point the first
+time a point inside it is sampled, and Serialize() lets baked tiles be kept on disk so later visits to the map don't
+query at all. Saved tiles are tagged with a hash of the map's pathing data, so they're thrown away if a game update
+changes the map. A sample is the bilinear blend of its cell's four corners, except where the corners differ by more than
+max_blend_step (cliffs, the edges of bridges) - those points are queried exactly instead.
+
+Queries go through a caller-supplied function, with a budget on baking so that it can be spread over frames:
+
+    uint32_t budget = 4 * TerrainHeightfield::queries_per_tile;
+    if (!heightfield.SampleAltitude(points, altitudes, query, budget)) { ... try again next frame }
+*/
+class TerrainHeightfield {
+public:
+    static constexpr float cell_size = 32.f;
+    static constexpr uint32_t tile_cells = 8;
+    static constexpr float max_blend_step = 16.f;
+    static constexpr uint32_t queries_per_tile = (tile_cells + 1) * (tile_cells + 1);
+
+    using QueryFn = std::function<float(float x, float y, uint32_t plane)>;
+
+    explicit TerrainHeightfield(const uint32_t map_id = 0, const uint64_t source_hash = 0) : map_id(map_id), source_hash(source_hash) {}
+
+    [[nodiscard]] uint32_t GetMapId() const { return map_id; }
+    // Hash of the pathing data the altitudes were baked from
+    [[nodiscard]] uint64_t GetSourceHash() const { return source_hash; }
+    // True if tiles have been baked since the heightfield was created or last deserialized
+    [[nodiscard]] bool IsDirty() const { return dirty; }
+    void ClearDirty() { dirty = false; }
+
+    // Altitude of each point on its own plane, written to the matching index of out (at least as long as points).
+    // Baking a tile uses queries_per_tile from query_budget; returns false if the next tile needed doesn't fit, in which
+    // case outputs past the last point sampled are left untouched but the tiles baked so far are kept.
+    bool SampleAltitude(std::span<const GW::GamePos> points, std::span<float> out, const QueryFn& query, uint32_t& query_budget);
+
+    [[nodiscard]] std::string Serialize() const;
+    // Replaces the baked tiles with the ones in data; false (leaving the heightfield empty) if it isn't a heightfield for
+    // this map and source hash
+    bool Deserialize(std::string_view data);
+
+private:
+    static constexpr uint32_t samples_per_side = tile_cells + 1;
+
+    struct Tile {
+        std::array<float, samples_per_side * samples_per_side> samples{};
+    };
+
+    const Tile* GetOrBakeTile(uint32_t plane, int32_t tile_x, int32_t tile_y, const QueryFn& query, uint32_t& query_budget);
+    bool Sample(const GW::GamePos& point, float& out, const QueryFn& query, uint32_t& query_budget);
+
+    std::unordered_map<uint64_t, Tile> tiles;
+    uint32_t map_id = 0;
+    uint64_t source_hash = 0;
+    bool dirty = false;
+};
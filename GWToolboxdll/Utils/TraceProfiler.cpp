@@ -0,0 +1,331 @@
+#include "stdafx.h"
+
+#include "TraceProfiler.h"
+
+#include <bit>
+
+namespace TraceProfiler {
+    std::atomic<bool> enabled = false;
+}
+
+namespace {
+    using TraceProfiler::ZoneId;
+
+    struct Sample {
+        uint64_t start;
+        uint64_t end;
+        ZoneId id;
+    };
+
+    // Single producer (owning thread), single consumer (Collect() on the render thread)
+    struct ThreadBuffer {
+        static constexpr uint32_t capacity = 1 << 12;
+        std::array<Sample, capacity> samples{};
+        std::atomic<uint32_t> head = 0;
+        std::atomic<uint32_t> tail = 0;
+        std::atomic<uint64_t> dropped = 0;
+        std::atomic<bool> thread_exited = false;
+        DWORD thread_id = 0;
+    };
+
+    std::mutex buffers_mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    // Buffers of threads that have exited, drained and ready for the next new thread
+    std::vector<std::unique_ptr<ThreadBuffer>> spare_buffers;
+    constexpr size_t max_spare_buffers = 8;
+
+    // Hands the thread's buffer back for Collect() to drain and recycle when the thread exits
+    struct ThreadBufferOwner {
+        ThreadBuffer* buffer = nullptr;
+        ~ThreadBufferOwner()
+        {
+            if (buffer) buffer->thread_exited.store(true, std::memory_order_release);
+        }
+    };
+    thread_local ThreadBufferOwner tls_buffer;
+
+    ThreadBuffer* GetThreadBuffer()
+    {
+        if (tls_buffer.buffer) return tls_buffer.buffer;
+        std::lock_guard lock(buffers_mutex);
+        std::unique_ptr<ThreadBuffer> buffer;
+        if (spare_buffers.empty()) {
+            buffer = std::make_unique<ThreadBuffer>();
+        }
+        else {
+            buffer = std::move(spare_buffers.back());
+            spare_buffers.pop_back();
+        }
+        buffer->thread_id = GetCurrentThreadId();
+        tls_buffer.buffer = buffer.get();
+        buffers.push_back(std::move(buffer));
+        return tls_buffer.buffer;
+    }
+
+    // Zone registry; names are only ever appended, so readers just need the count
+    constexpr size_t max_zones = 1024;
+    std::array<const char*, max_zones> zone_names{};
+    std::atomic<size_t> zone_count = 1; // 0 is InvalidZone
+    std::mutex zones_mutex;
+    std::deque<std::string> zone_name_storage;
+    std::unordered_map<std::string_view, ZoneId> zone_ids_by_name;
+
+    // Log-linear histogram: 4 sub-buckets per power of two of microseconds (~25% resolution)
+    constexpr size_t bucket_count = 128;
+
+    size_t BucketForMicroseconds(const uint64_t us)
+    {
+        if (us < 4) return static_cast<size_t>(us);
+        const auto exponent = static_cast<size_t>(std::bit_width(us) - 1);
+        const auto sub = static_cast<size_t>((us >> (exponent - 2)) & 3);
+        return std::min(4 * (exponent - 1) + sub, bucket_count - 1);
+    }
+
+    uint64_t BucketLowerBound(const size_t bucket)
+    {
+        if (bucket < 4) return bucket;
+        const auto exponent = bucket / 4 + 1;
+        return static_cast<uint64_t>(4 + bucket % 4) << (exponent - 2);
+    }
+
+    struct ZoneHistogram {
+        std::array<uint32_t, bucket_count> buckets{};
+        uint64_t count = 0;
+        uint64_t total_us = 0;
+        uint64_t max_us = 0;
+
+        void Record(const uint64_t us)
+        {
+            buckets[BucketForMicroseconds(us)]++;
+            count++;
+            total_us += us;
+            max_us = std::max(max_us, us);
+        }
+
+        [[nodiscard]] uint64_t Percentile(const double pct) const
+        {
+            if (!count) return 0;
+            const auto target = static_cast<uint64_t>(pct * static_cast<double>(count - 1));
+            uint64_t seen = 0;
+            for (size_t i = 0; i < bucket_count; i++) {
+                seen += buckets[i];
+                if (seen > target) return std::min(BucketLowerBound(i), max_us);
+            }
+            return max_us;
+        }
+    };
+
+    // Owned by the collecting (render) thread
+    std::vector<ZoneHistogram> histograms;
+
+    struct CapturedSample {
+        uint64_t start;
+        uint64_t end;
+        DWORD thread_id;
+        ZoneId id;
+    };
+
+    constexpr size_t max_capture_samples = 2'000'000;
+    std::vector<CapturedSample> capture;
+    bool capturing = false;
+    uint64_t dropped_total = 0;
+
+    LARGE_INTEGER GetFrequency()
+    {
+        static const LARGE_INTEGER freq = [] {
+            LARGE_INTEGER f;
+            QueryPerformanceFrequency(&f);
+            return f;
+        }();
+        return freq;
+    }
+
+    void WriteJsonEscaped(std::ofstream& out, const char* str)
+    {
+        for (; str && *str; str++) {
+            switch (*str) {
+                case '"':
+                    out << "\\\"";
+                    break;
+                case '\\':
+                    out << "\\\\";
+                    break;
+                default:
+                    if (static_cast<unsigned char>(*str) >= 0x20) out << *str;
+                    break;
+            }
+        }
+    }
+}
+
+void TraceProfiler::SetEnabled(const bool enable)
+{
+    enabled.store(enable, std::memory_order_relaxed);
+    if (!enable) {
+        StopCapture();
+    }
+}
+
+TraceProfiler::ZoneId TraceProfiler::RegisterZone(const std::string_view name)
+{
+    std::lock_guard lock(zones_mutex);
+    if (const auto found = zone_ids_by_name.find(name); found != zone_ids_by_name.end()) {
+        return found->second;
+    }
+    const auto id = zone_count.load(std::memory_order_relaxed);
+    if (id >= max_zones) {
+        return InvalidZone;
+    }
+    const auto& stored = zone_name_storage.emplace_back(name);
+    zone_names[id] = stored.c_str();
+    zone_ids_by_name.emplace(stored, static_cast<ZoneId>(id));
+    zone_count.store(id + 1, std::memory_order_release);
+    return static_cast<ZoneId>(id);
+}
+
+const char* TraceProfiler::GetZoneName(const ZoneId id)
+{
+    return id != InvalidZone && id < zone_count.load(std::memory_order_acquire) ? zone_names[id] : "";
+}
+
+uint64_t TraceProfiler::Now()
+{
+    LARGE_INTEGER t;
+    QueryPerformanceCounter(&t);
+    return static_cast<uint64_t>(t.QuadPart);
+}
+
+uint64_t TraceProfiler::TicksToMicroseconds(const uint64_t ticks)
+{
+    return ticks * 1000000 / static_cast<uint64_t>(GetFrequency().QuadPart);
+}
+
+void TraceProfiler::Record(const ZoneId id, const uint64_t start_ticks, const uint64_t end_ticks)
+{
+    if (id == InvalidZone || !IsEnabled()) return;
+    auto* buffer = GetThreadBuffer();
+    const auto head = buffer->head.load(std::memory_order_relaxed);
+    const auto tail = buffer->tail.load(std::memory_order_acquire);
+    if (head - tail >= ThreadBuffer::capacity) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer->samples[head & (ThreadBuffer::capacity - 1)] = {start_ticks, end_ticks, id};
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void TraceProfiler::Collect()
+{
+    histograms.resize(zone_count.load(std::memory_order_acquire));
+
+    std::lock_guard lock(buffers_mutex);
+    for (size_t i = 0; i < buffers.size();) {
+        auto& buffer = buffers[i];
+        // Checked before reading head, so that once it's set every sample the thread recorded is drained below
+        const bool thread_exited = buffer->thread_exited.load(std::memory_order_acquire);
+        auto tail = buffer->tail.load(std::memory_order_relaxed);
+        const auto head = buffer->head.load(std::memory_order_acquire);
+        for (; tail != head; tail++) {
+            const auto& sample = buffer->samples[tail & (ThreadBuffer::capacity - 1)];
+            if (sample.id < histograms.size()) {
+                histograms[sample.id].Record(TicksToMicroseconds(sample.end - sample.start));
+            }
+            if (capturing) {
+                capture.push_back({sample.start, sample.end, buffer->thread_id, sample.id});
+            }
+        }
+        buffer->tail.store(tail, std::memory_order_release);
+        dropped_total += buffer->dropped.exchange(0, std::memory_order_relaxed);
+        if (!thread_exited) {
+            i++;
+            continue;
+        }
+        std::swap(buffer, buffers.back());
+        auto released = std::move(buffers.back());
+        buffers.pop_back();
+        if (spare_buffers.size() < max_spare_buffers) {
+            released->head.store(0, std::memory_order_relaxed);
+            released->tail.store(0, std::memory_order_relaxed);
+            released->thread_exited.store(false, std::memory_order_relaxed);
+            spare_buffers.push_back(std::move(released));
+        }
+    }
+    if (capturing && capture.size() >= max_capture_samples) {
+        StopCapture();
+    }
+}
+
+void TraceProfiler::ResetStats()
+{
+    for (auto& histogram : histograms) {
+        histogram = {};
+    }
+}
+
+void TraceProfiler::GetSummaries(std::vector<ZoneSummary>& out)
+{
+    for (size_t i = 1; i < histograms.size(); i++) {
+        const auto& histogram = histograms[i];
+        if (!histogram.count) continue;
+        out.push_back({
+            .id = static_cast<ZoneId>(i),
+            .name = GetZoneName(static_cast<ZoneId>(i)),
+            .count = histogram.count,
+            .total_us = histogram.total_us,
+            .p50_us = histogram.Percentile(0.5),
+            .p99_us = histogram.Percentile(0.99),
+            .max_us = histogram.max_us
+        });
+    }
+}
+
+uint64_t TraceProfiler::GetDroppedCount()
+{
+    return dropped_total;
+}
+
+void TraceProfiler::StartCapture()
+{
+    capture.clear();
+    capture.reserve(0x10000);
+    capturing = true;
+}
+
+void TraceProfiler::StopCapture()
+{
+    capturing = false;
+}
+
+bool TraceProfiler::IsCapturing()
+{
+    return capturing;
+}
+
+size_t TraceProfiler::GetCaptureSize()
+{
+    return capture.size();
+}
+
+bool TraceProfiler::ExportChromeTrace(const std::filesystem::path& path)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+
+    uint64_t origin = UINT64_MAX;
+    for (const auto& sample : capture) {
+        origin = std::min(origin, sample.start);
+    }
+    const auto ticks_per_us = static_cast<double>(GetFrequency().QuadPart) / 1000000.0;
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& sample : capture) {
+        if (!first) out << ',';
+        first = false;
+        out << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << sample.thread_id << ",\"name\":\"";
+        WriteJsonEscaped(out, GetZoneName(sample.id));
+        out << std::format("\",\"ts\":{:.3f},\"dur\":{:.3f}}}", static_cast<double>(sample.start - origin) / ticks_per_us, static_cast<double>(sample.end - sample.start) / ticks_per_us);
+    }
+    out << "]}";
+    return out.good();
+}
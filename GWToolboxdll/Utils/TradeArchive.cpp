@@ -0,0 +1,930 @@
+#include "stdafx.h"
+
+#include <Utils/TradeArchive.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <format>
+
+namespace {
+    constexpr uint32_t file_magic = 0x31414354; // "TCA1"
+    constexpr uint32_t file_version = 1;
+    constexpr size_t max_word_length = 32;
+    constexpr size_t max_item_words = 6;
+    constexpr size_t load_batch_size = 1024;
+
+    // BM25 parameters
+    constexpr float bm25_k1 = 1.2f;
+    constexpr float bm25_b = 0.75f;
+
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+    };
+
+    // Held open without sharing by the one client writing to the folder; removed when that client closes it
+    HANDLE LockFolder(const std::filesystem::path& folder)
+    {
+        return CreateFileW((folder / L"archive.lock").c_str(), GENERIC_WRITE, 0, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+    }
+
+    void WriteVarint(uint64_t value, std::string& out)
+    {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    bool ReadVarint(std::string_view& data, uint64_t& value)
+    {
+        value = 0;
+        for (uint32_t shift = 0; shift < 64; shift += 7) {
+            if (data.empty()) {
+                return false;
+            }
+            const auto byte = static_cast<uint8_t>(data.front());
+            data.remove_prefix(1);
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool ReadBytes(std::string_view& data, const uint64_t length, std::string_view& value)
+    {
+        if (data.size() < length) {
+            return false;
+        }
+        value = data.substr(0, static_cast<size_t>(length));
+        data.remove_prefix(static_cast<size_t>(length));
+        return true;
+    }
+
+    uint64_t ZigZag(const int64_t value)
+    {
+        return static_cast<uint64_t>(value) << 1 ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    int64_t UnZigZag(const uint64_t value)
+    {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    // Bytes of UTF-8 sequences count as word characters, so accented names are kept whole
+    bool IsWordChar(const char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || static_cast<uint8_t>(c) >= 0x80;
+    }
+
+    char ToLower(const char c)
+    {
+        return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    template <typename Fn>
+    void ForEachWord(const std::string_view text, Fn fn)
+    {
+        std::string word;
+        for (size_t i = 0; i <= text.size(); i++) {
+            if (i < text.size() && IsWordChar(text[i])) {
+                if (word.size() < max_word_length) {
+                    word.push_back(ToLower(text[i]));
+                }
+                continue;
+            }
+            if (!word.empty()) {
+                fn(word);
+                word.clear();
+            }
+        }
+    }
+
+    bool IsSeparator(const char c)
+    {
+        return c == ',' || c == ';' || c == '|' || c == '/' || c == '+' || c == '&' || c == '\\';
+    }
+
+    bool IsSpace(const char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    struct Unit {
+        const char* name;
+        TradeArchive::Currency currency;
+        float multiplier;
+    };
+
+    constexpr Unit price_units[] = {
+        {"e", TradeArchive::Currency::Ecto, 1.f},
+        {"ec", TradeArchive::Currency::Ecto, 1.f},
+        {"ecto", TradeArchive::Currency::Ecto, 1.f},
+        {"ectos", TradeArchive::Currency::Ecto, 1.f},
+        {"k", TradeArchive::Currency::Gold, 1000.f},
+        {"plat", TradeArchive::Currency::Gold, 1000.f},
+        {"g", TradeArchive::Currency::Gold, 1.f},
+        {"gold", TradeArchive::Currency::Gold, 1.f},
+        {"a", TradeArchive::Currency::Armbit, 1.f},
+        {"arm", TradeArchive::Currency::Armbit, 1.f},
+        {"arms", TradeArchive::Currency::Armbit, 1.f},
+        {"armbit", TradeArchive::Currency::Armbit, 1.f},
+        {"armbits", TradeArchive::Currency::Armbit, 1.f},
+        {"z", TradeArchive::Currency::ZaishenKey, 1.f},
+        {"zkey", TradeArchive::Currency::ZaishenKey, 1.f},
+        {"zkeys", TradeArchive::Currency::ZaishenKey, 1.f},
+    };
+
+    const Unit* FindUnit(const std::string_view name)
+    {
+        const auto found = std::ranges::find_if(price_units, [name](const Unit& unit) {
+            return name == unit.name;
+        });
+        return found == std::end(price_units) ? nullptr : found;
+    }
+
+    // Splits "2.5e" into 2.5 and "e". False if word doesn't start with a number.
+    bool ParseNumber(const std::string_view word, float& number, std::string_view& suffix)
+    {
+        size_t i = 0;
+        bool has_digit = false;
+        bool has_point = false;
+        for (; i < word.size(); i++) {
+            if (word[i] >= '0' && word[i] <= '9') {
+                has_digit = true;
+            }
+            else if (word[i] == '.' && !has_point) {
+                has_point = true;
+            }
+            else {
+                break;
+            }
+        }
+        if (!has_digit) {
+            return false;
+        }
+        number = std::strtof(std::string(word.substr(0, i)).c_str(), nullptr);
+        suffix = word.substr(i);
+        return std::isfinite(number) && number > 0.f;
+    }
+
+    bool IsWordIn(const std::string_view word, const std::initializer_list<std::string_view> words)
+    {
+        return std::ranges::contains(words, word);
+    }
+}
+
+std::vector<std::string> TradeArchive::Tokenize(const std::string_view text)
+{
+    std::vector<std::string> words;
+    ForEachWord(text, [&words](const std::string& word) {
+        words.push_back(word);
+    });
+    return words;
+}
+
+const char* TradeArchive::CurrencyName(const Currency currency)
+{
+    switch (currency) {
+        case Currency::Ecto:
+            return "e";
+        case Currency::Armbit:
+            return "a";
+        case Currency::ZaishenKey:
+            return "z";
+        default:
+            return "g";
+    }
+}
+
+std::vector<std::pair<std::string, TradeArchive::PriceQuote>> TradeArchive::ExtractPrices(const std::string_view text)
+{
+    std::vector<std::pair<std::string, PriceQuote>> quotes;
+    std::string lower(text);
+    std::ranges::transform(lower, lower.begin(), ToLower);
+
+    // Split into words, with separators as words of their own
+    std::vector<std::string_view> words;
+    for (size_t i = 0; i < lower.size();) {
+        if (IsSpace(lower[i])) {
+            i++;
+            continue;
+        }
+        if (IsSeparator(lower[i])) {
+            words.push_back(std::string_view(lower).substr(i, 1));
+            i++;
+            continue;
+        }
+        const auto start = i;
+        while (i < lower.size() && !IsSpace(lower[i]) && !IsSeparator(lower[i])) {
+            i++;
+        }
+        auto word = std::string_view(lower).substr(start, i - start);
+        while (!word.empty() && !IsWordChar(word.front()) && word.front() != '.') {
+            word.remove_prefix(1);
+        }
+        while (!word.empty() && !IsWordChar(word.back())) {
+            word.remove_suffix(1);
+        }
+        if (!word.empty()) {
+            words.push_back(word);
+        }
+    }
+
+    bool selling = true;
+    std::vector<std::string_view> item_words;
+    for (size_t i = 0; i < words.size(); i++) {
+        const auto word = words[i];
+        if (word.size() == 1 && IsSeparator(word.front())) {
+            item_words.clear();
+            continue;
+        }
+        if (IsWordIn(word, {"wts", "selling", "sell", "s"})) {
+            selling = true;
+            item_words.clear();
+            continue;
+        }
+        if (IsWordIn(word, {"wtb", "buying", "buy", "b"})) {
+            selling = false;
+            item_words.clear();
+            continue;
+        }
+        float number = 0.f;
+        std::string_view suffix;
+        if (ParseNumber(word, number, suffix)) {
+            const Unit* unit = nullptr;
+            if (suffix.empty()) {
+                // "5 ecto"; a bare number before the item is more likely a quantity, e.g. "wts 250 ectos"
+                if (!item_words.empty() && i + 1 < words.size() && (unit = FindUnit(words[i + 1]))) {
+                    i++;
+                }
+            }
+            else {
+                unit = FindUnit(suffix);
+            }
+            if (unit) {
+                if (!item_words.empty()) {
+                    std::string item;
+                    for (const auto& item_word : item_words) {
+                        ForEachWord(item_word, [&item](const std::string& w) {
+                            if (!item.empty()) {
+                                item.push_back(' ');
+                            }
+                            item += w;
+                        });
+                    }
+                    if (!item.empty()) {
+                        quotes.emplace_back(std::move(item), PriceQuote{0, 0, number * unit->multiplier, unit->currency, selling});
+                    }
+                }
+                item_words.clear();
+                continue;
+            }
+            if (suffix.empty()) {
+                continue; // Quantities aren't part of the item name
+            }
+        }
+        if (IsWordIn(word, {"for", "each", "ea", "pm", "me", "price", "offer", "offers", "obo", "cheap", "only", "a", "an", "the", "my", "x"})) {
+            continue;
+        }
+        item_words.push_back(word);
+        if (item_words.size() > max_item_words) {
+            item_words.erase(item_words.begin());
+        }
+    }
+    return quotes;
+}
+
+TradeArchive::~TradeArchive()
+{
+    Close();
+}
+
+void TradeArchive::Open(const std::filesystem::path& _folder)
+{
+    Close();
+    {
+        std::unique_lock lock(index_mutex);
+        messages.clear();
+        message_lengths.clear();
+        total_length = 0;
+        senders.clear();
+        sender_ids.clear();
+        postings.clear();
+        prices.clear();
+        price_items_by_word.clear();
+        folder = _folder; // Read by searches still running on other threads
+    }
+    current_segment = {};
+    current_segment_id = 0;
+    stopping = false;
+    loading = true;
+    worker = std::thread(&TradeArchive::WorkerThread, this);
+}
+
+void TradeArchive::Close()
+{
+    if (!worker.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard lock(pending_mutex);
+        stopping = true;
+    }
+    pending_cv.notify_one();
+    worker.join();
+}
+
+bool TradeArchive::IsOpen() const
+{
+    return worker.joinable();
+}
+
+bool TradeArchive::IsLoading() const
+{
+    return loading;
+}
+
+bool TradeArchive::IsReadOnly() const
+{
+    return read_only;
+}
+
+size_t TradeArchive::size() const
+{
+    std::shared_lock lock(index_mutex);
+    return messages.size();
+}
+
+void TradeArchive::Append(const uint32_t timestamp, const std::string_view sender, const std::string_view text)
+{
+    if (!IsOpen() || read_only || sender.empty() || text.empty()) {
+        return;
+    }
+    {
+        std::lock_guard lock(pending_mutex);
+        pending.emplace_back(timestamp, std::string(sender), std::string(text));
+    }
+    pending_cv.notify_one();
+}
+
+void TradeArchive::WorkerThread()
+{
+    std::error_code ec;
+    std::filesystem::create_directories(folder, ec);
+    // Another client writing to the same folder would interleave its records with ours, so only one may append
+    const HANDLE lock_file = LockFolder(folder);
+    read_only = lock_file == INVALID_HANDLE_VALUE;
+    const bool loaded = LoadSegments();
+    loading = false;
+    if (!loaded || read_only) {
+        // Stopped part way through, current_segment doesn't describe the last segment; or not ours to append to
+        {
+            std::lock_guard lock(pending_mutex);
+            pending.clear();
+        }
+        if (lock_file != INVALID_HANDLE_VALUE) {
+            CloseHandle(lock_file);
+        }
+        return;
+    }
+    while (true) {
+        std::unique_lock lock(pending_mutex);
+        pending_cv.wait(lock, [this] {
+            return stopping || !pending.empty();
+        });
+        if (pending.empty()) {
+            break; // Stopping, and everything queued has been written
+        }
+        const auto message = std::move(pending.front());
+        pending.pop_front();
+        lock.unlock();
+        WriteMessage(message);
+    }
+    CloseHandle(lock_file);
+}
+
+std::filesystem::path TradeArchive::SegmentPath(const uint16_t segment) const
+{
+    return folder / std::format(L"{:05}.tca", segment);
+}
+
+bool TradeArchive::LoadSegments()
+{
+    std::error_code ec;
+    uint32_t segment = 0;
+    for (; segment <= UINT16_MAX && std::filesystem::exists(SegmentPath(static_cast<uint16_t>(segment)), ec); segment++) {
+        current_segment = {};
+        if (!LoadSegment(static_cast<uint16_t>(segment))) {
+            current_segment.message_count = segment_max_messages; // Don't append to a file we can't read
+        }
+        if (stopping) {
+            return false;
+        }
+    }
+    current_segment_id = static_cast<uint16_t>(segment ? segment - 1 : 0);
+    return true;
+}
+
+bool TradeArchive::LoadSegment(const uint16_t segment)
+{
+    const auto path = SegmentPath(segment);
+    std::string data;
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::error_code ec;
+        const auto file_size = std::filesystem::file_size(path, ec);
+        if (ec || !file.is_open()) {
+            return false;
+        }
+        data.resize(static_cast<size_t>(file_size));
+        if (!file.read(data.data(), static_cast<std::streamsize>(data.size()))) {
+            return false;
+        }
+    }
+    FileHeader header;
+    if (data.size() < sizeof(header)) {
+        return false;
+    }
+    memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != file_magic || header.version != file_version) {
+        return false;
+    }
+
+    struct Loaded {
+        MessageRef ref;
+        std::string_view sender;
+        std::string_view text;
+    };
+    std::vector<Loaded> batch;
+    batch.reserve(load_batch_size);
+    const auto index_batch = [&] {
+        std::unique_lock lock(index_mutex);
+        for (const auto& loaded : batch) {
+            IndexMessage(loaded.ref, loaded.sender, loaded.text);
+        }
+        batch.clear();
+    };
+
+    std::vector<std::string_view> segment_senders;
+    std::string_view in = std::string_view(data).substr(sizeof(header));
+    while (!in.empty() && current_segment.message_count < segment_max_messages) {
+        auto record = in;
+        uint64_t timestamp_delta = 0;
+        uint64_t sender_ref = 0;
+        uint64_t text_length = 0;
+        std::string_view sender;
+        std::string_view text;
+        if (!ReadVarint(record, timestamp_delta) || !ReadVarint(record, sender_ref)) {
+            break;
+        }
+        if (sender_ref == 0) {
+            uint64_t sender_length = 0;
+            if (!ReadVarint(record, sender_length) || !ReadBytes(record, sender_length, sender)) {
+                break;
+            }
+        }
+        else if (sender_ref <= segment_senders.size()) {
+            sender = segment_senders[static_cast<size_t>(sender_ref - 1)];
+        }
+        else {
+            break;
+        }
+        if (!ReadVarint(record, text_length) || text_length > UINT16_MAX || !ReadBytes(record, text_length, text)) {
+            break;
+        }
+        if (sender_ref == 0) {
+            current_segment.senders.emplace(std::string(sender), static_cast<uint32_t>(segment_senders.size()));
+            segment_senders.push_back(sender);
+        }
+        current_segment.previous_timestamp = static_cast<uint32_t>(current_segment.previous_timestamp + UnZigZag(timestamp_delta));
+        current_segment.message_count++;
+        batch.emplace_back(MessageRef{current_segment.previous_timestamp, 0, static_cast<uint32_t>(text.data() - data.data()), segment, static_cast<uint16_t>(text.size())}, sender, text);
+        if (batch.size() == load_batch_size) {
+            index_batch();
+            if (stopping) {
+                return true; // The rest of the file hasn't been read, not damaged
+            }
+        }
+        in = record;
+    }
+    index_batch();
+
+    current_segment.size = data.size() - in.size();
+    if (!in.empty() && !read_only) {
+        // Partly written record at the end; only cut off by the writer, as for anyone else it may still be being written
+        std::error_code ec;
+        std::filesystem::resize_file(path, current_segment.size, ec);
+    }
+    return true;
+}
+
+bool TradeArchive::WriteMessage(const PendingMessage& message)
+{
+    if (current_segment.message_count >= segment_max_messages) {
+        if (current_segment_id == UINT16_MAX) {
+            return false;
+        }
+        current_segment_id++;
+        current_segment = {};
+    }
+    const auto path = SegmentPath(current_segment_id);
+    std::string record;
+    if (current_segment.size == 0) {
+        const FileHeader header{file_magic, file_version};
+        record.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+    WriteVarint(ZigZag(static_cast<int64_t>(message.timestamp) - current_segment.previous_timestamp), record);
+    const auto found_sender = current_segment.senders.find(message.sender);
+    if (found_sender == current_segment.senders.end()) {
+        WriteVarint(0, record);
+        WriteVarint(message.sender.size(), record);
+        record += message.sender;
+    }
+    else {
+        WriteVarint(found_sender->second + 1, record);
+    }
+    const auto text = std::string_view(message.text).substr(0, UINT16_MAX);
+    WriteVarint(text.size(), record);
+    const auto text_offset = current_segment.size + record.size();
+    record += text;
+
+    std::ofstream file(path, std::ios::binary | std::ios::app);
+    if (!(file.write(record.data(), static_cast<std::streamsize>(record.size())) && file.flush())) {
+        // Don't leave part of a record for the next one to be appended after
+        file.close();
+        std::error_code ec;
+        std::filesystem::resize_file(path, current_segment.size, ec);
+        return false;
+    }
+    file.close();
+    current_segment.size += record.size();
+    current_segment.message_count++;
+    current_segment.previous_timestamp = message.timestamp;
+    if (found_sender == current_segment.senders.end()) {
+        current_segment.senders.emplace(message.sender, static_cast<uint32_t>(current_segment.senders.size()));
+    }
+
+    std::unique_lock lock(index_mutex);
+    IndexMessage({message.timestamp, 0, static_cast<uint32_t>(text_offset), current_segment_id, static_cast<uint16_t>(text.size())}, message.sender, text);
+    return true;
+}
+
+void TradeArchive::IndexMessage(MessageRef ref, const std::string_view sender, const std::string_view text)
+{
+    const auto id = static_cast<uint32_t>(messages.size());
+    auto found_sender = sender_ids.find(sender);
+    if (found_sender == sender_ids.end()) {
+        found_sender = sender_ids.emplace(std::string(sender), static_cast<uint32_t>(senders.size())).first;
+        senders.emplace_back(sender);
+    }
+    ref.sender = found_sender->second;
+    messages.push_back(ref);
+
+    size_t length = 0;
+    ForEachWord(text, [&](const std::string& word) {
+        auto found = postings.find(word);
+        if (found == postings.end()) {
+            found = postings.emplace(word, std::vector<uint32_t>{}).first;
+        }
+        found->second.push_back(id);
+        length++;
+    });
+    message_lengths.push_back(static_cast<uint8_t>(std::min<size_t>(length, UINT8_MAX)));
+    total_length += length;
+
+    for (auto& [item, quote] : ExtractPrices(text)) {
+        quote.message_id = id;
+        quote.timestamp = ref.timestamp;
+        auto found = prices.find(item);
+        if (found == prices.end()) {
+            found = prices.emplace(std::move(item), std::vector<PriceQuote>{}).first;
+            const auto item_quotes = &found->second;
+            ForEachWord(found->first, [&](const std::string& word) {
+                auto& items = price_items_by_word[word];
+                if (items.empty() || items.back() != item_quotes) {
+                    items.push_back(item_quotes);
+                }
+            });
+        }
+        found->second.push_back(quote);
+    }
+}
+
+bool TradeArchive::ReadMessage(const uint32_t id, Message& out, std::ifstream& file, uint16_t& file_segment) const
+{
+    const auto& ref = messages[id];
+    if (!file.is_open() || file_segment != ref.segment) {
+        file.close();
+        file.open(SegmentPath(ref.segment), std::ios::binary);
+        file_segment = ref.segment;
+    }
+    file.clear();
+    file.seekg(ref.text_offset);
+    out.text.resize(ref.text_length);
+    if (!file.read(out.text.data(), ref.text_length)) {
+        return false;
+    }
+    out.id = id;
+    out.timestamp = ref.timestamp;
+    out.sender = senders[ref.sender];
+    return true;
+}
+
+std::vector<uint32_t> TradeArchive::Matches(const Term& term) const
+{
+    std::vector<uint32_t> out;
+    const auto add_word = [&](const std::vector<uint32_t>& ids) {
+        const auto middle = out.size();
+        std::ranges::unique_copy(ids, std::back_inserter(out));
+        std::inplace_merge(out.begin(), out.begin() + middle, out.end());
+    };
+    switch (term.type) {
+        case Term::Type::Word: {
+            const auto found = postings.find(term.words.front());
+            if (found != postings.end()) {
+                add_word(found->second);
+            }
+        } break;
+        case Term::Type::Prefix: {
+            const auto& prefix = term.words.front();
+            for (auto it = postings.lower_bound(prefix); it != postings.end() && it->first.starts_with(prefix); ++it) {
+                out.insert(out.end(), it->second.begin(), it->second.end());
+            }
+            std::ranges::sort(out);
+            out.erase(std::ranges::unique(out).begin(), out.end());
+        } break;
+        case Term::Type::Phrase: {
+            // Messages with all of the words; whether they're in order is checked against the text
+            for (const auto& word : term.words) {
+                const auto found = postings.find(word);
+                if (found == postings.end()) {
+                    return {};
+                }
+                std::vector<uint32_t> ids;
+                std::ranges::unique_copy(found->second, std::back_inserter(ids));
+                if (&word == &term.words.front()) {
+                    out = std::move(ids);
+                    continue;
+                }
+                std::vector<uint32_t> both;
+                std::ranges::set_intersection(out, ids, std::back_inserter(both));
+                out = std::move(both);
+            }
+        } break;
+    }
+    return out;
+}
+
+std::vector<TradeArchive::Message> TradeArchive::Search(const std::string_view query, const size_t max_results) const
+{
+    // Parse the query into groups of terms; a message has to match a term from every group and none of the excluded ones
+    std::vector<std::vector<Term>> groups;
+    std::vector<Term> excluded;
+    bool has_phrase = false;
+    bool next_is_or = false;
+    for (size_t i = 0; i < query.size();) {
+        if (IsSpace(query[i])) {
+            i++;
+            continue;
+        }
+        bool exclude = false;
+        if (query[i] == '-') {
+            exclude = true;
+            i++;
+        }
+        Term term;
+        std::string_view raw;
+        if (i < query.size() && query[i] == '"') {
+            const auto end = query.find('"', i + 1);
+            raw = query.substr(i + 1, end == std::string_view::npos ? std::string_view::npos : end - i - 1);
+            i = end == std::string_view::npos ? query.size() : end + 1;
+            term.type = Term::Type::Phrase;
+        }
+        else {
+            const auto start = i;
+            while (i < query.size() && !IsSpace(query[i]) && query[i] != '"') {
+                i++;
+            }
+            raw = query.substr(start, i - start);
+            if (!exclude && (raw == "OR" || raw == "|")) {
+                next_is_or = !groups.empty();
+                continue;
+            }
+            if (raw.ends_with('*')) {
+                term.type = Term::Type::Prefix;
+            }
+        }
+        term.words = Tokenize(raw);
+        if (term.words.empty()) {
+            continue;
+        }
+        if (term.words.size() > 1) {
+            term.type = Term::Type::Phrase;
+        }
+        else if (term.type == Term::Type::Phrase) {
+            term.type = Term::Type::Word;
+        }
+        has_phrase |= term.type == Term::Type::Phrase;
+        if (exclude) {
+            excluded.push_back(std::move(term));
+        }
+        else if (next_is_or) {
+            groups.back().push_back(std::move(term));
+        }
+        else {
+            groups.push_back({std::move(term)});
+        }
+        next_is_or = false;
+    }
+
+    const auto matches_text = [&](const std::string_view text) {
+        const auto words = Tokenize(text);
+        const auto term_matches = [&words](const Term& term) {
+            switch (term.type) {
+                case Term::Type::Prefix:
+                    return std::ranges::any_of(words, [&term](const std::string& word) {
+                        return word.starts_with(term.words.front());
+                    });
+                case Term::Type::Phrase:
+                    return !std::ranges::search(words, term.words).empty();
+                default:
+                    return std::ranges::contains(words, term.words.front());
+            }
+        };
+        return std::ranges::all_of(groups, [&](const std::vector<Term>& group) {
+                   return std::ranges::any_of(group, term_matches);
+               })
+               && std::ranges::none_of(excluded, term_matches);
+    };
+
+    std::shared_lock lock(index_mutex);
+    std::vector<Message> results;
+    std::ifstream file;
+    uint16_t file_segment = 0;
+    const auto message_count = static_cast<uint32_t>(messages.size());
+
+    if (groups.empty()) {
+        // Nothing to rank by; newest first
+        for (uint32_t id = message_count; id-- > 0 && results.size() < max_results;) {
+            Message message;
+            if (ReadMessage(id, message, file, file_segment) && (excluded.empty() || matches_text(message.text))) {
+                results.push_back(std::move(message));
+            }
+        }
+        return results;
+    }
+
+    // BM25 over every positive word; a prefix counts as one word that occurs once in each message it matches. Scorers
+    // walk their ids alongside the candidates, which are visited in ascending order.
+    struct Scorer {
+        const std::vector<uint32_t>* ids;
+        float idf;
+        size_t pos = 0;
+    };
+    std::vector<Scorer> scorers;
+    const auto idf = [message_count](const size_t document_frequency) {
+        return std::log(1.f + (static_cast<float>(message_count) - document_frequency + 0.5f) / (document_frequency + 0.5f));
+    };
+
+    // Candidates: the intersection of each group's matches, smallest first
+    size_t term_count = 0;
+    for (const auto& group : groups) {
+        term_count += group.size();
+    }
+    std::vector<std::vector<uint32_t>> term_matches;
+    term_matches.reserve(term_count); // Scorers point into this
+    std::vector<std::vector<uint32_t>> group_matches;
+    for (const auto& group : groups) {
+        auto& ids = group_matches.emplace_back();
+        for (const auto& term : group) {
+            const auto& term_ids = term_matches.emplace_back(Matches(term));
+            if (term.type == Term::Type::Prefix) {
+                scorers.emplace_back(&term_ids, idf(term_ids.size()));
+            }
+            else if (!term_ids.empty()) {
+                for (const auto& word : term.words) {
+                    const auto document_frequency = term.type == Term::Type::Word ? term_ids.size() : Matches({Term::Type::Word, {word}}).size();
+                    scorers.emplace_back(&postings.find(word)->second, idf(document_frequency));
+                }
+            }
+            if (group.size() == 1) {
+                ids = term_ids;
+                continue;
+            }
+            const auto middle = ids.size();
+            ids.insert(ids.end(), term_ids.begin(), term_ids.end());
+            std::inplace_merge(ids.begin(), ids.begin() + middle, ids.end());
+        }
+        ids.erase(std::ranges::unique(ids).begin(), ids.end());
+    }
+    std::ranges::sort(group_matches, {}, [](const std::vector<uint32_t>& ids) {
+        return ids.size();
+    });
+    std::vector<uint32_t> candidates = std::move(group_matches.front());
+    for (size_t i = 1; i < group_matches.size() && !candidates.empty(); i++) {
+        std::vector<uint32_t> both;
+        std::ranges::set_intersection(candidates, group_matches[i], std::back_inserter(both));
+        candidates = std::move(both);
+    }
+    for (const auto& term : excluded) {
+        if (term.type == Term::Type::Phrase) {
+            continue; // Checked against the text
+        }
+        const auto term_ids = Matches(term);
+        std::vector<uint32_t> remaining;
+        std::ranges::set_difference(candidates, term_ids, std::back_inserter(remaining));
+        candidates = std::move(remaining);
+    }
+    if (candidates.empty()) {
+        return results;
+    }
+
+    const float average_length = static_cast<float>(total_length) / std::max<uint32_t>(message_count, 1);
+    std::vector<std::pair<float, uint32_t>> scored;
+    scored.reserve(candidates.size());
+    for (const auto id : candidates) {
+        const float length_norm = 1.f - bm25_b + bm25_b * message_lengths[id] / average_length;
+        float score = 0.f;
+        for (auto& scorer : scorers) {
+            const auto& ids = *scorer.ids;
+            while (scorer.pos < ids.size() && ids[scorer.pos] < id) {
+                scorer.pos++;
+            }
+            uint32_t tf = 0;
+            while (scorer.pos + tf < ids.size() && ids[scorer.pos + tf] == id) {
+                tf++;
+            }
+            if (tf) {
+                score += scorer.idf * tf * (bm25_k1 + 1.f) / (tf + bm25_k1 * length_norm);
+            }
+        }
+        scored.emplace_back(score, id);
+    }
+    const auto better = [](const std::pair<float, uint32_t>& a, const std::pair<float, uint32_t>& b) {
+        return a.first != b.first ? a.first > b.first : a.second > b.second;
+    };
+    const bool needs_text_check = has_phrase || std::ranges::any_of(excluded, [](const Term& term) {
+        return term.type == Term::Type::Phrase;
+    });
+    if (!needs_text_check && scored.size() > max_results) {
+        std::ranges::partial_sort(scored, scored.begin() + static_cast<ptrdiff_t>(max_results), better);
+        scored.resize(max_results);
+    }
+    else {
+        std::ranges::sort(scored, better);
+    }
+    for (const auto& [score, id] : scored) {
+        if (results.size() >= max_results) {
+            break;
+        }
+        Message message;
+        if (ReadMessage(id, message, file, file_segment) && (!needs_text_check || matches_text(message.text))) {
+            results.push_back(std::move(message));
+        }
+    }
+    return results;
+}
+
+std::vector<TradeArchive::PriceQuote> TradeArchive::GetPriceHistory(const std::string_view item, const uint32_t since) const
+{
+    std::vector<PriceQuote> out;
+    const auto words = Tokenize(item);
+    if (words.empty()) {
+        return out;
+    }
+    std::shared_lock lock(index_mutex);
+    std::vector<const std::vector<const std::vector<PriceQuote>*>*> word_items;
+    for (const auto& word : words) {
+        const auto found = price_items_by_word.find(word);
+        if (found == price_items_by_word.end()) {
+            return out;
+        }
+        word_items.push_back(&found->second);
+    }
+    // Check the items of the rarest word against the others
+    std::ranges::sort(word_items, {}, [](const auto* items) {
+        return items->size();
+    });
+    for (const auto item_quotes : *word_items.front()) {
+        const bool matches = std::all_of(word_items.begin() + 1, word_items.end(), [item_quotes](const auto* items) {
+            return std::ranges::contains(*items, item_quotes);
+        });
+        if (!matches) {
+            continue;
+        }
+        for (const auto& quote : *item_quotes) {
+            if (quote.timestamp >= since) {
+                out.push_back(quote);
+            }
+        }
+    }
+    std::ranges::sort(out, [](const PriceQuote& a, const PriceQuote& b) {
+        return a.timestamp != b.timestamp ? a.timestamp < b.timestamp : a.message_id < b.message_id;
+    });
+    return out;
+}
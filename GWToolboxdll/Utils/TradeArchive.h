@@ -0,0 +1,170 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <Utils/StringMap.h>
+
+/*
+Local archive of trade chat messages with a full-text index, so trade chat can be searched without the
+kamadan/ascalon website.
+
+Messages are appended to numbered segment files in a folder, each segment holding up to segment_max_messages
+records. A record is the change in timestamp since the previous record (zigzag varint), the sender (varint; 0 means
+a new name follows, otherwise the index + 1 of a name already in the segment), then the message text. Segments are
+self-contained, so a damaged one only loses its own messages, and a record that was only partly written is cut off
+the end of the last segment on load.
+
+Open() returns straight away; a worker thread reads the segments and builds the index, then writes and indexes
+appended messages in the order they were added. Searches can run on any thread while that happens and see
+whatever has been indexed so far.
+
+Only one client at a time writes to a folder; it holds archive.lock open without sharing. A client that can't take
+the lock opens the archive read-only: it indexes what was on disk when it loaded, ignores Append() and leaves the
+segment files alone.
+
+Query syntax, case-insensitive:
+    ecto armor           both words
+    ecto OR zkey         either word
+    "tormented shield"   words next to each other in this order
+    torm*                any word starting with torm
+    -wtb                 not containing wtb
+Results are ranked by BM25, newest first when scores tie. An empty query returns the newest messages.
+
+Quotes like "WTS Tormented Shield 5e" are pulled out of each message into a per-item price history.
+*/
+class TradeArchive {
+public:
+    static constexpr uint32_t segment_max_messages = 0x10000;
+
+    struct Message {
+        uint32_t id = 0; // Position in the archive, oldest first
+        uint32_t timestamp = 0;
+        std::string sender;
+        std::string text;
+    };
+
+    enum class Currency : uint8_t {
+        Gold,
+        Ecto,
+        Armbit,
+        ZaishenKey
+    };
+
+    struct PriceQuote {
+        uint32_t message_id = 0;
+        uint32_t timestamp = 0;
+        float amount = 0.f;
+        Currency currency = Currency::Gold;
+        bool selling = true; // False for WTB
+    };
+
+    // Quotes found in one message, keyed by normalised item name (lowercase words separated by single spaces)
+    static std::vector<std::pair<std::string, PriceQuote>> ExtractPrices(std::string_view text);
+    // Lowercase words of text, as indexed
+    static std::vector<std::string> Tokenize(std::string_view text);
+    static const char* CurrencyName(Currency currency);
+
+    TradeArchive() = default;
+    TradeArchive(const TradeArchive&) = delete;
+    ~TradeArchive();
+
+    // Starts loading the archive in folder, closing any archive already open. The folder is created if needed.
+    void Open(const std::filesystem::path& folder);
+    // Waits for queued messages to be written. Messages queued before the archive has finished loading are dropped.
+    void Close();
+    [[nodiscard]] bool IsOpen() const;
+    [[nodiscard]] bool IsLoading() const;
+    // True if another client is writing to the folder, so messages aren't being archived by this one
+    [[nodiscard]] bool IsReadOnly() const;
+    // Number of messages indexed so far
+    [[nodiscard]] size_t size() const;
+
+    // Queues a message to be written; ignored if the archive isn't open or is read-only
+    void Append(uint32_t timestamp, std::string_view sender, std::string_view text);
+
+    // Best max_results matches for query, best first
+    [[nodiscard]] std::vector<Message> Search(std::string_view query, size_t max_results) const;
+
+    // Quotes for items whose name contains every word of item, oldest first, limited to those at or after since
+    [[nodiscard]] std::vector<PriceQuote> GetPriceHistory(std::string_view item, uint32_t since = 0) const;
+
+private:
+    // Fixed size part of a message kept in memory; the sender and text stay on disk
+    struct MessageRef {
+        uint32_t timestamp;
+        uint32_t sender;      // Index into senders
+        uint32_t text_offset; // Offset of the text in its segment file
+        uint16_t segment;
+        uint16_t text_length;
+    };
+
+    struct PendingMessage {
+        uint32_t timestamp;
+        std::string sender;
+        std::string text;
+    };
+
+    struct Segment {
+        uint32_t previous_timestamp = 0;
+        uint32_t message_count = 0;
+        uint64_t size = 0;
+        StringMap<uint32_t> senders; // Sender -> index in the segment
+    };
+
+    struct Term {
+        enum class Type { Word, Prefix, Phrase } type = Type::Word;
+        std::vector<std::string> words; // One word unless this is a phrase
+    };
+
+    void WorkerThread();
+    // False if Close() was called before every segment was loaded
+    bool LoadSegments();
+    // False if the segment isn't a trade archive segment
+    bool LoadSegment(uint16_t segment);
+    bool WriteMessage(const PendingMessage& message);
+    // Must hold the index lock exclusively
+    void IndexMessage(MessageRef ref, std::string_view sender, std::string_view text);
+
+    [[nodiscard]] std::filesystem::path SegmentPath(uint16_t segment) const;
+    // Must hold the index lock. file is kept open on the last segment read from, to be passed back in for the next.
+    bool ReadMessage(uint32_t id, Message& out, std::ifstream& file, uint16_t& file_segment) const;
+    [[nodiscard]] std::vector<uint32_t> Matches(const Term& term) const;
+
+    std::filesystem::path folder;
+    std::thread worker;
+    std::mutex pending_mutex;
+    std::condition_variable pending_cv;
+    std::deque<PendingMessage> pending;
+    std::atomic<bool> stopping = false;
+    std::atomic<bool> loading = false;
+    std::atomic<bool> read_only = false;
+
+    // Only touched by the worker thread
+    Segment current_segment;
+    uint16_t current_segment_id = 0;
+
+    // Index; written by the worker thread
+    mutable std::shared_mutex index_mutex;
+    std::vector<MessageRef> messages;
+    std::vector<uint8_t> message_lengths; // Words per message, capped at 255
+    uint64_t total_length = 0;
+    std::vector<std::string> senders;
+    StringMap<uint32_t> sender_ids;
+    // Word -> ids of messages containing it, ascending; an id is repeated once for each time the word appears
+    std::map<std::string, std::vector<uint32_t>, std::less<>> postings;
+    StringMap<std::vector<PriceQuote>> prices;
+    // Word -> quotes of the items in prices whose name contains it
+    StringMap<std::vector<const std::vector<PriceQuote>*>> price_items_by_word;
+};
@@ -32,6 +32,37 @@ constexpr auto AGENTCOLOR_INIFILENAME = L"AgentColors.ini";
 namespace {
 
     GW::HookEntry ChatCmd_HookEntry;
+
+    // Custom polygon/marker colour of each living hostile by agent id, filled once per rebuild by ClassifyRegions
+    std::vector<const Color*> region_colors;
+
+    void ClassifyRegions(const GW::AgentArray& agents)
+    {
+        region_colors.assign(agents.size(), nullptr);
+        const auto& region_index = Minimap::Instance().custom_renderer.GetRegionIndex();
+        if (region_index.empty()) {
+            return;
+        }
+        static std::vector<GW::Vec2f> positions;
+        static std::vector<uint32_t> agent_ids;
+        static std::vector<const Color*> found;
+        positions.clear();
+        agent_ids.clear();
+        for (const auto agent : agents) {
+            const auto living = agent ? agent->GetAsAgentLiving() : nullptr;
+            if (!living || living->allegiance != GW::Constants::Allegiance::Enemy || living->GetIsDead() || living->agent_id >= agents.size()) {
+                continue;
+            }
+            positions.push_back(living->pos);
+            agent_ids.push_back(living->agent_id);
+        }
+        found.resize(positions.size());
+        region_index.Classify(positions, found);
+        for (size_t i = 0; i < agent_ids.size(); i++) {
+            region_colors[agent_ids[i]] = found[i];
+        }
+    }
+
     uint32_t GetAgentProfession(const GW::AgentLiving* agent)
     {
         if (!agent) {
@@ -613,6 +644,7 @@ AgentRenderer::AgentRenderer()
 {
     instance = this;
     last_check = TIMER_INIT();
+    dynamic = true; // rebuilt every 33ms; stream through the shared ring instead of re-creating a managed buffer
     shapes[Tear].AddVertex(1.8f, 0, Dark);      // A
     shapes[Tear].AddVertex(0.7f, 0.7f, Dark);   // B
     shapes[Tear].AddVertex(0.0f, 0.0f, Light);  // O
@@ -736,7 +768,27 @@ void AgentRenderer::OnUIMessage(GW::HookStatus*, const GW::UI::UIMessage msgid,
 
 void AgentRenderer::Shape_t::AddVertex(const float x, const float y, const Color_Modifier mod)
 {
-    vertices.push_back(Shape_Vertex(x, y, mod));
+    xs.push_back(x);
+    ys.push_back(y);
+    modifiers.push_back(static_cast<uint8_t>(mod));
+}
+
+void AgentRenderer::ShapeInstances::clear()
+{
+    x.clear();
+    y.clear();
+    rotation_cos.clear();
+    rotation_sin.clear();
+    size.clear();
+    shape.clear();
+    palette.clear();
+    vertex_count = 0;
+}
+
+void AgentRenderer::clear()
+{
+    D3DVertexBuffer::clear();
+    shape_instances.clear();
 }
 
 void AgentRenderer::Initialize(IDirect3DDevice9* device)
@@ -824,9 +876,12 @@ void AgentRenderer::Render(IDirect3DDevice9* device)
         // get stuff
         GW::AgentArray* agents = GW::Agents::GetAgentArray();
         if (!agents) {
+            ExpandShapes();
             return;
         }
 
+        ClassifyRegions(*agents);
+
         const GW::AgentLiving* player = GW::Agents::GetControlledCharacter();
         const GW::Agent* target = GW::Agents::GetTarget();
         if (target) {
@@ -1030,6 +1085,8 @@ void AgentRenderer::Render(IDirect3DDevice9* device)
         if (player) {
             Enqueue(player);
         }
+
+        ExpandShapes();
     }
     
     D3DVertexBuffer::Render(device);
@@ -1097,47 +1154,8 @@ Color AgentRenderer::GetColor(const GW::Agent* agent, const CustomAgent* ca) con
                 c = &profession_colors[prof];
             }
         }
-        const auto& polygons = Minimap::Instance().custom_renderer.polygons;
-        const auto& markers = Minimap::Instance().custom_renderer.markers;
-        const auto is_relevant = [living](const CustomRenderer::CustomPolygon& polygon)-> bool {
-            return (polygon.visible && polygon.map == GW::Constants::MapID::None || polygon.map == GW::Map::GetMapID()) && !polygon.points.empty() && (polygon.color_sub & IM_COL32_A_MASK) != 0 &&
-                   GetDistance(living->pos, polygon.points.at(0)) < 2500.f;
-        };
-        const auto is_relevant_circle = [living](const CustomRenderer::CustomMarker& marker) {
-            return (marker.visible && marker.map == GW::Constants::MapID::None || marker.map == GW::Map::GetMapID()) && (marker.color_sub & IM_COL32_A_MASK) != 0 &&
-                   GetDistance(living->pos, marker.pos) < 2500.f;
-        };
-        const auto is_inside = [](const GW::GamePos pos, const std::vector<GW::GamePos>& points) -> bool {
-            bool b = false;
-            //TODO: This might need adjust to take into account zlevels
-            for (auto i = 0u, j = points.size() - 1; i < points.size(); j = i++) {
-                if (points[i].y >= pos.y != points[j].y >= pos.y &&
-                    pos.x <= (points[j].x - points[i].x) * (pos.y - points[i].y) / (points[j].y - points[i].y) +
-                    points[i].x) {
-                    b = !b;
-                }
-            }
-            return b;
-        };
-
-        auto is_inside_circle = [](const GW::Vec2f pos, const GW::Vec2f circle, const float radius) -> bool {
-            return GetSquareDistance(pos, circle) <= radius * radius;
-        };
-        for (const auto& polygon : polygons) {
-            if (!is_relevant(polygon)) {
-                continue;
-            }
-            if (is_inside(living->pos, polygon.points)) {
-                c = &polygon.color_sub;
-            }
-        }
-        for (const auto& marker : markers) {
-            if (!is_relevant_circle(marker)) {
-                continue;
-            }
-            if (is_inside_circle(living->pos, marker.pos, marker.size)) {
-                c = &marker.color_sub;
-            }
+        if (living->agent_id < region_colors.size() && region_colors[living->agent_id]) {
+            c = region_colors[living->agent_id];
         }
         if (living->hp > 0.9f) {
             return *c;
@@ -1393,34 +1411,50 @@ void AgentRenderer::Enqueue(const Shape_e shape, const GW::MapProp* agent, const
 void AgentRenderer::Enqueue(const Shape_e shape, const RenderPosition& pos, const float size, const Color color, const Color modifier)
 {
     if ((color & IM_COL32_A_MASK) == 0) return;
-    const auto& shape_verts = shapes[shape].vertices;
-    vertices.reserve(vertices.size() + shape_verts.size());
-
-    const DWORD c_dark = Colors::Sub(color, modifier);
-    const DWORD c_light = Colors::Add(color, modifier);
-    const DWORD c_center = Colors::Sub(color, IM_COL32(0, 0, 0, 50));
-
-    GW::Vec2f calc_pos;
-    for (const Shape_Vertex& vert : shape_verts) {
-        calc_pos.x = ((vert.x * pos.rotation_cos) - (vert.y * pos.rotation_sin)) * size + pos.position.x;
-        calc_pos.y = ((vert.x * pos.rotation_sin) + (vert.y * pos.rotation_cos)) * size + pos.position.y;
-        DWORD c;
-        switch (vert.modifier) {
-            case Dark:
-                c = c_dark;
-                break;
-            case Light:
-                c = c_light;
-                break;
-            case CircleCenter:
-                c = c_center;
-                break;
-            default:
-                c = color;
-                break;
-        }
-        vertices.push_back({calc_pos.x, calc_pos.y, c});
+    auto& instances = shape_instances;
+    instances.x.push_back(pos.position.x);
+    instances.y.push_back(pos.position.y);
+    instances.rotation_cos.push_back(pos.rotation_cos);
+    instances.rotation_sin.push_back(pos.rotation_sin);
+    instances.size.push_back(size);
+    instances.shape.push_back(static_cast<uint8_t>(shape));
+    // indexed by Color_Modifier
+    instances.palette.push_back({
+        color,
+        Colors::Sub(color, modifier),
+        Colors::Add(color, modifier),
+        Colors::Sub(color, IM_COL32(0, 0, 0, 50))
+    });
+    instances.vertex_count += shapes[shape].size();
+}
+
+void AgentRenderer::ExpandShapes()
+{
+    auto& instances = shape_instances;
+    const auto first = vertices.size();
+    vertices.resize(first + instances.vertex_count);
+    auto* out = vertices.data() + first;
+    for (size_t i = 0; i < instances.shape.size(); i++) {
+        const auto& shape = shapes[instances.shape[i]];
+        const auto rotation_cos = instances.rotation_cos[i];
+        const auto rotation_sin = instances.rotation_sin[i];
+        const auto size = instances.size[i];
+        const auto x = instances.x[i];
+        const auto y = instances.y[i];
+        const auto& palette = instances.palette[i];
+        const auto* xs = shape.xs.data();
+        const auto* ys = shape.ys.data();
+        const auto* modifiers = shape.modifiers.data();
+        const auto count = shape.size();
+        for (size_t v = 0; v < count; v++) {
+            out[v].x = ((xs[v] * rotation_cos) - (ys[v] * rotation_sin)) * size + x;
+            out[v].y = ((xs[v] * rotation_sin) + (ys[v] * rotation_cos)) * size + y;
+            out[v].z = 0.f;
+            out[v].color = palette[modifiers[v]];
+        }
+        out += count;
     }
+    instances.clear();
 }
 
 void AgentRenderer::BuildCustomAgentsMap()
@@ -112,20 +112,33 @@ private:
         bool size_active = false;
     };
 
-    struct Shape_Vertex : GW::Vec2f {
-        Shape_Vertex(const float x, const float y, const Color_Modifier mod)
-            : Vec2f(x, y), modifier(mod) { }
-
-        Color_Modifier modifier;
-    };
-
+    // Shape template, one array per vertex component so expanding an instance is a straight loop
     struct Shape_t {
-        std::vector<Shape_Vertex> vertices{};
+        std::vector<float> xs{};
+        std::vector<float> ys{};
+        std::vector<uint8_t> modifiers{}; // Color_Modifier, used as an index into an instance's palette
         void AddVertex(float x, float y, Color_Modifier mod);
+        [[nodiscard]] size_t size() const { return xs.size(); }
     };
 
     Shape_t shapes[shape_size];
 
+    // Shapes enqueued since the last rebuild; ExpandShapes() writes them all into vertices in one pass
+    struct ShapeInstances {
+        std::vector<float> x{};
+        std::vector<float> y{};
+        std::vector<float> rotation_cos{};
+        std::vector<float> rotation_sin{};
+        std::vector<float> size{};
+        std::vector<uint8_t> shape{};
+        std::vector<std::array<Color, 4>> palette{}; // Colour per Color_Modifier
+        size_t vertex_count = 0;
+        void clear();
+    } shape_instances;
+
+    void ExpandShapes();
+    void clear() override;
+
     void Initialize(IDirect3DDevice9* device) override;
 
 
@@ -0,0 +1,216 @@
+#include "stdafx.h"
+
+#include <Widgets/Minimap/CustomRegionIndex.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    struct Bounds {
+        float min_x = std::numeric_limits<float>::max();
+        float min_y = std::numeric_limits<float>::max();
+        float max_x = std::numeric_limits<float>::lowest();
+        float max_y = std::numeric_limits<float>::lowest();
+
+        void Extend(const float x, const float y)
+        {
+            min_x = std::min(min_x, x);
+            min_y = std::min(min_y, y);
+            max_x = std::max(max_x, x);
+            max_y = std::max(max_y, y);
+        }
+
+        void Extend(const Bounds& other)
+        {
+            Extend(other.min_x, other.min_y);
+            Extend(other.max_x, other.max_y);
+        }
+
+        [[nodiscard]] bool IsEmpty() const { return min_x > max_x; }
+    };
+
+    float SquareDistance(const GW::Vec2f a, const GW::Vec2f b)
+    {
+        return (a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y);
+    }
+
+    // Flattens per-cell lists into offsets + one array, keeping each list's order
+    void Flatten(const std::vector<std::vector<uint32_t>>& lists, std::vector<uint32_t>& offsets, std::vector<uint32_t>& items)
+    {
+        offsets.clear();
+        items.clear();
+        offsets.reserve(lists.size() + 1);
+        for (const auto& list : lists) {
+            offsets.push_back(static_cast<uint32_t>(items.size()));
+            items.insert(items.end(), list.begin(), list.end());
+        }
+        offsets.push_back(static_cast<uint32_t>(items.size()));
+    }
+}
+
+void CustomRegionIndex::Build(const std::span<const Polygon> polygons_in, const std::span<const Circle> circles_in)
+{
+    Clear();
+
+    // Fewer than 3 points can't enclose anything
+    std::vector<const Polygon*> valid_polygons;
+    std::vector<Bounds> polygon_bounds;
+    std::vector<Bounds> circle_bounds;
+    Bounds bounds;
+    for (const auto& polygon : polygons_in) {
+        if (polygon.points.size() < 3) {
+            continue;
+        }
+        auto& polygon_bound = polygon_bounds.emplace_back();
+        for (const auto& point : polygon.points) {
+            polygon_bound.Extend(point.x, point.y);
+        }
+        bounds.Extend(polygon_bound);
+        valid_polygons.push_back(&polygon);
+    }
+    for (const auto& circle : circles_in) {
+        const auto radius = std::min(std::abs(circle.radius), max_distance);
+        auto& circle_bound = circle_bounds.emplace_back();
+        circle_bound.Extend(circle.center.x - radius, circle.center.y - radius);
+        circle_bound.Extend(circle.center.x + radius, circle.center.y + radius);
+        bounds.Extend(circle_bound);
+    }
+    if (bounds.IsEmpty()) {
+        return;
+    }
+
+    origin = {bounds.min_x, bounds.min_y};
+    cell_size = std::max(min_cell_size, std::max(bounds.max_x - bounds.min_x, bounds.max_y - bounds.min_y) / max_cells_per_side);
+    columns = static_cast<uint32_t>((bounds.max_x - bounds.min_x) / cell_size) + 1;
+    rows = static_cast<uint32_t>((bounds.max_y - bounds.min_y) / cell_size) + 1;
+
+    std::vector<std::vector<uint32_t>> polygons_by_cell(columns * rows);
+    std::vector<std::vector<uint32_t>> circles_by_cell(columns * rows);
+    const auto add_to_cells = [this](std::vector<std::vector<uint32_t>>& by_cell, const Bounds& region_bounds, const uint32_t region) {
+        for (auto row = Row(region_bounds.min_y); row <= Row(region_bounds.max_y); row++) {
+            for (auto column = Column(region_bounds.min_x); column <= Column(region_bounds.max_x); column++) {
+                by_cell[row * columns + column].push_back(region);
+            }
+        }
+    };
+
+    for (size_t p = 0; p < valid_polygons.size(); p++) {
+        const auto& points = valid_polygons[p]->points;
+        const auto& polygon_bound = polygon_bounds[p];
+        auto& entry = polygons.emplace_back();
+        entry.anchor = points[0];
+        entry.color = valid_polygons[p]->color;
+        entry.first_row = Row(polygon_bound.min_y);
+        entry.row_count = Row(polygon_bound.max_y) - entry.first_row + 1;
+        entry.row_offsets_begin = static_cast<uint32_t>(row_offsets.size());
+        for (auto row = entry.first_row; row < entry.first_row + entry.row_count; row++) {
+            row_offsets.push_back(static_cast<uint32_t>(edge_x0.size()));
+            for (size_t i = 0, j = points.size() - 1; i < points.size(); j = i++) {
+                const auto& a = points[i];
+                const auto& b = points[j];
+                // Horizontal edges are never crossed
+                if (a.y == b.y || Row(std::min(a.y, b.y)) > row || Row(std::max(a.y, b.y)) < row) {
+                    continue;
+                }
+                edge_x0.push_back(a.x);
+                edge_y0.push_back(a.y);
+                edge_y1.push_back(b.y);
+                edge_slope.push_back((b.x - a.x) / (b.y - a.y));
+            }
+        }
+        row_offsets.push_back(static_cast<uint32_t>(edge_x0.size()));
+        add_to_cells(polygons_by_cell, polygon_bound, static_cast<uint32_t>(p));
+    }
+
+    for (size_t c = 0; c < circles_in.size(); c++) {
+        const auto& circle = circles_in[c];
+        circles.push_back({circle.center, circle.radius * circle.radius, circle.color});
+        add_to_cells(circles_by_cell, circle_bounds[c], static_cast<uint32_t>(c));
+    }
+
+    Flatten(polygons_by_cell, cell_polygon_offsets, cell_polygons);
+    Flatten(circles_by_cell, cell_circle_offsets, cell_circles);
+}
+
+void CustomRegionIndex::Clear()
+{
+    polygons.clear();
+    circles.clear();
+    edge_x0.clear();
+    edge_y0.clear();
+    edge_y1.clear();
+    edge_slope.clear();
+    row_offsets.clear();
+    cell_polygon_offsets.clear();
+    cell_polygons.clear();
+    cell_circle_offsets.clear();
+    cell_circles.clear();
+    columns = rows = 0;
+}
+
+uint32_t CustomRegionIndex::Column(const float x) const
+{
+    return std::min(static_cast<uint32_t>(std::max((x - origin.x) / cell_size, 0.f)), columns - 1);
+}
+
+uint32_t CustomRegionIndex::Row(const float y) const
+{
+    return std::min(static_cast<uint32_t>(std::max((y - origin.y) / cell_size, 0.f)), rows - 1);
+}
+
+bool CustomRegionIndex::PolygonContains(const PolygonEntry& polygon, const uint32_t row, const GW::Vec2f pos) const
+{
+    if (row < polygon.first_row || row - polygon.first_row >= polygon.row_count) {
+        return false;
+    }
+    const auto begin = row_offsets[polygon.row_offsets_begin + row - polygon.first_row];
+    const auto end = row_offsets[polygon.row_offsets_begin + row - polygon.first_row + 1];
+    // Count edges crossed by a ray from pos towards +x
+    uint32_t crossings = 0;
+    for (auto i = begin; i < end; i++) {
+        const bool spans_y = (edge_y0[i] >= pos.y) != (edge_y1[i] >= pos.y);
+        const bool right_of_pos = pos.x <= edge_x0[i] + (pos.y - edge_y0[i]) * edge_slope[i];
+        crossings += spans_y & right_of_pos;
+    }
+    return crossings & 1;
+}
+
+const Color* CustomRegionIndex::Find(const GW::Vec2f pos) const
+{
+    const auto grid_x = (pos.x - origin.x) / cell_size;
+    const auto grid_y = (pos.y - origin.y) / cell_size;
+    if (!(grid_x >= 0.f && grid_x < static_cast<float>(columns) && grid_y >= 0.f && grid_y < static_cast<float>(rows))) {
+        return nullptr;
+    }
+    const auto row = static_cast<uint32_t>(grid_y);
+    const auto cell = row * columns + static_cast<uint32_t>(grid_x);
+    constexpr auto max_distance_squared = max_distance * max_distance;
+
+    for (auto i = cell_circle_offsets[cell + 1]; i-- > cell_circle_offsets[cell];) {
+        const auto& circle = circles[cell_circles[i]];
+        const auto distance_squared = SquareDistance(pos, circle.center);
+        if (distance_squared <= circle.radius_squared && distance_squared < max_distance_squared) {
+            return &circle.color;
+        }
+    }
+    for (auto i = cell_polygon_offsets[cell + 1]; i-- > cell_polygon_offsets[cell];) {
+        const auto& polygon = polygons[cell_polygons[i]];
+        if (SquareDistance(pos, polygon.anchor) < max_distance_squared && PolygonContains(polygon, row, pos)) {
+            return &polygon.color;
+        }
+    }
+    return nullptr;
+}
+
+void CustomRegionIndex::Classify(const std::span<const GW::Vec2f> positions, const std::span<const Color*> out) const
+{
+    ASSERT(out.size() >= positions.size());
+    if (empty()) {
+        std::fill_n(out.begin(), positions.size(), nullptr);
+        return;
+    }
+    for (size_t i = 0; i < positions.size(); i++) {
+        out[i] = Find(positions[i]);
+    }
+}
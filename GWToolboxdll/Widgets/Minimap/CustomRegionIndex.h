@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <GWCA/GameContainers/GamePos.h>
+
+using Color = uint32_t;
+
+/*
+Uniform grid over the custom polygons and circles that recolour hostile agents on the minimap.
+
+Build() lists every region under each grid cell its bounds overlap, and files each polygon's edges under every grid
+row their y range touches. A point query only visits the regions listed in its cell, and only crossing-tests the
+edges of a polygon in the point's row - a horizontal ray from the point can't cross any other edge. Edge slopes are
+precomputed and edge components are stored in separate arrays, so the crossing loop is branch-free.
+
+A region only applies within max_distance of its anchor (a polygon's first point, a circle's centre). Where regions
+overlap, the last circle containing the point wins, otherwise the last polygon.
+*/
+class CustomRegionIndex {
+public:
+    struct Polygon {
+        std::span<const GW::GamePos> points;
+        Color color;
+    };
+
+    struct Circle {
+        GW::Vec2f center;
+        float radius;
+        Color color;
+    };
+
+    static constexpr float max_distance = 2500.f;
+
+    void Build(std::span<const Polygon> polygons, std::span<const Circle> circles);
+    void Clear();
+    [[nodiscard]] bool empty() const { return polygons.empty() && circles.empty(); }
+
+    // Colour of the region containing pos, or nullptr if there isn't one
+    [[nodiscard]] const Color* Find(GW::Vec2f pos) const;
+    // Find() for every position, written to the matching index of out (at least as long as positions)
+    void Classify(std::span<const GW::Vec2f> positions, std::span<const Color*> out) const;
+
+private:
+    static constexpr float min_cell_size = 256.f;
+    static constexpr uint32_t max_cells_per_side = 64;
+
+    struct PolygonEntry {
+        GW::Vec2f anchor;
+        uint32_t first_row = 0;
+        uint32_t row_count = 0;
+        uint32_t row_offsets_begin = 0; // row_count + 1 offsets into the edge arrays
+        Color color = 0;
+    };
+
+    struct CircleEntry {
+        GW::Vec2f center;
+        float radius_squared = 0.f;
+        Color color = 0;
+    };
+
+    [[nodiscard]] uint32_t Column(float x) const;
+    [[nodiscard]] uint32_t Row(float y) const;
+    [[nodiscard]] bool PolygonContains(const PolygonEntry& polygon, uint32_t row, GW::Vec2f pos) const;
+
+    std::vector<PolygonEntry> polygons;
+    std::vector<CircleEntry> circles;
+
+    // Edges of every polygon, duplicated into each row they span
+    std::vector<float> edge_x0;
+    std::vector<float> edge_y0;
+    std::vector<float> edge_y1;
+    std::vector<float> edge_slope; // dx/dy
+    std::vector<uint32_t> row_offsets;
+
+    // Regions overlapping each cell, as offsets into cell_polygons/cell_circles; both in build order
+    std::vector<uint32_t> cell_polygon_offsets;
+    std::vector<uint32_t> cell_polygons;
+    std::vector<uint32_t> cell_circle_offsets;
+    std::vector<uint32_t> cell_circles;
+
+    GW::Vec2f origin;
+    float cell_size = min_cell_size;
+    uint32_t columns = 0;
+    uint32_t rows = 0;
+};
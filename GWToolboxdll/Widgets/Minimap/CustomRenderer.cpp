@@ -738,6 +738,32 @@ void CustomRenderer::Terminate()
         m.Terminate();
     }
     markers.clear();
+    region_index.Clear();
+    region_index_dirty = true;
+}
+
+const CustomRegionIndex& CustomRenderer::GetRegionIndex()
+{
+    const auto map_id = GW::Map::GetMapID();
+    if (!region_index_dirty && region_index_map_id == map_id) {
+        return region_index;
+    }
+    std::vector<CustomRegionIndex::Polygon> region_polygons;
+    for (const auto& polygon : polygons) {
+        if ((polygon.visible && polygon.map == GW::Constants::MapID::None || polygon.map == map_id) && (polygon.color_sub & IM_COL32_A_MASK) != 0) {
+            region_polygons.push_back({polygon.points, polygon.color_sub});
+        }
+    }
+    std::vector<CustomRegionIndex::Circle> region_circles;
+    for (const auto& marker : markers) {
+        if ((marker.visible && marker.map == GW::Constants::MapID::None || marker.map == map_id) && (marker.color_sub & IM_COL32_A_MASK) != 0) {
+            region_circles.push_back({marker.pos, marker.size, marker.color_sub});
+        }
+    }
+    region_index.Build(region_polygons, region_circles);
+    region_index_map_id = map_id;
+    region_index_dirty = false;
+    return region_index;
 }
 void CustomRenderer::CustomPolygon::Initialize(IDirect3DDevice9* device)
 {
@@ -822,6 +848,7 @@ void CustomRenderer::Render(IDirect3DDevice9* device)
         GameWorldRenderer::TriggerSyncAllMarkers();
         marker_file_dirty = true;
         markers_changed = false;
+        region_index_dirty = true;
         Invalidate();
         return;
     }
@@ -3,6 +3,7 @@
 #include <GWCA/GameContainers/GamePos.h>
 
 #include <D3DContainers.h>
+#include <Widgets/Minimap/CustomRegionIndex.h>
 
 namespace GW::Constants {
     enum class MapID : uint32_t;
@@ -103,6 +104,8 @@ public:
     [[nodiscard]] const std::vector<CustomLine*>& GetLines() const { return lines; }
     [[nodiscard]] const std::vector<CustomPolygon>& GetPolys() const { return polygons; }
     [[nodiscard]] const std::vector<CustomMarker>& GetMarkers() const { return markers; }
+    // Polygons and markers that recolour hostile agents in the current map; rebuilt when they change or the map does
+    [[nodiscard]] const CustomRegionIndex& GetRegionIndex();
 
 private:
     void Initialize(IDirect3DDevice9* device) override;
@@ -124,6 +127,9 @@ private:
     int show_polygon_details = -1;
     bool markers_changed = false;
     bool marker_file_dirty = true;
+    bool region_index_dirty = true;
+    GW::Constants::MapID region_index_map_id{};
+    CustomRegionIndex region_index;
     std::vector<CustomLine*> lines{};
     std::vector<CustomMarker> markers{};
     std::vector<CustomPolygon> polygons{};
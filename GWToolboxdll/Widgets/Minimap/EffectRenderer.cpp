@@ -33,33 +33,27 @@ namespace {
         Churning_earth       = 994
     };
 
-    class EffectCircle : public D3DVertexBuffer {
-        void Initialize(IDirect3DDevice9* device) override;
-
-    public:
-        Color* color = nullptr;
-        float range = GW::Constants::Range::Adjacent;
-    };
-
     struct Effect {
         Effect(const uint32_t _effect_id, const float _x, const float _y, const uint32_t _duration,
-               const float range, Color* _color)
+               const float _range, Color* _color)
             : start(TIMER_INIT())
             , effect_id(_effect_id)
             , pos(_x, _y)
             , duration(_duration)
-        {
-            circle.range = range;
-            circle.color = _color;
-        }
-        ~Effect() { circle.Terminate();}
+            , range(_range)
+            , color(_color) { }
         clock_t start;
         const uint32_t effect_id;
         const GW::Vec2f pos;
         uint32_t duration;
-        EffectCircle circle;
+        float range = GW::Constants::Range::Adjacent;
+        Color* color = nullptr;
     };
 
+    // All live effect circles are expanded into one world-space line list and drawn in a single call
+    constexpr size_t circle_segments = 16;
+    std::vector<D3DVertex> effect_vertices;
+
     struct pair_hash {
         template <class T1, class T2>
         size_t operator()(const std::pair<T1, T2>& pair) const
@@ -104,7 +98,6 @@ namespace {
 
     GW::HookEntry StoC_Hook;
 
-    unsigned int vertices_max = 0x1000; // max number of vertices to draw in one call
 }
 
 void EffectRenderer::LoadDefaults()
@@ -220,7 +213,7 @@ void EffectRenderer::RemoveTriggeredEffect(const uint32_t effect_id, GW::Vec2f*
         // Trigger this trap to time out in 2 seconds' time. Increase damage radius from adjacent to nearby.
         closest->start = TIMER_INIT();
         closest->duration = trigger->duration;
-        closest->circle.range = trigger->range;
+        closest->range = trigger->range;
     }
 }
 
@@ -309,12 +302,6 @@ void EffectRenderer::Initialize(IDirect3DDevice9* device)
     }
     initialized = true;
     type = D3DPT_LINELIST;
-
-    const HRESULT hr = device->CreateVertexBuffer(sizeof(D3DVertex) * vertices_max, 0,
-                                                  D3DFVF_CUSTOMVERTEX, D3DPOOL_MANAGED, &buffer, nullptr);
-    if (FAILED(hr)) {
-        printf("Error setting up PingsLinesRenderer vertex buffer: HRESULT: 0x%lX\n", hr);
-    }
     GW::StoC::RegisterPacketCallback<GW::Packet::StoC::GameSrvTransfer>(&StoC_Hook, [&](GW::HookStatus*, GW::Packet::StoC::GameSrvTransfer*) {
         need_to_clear_effects = true;
     });
@@ -336,40 +323,36 @@ void EffectRenderer::DrawAoeEffects(IDirect3DDevice9* device)
         return;
     }
     std::lock_guard lock(effects_mutex);
-    size_t effect_size = aoe_effects.size();
-    for (size_t i = 0; i < effect_size; i++) {
-        Effect* effect = aoe_effects[i];
-        if (!effect) {
-            continue;
+
+    static const auto unit_circle = [] {
+        std::array<GW::Vec2f, circle_segments + 1> points{};
+        for (size_t i = 0; i <= circle_segments; i++) {
+            const float angle = (i % circle_segments) * (DirectX::XM_2PI / circle_segments);
+            points[i] = {std::cos(angle), std::sin(angle)};
         }
-        if (TIMER_DIFF(effect->start) > static_cast<clock_t>(effect->duration)) {
-            aoe_effects.erase(aoe_effects.begin() + static_cast<int>(i));
-            delete effect;
-            i--;
-            effect_size--;
-            continue;
+        return points;
+    }();
+
+    effect_vertices.clear();
+    std::erase_if(aoe_effects, [](Effect* effect) {
+        if (effect && TIMER_DIFF(effect->start) <= static_cast<clock_t>(effect->duration))
+            return false;
+        delete effect;
+        return true;
+    });
+    for (const auto effect : aoe_effects) {
+        const auto color = *effect->color;
+        for (size_t i = 0; i < circle_segments; i++) {
+            const auto& a = unit_circle[i];
+            const auto& b = unit_circle[i + 1];
+            effect_vertices.emplace_back(effect->pos.x + a.x * effect->range, effect->pos.y + a.y * effect->range, color);
+            effect_vertices.emplace_back(effect->pos.x + b.x * effect->range, effect->pos.y + b.y * effect->range, color);
         }
-        const auto translate = DirectX::XMMatrixTranslation(effect->pos.x, effect->pos.y, 0.0f);
-        const auto scale = DirectX::XMMatrixScaling(effect->circle.range, effect->circle.range, 1.0f);
-        auto world = scale * translate;
-        device->SetTransform(D3DTS_WORLD, reinterpret_cast<D3DMATRIX*>(&world));
-        effect->circle.Render(device);
     }
-}
-
-void EffectCircle::Initialize(IDirect3DDevice9* device)
-{
-    constexpr size_t poly_count = 16;
-    type = D3DPT_LINESTRIP;
-
-    vertices.resize(poly_count + 1);
-    for (size_t i = 0; i < poly_count; i++) {
-        const float angle = i * (DirectX::XM_2PI / poly_count);
-        vertices[i] = {std::cos(angle), std::sin(angle), 0.f, *color};
+    if (effect_vertices.empty()) {
+        return;
     }
-    vertices[poly_count] = vertices[0];
-
-    D3DVertexBuffer::Initialize(device);
-
-    count = poly_count;
+    const auto identity = DirectX::XMMatrixIdentity();
+    device->SetTransform(D3DTS_WORLD, reinterpret_cast<const D3DMATRIX*>(&identity));
+    D3DDynamicVertexRing::Instance().Draw(device, type, effect_vertices.data(), effect_vertices.size());
 }
@@ -9,6 +9,8 @@
 #include <GWCA/Managers/RenderMgr.h>
 
 #include <Defines.h>
+#include <Modules/Resources.h>
+#include <Utils/TerrainHeightfield.h>
 #include <Widgets/Minimap/GameWorldRenderer.h>
 #include <Widgets/Minimap/Minimap.h>
 #include <ImGuiAddons.h>
@@ -33,6 +35,106 @@ namespace {
     IDirect3DPixelShader9* pshader = nullptr;
     IDirect3DVertexDeclaration9* vertex_declaration = nullptr;
 
+    // Altitudes for the current map; only touched by the render thread
+    TerrainHeightfield heightfield;
+    bool heightfield_loading = false;
+    // A worker loads the next map's heightfield from disk into loaded_heightfield, for SyncHeightfield to pick up.
+    // heightfield_load_id is bumped to drop a load that's no longer wanted.
+    std::mutex heightfield_load_mutex;
+    std::unique_ptr<TerrainHeightfield> loaded_heightfield;
+    uint32_t heightfield_load_id = 0;
+    // Hash of the current pathing map, recomputed when the game's pathing data moves
+    const void* hashed_pathing_data = nullptr;
+    uint64_t pathing_hash = 0;
+    // Altitude queries per frame, for baking tiles and for exact other-plane lookups, so entering an unvisited map
+    // doesn't stall the render thread
+    constexpr uint32_t heightfield_queries_per_frame = 16 * TerrainHeightfield::queries_per_tile;
+    uint32_t heightfield_query_budget = 0;
+
+    float QueryTerrainAltitude(const float x, const float y, const uint32_t plane)
+    {
+        GW::GamePos p = {x, y, plane};
+        return GW::Map::QueryAltitude(&p);
+    }
+
+    std::filesystem::path GetHeightfieldPath(const uint32_t map_id)
+    {
+        return Resources::GetPath(L"heightfields", std::format(L"{}.bin", map_id));
+    }
+
+    void SaveHeightfield()
+    {
+        if (!heightfield.IsDirty() || !heightfield.GetMapId()) {
+            return;
+        }
+        Resources::EnqueueWorkerTask([map_id = heightfield.GetMapId(), data = heightfield.Serialize()] {
+            if (Resources::EnsureFolderExists(Resources::GetPath(L"heightfields"))) {
+                Resources::WriteFile(GetHeightfieldPath(map_id), data);
+            }
+        });
+        heightfield.ClearDirty();
+    }
+
+    // FNV-1a over the pathing trapezoids, so a heightfield saved before a game update changed the map isn't used
+    uint64_t HashPathingMap(const GW::PathingMapArray& pathing_map)
+    {
+        uint64_t hash = 0xcbf29ce484222325;
+        const auto add = [&hash](const void* data, const size_t size) {
+            for (size_t i = 0; i < size; i++) {
+                hash = (hash ^ static_cast<const uint8_t*>(data)[i]) * 0x100000001b3;
+            }
+        };
+        for (const auto& plane : pathing_map) {
+            add(&plane.trapezoid_count, sizeof(plane.trapezoid_count));
+            for (uint32_t i = 0; i < plane.trapezoid_count; i++) {
+                add(&plane.trapezoids[i].XTL, sizeof(float) * 6);
+            }
+        }
+        return hash;
+    }
+
+    // Swaps the heightfield for map_id's, saving the old one; false while the new one is still loading
+    bool SyncHeightfield(const GW::Constants::MapID map_id, const GW::PathingMapArray& pathing_map)
+    {
+        if (heightfield_loading) {
+            std::lock_guard lock(heightfield_load_mutex);
+            if (!loaded_heightfield) {
+                return false;
+            }
+            heightfield = std::move(*loaded_heightfield);
+            loaded_heightfield.reset();
+            heightfield_loading = false;
+        }
+        if (hashed_pathing_data != pathing_map.begin()) {
+            hashed_pathing_data = pathing_map.begin();
+            pathing_hash = HashPathingMap(pathing_map);
+        }
+        const auto id = static_cast<uint32_t>(map_id);
+        if (heightfield.GetMapId() == id && heightfield.GetSourceHash() == pathing_hash) {
+            return true;
+        }
+        SaveHeightfield();
+        heightfield = TerrainHeightfield();
+        heightfield_loading = true;
+        uint32_t load_id;
+        {
+            std::lock_guard lock(heightfield_load_mutex);
+            load_id = ++heightfield_load_id;
+        }
+        Resources::EnqueueWorkerTask([id, source_hash = pathing_hash, load_id] {
+            auto loaded = std::make_unique<TerrainHeightfield>(id, source_hash);
+            std::string data;
+            if (Resources::ReadFile(GetHeightfieldPath(id), data)) {
+                loaded->Deserialize(data);
+            }
+            std::lock_guard lock(heightfield_load_mutex);
+            if (load_id == heightfield_load_id) {
+                loaded_heightfield = std::move(loaded);
+            }
+        });
+        return false;
+    }
+
     constexpr GW::Vec2f lerp(const GW::Vec2f& a, const GW::Vec2f& b, const float t)
     {
         return a * t + b * (1.f - t);
@@ -75,72 +177,89 @@ namespace {
         return nullptr;
     }
 
-    // update altitudes if not done already, then add to the device buffer
-    bool AddPolyToDevice(GameWorldRenderer::GenericPolyRenderable& poly, IDirect3DDevice9* device)
+    // altitudes (Z value) for each vertex can't be known until we are in the correct map, so these are dynamically
+    // computed, one-time. Each vertex takes the altitude of its own plane; where that's far off the line between the
+    // first and last vertex (e.g. a line passing under a bridge), every other plane is tried too.
+    // Returns false, leaving the vertices untouched, until the heightfield has the tiles for all of them.
+    bool ComputeAltitudes(GameWorldRenderer::GenericPolyRenderable& poly)
     {
-        if (poly.vb)
-            return true; // Already created the vertex buffer for this poly, which means altitudes have been done!
-        auto& vertices = poly.vertices;
-        if (poly.vertices_processed == vertices.size())
-            return true;
-        // altitudes (Z value) for each vertex can't be known until we are in the correct map,
-        // so these are dynamically computed, one-time.
-        float altitude = ALTITUDE_UNKNOWN;
-
         // in order to properly query altitudes, we have to use the pathing map
         // to determine the number of Z planes in the current map.
         const GW::PathingMapArray* pathing_map = GW::Map::GetPathingMap();
         if (!pathing_map || pathing_map->size() == 0)
             return false;
+        if (!SyncHeightfield(GW::Map::GetMapID(), *pathing_map))
+            return false;
 
-        const auto z_plane0 = poly.vertices_zplanes[0];
-        GW::GamePos p = {vertices[0].x, vertices[0].y, z_plane0};
-        altitude = GW::Map::QueryAltitude(&p);
-        const auto altitude0 = altitude;
-        ++poly.vertices_processed;
-        vertices[0].z = altitude;
-
-        const auto z_planeZ = poly.vertices_zplanes[vertices.size() - 1];
-        p = {vertices[vertices.size() - 1].x, vertices[vertices.size() - 1].y, z_planeZ};
-        altitude = GW::Map::QueryAltitude(&p);
-        const auto altitudeZ = altitude;
-        vertices[vertices.size() - 1].z = altitude;
-
-        const auto altitude_diff = altitudeZ - altitude0;
-
-        for (size_t i = poly.vertices_processed; i < vertices.size() - 1; i++, poly.vertices_processed++) {
-            // until we have a better solution, all Z planes will be queried per vertex
-            // to avoid a significant delay in the render thread, query one plane per frame
-            // until all have been queried. this might result in some renderables shifting
-            // not appearing for a while on first map load, but IMO is better than stalling.
-            // It seems to take, even in most extreme cases, less time than it takes for agents
-            // to appear.
-
-            // @Cleanup: zplane needs setting properly here!
-            const auto z_plane = poly.vertices_zplanes[i];
-            p = {vertices[i].x, vertices[i].y, z_plane};
-            altitude = GW::Map::QueryAltitude(&p);
-
-            if (altitude < vertices[i].z) {
-                // recall that the Up camera component is inverted
-                vertices[i].z = altitude;
+        auto& vertices = poly.vertices;
+        std::vector<GW::GamePos> points;
+        points.reserve(vertices.size());
+        for (size_t i = 0; i < vertices.size(); i++) {
+            points.emplace_back(vertices[i].x, vertices[i].y, poly.vertices_zplanes[i]);
+        }
+        std::vector<float> altitudes(points.size());
+        if (!heightfield.SampleAltitude(points, altitudes, QueryTerrainAltitude, heightfield_query_budget))
+            return false;
+
+        const auto last = vertices.size() - 1;
+        const auto altitude0 = altitudes[0];
+        const auto altitude_diff = altitudes[last] - altitude0;
+        const auto guess_altitude = [&](const size_t i) {
+            return altitude0 + altitude_diff * static_cast<float>(i) / static_cast<float>(last);
+        };
+
+        // the other planes of a mismatched vertex are queried exactly, one query per plane, rather than baking a tile of
+        // every other plane for a single point; planes from highest to 1
+        const auto other_planes = pathing_map->size() - 1;
+        std::vector<size_t> mismatched;
+        for (size_t i = 1; i < last; i++) {
+            if (std::abs(altitudes[i] - guess_altitude(i)) > 20.f)
+                mismatched.push_back(i);
+        }
+        const auto exact_queries = static_cast<uint32_t>(mismatched.size() * other_planes);
+        // a poly needing more than a whole frame's budget still goes through, on a frame of its own
+        if (exact_queries > heightfield_query_budget && heightfield_query_budget < heightfield_queries_per_frame)
+            return false;
+        heightfield_query_budget -= std::min(exact_queries, heightfield_query_budget);
+        std::vector<float> plane_altitudes;
+        plane_altitudes.reserve(exact_queries);
+        for (const auto i : mismatched) {
+            for (uint32_t zplane = other_planes; zplane >= 1; --zplane) {
+                plane_altitudes.push_back(QueryTerrainAltitude(vertices[i].x, vertices[i].y, zplane));
             }
+        }
 
-            const auto guessed_altitude = altitude0 + (altitude_diff * static_cast<float>(i) / static_cast<float>(vertices.size() - 1));
-            if (std::abs(altitude - guessed_altitude) > 20.f) {
-                auto min_diff = std::abs(altitude - guessed_altitude);
-                for (unsigned zplane = pathing_map->size() - 1; zplane >= 1; --zplane) {
-                    p = {vertices[i].x, vertices[i].y, zplane};
-                    altitude = GW::Map::QueryAltitude(&p);
-                    const auto cur_diff = std::abs(altitude - guessed_altitude);
-                    if (cur_diff < min_diff && altitude < vertices[i].z) {
-                        min_diff = cur_diff;
-                        vertices[i].z = altitude;
-                    }
+        for (size_t i = 0; i < vertices.size(); i++) {
+            vertices[i].z = altitudes[i];
+        }
+        for (size_t m = 0; m < mismatched.size(); m++) {
+            const auto i = mismatched[m];
+            const auto guessed_altitude = guess_altitude(i);
+            auto min_diff = std::abs(altitudes[i] - guessed_altitude);
+            for (size_t j = 0; j < other_planes; j++) {
+                const auto altitude = plane_altitudes[m * other_planes + j];
+                const auto cur_diff = std::abs(altitude - guessed_altitude);
+                // recall that the Up camera component is inverted
+                if (cur_diff < min_diff && altitude < vertices[i].z) {
+                    min_diff = cur_diff;
+                    vertices[i].z = altitude;
                 }
             }
         }
-        ++poly.vertices_processed;
+        return true;
+    }
+
+    // update altitudes if not done already, then add to the device buffer
+    bool AddPolyToDevice(GameWorldRenderer::GenericPolyRenderable& poly, IDirect3DDevice9* device)
+    {
+        if (poly.vb)
+            return true; // Already created the vertex buffer for this poly, which means altitudes have been done!
+        auto& vertices = poly.vertices;
+        if (poly.vertices_processed == vertices.size())
+            return true;
+        if (!ComputeAltitudes(poly))
+            return false;
+        poly.vertices_processed = vertices.size();
 
         // commit the completed vertices to vram
         auto res = device->CreateVertexBuffer(vertices.size() * sizeof(D3DVertex), D3DUSAGE_WRITEONLY, D3DFVF_CUSTOMVERTEX, D3DPOOL_MANAGED, &poly.vb, nullptr);
@@ -405,6 +524,7 @@ void GameWorldRenderer::Render(IDirect3DDevice9* device)
         }
 
         const auto map_id = GW::Map::GetMapID();
+        heightfield_query_budget = heightfield_queries_per_frame;
         renderables_mutex.lock();
         for (auto& renderable : renderables) {
             if (renderable.map_id == map_id) {
@@ -504,6 +624,16 @@ void GameWorldRenderer::Terminate()
 {
     // free up any vertex buffers
     renderables.clear();
+    {
+        // Drop a load still running on a worker
+        std::lock_guard lock(heightfield_load_mutex);
+        heightfield_load_id++;
+        loaded_heightfield.reset();
+    }
+    SaveHeightfield();
+    heightfield = TerrainHeightfield();
+    heightfield_loading = false;
+    hashed_pathing_data = nullptr;
     if (vshader)
         vshader->Release();
     vshader = nullptr;
@@ -28,6 +28,8 @@ public:
             other.points.clear();
             vertices = std::move(other.vertices);
             other.vertices.clear();
+            vertices_zplanes = std::move(other.vertices_zplanes);
+            other.vertices_zplanes.clear();
         }
 
         // copy not allowed
@@ -42,6 +44,7 @@ public:
             other.vb = nullptr;
             points = std::move(other.points);
             vertices = std::move(other.vertices);
+            vertices_zplanes = std::move(other.vertices_zplanes);
 
             map_id = other.map_id;
             col = other.col;
@@ -789,6 +789,7 @@ void Minimap::SignalTerminate()
     custom_renderer.Terminate();
     effect_renderer.Terminate();
     GameWorldRenderer::Terminate();
+    D3DDynamicVertexRing::Instance().InvalidateDeviceObjects();
     GW::GameThread::Enqueue([] {
         RefreshQuestMarker();
         ResetWindowPosition(GW::UI::WindowID_Compass, compass_frame);
@@ -15,6 +15,7 @@
 #include <Modules/Resources.h>
 #include <Modules/ToolboxSettings.h>
 #include <Widgets/PartyDamage.h>
+#include <Utils/CombatEvents.h>
 #include <Utils/TextUtils.h>
 #include <Utils/ToolboxUtils.h>
 
@@ -57,7 +58,7 @@ namespace {
     // Distance away from the party window on the x axis; used with snap to party window
     int user_offset = 0;
 
-    GW::HookEntry GenericModifier_Entry;
+    CombatEvents::Subscriber combat_events{CombatEvents::TypeMask(CombatEventType::Damage, CombatEventType::Heal)};
     GW::HookEntry MapLoaded_Entry;
 
     float GetPartOfTotal(uint32_t dmg)
@@ -296,7 +297,13 @@ void PartyDamage::WritePartyDamage()
 
 void PartyDamage::MapLoadedCallback(GW::HookStatus*, const GW::Packet::StoC::MapLoaded*)
 {
-    switch (GW::Map::GetInstanceType()) {
+    // Reset once the damage from the previous map still queued has been counted
+    combat_events.Push({.type = CombatEventType::Marker, .value = static_cast<uint32_t>(GW::Map::GetInstanceType())});
+}
+
+void PartyDamage::OnMapLoaded(const GW::Constants::InstanceType instance_type)
+{
+    switch (instance_type) {
         case GW::Constants::InstanceType::Outpost:
             in_explorable = false;
             break;
@@ -312,24 +319,15 @@ void PartyDamage::MapLoadedCallback(GW::HookStatus*, const GW::Packet::StoC::Map
     }
 }
 
-void PartyDamage::DamagePacketCallback(GW::HookStatus*, const GW::Packet::StoC::GenericModifier* packet)
+void PartyDamage::OnDamageEvent(const CombatEvent& event)
 {
-    // ignore non-damage/heal packets
-    switch (packet->type) {
-        case GW::Packet::StoC::P156_Type::damage:
-        case GW::Packet::StoC::P156_Type::critical:
-        case GW::Packet::StoC::P156_Type::armorignoring:
-            break;
-        default:
-            return;
+    TB_TRACE_ZONE("PartyDamage::OnDamageEvent");
+    if (event.type == CombatEventType::Marker) {
+        return OnMapLoaded(static_cast<GW::Constants::InstanceType>(event.value));
     }
+    const bool is_damage = event.type == CombatEventType::Damage;
 
-    const bool is_heal = packet->value > 0;
-    const bool is_damage = packet->value < 0;
-    if (!is_heal && !is_damage)
-        return;
-
-    const auto cause = static_cast<GW::AgentLiving*>(GW::Agents::GetAgentByID(packet->cause_id));
+    const auto cause = static_cast<GW::AgentLiving*>(GW::Agents::GetAgentByID(event.agent_id));
     if (!(cause && cause->GetIsLivingType()))
         return; // Ignore damage/heals caused by non-living agents
     if (cause->allegiance != GW::Constants::Allegiance::Ally_NonAttackable)
@@ -340,7 +338,7 @@ void PartyDamage::DamagePacketCallback(GW::HookStatus*, const GW::Packet::StoC::
     if (!entry)
         return;
 
-    const auto target = static_cast<GW::AgentLiving*>(GW::Agents::GetAgentByID(packet->target_id));
+    const auto target = static_cast<GW::AgentLiving*>(GW::Agents::GetAgentByID(event.target_id));
     if (!(target && target->GetIsLivingType()))
         return; // Ignore damage/heals on non-living agents
 
@@ -369,24 +367,24 @@ void PartyDamage::DamagePacketCallback(GW::HookStatus*, const GW::Packet::StoC::
 
     long lvalue;
     if (target->max_hp > 0 && target->max_hp < 100000) {
-        lvalue = std::lround(std::abs(packet->value) * target->max_hp);
+        lvalue = std::lround(std::abs(event.amount) * target->max_hp);
         hp_map[target->player_number] = target->max_hp;
     }
     else {
         const auto it = hp_map.find(target->player_number);
         if (it == hp_map.end()) {
             // max hp not found, approximate with hp/lvl formula
-            lvalue = std::lround(std::abs(packet->value) * (target->level * 20 + 100));
+            lvalue = std::lround(std::abs(event.amount) * (target->level * 20 + 100));
         }
         else {
-            lvalue = std::lround(std::abs(packet->value) * it->second);
+            lvalue = std::lround(std::abs(event.amount) * it->second);
         }
     }
 
     const uint32_t amount = static_cast<uint32_t>(lvalue);
 
     if (entry->damage == 0 && entry->healing == 0) {
-        entry->agent_id = packet->cause_id;
+        entry->agent_id = event.agent_id;
         entry->primary = static_cast<GW::Constants::Profession>(cause->primary);
         entry->secondary = static_cast<GW::Constants::Profession>(cause->secondary);
     }
@@ -478,7 +476,7 @@ void PartyDamage::Initialize()
     total = 0;
     send_timer = TIMER_INIT();
 
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::GenericModifier>(&GenericModifier_Entry, DamagePacketCallback, 0x8000);
+    combat_events.Subscribe();
     GW::StoC::RegisterPacketCallback<GW::Packet::StoC::MapLoaded>(&MapLoaded_Entry, MapLoadedCallback, 0x8000);
 
     GW::Chat::CreateCommand(&ChatCmd_HookEntry, L"dmg", CmdDamage);
@@ -489,7 +487,7 @@ void PartyDamage::Initialize()
 void PartyDamage::Terminate()
 {
     SnapsToPartyWindow::Terminate();
-    GW::StoC::RemoveCallbacks(&GenericModifier_Entry);
+    combat_events.Unsubscribe();
     GW::StoC::RemoveCallbacks(&MapLoaded_Entry);
     GW::Chat::DeleteCommand(&ChatCmd_HookEntry);
 
@@ -504,6 +502,8 @@ void PartyDamage::Terminate()
 
 void PartyDamage::Update(const float)
 {
+    combat_events.Drain(OnDamageEvent);
+
     if (!send_queue.empty() && TIMER_DIFF(send_timer) > 600) {
         send_timer = TIMER_INIT();
         if (GW::Map::GetInstanceType() != GW::Constants::InstanceType::Loading
@@ -7,6 +7,9 @@
 #include <Widgets/SnapsToPartyWindow.h>
 
 namespace GW {
+    namespace Constants {
+        enum class InstanceType;
+    }
     namespace Packet {
         namespace StoC {
             struct MapLoaded;
@@ -14,6 +17,7 @@ namespace GW {
     }
     struct HookStatus;
 }
+struct CombatEvent;
 
 class PartyDamage : public SnapsToPartyWindow {
 protected:
@@ -33,7 +37,8 @@ protected:
     static void CHAT_CMD_FUNC(CmdDamage);
 
     static void MapLoadedCallback(GW::HookStatus*, const GW::Packet::StoC::MapLoaded*);
-    static void DamagePacketCallback(GW::HookStatus*, const GW::Packet::StoC::GenericModifier*);
+    static void OnMapLoaded(GW::Constants::InstanceType instance_type);
+    static void OnDamageEvent(const CombatEvent& event);
 
 public:
     static PartyDamage& Instance()
@@ -36,6 +36,7 @@
 #include <Windows/TravelWindow.h>
 
 #include <Utils/GuiUtils.h>
+#include <Utils/StaticRTree.h>
 #include <Utils/ToolboxUtils.h>
 
 #include "Defines.h"
@@ -75,46 +76,61 @@ namespace {
         GW::Vec2f world_pos;
         uint32_t map_file_id = 0;
         uint32_t prop_index = 0;
-        
+
         uint32_t linked_portal_map_file_id = 0;
-        uint32_t linked_portal_prop_index = 0;
+        uint32_t linked_portal_index = 0; // Index into the linked map's portals
 
         const MapPortal* linkedPortal() const
         {
             const auto found = map_info_by_file_id.find(linked_portal_map_file_id);
             if (found == map_info_by_file_id.end()) return nullptr;
-
             const auto& other_map_portals = found->second.portals;
-
-            const auto other_portal = std::ranges::find_if(other_map_portals.begin(), other_map_portals.end(), [this](const MapPortal& other) {
-                return other.linked_portal_prop_index == this->prop_index;
-            });
-            return other_portal == other_map_portals.end() ? nullptr : &other_portal[0];
-        }
-
-        void checkForLinkedPortal(GW::Continent continent)
-        {
-            if (linked_portal_map_file_id) return;
-            for (auto& it : map_info_by_file_id) {
-                if (it.second.continent != continent) continue;
-                auto& other_map_portals = it.second.portals;
-                auto other_portal = std::ranges::find_if(other_map_portals.begin(), other_map_portals.end(), [this](const MapPortal& other) {
-                    return other.map_file_id != this->map_file_id && other.world_pos.x == this->world_pos.x && other.world_pos.y == this->world_pos.y;
-                });
-                if (other_portal != other_map_portals.end()) {
-                    linked_portal_map_file_id = other_portal->map_file_id;
-                    linked_portal_prop_index = other_portal->prop_index;
-                    other_portal->linked_portal_map_file_id = map_file_id;
-                    other_portal->linked_portal_prop_index = prop_index;
-                    return;
-                }
-            }
+            return linked_portal_index < other_map_portals.size() ? &other_map_portals[linked_portal_index] : nullptr;
         }
     };
 
+    // Portal link graph: two portals on different maps of the same continent at the same world map position lead into each other.
+    // Keyed on exact position; value is (map_file_id, portal index) of the first portal seen there.
+    std::map<std::tuple<GW::Continent, float, float>, std::pair<uint32_t, uint32_t>> portals_by_position;
 
+    void LinkPortals(MapFileInfo& info)
+    {
+        for (uint32_t i = 0; i < info.portals.size(); i++) {
+            auto& portal = info.portals[i];
+            if (portal.linked_portal_map_file_id) continue;
+            const auto [found, inserted] = portals_by_position.try_emplace({info.continent, portal.world_pos.x, portal.world_pos.y}, info.map_file_id, i);
+            if (inserted) continue;
+            const auto [other_map_file_id, other_index] = found->second;
+            if (other_map_file_id == info.map_file_id) continue;
+            const auto other_map = map_info_by_file_id.find(other_map_file_id);
+            if (other_map == map_info_by_file_id.end() || other_index >= other_map->second.portals.size()) continue;
+            auto& other = other_map->second.portals[other_index];
+            portal.linked_portal_map_file_id = other_map_file_id;
+            portal.linked_portal_index = other_index;
+            other.linked_portal_map_file_id = info.map_file_id;
+            other.linked_portal_index = i;
+        }
+    }
 
+    // World map bounds of every map shown on the world map, per continent. Built once from the area info table.
+    std::map<GW::Continent, StaticRTree<GW::Constants::MapID>> map_bounds_by_continent;
 
+    void BuildMapBoundsIndex()
+    {
+        std::map<GW::Continent, std::vector<StaticRTree<GW::Constants::MapID>::Entry>> entries;
+        for (size_t i = 1; i < static_cast<size_t>(GW::Constants::MapID::Count); i++) {
+            const auto map_id = static_cast<GW::Constants::MapID>(i);
+            const auto map_info = GW::Map::GetMapInfo(map_id);
+            if (!(map_info && map_info->GetIsOnWorldMap())) continue;
+            ImRect map_bounds;
+            if (!GW::Map::GetMapWorldMapBounds(map_info, &map_bounds) || map_bounds.Min.x >= map_bounds.Max.x || map_bounds.Min.y >= map_bounds.Max.y) continue;
+            entries[map_info->continent].push_back({{map_bounds.Min.x, map_bounds.Min.y, map_bounds.Max.x, map_bounds.Max.y}, map_id});
+        }
+        map_bounds_by_continent.clear();
+        for (auto& [continent, continent_entries] : entries) {
+            map_bounds_by_continent[continent].Build(std::move(continent_entries));
+        }
+    }
 
     const ImColor completed_bg = IM_COL32(0, 0x99, 0, 192);
     const ImColor completed_text = IM_COL32(0xE5, 0xFF, 0xCC, 255);
@@ -153,6 +169,7 @@ namespace {
     GW::Vec2f viewport_offset;
     GW::Vec2f ui_scale;
     float world_map_scale = 1.f;
+    ImRect visible_world_rect;
     GW::WorldMapContext* world_map_context = nullptr;
     float quest_star_rotation_angle = .0f;
     float quest_icon_size = 24.f;
@@ -390,31 +407,41 @@ namespace {
 
     GW::Constants::MapID GetClosestMapToPoint(const GW::Vec2f& world_map_point)
     {
-        for (size_t i = 0; i < (size_t)GW::Constants::MapID::Count; i++) {
-            const auto map_info = GW::Map::GetMapInfo((GW::Constants::MapID)i);
-            if (!map_info || !map_info->thumbnail_id || !map_info->name_id || !(map_info->x || map_info->y)) continue;
-            if ((map_info->flags & 0x5000000) == 0x5000000) continue;   // e.g. "wrong" augury rock is map 119, no NPCs
-            if ((map_info->flags & 0x80000000) == 0x80000000) continue; // e.g. Debug map
-            if (!map_info->GetIsOnWorldMap()) continue;
-            (world_map_point);
-            // TODO: distance from point to rect
-        }
-        return GW::Constants::MapID::None;
+        const auto current_map_info = GW::Map::GetMapInfo();
+        if (!current_map_info) return GW::Constants::MapID::None;
+        const auto found_continent = map_bounds_by_continent.find(current_map_info->continent);
+        if (found_continent == map_bounds_by_continent.end()) return GW::Constants::MapID::None;
+        const auto closest = found_continent->second.Nearest(world_map_point.x, world_map_point.y, [](const auto&, const GW::Constants::MapID map_id) {
+            const auto map_info = GW::Map::GetMapInfo(map_id);
+            if (!map_info || !map_info->thumbnail_id || !map_info->name_id || !(map_info->x || map_info->y)) return false;
+            if ((map_info->flags & 0x5000000) == 0x5000000) return false;   // e.g. "wrong" augury rock is map 119, no NPCs
+            if ((map_info->flags & 0x80000000) == 0x80000000) return false; // e.g. Debug map
+            return true;
+        });
+        return closest ? closest->second : GW::Constants::MapID::None;
     }
 
-    GW::MapProp* GetClosestPortalToLocation(const GW::Vec2f& game_pos)
+    // Travel portals among the current map's props; collected once per map load
+    std::vector<GW::MapProp*> travel_portal_props;
+
+    void CacheTravelPortalProps()
     {
-        GW::MapProp* found = nullptr;
-        float closest_distance = .9999f;
+        travel_portal_props.clear();
         const auto props = GW::Map::GetMapProps();
-        if (!props) return found;
+        if (!props) return;
         for (auto prop : *props) {
-            if (!IsTravelPortal(prop)) continue;
-            // TOOD: If found is null or this prop->location is closer than the found one, this wins
-            // Calculate the distance between the current portal and the given location
-            float distance = GW::GetDistance(prop->position, game_pos);
+            if (IsTravelPortal(prop)) {
+                travel_portal_props.push_back(prop);
+            }
+        }
+    }
 
-            // If found is null or this portal is closer than the currently found one, update found
+    GW::MapProp* GetClosestPortalToLocation(const GW::Vec2f& game_pos)
+    {
+        GW::MapProp* found = nullptr;
+        float closest_distance = .0f;
+        for (auto prop : travel_portal_props) {
+            const float distance = GW::GetDistance(prop->position, game_pos);
             if (!found || distance < closest_distance) {
                 found = prop;
                 closest_distance = distance;
@@ -433,26 +460,18 @@ namespace {
         info.map_id = map_context->map_id;
         info.continent = GW::Map::GetMapInfo(info.map_id)->continent;
 
-        std::vector<MapPortal> portals;
-        const auto props = GW::Map::GetMapProps();
-
-        if (!props) return;
-        for (auto prop : *props) {
-            if (IsTravelPortal(prop)) {
-                GW::Vec2f world_pos;
-                if (!WorldMapWidget::GamePosToWorldMap({prop->position.x, prop->position.y}, world_pos)) continue;
-                portals.push_back({world_pos, current_map_file_id, prop->prop_index});
-            }
-        }
-        for (auto& portal : portals) {
-            portal.checkForLinkedPortal(info.continent);
+        if (!GW::Map::GetMapProps()) return;
+        for (auto prop : travel_portal_props) {
+            GW::Vec2f world_pos;
+            if (!WorldMapWidget::GamePosToWorldMap({prop->position.x, prop->position.y}, world_pos)) continue;
+            info.portals.push_back({world_pos, current_map_file_id, prop->prop_index});
         }
 
         WorldMapWidget::GamePosToWorldMap(map_context->start_pos, info.world_pos_start);
         WorldMapWidget::GamePosToWorldMap(map_context->end_pos, info.world_pos_end);
-        info.portals = std::move(portals);
 
-        map_info_by_file_id[current_map_file_id] = info;
+        auto& stored = map_info_by_file_id[current_map_file_id] = std::move(info);
+        LinkPortals(stored);
     }
 
 
@@ -469,6 +488,7 @@ namespace {
                 if (packet->file_name && *packet->file_name) {
                     current_map_file_id = ArenaNetFileParser::FileHashToFileId(packet->file_name);
                 }
+                CacheTravelPortalProps();
                 AppendMapFileInfo();
                 QuestModule::FetchMissingQuestInfo();
             } break;
@@ -568,6 +588,16 @@ namespace {
         quest_icon_size = 24.0f * ui_scale.x;
         quest_icon_size_half = quest_icon_size / 2.f;
 
+        // World map area covered by the viewport, padded by the largest icon so markers straddling the edge still draw
+        const GW::Vec2f pixels_per_unit = {ui_scale.x * world_map_scale, ui_scale.y * world_map_scale};
+        if (pixels_per_unit.x <= 0.f || pixels_per_unit.y <= 0.f) return false;
+        constexpr float margin = 32.f;
+        const auto& top_left = world_map_context->top_left;
+        visible_world_rect = {
+            top_left.x - margin / pixels_per_unit.x, top_left.y - margin / pixels_per_unit.y,
+            top_left.x + (viewport->Size.x + margin) / pixels_per_unit.x, top_left.y + (viewport->Size.y + margin) / pixels_per_unit.y
+        };
+
         constexpr float FULL_ROTATION_TIME = 16.0f;
         const float elapsed_seconds = static_cast<float>(TIMER_INIT()) / CLOCKS_PER_SEC;
         quest_star_rotation_angle = 2.0f * (float)M_PI * fmod(elapsed_seconds, FULL_ROTATION_TIME) / FULL_ROTATION_TIME;
@@ -602,8 +632,156 @@ namespace {
 
     std::unordered_map<GW::Constants::MapID, uint32_t> locations_assigned_to_outposts;
 
-    bool DrawBossLocationOnWorldMap(const EliteBossLocation& boss)
+    // One icon per elite boss coordinate. Bosses the world map can't place are stacked in a row next to their outpost's icon;
+    // their slot in the row depends on which of them are shown, so it's assigned at draw time.
+    struct BossMarker {
+        const EliteBossLocation* boss = nullptr;
+        GW::Vec2f world_pos; // Outpost icon position if stacked
+        bool stacked = false;
+    };
+    std::vector<BossMarker> boss_markers; // In elite_boss_locations order
+    std::map<GW::Continent, StaticRTree<uint32_t>> boss_markers_by_continent; // Indexes into boss_markers
+    std::vector<uint32_t> visible_boss_markers;
+
+    // Returns true if the boss is stacked next to its outpost, in which case out is the outpost icon position
+    bool GetBossMarkerWorldPos(const EliteBossLocation& boss, const GW::AreaInfo* map_info, GW::Vec2f boss_pos, GW::Vec2f& out)
+    {
+        float elites_scale = default_scale;
+        GW::Vec2f* region_offset = nullptr;
+        switch (map_info->campaign) {
+            case GW::Constants::Campaign::Prophecies: {
+                switch (boss.region_id) {
+                    case 1: {
+                        region_offset = &crystal_desert_region;
+                    } break;
+                    case 2: {
+                        region_offset = &southern_shivers_start;
+                    } break;
+                    case 3: {
+                        region_offset = &ring_of_fire_region;
+                    } break;
+                    case 4: {
+                        region_offset = &post_searing_region;
+                    } break;
+                    case 5: {
+                        region_offset = &kryta_region;
+                    } break;
+                    case 7: {
+                        region_offset = &maguuma_region;
+                    } break;
+                }
+            } break;
+            case GW::Constants::Campaign::Factions: {
+                switch (boss.region_id) {
+                    case 1: {
+                        region_offset = &kaineng_city;
+                    } break;
+                    case 2: {
+                        region_offset = &echovald_forest;
+                    } break;
+                    case 3: {
+                        region_offset = &jade_sea;
+                    } break;
+                    case 4: {
+                        region_offset = &shing_jea_island;
+                    } break;
+                }
+            } break;
+            case GW::Constants::Campaign::Nightfall: {
+                switch (boss.region_id) {
+                    case 1: {
+                        region_offset = &istan;
+                    } break;
+                    case 2: {
+                        region_offset = &kourna;
+                    } break;
+                    case 3: {
+                        region_offset = &vabbi;
+                        elites_scale = 1.34f;
+                    } break;
+                    case 4: {
+                        region_offset = &desolation;
+                        elites_scale = 1.34f;
+                    } break;
+                    case 5: {
+                        // Domain of Anguish is where the devs just gave up trying to make the world map useful.
+                        out = {(float)map_info->x, (float)map_info->y};
+                        return true;
+                    }
+                }
+            } break;
+            case GW::Constants::Campaign::EyeOfTheNorth: {
+                elites_scale = 1.315f;
+                switch (boss.region_id) {
+                    case 1: {
+                        region_offset = &far_shiverpeaks;
+                    } break;
+                    case 2: {
+                        region_offset = &charr_homelands;
+                    } break;
+                    case 3: {
+                        region_offset = &tarnished_coast;
+                        if (boss.map_id == GW::Constants::MapID::Sparkfly_Swamp) {
+                            // MappingOut stitches the tarnished coast together, which means I had to manually place the sparkfly swamp elites myself. No need to offset or scale
+                            region_offset = nullptr;
+                            elites_scale = 1.f;
+                        }
+                    } break;
+                }
+            } break;
+        }
+        if (boss.region_id == 0xff) {
+            out = {(float)map_info->x, (float)map_info->y};
+            return true;
+        }
+
+        out = boss_pos * elites_scale;
+        if (region_offset) {
+            out += *region_offset;
+        }
+        return false;
+    }
+
+    void BuildBossMarkerIndex()
     {
+        boss_markers.clear();
+        std::unordered_map<GW::Constants::MapID, uint32_t> stacked_count;
+        for (const auto& boss : elite_boss_locations) {
+            const auto map_info = GW::Map::GetMapInfo(boss.map_id);
+            if (!map_info) continue;
+            for (const auto& coords : boss.coords) {
+                BossMarker marker{&boss};
+                marker.stacked = GetBossMarkerWorldPos(boss, map_info, coords, marker.world_pos);
+                if (marker.stacked) {
+                    stacked_count[boss.map_id]++;
+                }
+                boss_markers.push_back(marker);
+            }
+        }
+
+        std::map<GW::Continent, std::vector<StaticRTree<uint32_t>::Entry>> entries;
+        constexpr float max_icon_size = 32.f;
+        for (uint32_t i = 0; i < boss_markers.size(); i++) {
+            const auto& marker = boss_markers[i];
+            const auto& pos = marker.world_pos;
+            StaticRTree<uint32_t>::Box box = {pos.x, pos.y, pos.x, pos.y};
+            if (marker.stacked) {
+                // Cover every slot the row can use so the whole row is either drawn or culled, keeping slot assignment stable
+                const auto count = static_cast<float>(stacked_count[marker.boss->map_id]);
+                box.min_x = pos.x - max_icon_size * 2.f;
+                box.max_x = pos.x + max_icon_size * std::max(0.f, count - 3.f);
+            }
+            entries[GW::Map::GetMapInfo(marker.boss->map_id)->continent].push_back({box, i});
+        }
+        boss_markers_by_continent.clear();
+        for (auto& [continent, continent_entries] : entries) {
+            boss_markers_by_continent[continent].Build(std::move(continent_entries));
+        }
+    }
+
+    bool DrawBossLocationOnWorldMap(const BossMarker& marker)
+    {
+        const auto& boss = *marker.boss;
         if (!show_any_elite_capture_locations) return false;
         if (!(world_map_context)) return false;
         if (world_map_context->zoom != 1.f && world_map_context->zoom != .0f) return false; // Map is animating
@@ -637,120 +815,19 @@ namespace {
 
         if (!Resources::GetTextureSize(*texture, &skill_texture_size)) return false;
 
-        float icon_size = world_map_context->zoom == 1.f ? 32.f : 16.f;
+        const float icon_size = world_map_context->zoom == 1.f ? 32.f : 16.f;
         const auto half_size = icon_size / 2.f;
 
-        bool hovered = false;
-        float elites_scale = default_scale;
-        for (auto boss_pos : boss.coords) {
-            GW::Vec2f* region_offset = nullptr;
-            switch (map_info->campaign) {
-                case GW::Constants::Campaign::Prophecies: {
-                    switch (boss.region_id) {
-                        case 1: {
-                            region_offset = &crystal_desert_region;
-                        } break;
-                        case 2: {
-                            region_offset = &southern_shivers_start;
-                        } break;
-                        case 3: {
-                            region_offset = &ring_of_fire_region;
-                        } break;
-                        case 4: {
-                            region_offset = &post_searing_region;
-                        } break;
-                        case 5: {
-                            region_offset = &kryta_region;
-                        } break;
-                        case 7: {
-                            region_offset = &maguuma_region;
-                        } break;
-                    }
-                } break;
-                case GW::Constants::Campaign::Factions: {
-                    switch (boss.region_id) {
-                        case 1: {
-                            region_offset = &kaineng_city;
-                        } break;
-                        case 2: {
-                            region_offset = &echovald_forest;
-                        } break;
-                        case 3: {
-                            region_offset = &jade_sea;
-                        } break;
-                        case 4: {
-                            region_offset = &shing_jea_island;
-                        } break;
-                    }
-                } break;
-                case GW::Constants::Campaign::Nightfall: {
-                    switch (boss.region_id) {
-                        case 1: {
-                            region_offset = &istan;
-                        } break;
-                        case 2: {
-                            region_offset = &kourna;
-                        } break;
-                        case 3: {
-                            region_offset = &vabbi;
-                            elites_scale = 1.34f;
-                        } break;
-                        case 4: {
-                            region_offset = &desolation;
-                            elites_scale = 1.34f;
-                        } break;
-                        case 5: {
-                            // Domain of Anguish is where the devs just gave up trying to make the world map useful.
-                            boss_pos = GW::Vec2f((float)map_info->x - icon_size * 2.f, (float)map_info->y);
-                            locations_assigned_to_outposts[boss.map_id]++;
-                            boss_pos.x += icon_size * (locations_assigned_to_outposts[boss.map_id] - 1);
-                            elites_scale = 1.f;
-                        }
-                    }
-                } break;
-                case GW::Constants::Campaign::EyeOfTheNorth: {
-                    elites_scale = 1.315f;
-                    switch (boss.region_id) {
-                        case 1: {
-                            region_offset = &far_shiverpeaks;
-                        } break;
-                        case 2: {
-                            region_offset = &charr_homelands;
-                        } break;
-                        case 3: {
-                            region_offset = &tarnished_coast;
-                            if (boss.map_id == GW::Constants::MapID::Sparkfly_Swamp) {
-                                // MappingOut stitches the tarnished coast together, which means I had to manually place the sparkfly swamp elites myself. No need to offset or scale
-                                region_offset = nullptr;
-                                elites_scale = 1.f;
-                            }
-                        } break;
-                    }
-                } break;
-            }
-            if (boss.region_id == 0xff) {
-                boss_pos = GW::Vec2f((float)map_info->x - icon_size * 2.f, (float)map_info->y);
-                locations_assigned_to_outposts[boss.map_id]++;
-                boss_pos.x += icon_size * (locations_assigned_to_outposts[boss.map_id] - 1);
-                elites_scale = 1.f;
-            }
-
-            boss_pos *= elites_scale;
-            if (region_offset) {
-                boss_pos += *region_offset;
-            }
-
-
-            const auto viewport_quest_pos = CalculateViewportPos(boss_pos, world_map_context->top_left);
-
-
-            const ImRect icon_rect = {{viewport_quest_pos.x - half_size, viewport_quest_pos.y - half_size}, {viewport_quest_pos.x + half_size, viewport_quest_pos.y + half_size}};
-
-            ImGui::AddImageScaled(draw_list, *texture, icon_rect.Min, skill_texture_size, icon_size, icon_size);
-            hovered |= icon_rect.Contains(ImGui::GetMousePos());
+        auto boss_pos = marker.world_pos;
+        if (marker.stacked) {
+            boss_pos.x += icon_size * (static_cast<float>(++locations_assigned_to_outposts[boss.map_id]) - 3.f);
         }
 
-        return hovered;
+        const auto viewport_quest_pos = CalculateViewportPos(boss_pos, world_map_context->top_left);
+        const ImRect icon_rect = {{viewport_quest_pos.x - half_size, viewport_quest_pos.y - half_size}, {viewport_quest_pos.x + half_size, viewport_quest_pos.y + half_size}};
+
+        ImGui::AddImageScaled(draw_list, *texture, icon_rect.Min, skill_texture_size, icon_size, icon_size);
+        return icon_rect.Contains(ImGui::GetMousePos());
     }
 
     bool DrawQuestMarkerOnWorldMap(const GW::Quest* quest)
@@ -866,19 +943,22 @@ namespace {
 
 GW::Constants::MapID WorldMapWidget::GetMapIdForLocation(const GW::Vec2f& world_map_pos, GW::Constants::MapID exclude_map_id)
 {
-    auto map_id = GW::Map::GetMapID();
-    auto map_info = GW::Map::GetMapInfo();
+    const auto map_id = GW::Map::GetMapID();
+    const auto map_info = GW::Map::GetMapInfo();
     if (!map_info) return GW::Constants::MapID::None;
     const auto continent = map_info->continent;
     if (map_id != exclude_map_id && MapContainsWorldPos(map_id, world_map_pos, continent)) return map_id;
-    for (size_t i = 1; i < static_cast<size_t>(GW::Constants::MapID::Count); i++) {
-        map_id = static_cast<GW::Constants::MapID>(i);
-        if (map_id == exclude_map_id) continue;
-        map_info = GW::Map::GetMapInfo(map_id);
-        if (!(map_info && map_info->GetIsOnWorldMap())) continue;
-        if (MapContainsWorldPos(map_id, world_map_pos, continent)) return map_id;
-    }
-    return GW::Constants::MapID::None;
+    const auto found_continent = map_bounds_by_continent.find(continent);
+    if (found_continent == map_bounds_by_continent.end()) return GW::Constants::MapID::None;
+    // Lowest map id wins where maps overlap
+    auto found = GW::Constants::MapID::Count;
+    found_continent->second.QueryPoint(world_map_pos.x, world_map_pos.y, [&](const auto&, const GW::Constants::MapID candidate) {
+        if (candidate != exclude_map_id && candidate < found) {
+            found = candidate;
+        }
+        return true;
+    });
+    return found == GW::Constants::MapID::Count ? GW::Constants::MapID::None : found;
 }
 
 void WorldMapWidget::Initialize()
@@ -909,6 +989,9 @@ void WorldMapWidget::Initialize()
         GW::UI::RegisterUIMessageCallback(&OnUIMessage_HookEntry, ui_message, OnUIMessage, 0x8000);
     }
 
+    BuildMapBoundsIndex();
+    BuildBossMarkerIndex();
+    CacheTravelPortalProps();
     AppendMapFileInfo();
 }
 
@@ -1028,11 +1111,15 @@ void WorldMapWidget::LoadSettings(ToolboxIni* ini)
         }
         // Linked portals span across maps, so resolve them in a second pass
         // once the entire file has been loaded.
+        portals_by_position.clear();
         for (auto& [_, info] : map_info_by_file_id) {
             for (auto& portal : info.portals) {
-                portal.checkForLinkedPortal(info.continent);
+                portal.linked_portal_map_file_id = 0;
             }
         }
+        for (auto& [_, info] : map_info_by_file_id) {
+            LinkPortals(info);
+        }
     }
 }
 
@@ -1173,9 +1260,20 @@ void WorldMapWidget::Draw(IDirect3DDevice9*)
 
     hovered_boss = nullptr;
     locations_assigned_to_outposts.clear();
-    for (auto& boss : elite_boss_locations) {
-        if (DrawBossLocationOnWorldMap(boss)) {
-            hovered_boss = &boss;
+    visible_boss_markers.clear();
+    if (show_any_elite_capture_locations) {
+        if (const auto found = boss_markers_by_continent.find(world_map_context->continent); found != boss_markers_by_continent.end()) {
+            found->second.Query({visible_world_rect.Min.x, visible_world_rect.Min.y, visible_world_rect.Max.x, visible_world_rect.Max.y}, [](const auto&, const uint32_t index) {
+                visible_boss_markers.push_back(index);
+                return true;
+            });
+        }
+        // Table order, so stacked rows hand out their slots the same way every frame
+        std::ranges::sort(visible_boss_markers);
+    }
+    for (const auto index : visible_boss_markers) {
+        if (DrawBossLocationOnWorldMap(boss_markers[index])) {
+            hovered_boss = boss_markers[index].boss;
         }
     }
 
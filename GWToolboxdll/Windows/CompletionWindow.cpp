@@ -32,6 +32,7 @@
 #include <Color.h>
 #include <Modules/DialogModule.h>
 
+#include <Utils/CompletionMatrix.h>
 #include <Utils/ToolboxUtils.h>
 #include <Utils/TextUtils.h>
 
@@ -51,17 +52,6 @@ namespace {
         return (array[real_index] & flag) != 0;
     }
 
-    bool ArrayBoolAt(const std::vector<uint32_t>& array, const uint32_t index)
-    {
-        const uint32_t real_index = index / 32;
-        if (real_index >= array.size()) {
-            return false;
-        }
-        const uint32_t shift = index % 32;
-        const uint32_t flag = 1 << shift;
-        return (array[real_index] & flag) != 0;
-    }
-
     void ArrayBoolSet(std::vector<uint32_t>& array, const uint32_t index, const bool is_set = true)
     {
         const uint32_t real_index = index / 32;
@@ -285,6 +275,10 @@ namespace {
     };
 
     std::map<std::wstring, CharacterCompletion*> character_completion;
+    // The same unlocks as character_completion, for asking about every character at once. Bits are indexed the same way
+    // as in the character's arrays; heroes are indexed by hero id.
+    CompletionMatrix completion_matrix(std::to_underlying(CompletionType::FestivalHats) + 1);
+    std::vector<CharacterCompletion*> characters_by_matrix_row;
     GW::HookEntry OnPostUIMessage_Entry;
 
     std::map<Campaign, std::vector<OutpostUnlock*>> outposts;
@@ -320,6 +314,59 @@ namespace {
         return CompletionWindow::Instance();
     }
 
+    uint32_t Category(const CompletionType type)
+    {
+        return std::to_underlying(type);
+    }
+
+    std::vector<uint32_t>& GetCompletionArray(CharacterCompletion* cc, const CompletionType type)
+    {
+        switch (type) {
+            case CompletionType::Mission:
+                return cc->mission;
+            case CompletionType::MissionBonus:
+                return cc->mission_bonus;
+            case CompletionType::MissionHM:
+                return cc->mission_hm;
+            case CompletionType::MissionBonusHM:
+                return cc->mission_bonus_hm;
+            case CompletionType::Skills:
+                return cc->skills;
+            case CompletionType::Vanquishes:
+                return cc->vanquishes;
+            case CompletionType::Heroes:
+                return cc->heroes;
+            case CompletionType::MapsUnlocked:
+                return cc->maps_unlocked;
+            case CompletionType::MinipetsUnlocked:
+                return cc->minipets_unlocked;
+            case CompletionType::FestivalHats:
+                return cc->festival_hats;
+        }
+        ASSERT("Invalid CompletionType" && false);
+        return cc->mission;
+    }
+
+    void SetUnlocked(CharacterCompletion* cc, const CompletionType type, const uint32_t index)
+    {
+        ArrayBoolSet(GetCompletionArray(cc, type), index, true);
+        completion_matrix.Set(Category(type), cc->matrix_row, index);
+    }
+
+    void ClearUnlocked(CharacterCompletion* cc, const CompletionType type)
+    {
+        GetCompletionArray(cc, type).clear();
+        completion_matrix.ClearRow(Category(type), cc->matrix_row);
+    }
+
+    void DeleteCharacterCompletion(const std::map<std::wstring, CharacterCompletion*>::iterator& it)
+    {
+        completion_matrix.RemoveRow(it->second->matrix_row);
+        characters_by_matrix_row[it->second->matrix_row] = nullptr;
+        delete it->second;
+        character_completion.erase(it);
+    }
+
     HallOfMonumentsAchievements* GetCharacterHom(const std::wstring& player_name)
     {
         const auto cc = CompletionWindow::GetCharacterCompletion(player_name.c_str(), false);
@@ -338,14 +385,17 @@ namespace {
         static constexpr ctll::fixed_string displayed_miniatures = L"\x2\x102\x2([^\x102\x2]+)";
         std::wstring_view subject(dialog_body);
         std::wstring msg;
-        const auto cc = character_completion[GetPlayerName()];
-        auto& minipets_unlocked = cc->minipets_unlocked;
-        minipets_unlocked.clear();
+        const auto player_name = GetPlayerName();
+        if (!player_name) {
+            return;
+        }
+        const auto cc = CompletionWindow::GetCharacterCompletion(player_name, true);
+        ClearUnlocked(cc, CompletionType::MinipetsUnlocked);
         for (auto m : ctre::search_all<displayed_miniatures>(subject)) {
             std::wstring miniature_encoded_name = m.get<1>().to_string();
             for (size_t i = 0; i < _countof(encoded_minipet_names); i++) {
                 if (encoded_minipet_names[i] == miniature_encoded_name) {
-                    ArrayBoolSet(minipets_unlocked, i, true);
+                    SetUnlocked(cc, CompletionType::MinipetsUnlocked, i);
                     break;
                 }
             }
@@ -355,7 +405,7 @@ namespace {
             std::wstring miniature_encoded_name = m.get<1>().to_string();
             for (size_t i = 0; i < _countof(encoded_minipet_names); i++) {
                 if (encoded_minipet_names[i] == miniature_encoded_name) {
-                    ArrayBoolSet(minipets_unlocked, i, true);
+                    SetUnlocked(cc, CompletionType::MinipetsUnlocked, i);
                     break;
                 }
             }
@@ -374,12 +424,15 @@ namespace {
         }
 
         const auto& buttons = DialogModule::GetDialogButtons();
-        const auto cc = character_completion[GetPlayerName()];
-        auto& unlocked = cc->festival_hats;
+        const auto player_name = GetPlayerName();
+        if (!player_name) {
+            return;
+        }
+        const auto cc = CompletionWindow::GetCharacterCompletion(player_name, true);
         for (const auto btn : buttons) {
             for (size_t i = 0; i < _countof(encoded_festival_hat_names); i++) {
                 if (wcsstr(btn->message, encoded_festival_hat_names[i])) {
-                    ArrayBoolSet(unlocked, i, true);
+                    SetUnlocked(cc, CompletionType::FestivalHats, i);
                     break;
                 }
             }
@@ -402,14 +455,17 @@ namespace {
         }
         const std::wstring_view subject((*this_dialog_button)->message);
         std::wstring msg;
-        const auto cc = character_completion[GetPlayerName()];
-        auto& minipets_unlocked = cc->minipets_unlocked;
+        const auto player_name = GetPlayerName();
+        if (!player_name) {
+            return;
+        }
+        const auto cc = CompletionWindow::GetCharacterCompletion(player_name, true);
         static constexpr ctll::fixed_string miniature_displayed_regex = L"\x8102\x2B91\xDAA2\xD19F\x32DB\x10A([^\x1]+)";
         if (auto m = ctre::search<miniature_displayed_regex>(subject)) {
             const std::wstring miniature_encoded_name = m.get<1>().to_string();
             for (size_t i = 0; i < _countof(encoded_minipet_names); i++) {
                 if (encoded_minipet_names[i] == miniature_encoded_name) {
-                    ArrayBoolSet(minipets_unlocked, i, true);
+                    SetUnlocked(cc, CompletionType::MinipetsUnlocked, i);
                     Instance().CheckProgress();
                     break;
                 }
@@ -424,10 +480,9 @@ namespace {
         if (result->state != HallOfMonumentsAchievements::State::Done) {
             Log::LogW(L"Failed to load Hall of Monuments achievements for %s", result->character_name.c_str());
             if (result->error_str_from_request.contains("ErrCharacterNotFound")) {
-                auto found = character_completion.find(result->character_name);
+                const auto found = character_completion.find(result->character_name);
                 if (found != character_completion.end()) {
-                    delete found->second;
-                    character_completion.erase(found);
+                    DeleteCharacterCompletion(found);
                 }
             }
             return;
@@ -506,59 +561,33 @@ namespace {
             }
         }
         const auto this_character_completion = CompletionWindow::GetCharacterCompletion(character_name, true);
-        std::vector<uint32_t>* write_buf = nullptr;
-        switch (type) {
-            case CompletionType::Mission:
-                write_buf = &this_character_completion->mission;
-                break;
-            case CompletionType::MissionBonus:
-                write_buf = &this_character_completion->mission_bonus;
-                break;
-            case CompletionType::MissionHM:
-                write_buf = &this_character_completion->mission_hm;
-                break;
-            case CompletionType::MissionBonusHM:
-                write_buf = &this_character_completion->mission_bonus_hm;
-                break;
-            case CompletionType::Skills:
-                write_buf = &this_character_completion->skills;
-                break;
-            case CompletionType::Vanquishes:
-                write_buf = &this_character_completion->vanquishes;
-                break;
-            case CompletionType::Heroes: {
-                write_buf = &this_character_completion->heroes;
-                if (from_game) {
-                    // Writing from game memory, not from file
-                    std::vector<uint32_t>& write = *write_buf;
-                    const GW::HeroInfo* hero_arr = (GW::HeroInfo*)buffer;
-                    if (write.size() < len) {
-                        write.resize(len, 0);
-                    }
-                    for (size_t i = 0; i < len; i++) {
-                        write[i] = hero_arr[i].hero_id;
-                    }
-                    return true;
-                }
-            }
-            break;
-            case CompletionType::MapsUnlocked:
-                write_buf = &this_character_completion->maps_unlocked;
-                break;
-            case CompletionType::MinipetsUnlocked:
-                write_buf = &this_character_completion->minipets_unlocked;
-                break;
-            case CompletionType::FestivalHats:
-                write_buf = &this_character_completion->festival_hats;
-                break;
-            default: ASSERT("Invalid CompletionType" && false);
-        }
-        std::vector<uint32_t>& write = *write_buf;
+        const auto row = this_character_completion->matrix_row;
+        std::vector<uint32_t>& write = GetCompletionArray(this_character_completion, type);
         if (write.size() < len) {
             write.resize(len, 0);
         }
-        for (size_t i = 0; i < len; i++) {
-            write[i] |= buffer[i];
+        if (type == CompletionType::Heroes && from_game) {
+            // Writing from game memory, not from file
+            const GW::HeroInfo* hero_arr = (GW::HeroInfo*)buffer;
+            for (size_t i = 0; i < len; i++) {
+                write[i] = hero_arr[i].hero_id;
+            }
+        }
+        else {
+            for (size_t i = 0; i < len; i++) {
+                write[i] |= buffer[i];
+            }
+        }
+        if (type == CompletionType::Heroes) {
+            // Hero arrays are lists of hero ids rather than bits
+            for (const auto hero_id : write) {
+                if (hero_id) {
+                    completion_matrix.Set(Category(type), row, hero_id);
+                }
+            }
+        }
+        else {
+            completion_matrix.Merge(Category(type), row, {buffer, len});
         }
         return true;
     }
@@ -605,8 +634,7 @@ namespace {
                         return character.player_name == char_name;
                     });
                     if (exists == chars->end()) {
-                        delete it->second;
-                        character_completion.erase(it);
+                        DeleteCharacterCompletion(it);
                         it = character_completion.begin();
                         continue;
                     }
@@ -686,38 +714,114 @@ namespace {
         return true;
     }
 
-    bool IsAreaComplete(const wchar_t* player_name, const MapID map_id, CompletionCheck check, const GW::AreaInfo* map)
+    // Completion categories the map's bit has to be set in for the area to count as complete. False if the area is
+    // always complete.
+    bool GetAreaCompletionCategories(const MapID map_id, const CompletionCheck check, const GW::AreaInfo* map, std::vector<uint32_t>& categories)
     {
+        categories.clear();
         if (map_id == MapID::None)
-            return true;
+            return false;
         if (map_id == MapID::Tomb_of_the_Primeval_Kings)
-            return true; // Topk special case
-        const auto completion = CompletionWindow::GetCharacterCompletion(player_name, false);
-        if (!(map && completion)) return false;
+            return false; // Topk special case
 
         switch (map->type) {
             case GW::RegionType::EliteMission:
-                return true;
+                return false;
             case GW::RegionType::ExplorableZone:
                 if (map->continent == GW::Continent::BattleIsles)
-                    return true; // Fow, Uw
-                return !map->GetIsOnWorldMap() || ArrayBoolAt(completion->vanquishes, static_cast<uint32_t>(map_id));
+                    return false; // Fow, Uw
+                if (!map->GetIsOnWorldMap())
+                    return false;
+                categories.push_back(Category(CompletionType::Vanquishes));
+                return true;
         }
 
-        if ((check & NormalMode) && !ArrayBoolAt(completion->mission, static_cast<uint32_t>(map_id)))
-            return false;
-        if ((check & HardMode) && !ArrayBoolAt(completion->mission_hm, static_cast<uint32_t>(map_id)))
-            return false;
         const bool has_bonus = map->campaign != Campaign::EyeOfTheNorth;
-        if (has_bonus) {
-            if ((check & NormalMode) && !ArrayBoolAt(completion->mission_bonus, static_cast<uint32_t>(map_id)))
-                return false;
-            if ((check & HardMode) && !ArrayBoolAt(completion->mission_bonus_hm, static_cast<uint32_t>(map_id)))
-                return false;
+        if (check & NormalMode) {
+            categories.push_back(Category(CompletionType::Mission));
+            if (has_bonus)
+                categories.push_back(Category(CompletionType::MissionBonus));
+        }
+        if (check & HardMode) {
+            categories.push_back(Category(CompletionType::MissionHM));
+            if (has_bonus)
+                categories.push_back(Category(CompletionType::MissionBonusHM));
         }
         return true;
     }
 
+    bool IsAreaComplete(const wchar_t* player_name, const MapID map_id, CompletionCheck check, const GW::AreaInfo* map)
+    {
+        if (map_id == MapID::None || map_id == MapID::Tomb_of_the_Primeval_Kings)
+            return true;
+        const auto completion = CompletionWindow::GetCharacterCompletion(player_name, false);
+        if (!(map && completion)) return false;
+
+        std::vector<uint32_t> categories;
+        if (!GetAreaCompletionCategories(map_id, check, map, categories))
+            return true;
+        return std::ranges::all_of(categories, [&](const uint32_t category) {
+            return completion_matrix.Get(category, completion->matrix_row, std::to_underlying(map_id));
+        });
+    }
+
+    // Characters that the "characters who haven't..." lists and account-wide totals cover
+    CompletionMatrix::RowMask GetListedCharacters()
+    {
+        auto mask = completion_matrix.MakeMask();
+        const auto account_id = GetCurrentAccountId();
+        for (const auto cc : character_completion | std::views::values) {
+            if (cc->is_pvp || cc->is_pre_searing)
+                continue;
+            if (only_show_account_chars && !account_id.empty() && cc->account != account_id)
+                continue;
+            CompletionMatrix::SetRow(mask, cc->matrix_row);
+        }
+        return mask;
+    }
+
+    std::vector<CharacterCompletion*> GetCharactersInMask(const CompletionMatrix::RowMask& mask)
+    {
+        std::vector<CharacterCompletion*> out;
+        for (uint32_t row = 0; row < characters_by_matrix_row.size(); row++) {
+            if (characters_by_matrix_row[row] && CompletionMatrix::HasRow(mask, row))
+                out.push_back(characters_by_matrix_row[row]);
+        }
+        std::ranges::sort(out, [](CharacterCompletion* a, CharacterCompletion* b) {
+            return a->name_str.compare(b->name_str) < 0;
+        });
+        return out;
+    }
+
+    std::vector<CharacterCompletion*> GetCharactersWithout(const std::vector<uint32_t>& categories, const uint32_t column)
+    {
+        const auto among = GetListedCharacters();
+        auto missing = completion_matrix.MakeMask();
+        completion_matrix.RowsWithout(categories, column, among, missing);
+        return GetCharactersInMask(missing);
+    }
+
+    // Tooltip for the last item with how far every listed character has got through items, where an item counts as
+    // done for a character once its column is set in each of the categories
+    template <typename T, typename ColumnFn>
+    void AccountProgressTooltip(const std::vector<uint32_t>& categories, const std::vector<T*>& items, ColumnFn column_of)
+    {
+        if (!ImGui::IsItemHovered())
+            return;
+        const auto among = GetListedCharacters();
+        const auto characters = CompletionMatrix::CountRows(among);
+        const auto total = characters * items.size();
+        if (!total)
+            return;
+        std::vector<uint32_t> columns;
+        columns.reserve(items.size());
+        for (const auto item : items) {
+            columns.push_back(static_cast<uint32_t>(column_of(item)));
+        }
+        const auto done = completion_matrix.Count(categories, columns, among);
+        ImGui::SetTooltip("All characters: %zu of %zu - %.0f%%\nAcross %zu characters", done, total, static_cast<float>(done) / static_cast<float>(total) * 100.f, characters);
+    }
+
     void OnMapLoaded()
     {
         if (GW::Map::GetInstanceType() == InstanceType::Loading)
@@ -922,11 +1026,12 @@ void Mission::OnHover()
             ImGui::TextUnformatted("Characters who have not completed this area:");
             auto icon_size = ImGui::CalcTextSize(" ");
             icon_size.x = icon_size.y;
-            const auto map = GW::Map::GetMapInfo(outpost);
+            const auto chars_without_nm = CompletionWindow::GetCharactersWithoutAreaComplete(outpost, CompletionCheck::NormalMode);
+            const auto chars_without_hm = CompletionWindow::GetCharactersWithoutAreaComplete(outpost, CompletionCheck::HardMode);
             for (auto char_completion : chars_without_completed) {
                 ImGui::Image(*Resources::GetProfessionIcon(char_completion->profession), icon_size);
-                bool is_hm_complete = ::IsAreaComplete(TextUtils::StringToWString(char_completion->name_str).c_str(), outpost, CompletionCheck::HardMode, map);
-                bool is_nm_complete = ::IsAreaComplete(TextUtils::StringToWString(char_completion->name_str).c_str(), outpost, CompletionCheck::NormalMode, map);
+                const bool is_hm_complete = !std::ranges::contains(chars_without_hm, char_completion);
+                const bool is_nm_complete = !std::ranges::contains(chars_without_nm, char_completion);
                 ImGui::SameLine();
                 ImGui::Text("%s (%s)", char_completion->name_str.c_str(), TextUtils::Join({is_nm_complete ? "" : "NM", is_hm_complete ? "" : "HM"}, ",").c_str());
             }
@@ -934,23 +1039,22 @@ void Mission::OnHover()
     });
 }
 
-void Mission::CheckProgress(const std::wstring& player_name)
+void Mission::CheckProgress(const CharacterCompletion* cc)
 {
     is_completed = bonus = false;
-    const auto& completion = character_completion;
-    if (!completion.contains(player_name)) {
+    if (!cc) {
         return;
     }
-    const auto& player_completion = completion.at(player_name);
-    const std::vector<uint32_t>* missions_complete = &player_completion->mission;
-    const std::vector<uint32_t>* missions_bonus = &player_completion->mission_bonus;
+    const std::vector<uint32_t>* missions_complete = &cc->mission;
+    const std::vector<uint32_t>* missions_bonus = &cc->mission_bonus;
     if (hard_mode) {
-        missions_complete = &player_completion->mission_hm;
-        missions_bonus = &player_completion->mission_bonus_hm;
+        missions_complete = &cc->mission_hm;
+        missions_bonus = &cc->mission_bonus_hm;
     }
-    map_unlocked = player_completion->maps_unlocked.empty() || ArrayBoolAt(player_completion->maps_unlocked, std::to_underlying(outpost));
-    is_completed = ArrayBoolAt(*missions_complete, std::to_underlying(outpost));
-    bonus = ArrayBoolAt(*missions_bonus, std::to_underlying(outpost));
+    const auto column = std::to_underlying(outpost);
+    map_unlocked = cc->maps_unlocked.empty() || completion_matrix.Get(Category(CompletionType::MapsUnlocked), cc->matrix_row, column);
+    is_completed = completion_matrix.Get(Category(hard_mode ? CompletionType::MissionHM : CompletionType::Mission), cc->matrix_row, column);
+    bonus = completion_matrix.Get(Category(hard_mode ? CompletionType::MissionBonusHM : CompletionType::MissionBonus), cc->matrix_row, column);
 
     GW::Array<uint32_t> complete_arr;
     complete_arr.m_buffer = const_cast<uint32_t*>(missions_complete->data());
@@ -965,14 +1069,12 @@ void Mission::CheckProgress(const std::wstring& player_name)
     GetOutpostIcons(outpost, icons, mission_state, hard_mode);
 }
 
-void OutpostUnlock::CheckProgress(const std::wstring& player_name)
+void OutpostUnlock::CheckProgress(const CharacterCompletion* cc)
 {
-    const auto& completion = character_completion;
-    if (!completion.contains(player_name)) {
+    if (!cc) {
         return;
     }
-    const auto& player_completion = completion.at(player_name);
-    is_completed = bonus = map_unlocked = ArrayBoolAt(player_completion->maps_unlocked, std::to_underlying(outpost));
+    is_completed = bonus = map_unlocked = completion_matrix.Get(Category(CompletionType::MapsUnlocked), cc->matrix_row, std::to_underlying(outpost));
 
     GetOutpostIcons(outpost, icons, 0);
 }
@@ -1024,9 +1126,9 @@ bool EotNMission::HasQuest()
 }
 
 
-void EotNMission::CheckProgress(const std::wstring& player_name)
+void EotNMission::CheckProgress(const CharacterCompletion* cc)
 {
-    Mission::CheckProgress(player_name);
+    Mission::CheckProgress(cc);
     bonus = is_completed;
     // EotN mission icons are sprited - first sprite for incomplete, second for complete
     if (is_completed) {
@@ -1045,15 +1147,13 @@ HeroUnlock::HeroUnlock(HeroID _hero_id)
     skill_id = static_cast<SkillID>(_hero_id);
 }
 
-void HeroUnlock::CheckProgress(const std::wstring& player_name)
+void HeroUnlock::CheckProgress(const CharacterCompletion* cc)
 {
     is_completed = false;
-    const auto& skills = character_completion;
-    if (!skills.contains(player_name)) {
+    if (!cc) {
         return;
     }
-    auto& heroes = skills.at(player_name)->heroes;
-    is_completed = bonus = std::ranges::contains(heroes, std::to_underlying(skill_id));
+    is_completed = bonus = completion_matrix.Get(Category(CompletionType::Heroes), cc->matrix_row, std::to_underlying(skill_id));
 }
 
 const char* HeroUnlock::Name()
@@ -1216,15 +1316,13 @@ bool PvESkill::Draw(IDirect3DDevice9* device)
     return true;
 }
 
-void PvESkill::CheckProgress(const std::wstring& player_name)
+void PvESkill::CheckProgress(const CharacterCompletion* cc)
 {
     is_completed = false;
-    const auto& skills = character_completion;
-    if (!skills.contains(player_name)) {
+    if (!cc) {
         return;
     }
-    const auto& unlocked = skills.at(player_name)->skills;
-    is_completed = bonus = ArrayBoolAt(unlocked, std::to_underlying(skill_id));
+    is_completed = bonus = completion_matrix.Get(Category(CompletionType::Skills), cc->matrix_row, std::to_underlying(skill_id));
 }
 
 FactionsPvESkill::FactionsPvESkill(const SkillID skill_id)
@@ -1256,15 +1354,13 @@ bool FactionsPvESkill::Draw(IDirect3DDevice9* device)
     return drawn;
 }
 
-void Vanquish::CheckProgress(const std::wstring& player_name)
+void Vanquish::CheckProgress(const CharacterCompletion* cc)
 {
     is_completed = false;
-    const auto& completion = character_completion;
-    if (!completion.contains(player_name)) {
+    if (!cc) {
         return;
     }
-    const auto& unlocked = completion.at(player_name)->vanquishes;
-    is_completed = bonus = ArrayBoolAt(unlocked, std::to_underlying(outpost));
+    is_completed = bonus = completion_matrix.Get(Category(CompletionType::Vanquishes), cc->matrix_row, std::to_underlying(outpost));
     mission_state = is_completed ? 0x7 : 0x0;
 
     GetOutpostIcons(outpost, icons, mission_state, true);
@@ -2139,6 +2235,8 @@ void CompletionWindow::Terminate()
         delete camp.second;
     }
     character_completion.clear();
+    completion_matrix.Clear();
+    characters_by_matrix_row.clear();
 }
 
 void CompletionWindow::Draw(IDirect3DDevice9* device)
@@ -2309,7 +2407,9 @@ void CompletionWindow::Draw(IDirect3DDevice9* device)
         char label[128];
         snprintf(label, _countof(label), "%s (%d of %d unlocked) - %.0f%%###campaign_outposts_%d",
                  CampaignName(campaign), completed, unlockable_outposts.size(), static_cast<float>(completed) / static_cast<float>(unlockable_outposts.size()) * 100.f, campaign);
-        if (ImGui::CollapsingHeader(label)) {
+        const bool is_open = ImGui::CollapsingHeader(label);
+        AccountProgressTooltip({Category(CompletionType::MapsUnlocked)}, unlockable_outposts, [](const Mission* m) { return m->GetOutpost(); });
+        if (is_open) {
             draw_missions(filtered);
         }
     }
@@ -2336,7 +2436,15 @@ void CompletionWindow::Draw(IDirect3DDevice9* device)
         }
         char label[128];
         snprintf(label, _countof(label), "%s (%d of %d completed) - %.0f%%###campaign_missions_%d", CampaignName(camp.first), completed, camp_missions.size(), static_cast<float>(completed) / static_cast<float>(camp_missions.size()) * 100.f, camp.first);
-        if (ImGui::CollapsingHeader(label)) {
+        const bool is_open = ImGui::CollapsingHeader(label);
+        // EotN missions and dungeons have no bonus
+        const bool has_bonus = camp.first != Campaign::EyeOfTheNorth && camp.first != Campaign::BonusMissionPack;
+        std::vector<uint32_t> categories = {Category(hard_mode ? CompletionType::MissionHM : CompletionType::Mission)};
+        if (has_bonus) {
+            categories.push_back(Category(hard_mode ? CompletionType::MissionBonusHM : CompletionType::MissionBonus));
+        }
+        AccountProgressTooltip(categories, camp_missions, [](const Mission* m) { return m->GetOutpost(); });
+        if (is_open) {
             draw_missions(filtered);
         }
     }
@@ -2367,7 +2475,9 @@ void CompletionWindow::Draw(IDirect3DDevice9* device)
         char label[128];
         snprintf(label, _countof(label), "%s (%d of %d completed) - %.0f%%###campaign_vanquishes_%d", CampaignName(camp.first), completed, camp_missions.size(), static_cast<float>(completed) / static_cast<float>(camp_missions.size()) * 100.f,
                  camp.first);
-        if (ImGui::CollapsingHeader(label)) {
+        const bool is_open = ImGui::CollapsingHeader(label);
+        AccountProgressTooltip({Category(CompletionType::Vanquishes)}, camp_missions, [](const Mission* m) { return m->GetOutpost(); });
+        if (is_open) {
             draw_missions(filtered);
         }
     }
@@ -2409,7 +2519,9 @@ void CompletionWindow::Draw(IDirect3DDevice9* device)
         }
         char label[128];
         snprintf(label, _countof(label), "%s (%d of %d completed) - %.0f%%###campaign_eskills_%d", CampaignName(camp.first), completed, camp_missions.size(), static_cast<float>(completed) / static_cast<float>(camp_missions.size()) * 100.f, camp.first);
-        if (ImGui::CollapsingHeader(label)) {
+        const bool is_open = ImGui::CollapsingHeader(label);
+        AccountProgressTooltip({Category(CompletionType::Skills)}, camp_missions, [](const PvESkill* skill) { return skill->GetSkillId(); });
+        if (is_open) {
             draw_missions(filtered);
         }
     }
@@ -2432,7 +2544,9 @@ void CompletionWindow::Draw(IDirect3DDevice9* device)
         }
         char label[128];
         snprintf(label, _countof(label), "%s (%d of %d completed) - %.0f%%###campaign_skills_%d", CampaignName(camp.first), completed, camp_missions.size(), static_cast<float>(completed) / static_cast<float>(camp_missions.size()) * 100.f, camp.first);
-        if (ImGui::CollapsingHeader(label)) {
+        const bool is_open = ImGui::CollapsingHeader(label);
+        AccountProgressTooltip({Category(CompletionType::Skills)}, camp_missions, [](const PvESkill* skill) { return skill->GetSkillId(); });
+        if (is_open) {
             draw_missions(filtered);
         }
     }
@@ -2447,7 +2561,9 @@ void CompletionWindow::Draw(IDirect3DDevice9* device)
         }
         char label[128];
         snprintf(label, _countof(label), "%s (%d of %d completed) - %.0f%%###campaign_heros_%d", CampaignName(camp.first), completed, camp_missions.size(), static_cast<float>(completed) / static_cast<float>(camp_missions.size()) * 100.f, camp.first);
-        if (ImGui::CollapsingHeader(label)) {
+        const bool is_open = ImGui::CollapsingHeader(label);
+        AccountProgressTooltip({Category(CompletionType::Heroes)}, camp_missions, [](const HeroUnlock* hero) { return hero->GetSkillId(); });
+        if (is_open) {
             draw_missions(camp_missions);
         }
     }
@@ -2890,58 +3006,61 @@ void CompletionWindow::LoadSettings(ToolboxIni* ini)
 
 CompletionWindow* CompletionWindow::CheckProgress(const bool fetch_hom)
 {
+    // Looked up once here; every item then reads its bits from the matrix by the character's row
+    const auto found = character_completion.find(chosen_player_name);
+    const CharacterCompletion* chosen = found != character_completion.end() ? found->second : nullptr;
     for (auto& skills : pve_skills | std::views::values) {
         for (const auto& skill : skills) {
-            skill->CheckProgress(chosen_player_name);
+            skill->CheckProgress(chosen);
         }
     }
     for (auto& skills : elite_skills | std::views::values) {
         for (const auto& skill : skills) {
-            skill->CheckProgress(chosen_player_name);
+            skill->CheckProgress(chosen);
         }
     }
     for (auto& skills : outposts | std::views::values) {
         for (const auto& skill : skills) {
-            skill->CheckProgress(chosen_player_name);
+            skill->CheckProgress(chosen);
         }
     }
     for (auto& completed_missions : missions | std::views::values) {
         for (const auto& mission : completed_missions) {
-            mission->CheckProgress(chosen_player_name);
+            mission->CheckProgress(chosen);
         }
     }
     for (auto& completed_missions : vanquishes | std::views::values) {
         for (const auto& mission : completed_missions) {
-            mission->CheckProgress(chosen_player_name);
+            mission->CheckProgress(chosen);
         }
     }
     for (auto& unlocks : heros | std::views::values) {
         for (const auto& unlock : unlocks) {
-            unlock->CheckProgress(chosen_player_name);
+            unlock->CheckProgress(chosen);
         }
     }
     for (auto& items : unlocked_pvp_items | std::views::values) {
         for (const auto& item : items) {
-            item->CheckProgress(chosen_player_name);
+            item->CheckProgress(chosen);
         }
     }
     for (const auto achievement : festival_hats) {
-        achievement->CheckProgress(chosen_player_name);
+        achievement->CheckProgress(chosen);
     }
     for (const auto achievement : minipets) {
-        achievement->CheckProgress(chosen_player_name);
+        achievement->CheckProgress(chosen);
     }
     for (const auto achievement : hom_weapons) {
-        achievement->CheckProgress(chosen_player_name);
+        achievement->CheckProgress(chosen);
     }
     for (const auto achievement : hom_armor) {
-        achievement->CheckProgress(chosen_player_name);
+        achievement->CheckProgress(chosen);
     }
     for (const auto achievement : hom_companions) {
-        achievement->CheckProgress(chosen_player_name);
+        achievement->CheckProgress(chosen);
     }
     for (const auto achievement : hom_titles) {
-        achievement->CheckProgress(chosen_player_name);
+        achievement->CheckProgress(chosen);
     }
     if (fetch_hom) {
         const auto cc = GetCharacterCompletion(chosen_player_name.c_str(), true);
@@ -3013,6 +3132,11 @@ CharacterCompletion* CompletionWindow::GetCharacterCompletion(const wchar_t* cha
         this_character_completion = new CharacterCompletion();
         this_character_completion->name_str = TextUtils::WStringToString(character_name);
         this_character_completion->hom_achievements.character_name = character_name;
+        this_character_completion->matrix_row = completion_matrix.AddRow();
+        if (characters_by_matrix_row.size() <= this_character_completion->matrix_row) {
+            characters_by_matrix_row.resize(this_character_completion->matrix_row + 1);
+        }
+        characters_by_matrix_row[this_character_completion->matrix_row] = this_character_completion;
         character_completion[character_name] = this_character_completion;
         FetchHom(&this_character_completion->hom_achievements);
     }
@@ -3063,92 +3187,57 @@ bool CompletionWindow::IsAreaUnlocked(const wchar_t* player_name, const MapID ma
     const auto completion = GetCharacterCompletion(player_name, false);
     const auto map = completion ? GW::Map::GetMapInfo(map_id) : nullptr;
     if (!(map && completion)) return false;
-    return ArrayBoolAt(completion->maps_unlocked, static_cast<uint32_t>(map_id));
+    return completion_matrix.Get(Category(CompletionType::MapsUnlocked), completion->matrix_row, static_cast<uint32_t>(map_id));
 }
 
 bool CompletionWindow::IsSkillUnlocked(const wchar_t* player_name, const SkillID skill_id)
 {
     const auto completion = GetCharacterCompletion(player_name, false);
-    return completion && ArrayBoolAt(completion->skills, static_cast<uint32_t>(skill_id));
+    return completion && completion_matrix.Get(Category(CompletionType::Skills), completion->matrix_row, static_cast<uint32_t>(skill_id));
 }
 
 std::vector<CharacterCompletion*> CompletionWindow::GetCharactersWithoutAreaComplete(MapID map_id, CompletionCheck check)
 {
-    std::vector<CharacterCompletion*> out;
     if (map_id == MapID::None)
-        return out;
+        return {};
     const auto info = GW::Map::GetMapInfo(map_id);
-    const auto account_id = GetCurrentAccountId();
-    for (auto& it : character_completion) {
-        if (it.second->is_pvp || it.second->is_pre_searing)
-            continue;
-        if (only_show_account_chars && !account_id.empty() && it.second->account != account_id)
-            continue;
-        if (!::IsAreaComplete(it.first.c_str(), map_id, check, info))
-            out.push_back(it.second);
-    }
-    std::ranges::sort(out, [](CharacterCompletion* a, CharacterCompletion* b) {
-        return a->name_str.compare(b->name_str) < 0;
-    });
-    return out;
+    if (!info)
+        return GetCharactersInMask(GetListedCharacters());
+    std::vector<uint32_t> categories;
+    if (!GetAreaCompletionCategories(map_id, check, info, categories))
+        return {};
+    return GetCharactersWithout(categories, std::to_underlying(map_id));
 }
 
 std::vector<CharacterCompletion*> CompletionWindow::GetCharactersWithoutAreaUnlocked(MapID map_id)
 {
-    std::vector<CharacterCompletion*> out;
-    const auto account_id = GetCurrentAccountId();
-    for (auto& it : character_completion) {
-        if (it.second->is_pvp || it.second->is_pre_searing)
-            continue;
-        if (only_show_account_chars && !account_id.empty() && it.second->account != account_id)
-            continue;
-        if (!IsAreaUnlocked(it.first.c_str(), map_id))
-            out.push_back(it.second);
-    }
-    std::ranges::sort(out, [](CharacterCompletion* a, CharacterCompletion* b) {
-        return a->name_str.compare(b->name_str) < 0;
-    });
-    return out;
+    if (!GW::Map::GetMapInfo(map_id))
+        return GetCharactersInMask(GetListedCharacters());
+    return GetCharactersWithout({Category(CompletionType::MapsUnlocked)}, std::to_underlying(map_id));
 }
 
 std::vector<CharacterCompletion*> CompletionWindow::GetCharactersWithoutSkillUnlocked(SkillID skill_id)
 {
-    std::vector<CharacterCompletion*> out;
-    const auto account_id = GetCurrentAccountId();
-    for (auto& it : character_completion) {
-        if (it.second->is_pvp || it.second->is_pre_searing)
-            continue;
-        if (only_show_account_chars && !account_id.empty() && it.second->account != account_id)
-            continue;
-        if (!IsSkillUnlocked(it.first.c_str(), skill_id))
-            out.push_back(it.second);
-    }
-    std::ranges::sort(out, [](CharacterCompletion* a, CharacterCompletion* b) {
-        return a->name_str.compare(b->name_str) < 0;
-    });
-    return out;
+    return GetCharactersWithout({Category(CompletionType::Skills)}, std::to_underlying(skill_id));
 }
 
 
-void MinipetAchievement::CheckProgress(const std::wstring& player_name)
+void MinipetAchievement::CheckProgress(const CharacterCompletion* cc)
 {
     is_completed = false;
-    const auto& cc = character_completion;
-    if (!cc.contains(player_name)) {
+    if (!cc) {
         return;
     }
-    const std::vector<uint32_t>& minipets_unlocked = cc.at(player_name)->minipets_unlocked;
-    is_completed = bonus = ArrayBoolAt(minipets_unlocked, encoded_name_index);
+    is_completed = bonus = completion_matrix.Get(Category(CompletionType::MinipetsUnlocked), cc->matrix_row, encoded_name_index);
 }
 
-void WeaponAchievement::CheckProgress(const std::wstring& player_name)
+void WeaponAchievement::CheckProgress(const CharacterCompletion* cc)
 {
     is_completed = false;
-    const auto& cc = character_completion;
-    if (!cc.contains(player_name)) {
+    if (!cc) {
         return;
     }
-    const auto& hom = cc.at(player_name)->hom_achievements;
+    const auto& hom = cc->hom_achievements;
     if (hom.state != HallOfMonumentsAchievements::State::Done) {
         return;
     }
@@ -3165,14 +3254,13 @@ size_t AchieventWithWikiFile::GetLoadedIcons(IDirect3DTexture9* icons_out[4])
     return Mission::GetLoadedIcons(icons_out);
 }
 
-void ArmorAchievement::CheckProgress(const std::wstring& player_name)
+void ArmorAchievement::CheckProgress(const CharacterCompletion* cc)
 {
     is_completed = false;
-    const auto& cc = character_completion;
-    if (!cc.contains(player_name)) {
+    if (!cc) {
         return;
     }
-    const auto& hom = cc.at(player_name)->hom_achievements;
+    const auto& hom = cc->hom_achievements;
     if (hom.state != HallOfMonumentsAchievements::State::Done) {
         return;
     }
@@ -3180,14 +3268,13 @@ void ArmorAchievement::CheckProgress(const std::wstring& player_name)
     is_completed = bonus = unlocked[encoded_name_index] != 0;
 }
 
-void CompanionAchievement::CheckProgress(const std::wstring& player_name)
+void CompanionAchievement::CheckProgress(const CharacterCompletion* cc)
 {
     is_completed = false;
-    const auto& cc = character_completion;
-    if (!cc.contains(player_name)) {
+    if (!cc) {
         return;
     }
-    const auto& hom = cc.at(player_name)->hom_achievements;
+    const auto& hom = cc->hom_achievements;
     if (hom.state != HallOfMonumentsAchievements::State::Done) {
         return;
     }
@@ -3195,14 +3282,13 @@ void CompanionAchievement::CheckProgress(const std::wstring& player_name)
     is_completed = bonus = unlocked[encoded_name_index] != 0;
 }
 
-void HonorAchievement::CheckProgress(const std::wstring& player_name)
+void HonorAchievement::CheckProgress(const CharacterCompletion* cc)
 {
     is_completed = false;
-    const auto& cc = character_completion;
-    if (!cc.contains(player_name)) {
+    if (!cc) {
         return;
     }
-    const auto& hom = cc.at(player_name)->hom_achievements;
+    const auto& hom = cc->hom_achievements;
     if (hom.state != HallOfMonumentsAchievements::State::Done) {
         return;
     }
@@ -3210,15 +3296,13 @@ void HonorAchievement::CheckProgress(const std::wstring& player_name)
     is_completed = bonus = unlocked[encoded_name_index] != 0;
 }
 
-void FestivalHat::CheckProgress(const std::wstring& player_name)
+void FestivalHat::CheckProgress(const CharacterCompletion* cc)
 {
     is_completed = false;
-    const auto& cc = character_completion;
-    if (!cc.contains(player_name)) {
+    if (!cc) {
         return;
     }
-    const std::vector<uint32_t>& unlocked = cc.at(player_name)->festival_hats;
-    is_completed = bonus = ArrayBoolAt(unlocked, encoded_name_index);
+    is_completed = bonus = completion_matrix.Get(Category(CompletionType::FestivalHats), cc->matrix_row, encoded_name_index);
 }
 
 size_t UnlockedPvPItemUpgrade::GetLoadedIcons(IDirect3DTexture9* icons_out[4])
@@ -3236,7 +3320,7 @@ size_t UnlockedPvPItemUpgrade::GetLoadedIcons(IDirect3DTexture9* icons_out[4])
     return Mission::GetLoadedIcons(icons_out);
 }
 
-void UnlockedPvPItemUpgrade::CheckProgress(const std::wstring&)
+void UnlockedPvPItemUpgrade::CheckProgress(const CharacterCompletion*)
 {
     const auto acc = GW::GetAccountContext();
     is_completed = false;
@@ -7,6 +7,8 @@
 #include <Color.h>
 #include <Utils/GuiUtils.h>
 
+struct CharacterCompletion;
+
 namespace Missions {
 
     class Mission {
@@ -48,13 +50,13 @@ namespace Missions {
         virtual void OnHover();
         virtual bool IsDaily();  // True if this mission is ZM or ZB today
         virtual bool HasQuest(); // True if the ZM or ZB is in quest log
-        virtual void CheckProgress(const std::wstring& player_name);
+        virtual void CheckProgress(const CharacterCompletion* cc);
     };
 
     class OutpostUnlock : public Mission {
     public:
         OutpostUnlock(GW::Constants::MapID map_id) : Mission(map_id) {};
-        void CheckProgress(const std::wstring& player_name) override;
+        void CheckProgress(const CharacterCompletion* cc) override;
         bool Draw(IDirect3DDevice9*) override;
         void OnHover() override;
     };
@@ -66,6 +68,7 @@ namespace Missions {
     public:
         GW::Constants::ProfessionByte profession = (GW::Constants::ProfessionByte)0;
         PvESkill(GW::Constants::SkillID _skill_id);
+        [[nodiscard]] GW::Constants::SkillID GetSkillId() const { return skill_id; }
         bool IsDaily() override { return false; }
         bool HasQuest() override { return false; }
 
@@ -75,7 +78,7 @@ namespace Missions {
         void OnClick() override;
         void OnHover() override;
 
-        void CheckProgress(const std::wstring& player_name) override;
+        void CheckProgress(const CharacterCompletion* cc) override;
     };
 
     class HeroUnlock : public PvESkill {
@@ -88,7 +91,7 @@ namespace Missions {
         void OnClick() override;
         void OnHover() override { ImGui::SetTooltip(Name()); };
 
-        void CheckProgress(const std::wstring& player_name) override;
+        void CheckProgress(const CharacterCompletion* cc) override;
         const char* Name() override;
     };
 
@@ -112,7 +115,7 @@ namespace Missions {
         FestivalHat(const size_t _encoded_name_index, const wchar_t* encoded_name)
             : ItemAchievement(_encoded_name_index, encoded_name) { }
 
-        void CheckProgress(const std::wstring& player_name) override;
+        void CheckProgress(const CharacterCompletion* cc) override;
     };
 
     class UnlockedPvPItemUpgrade : public ItemAchievement {
@@ -120,7 +123,7 @@ namespace Missions {
         UnlockedPvPItemUpgrade(const size_t _encoded_name_index)
             : ItemAchievement(_encoded_name_index, nullptr) {}
 
-        void CheckProgress(const std::wstring& player_name) override;
+        void CheckProgress(const CharacterCompletion* cc) override;
         size_t GetLoadedIcons(IDirect3DTexture9* icons_out[4]) override;
         const char* Name() override;
 
@@ -137,7 +140,7 @@ namespace Missions {
         MinipetAchievement(const size_t hom_achievement_index, const wchar_t* encoded_name)
             : ItemAchievement(hom_achievement_index, encoded_name) { }
 
-        void CheckProgress(const std::wstring& player_name) override;
+        void CheckProgress(const CharacterCompletion* cc) override;
     };
 
     class WeaponAchievement : public ItemAchievement {
@@ -145,7 +148,7 @@ namespace Missions {
         WeaponAchievement(const size_t _encoded_name_index, const wchar_t* encoded_name)
             : ItemAchievement(_encoded_name_index, encoded_name) { }
 
-        void CheckProgress(const std::wstring& player_name) override;
+        void CheckProgress(const CharacterCompletion* cc) override;
     };
 
     class AchieventWithWikiFile : public ItemAchievement {
@@ -168,21 +171,21 @@ namespace Missions {
     public:
         ArmorAchievement(const size_t hom_achievement_index, const wchar_t* encoded_name, const char* _wiki_file_name = nullptr)
             : AchieventWithWikiFile(hom_achievement_index, encoded_name, _wiki_file_name) { };
-        void CheckProgress(const std::wstring& player_name) override;
+        void CheckProgress(const CharacterCompletion* cc) override;
     };
 
     class CompanionAchievement : public AchieventWithWikiFile {
     public:
         CompanionAchievement(const size_t hom_achievement_index, const wchar_t* encoded_name, const char* _wiki_file_name = nullptr)
             : AchieventWithWikiFile(hom_achievement_index, encoded_name, _wiki_file_name) { };
-        void CheckProgress(const std::wstring& player_name) override;
+        void CheckProgress(const CharacterCompletion* cc) override;
     };
 
     class HonorAchievement : public AchieventWithWikiFile {
     public:
         HonorAchievement(const size_t hom_achievement_index, const wchar_t* encoded_name, const char* _wiki_file_name = nullptr)
             : AchieventWithWikiFile(hom_achievement_index, encoded_name, _wiki_file_name) { };
-        void CheckProgress(const std::wstring& player_name) override;
+        void CheckProgress(const CharacterCompletion* cc) override;
     };
 
     class FactionsPvESkill : public PvESkill {
@@ -197,7 +200,7 @@ namespace Missions {
         Vanquish(const GW::Constants::MapID _outpost, const GW::Constants::QuestID _zm_quest = static_cast<GW::Constants::QuestID>(0))
             : Mission(_outpost, _zm_quest) { }
 
-        void CheckProgress(const std::wstring& player_name) override;
+        void CheckProgress(const CharacterCompletion* cc) override;
     };
 
     class EotNMission : public Mission {
@@ -208,7 +211,7 @@ namespace Missions {
         EotNMission(const GW::Constants::MapID _outpost, GW::Constants::QuestID _zb_quest = static_cast<GW::Constants::QuestID>(0))
             : zb_quests({_zb_quest}), Mission(_outpost)  { }
 
-        void CheckProgress(const std::wstring& player_name) override;
+        void CheckProgress(const CharacterCompletion* cc) override;
         bool HasQuest() override;
     private:
         std::vector<GW::Constants::QuestID> zb_quests{};
@@ -240,6 +243,7 @@ struct CharacterCompletion {
     HallOfMonumentsAchievements hom_achievements;
     std::vector<uint32_t> minipets_unlocked{};
     std::vector<uint32_t> festival_hats{};
+    uint32_t matrix_row = 0; // Row in the completion matrix shared by all characters
 };
 
 // class used to keep a list of hotkeys, capture keyboard event and fire hotkeys as needed
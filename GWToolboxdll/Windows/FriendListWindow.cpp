@@ -70,8 +70,11 @@ namespace {
         return "Unknown";
     }
 
-    ToolboxIni inifile{};
+    // friends.ini is a snapshot; changes since then are appended to the journal, which is folded back in now and then
     const wchar_t* ini_filename = L"friends.ini";
+    const wchar_t* journal_filename = L"friends_journal.txt";
+    constexpr size_t journal_compact_threshold = 500; // Records
+    size_t journal_record_count = 0;
     bool loading = false;     // Loading from disk?
     bool polling = false;     // Polling in progress?
     bool poll_queued = false; // Used to avoid overloading the thread queue.
@@ -110,20 +113,81 @@ namespace {
 
     uint8_t poll_interval_seconds = 10;
 
-    // Mapping of Name > UUID
-    std::unordered_map<std::wstring, FriendListWindow::Friend*> uuid_by_name{};
+    struct UuidHash {
+        size_t operator()(const UUID& uuid) const noexcept
+        {
+            uint64_t halves[2];
+            memcpy(halves, &uuid, sizeof(halves));
+            return std::hash<uint64_t>{}(halves[0] ^ halves[1] * 0x9e3779b97f4a7c15ull);
+        }
+    };
+
+    struct NameHash {
+        using is_transparent = void;
+        size_t operator()(const std::wstring_view name) const noexcept { return std::hash<std::wstring_view>{}(name); }
+    };
+
+    // Mapping of alias or char name > Friend; can be searched with a wstring_view
+    std::unordered_map<std::wstring, FriendListWindow::Friend*, NameHash, std::equal_to<>> uuid_by_name{};
+
+    // Main store of Friend info, by GW's uuid
+    std::unordered_map<UUID, FriendListWindow::Friend*, UuidHash> friends{};
+
+    // Bit per player number in the current instance, set if that player is ignored.
+    // Kept up to date as players join and leave; rebuilt from the player array when the map or ignore list changes.
+    std::vector<uint64_t> ignored_players;
+    bool ignored_players_dirty = true;
+
+    FriendListWindow::Friend* GetFriendByName(const std::wstring_view name)
+    {
+        if (name.empty()) return nullptr;
+        const auto it = uuid_by_name.find(name);
+        return it == uuid_by_name.end() ? nullptr : it->second;
+    }
+
+    bool IsIgnored(const FriendListWindow::Friend* f)
+    {
+        return f && f->type == GW::FriendType::Ignore;
+    }
+
+    void SetPlayerIgnored(const uint32_t player_number, const bool ignored)
+    {
+        const auto word = player_number / 64;
+        const auto bit = uint64_t{1} << (player_number % 64);
+        if (ignored) {
+            if (word >= ignored_players.size()) {
+                ignored_players.resize(word + 1);
+            }
+            ignored_players[word] |= bit;
+        }
+        else if (word < ignored_players.size()) {
+            ignored_players[word] &= ~bit;
+        }
+    }
 
-    // Main store of Friend info
-    std::unordered_map<std::string, FriendListWindow::Friend*> friends{};
+    void RebuildIgnoredPlayers()
+    {
+        ignored_players.clear();
+        ignored_players_dirty = false;
+        const auto players = GW::PlayerMgr::GetPlayerArray();
+        if (!players) {
+            return;
+        }
+        for (const auto& player : *players) {
+            if (player.player_number && player.name && IsIgnored(GetFriendByName(TextUtils::SanitizePlayerName(player.name)))) {
+                SetPlayerIgnored(player.player_number, true);
+            }
+        }
+    }
 
     bool show_location = true;
 
     GW::HookEntry FriendStatusUpdate_Entry;
 
-    void LoadCharnames(const char* section, std::unordered_map<std::wstring, uint8_t>* out)
+    void LoadCharnames(const ToolboxIni& ini, const char* section, std::unordered_map<std::wstring, uint8_t>* out)
     {
         TNamesDepend values{};
-        inifile.GetAllValues(section, "charname", values);
+        ini.GetAllValues(section, "charname", values);
         for (auto i = values.cbegin(); i != values.cend(); ++i) {
             std::wstring char_wstr = TextUtils::StringToWString(i->pItem);
             std::wstring temp;
@@ -145,6 +209,139 @@ namespace {
     }
 
 
+    // Friend as stored on disk
+    struct StoredFriend {
+        long type = static_cast<long>(GW::FriendType::Unknow);
+        std::string alias;
+        std::unordered_map<std::wstring, uint8_t> charnames;
+    };
+    // By uuid string, as used for the ini section names
+    using StoredFriends = std::map<std::string, StoredFriend>;
+
+    void ReadIni(const ToolboxIni& ini, StoredFriends& out)
+    {
+        TNamesDepend entries;
+        ini.GetAllSections(entries);
+        for (const auto& entry : entries) {
+            auto& stored = out[entry.pItem];
+            stored.type = ini.GetLongValue(entry.pItem, "type", stored.type);
+            stored.alias = ini.GetValue(entry.pItem, "alias", "");
+            LoadCharnames(ini, entry.pItem, &stored.charnames);
+        }
+    }
+
+    void WriteIni(const StoredFriends& stored, ToolboxIni& ini)
+    {
+        ini.Reset();
+        ini.SetMultiKey(true);
+        for (const auto& [uuid, f] : stored) {
+            ini.SetLongValue(uuid.c_str(), "type", f.type);
+            ini.SetValue(uuid.c_str(), "alias", f.alias.c_str());
+            for (const auto& [name, profession] : f.charnames) {
+                char charname[128] = {0};
+                snprintf(charname, 128, "%s,%d", TextUtils::WStringToString(name).c_str(), profession);
+                ini.SetValue(uuid.c_str(), "charname", charname);
+            }
+        }
+    }
+
+    // One journal record per line, tab separated:
+    //   F <uuid> <type> <alias>          friend added, or their type or alias changed
+    //   C <uuid> <profession> <charname> character added, or its profession found out
+    void AppendFriendRecord(std::string& journal, FriendListWindow::Friend& f)
+    {
+        journal += std::format("F\t{}\t{}\t{}\n", f.uuid, static_cast<long>(f.type), f.GetAliasA());
+    }
+
+    void AppendCharacterRecord(std::string& journal, const FriendListWindow::Friend& f, FriendListWindow::Character& c)
+    {
+        journal += std::format("C\t{}\t{}\t{}\n", f.uuid, c.profession, c.GetNameA());
+    }
+
+    // Applies the journal on top of what's been read from the ini; returns the number of records applied
+    size_t ApplyJournal(std::string_view journal, StoredFriends& stored)
+    {
+        size_t count = 0;
+        while (!journal.empty()) {
+            const auto line_end = journal.find('\n');
+            auto line = journal.substr(0, line_end);
+            journal.remove_prefix(line_end == std::string_view::npos ? journal.size() : line_end + 1);
+
+            std::string_view fields[4];
+            size_t field_count = 0;
+            for (; field_count < 3; field_count++) {
+                const auto tab = line.find('\t');
+                if (tab == std::string_view::npos) break;
+                fields[field_count] = line.substr(0, tab);
+                line.remove_prefix(tab + 1);
+            }
+            fields[field_count++] = line;
+            if (field_count != 4 || fields[0].size() != 1 || fields[1].empty() || fields[3].empty()) {
+                continue; // Truncated or garbled
+            }
+            long value = 0;
+            std::from_chars(fields[2].data(), fields[2].data() + fields[2].size(), value);
+            auto& f = stored[std::string(fields[1])];
+            switch (fields[0][0]) {
+                case 'F':
+                    f.type = value;
+                    f.alias = fields[3];
+                    break;
+                case 'C': {
+                    auto& profession = f.charnames[TextUtils::StringToWString(fields[3])];
+                    if (value > 0 && value < 11) {
+                        profession = static_cast<uint8_t>(value);
+                    }
+                } break;
+                default:
+                    continue;
+            }
+            count++;
+        }
+        return count;
+    }
+
+    size_t ApplyJournalFile(const std::filesystem::path& path, StoredFriends& stored)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            return 0;
+        }
+        const std::string journal((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        return ApplyJournal(journal, stored);
+    }
+
+    std::filesystem::path GetCompactingJournalPath()
+    {
+        auto path = Resources::GetSettingFile(journal_filename);
+        path += L".compacting";
+        return path;
+    }
+
+    // Folds the journal into friends.ini and starts a new journal. Other GW clients may be appending to the journal
+    // at the same time, so it's moved aside first; anything they write after that goes into a fresh journal.
+    void CompactJournal()
+    {
+        const auto journal_path = Resources::GetSettingFile(journal_filename);
+        const auto compacting_path = GetCompactingJournalPath();
+        std::error_code ec;
+        if (!std::filesystem::exists(compacting_path, ec)) {
+            std::filesystem::rename(journal_path, compacting_path, ec);
+            if (ec) {
+                return; // Try again next time
+            }
+        }
+        ToolboxIni ini(false, true);
+        ini.LoadFile(Resources::GetSettingFile(ini_filename));
+        StoredFriends stored;
+        ReadIni(ini, stored);
+        ApplyJournalFile(compacting_path, stored);
+        WriteIni(stored, ini);
+        if (ini.SaveFile(Resources::GetSettingFile(ini_filename)) == SI_OK) {
+            std::filesystem::remove(compacting_path, ec);
+        }
+    }
+
     FriendListWindow::Friend* SetFriend(const uint8_t*, GW::FriendType, GW::FriendStatus, uint32_t, const wchar_t*, const wchar_t*);
     FriendListWindow::Friend* SetFriend(const GW::Friend*);
 
@@ -349,7 +546,9 @@ namespace {
         GW::Packet::StoC::TradeStart::STATIC_HEADER,
         GW::Packet::StoC::MessageGlobal::STATIC_HEADER,
         GW::Packet::StoC::PartyInviteReceived_Create::STATIC_HEADER,
-        GW::Packet::StoC::PlayerJoinInstance::STATIC_HEADER
+        GW::Packet::StoC::PlayerJoinInstance::STATIC_HEADER,
+        GW::Packet::StoC::PlayerLeaveInstance::STATIC_HEADER,
+        GW::Packet::StoC::MapLoaded::STATIC_HEADER
     };
 
     GW::HookEntry OnPostStoCPacket_Entry;
@@ -364,14 +563,21 @@ namespace {
         case GW::Packet::StoC::PlayerJoinInstance::STATIC_HEADER: {
             const auto p = (GW::Packet::StoC::PlayerJoinInstance*)pak;
             const auto player_name = TextUtils::SanitizePlayerName(p->player_name);
-            const auto a = GW::PlayerMgr::GetPlayerByName(p->player_name);
-            const auto f = a && a->primary ? Instance().GetFriend(player_name.data()) : nullptr;
-            const auto fc = f ? f->GetCharacter(player_name.data()) : nullptr;
+            const auto f = GetFriendByName(player_name);
+            SetPlayerIgnored(p->player_number, IsIgnored(f));
+            const auto a = f ? GW::PlayerMgr::GetPlayerByName(p->player_name) : nullptr;
+            const auto fc = a && a->primary ? f->GetCharacter(player_name.data()) : nullptr;
             if (fc) {
                 ASSERT(a->primary > 0 && a->primary < 11);
                 fc->profession = static_cast<uint8_t>(a->primary);
             }
         } break;
+        case GW::Packet::StoC::PlayerLeaveInstance::STATIC_HEADER:
+            SetPlayerIgnored(((GW::Packet::StoC::PlayerLeaveInstance*)pak)->player_number, false);
+            break;
+        case GW::Packet::StoC::MapLoaded::STATIC_HEADER:
+            ignored_players_dirty = true; // New instance, new player numbers
+            break;
         }
     }
 
@@ -522,10 +728,14 @@ namespace {
         const bool alias_changed = alias != lf->GetAliasW();
         if (uuid_changed) {
             // UUID is different. This could be because GW has assigned a UUID to this friend.
-            friends.erase(lf->uuid);
-            lf->uuid_bytes = *(UUID*)uuid;
+            friends.erase(lf->uuid_bytes);
+            memcpy(&lf->uuid_bytes, uuid, sizeof(UUID));
             lf->uuid = TextUtils::GuidToString(&lf->uuid_bytes);
-            friends.emplace(lf->uuid, lf);
+            friends.emplace(lf->uuid_bytes, lf);
+            // Journal records are keyed by uuid; write the characters again under the new one
+            for (auto& character : lf->characters | std::views::values) {
+                character.dirty = true;
+            }
         }
         if (alias && alias_changed) {
             // Friend's alias for this uuid has changed, or the uuid for this alias has changed.
@@ -543,9 +753,10 @@ namespace {
         if (!charname || status == GW::FriendStatus::Offline) {
             lf->current_char = nullptr;
         }
+        bool name_added = false;
         if (status != GW::FriendStatus::Offline && charname) {
             lf->current_char = lf->SetCharacter(charname);
-            uuid_by_name.emplace(charname, lf);
+            name_added = uuid_by_name.emplace(charname, lf).second;
         }
         const bool status_changed = lf->status != status;
         lf->status = status;
@@ -553,6 +764,12 @@ namespace {
         if (status_changed || alias_changed || uuid_changed || type_changed) {
             need_to_reorder_friends = true;
         }
+        if (alias_changed || uuid_changed || type_changed) {
+            lf->dirty = true;
+        }
+        if (type_changed || (IsIgnored(lf) && (alias_changed || name_added))) {
+            ignored_players_dirty = true;
+        }
 
         friends_changed = true;
         return lf;
@@ -651,7 +868,7 @@ bool FriendListWindow::GetIsPlayerIgnored(GW::Packet::StoC::PacketBase* pak)
             return GetIsPlayerIgnored(((uint32_t*)pak)[1]);
         case GAME_SMSG_CHAT_MESSAGE_GLOBAL: {
             const auto p = static_cast<GW::Packet::StoC::MessageGlobal*>(pak);
-            return GetIsPlayerIgnored(std::wstring(p->sender_name));
+            return GetIsPlayerIgnored(std::wstring_view(p->sender_name));
         }
         case GAME_SMSG_PARTY_REQUEST_CANCEL:
         case GAME_SMSG_PARTY_REQUEST_RESPONSE:
@@ -670,14 +887,20 @@ bool FriendListWindow::GetIsPlayerIgnored(GW::Packet::StoC::PacketBase* pak)
 // Find out whether a player in the current map is on the current player's ignore list.
 bool FriendListWindow::GetIsPlayerIgnored(const uint32_t player_number)
 {
-    return GetIsPlayerIgnored(GetPlayerName(player_number));
+    if (!player_number) {
+        return false;
+    }
+    if (ignored_players_dirty) {
+        RebuildIgnoredPlayers();
+    }
+    const auto word = player_number / 64;
+    return word < ignored_players.size() && (ignored_players[word] >> (player_number % 64) & 1);
 }
 
 // Find out whether this player's name is on the current player's ignore list.
-bool FriendListWindow::GetIsPlayerIgnored(const std::wstring& player_name)
+bool FriendListWindow::GetIsPlayerIgnored(const std::wstring_view player_name)
 {
-    const auto* f = player_name.empty() ? nullptr : Instance().GetFriend(player_name.c_str());
-    return f && f->type == GW::FriendType::Ignore;
+    return IsIgnored(GetFriendByName(player_name));
 }
 
 
@@ -716,12 +939,14 @@ FriendListWindow::Character* FriendListWindow::Friend::SetCharacter(const wchar_
     if (!existing) {
         Character c;
         c.SetName(char_name);
+        c.dirty = true;
         characters.emplace(c.getNameW(), c);
         existing = GetCharacter(c.getNameW().c_str());
         cached_charnames_hover = false;
     }
     if (profession && profession != existing->profession) {
         existing->profession = profession;
+        existing->dirty = true;
         cached_charnames_hover = false;
     }
     return existing;
@@ -794,9 +1019,7 @@ std::string FriendListWindow::Friend::GetCharactersHover(const bool include_char
 // Find existing record for friend by char name.
 FriendListWindow::Friend* FriendListWindow::GetFriend(const wchar_t* name)
 {
-    if (!(name && *name)) return nullptr;
-    const auto it = uuid_by_name.find(name);
-    return it == uuid_by_name.end() ? nullptr : it->second;
+    return name ? GetFriendByName(name) : nullptr;
 }
 
 // Find existing record for friend by GW Friend object
@@ -807,14 +1030,17 @@ FriendListWindow::Friend* FriendListWindow::GetFriend(const GW::Friend* f)
 
 FriendListWindow::Friend* FriendListWindow::GetFriend(const uint8_t* uuid)
 {
-    return GetFriendByUUID(TextUtils::GuidToString((GUID*)uuid));
+    UUID key;
+    memcpy(&key, uuid, sizeof(key));
+    const auto it = friends.find(key);
+    return it == friends.end() ? nullptr : it->second;
 }
 
-// Find existing record for friend by uuid
+// Find existing record for friend by uuid string
 FriendListWindow::Friend* FriendListWindow::GetFriendByUUID(const std::string& uuid)
 {
-    const auto it = friends.find(uuid);
-    return it == friends.end() ? nullptr : it->second;
+    UUID key;
+    return TextUtils::StringToGuid(uuid, &key) ? GetFriend(reinterpret_cast<const uint8_t*>(&key)) : nullptr;
 }
 
 bool FriendListWindow::RemoveFriend(const Friend* f)
@@ -822,7 +1048,10 @@ bool FriendListWindow::RemoveFriend(const Friend* f)
     if (!f) {
         return false;
     }
-    friends.erase(f->uuid);
+    friends.erase(f->uuid_bytes);
+    if (IsIgnored(f)) {
+        ignored_players_dirty = true;
+    }
     for (const auto& char_key : f->characters | std::views::keys) {
         uuid_by_name.erase(char_key);
     }
@@ -976,17 +1205,14 @@ void FriendListWindow::Poll()
     const clock_t now = clock();
 
     // 1. Remove friends from toolbox list that are no longer in gw list
-    auto it = friends.begin();
-    while (it != friends.end()) {
-        Friend* lf = it->second;
-        if (lf->GetFriend()) {
-            // Friend exists in friend list, don't need to mess
-            ++it;
-            continue;
+    std::vector<Friend*> removed;
+    for (const auto lf : friends | std::views::values) {
+        if (!lf->GetFriend()) {
+            removed.push_back(lf);
         }
-        // Removed from in-game friend list, delete from tb friend list.
+    }
+    for (const auto lf : removed) {
         ASSERT(RemoveFriend(lf));
-        it = friends.begin();
     }
 
     // 2. Update or add friends from gw list into toolbox list
@@ -1352,34 +1578,30 @@ void FriendListWindow::LoadFromFile()
         }
         friends.clear();
 
-        inifile.Reset();
-        inifile.SetMultiKey(true);
-        inifile.LoadFile(Resources::GetSettingFile(ini_filename).c_str());
-
-        TNamesDepend entries;
-        inifile.GetAllSections(entries);
-        for (const auto& entry : entries) {
+        ToolboxIni ini(false, true);
+        ini.LoadFile(Resources::GetSettingFile(ini_filename));
+        StoredFriends stored;
+        ReadIni(ini, stored);
+        // A journal left mid-compaction is older than the current one
+        journal_record_count = ApplyJournalFile(GetCompactingJournalPath(), stored);
+        journal_record_count += ApplyJournalFile(Resources::GetSettingFile(journal_filename), stored);
+
+        for (const auto& [uuid, entry] : stored) {
+            if (uuid.empty() || entry.alias.empty() || entry.charnames.empty()) {
+                continue; // Error, alias or uuid empty, or no charnames
+            }
             auto lf = new Friend(this);
-            lf->uuid = entry.pItem;
+            lf->uuid = uuid;
             TextUtils::StringToGuid(lf->uuid, &lf->uuid_bytes);
-            lf->setAlias(TextUtils::StringToWString(inifile.GetValue(entry.pItem, "alias", "")));
-            lf->type = static_cast<GW::FriendType>(inifile.GetLongValue(entry.pItem, "type", static_cast<long>(lf->type)));
-            if (lf->uuid.empty() || lf->GetAliasW().empty()) {
-                delete lf;
-                continue; // Error, alias or uuid empty.
+            lf->setAlias(TextUtils::StringToWString(entry.alias));
+            lf->type = static_cast<GW::FriendType>(entry.type);
+            for (const auto& [name, profession] : entry.charnames) {
+                lf->SetCharacter(name.c_str(), profession)->dirty = false;
             }
-
-            // Grab char names
-            std::unordered_map<std::wstring, uint8_t> charnames;
-            LoadCharnames(entry.pItem, &charnames);
-            for (const auto& it : charnames) {
-                lf->SetCharacter(it.first.c_str(), it.second);
-            }
-            if (lf->characters.empty()) {
+            if (!friends.emplace(lf->uuid_bytes, lf).second) {
                 delete lf;
-                continue; // Error, should have at least 1 charname...
+                continue;
             }
-            friends.emplace(lf->uuid, lf);
             for (const auto& it : lf->characters) {
                 uuid_by_name[it.first] = lf;
             }
@@ -1387,53 +1609,51 @@ void FriendListWindow::LoadFromFile()
         }
         Log::Log("%s: Loaded friends from ini\n", Name());
         friends_list_checked = false;
+        ignored_players_dirty = true;
         loading = false;
     });
 }
 
+// Appends what's changed since the last save to the journal; every so often the journal is folded into friends.ini
 void FriendListWindow::SaveToFile()
 {
     if (!friends_changed) {
         return;
     }
+    friends_changed = false;
+    std::string records;
+    for (const auto lf : friends | std::views::values) {
+        if (lf->dirty) {
+            AppendFriendRecord(records, *lf);
+            journal_record_count++;
+            lf->dirty = false;
+        }
+        for (auto& character : lf->characters | std::views::values) {
+            if (!character.dirty) {
+                continue;
+            }
+            AppendCharacterRecord(records, *lf, character);
+            journal_record_count++;
+            character.dirty = false;
+        }
+    }
+    if (records.empty()) {
+        return;
+    }
+    const bool compact = journal_record_count > journal_compact_threshold;
+    if (compact) {
+        journal_record_count = 0;
+    }
     if (settings_thread.joinable()) {
         settings_thread.join();
     }
-    settings_thread = std::thread([this] {
-        friends_changed = false;
-        inifile.Reset();
-        // Load the existing file in, and amend the info
-        inifile.LoadFile(Resources::GetSettingFile(ini_filename).c_str());
-        inifile.SetMultiKey(true);
-        if (friends.empty()) {
-            return; // Error, should have at least 1 friend
-        }
-        //std::lock_guard<std::recursive_mutex> lock(friends_mutex);
-        for (auto it = friends.begin(); it != friends.end(); ++it) {
-            // do something
-            Friend& lf = *it->second;
-            const char* uuid = lf.uuid.c_str();
-            inifile.SetLongValue(uuid, "type", static_cast<long>(lf.type));
-            inifile.SetValue(uuid, "alias", lf.GetAliasA().c_str());
-            // Append to existing charnames, but don't duplicate. This allows multiple accounts to contribute to the friend list.
-            std::unordered_map<std::wstring, uint8_t> charnames;
-            LoadCharnames(uuid, &charnames);
-            for (const auto& char_it : lf.characters) {
-                const auto& found = charnames.find(char_it.first);
-                // Note: Don't overwrite the profession
-                if (found == charnames.end() || char_it.second.profession != 0) {
-                    charnames.emplace(char_it.first, char_it.second.profession);
-                }
-            }
-            inifile.Delete(uuid, "charname");
-            for (const auto& char_it : charnames) {
-                char charname[128] = {0};
-                snprintf(charname, 128, "%s,%d",
-                         TextUtils::WStringToString(char_it.first).c_str(),
-                         char_it.second);
-                inifile.SetValue(uuid, "charname", charname);
-            }
+    settings_thread = std::thread([records = std::move(records), compact] {
+        if (!Resources::WriteFile(Resources::GetSettingFile(journal_filename), records, true)) {
+            Log::Log("Failed to write friend list changes to %ls\n", journal_filename);
+            return;
+        }
+        if (compact) {
+            CompactJournal();
         }
-        ASSERT(inifile.SaveFile(Resources::GetSettingFile(ini_filename)) == SI_OK);
     });
 }
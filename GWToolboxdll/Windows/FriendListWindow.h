@@ -23,6 +23,7 @@ public:
 
     public:
         uint8_t profession = 0;
+        bool dirty = false; // New or changed since the last save
 
         const std::string& GetNameA()
         {
@@ -82,6 +83,7 @@ public:
         clock_t last_update = 0;
         std::string cached_charnames_hover_str;
         bool cached_charnames_hover = false;
+        bool dirty = false; // Type or alias changed since the last save
 
         Character* GetCharacter(const wchar_t*);
         Character* SetCharacter(const wchar_t*, uint8_t profession = 0);
@@ -132,7 +134,7 @@ public:
 
     static bool GetIsPlayerIgnored(GW::Packet::StoC::PacketBase* pak);
     static bool GetIsPlayerIgnored(uint32_t player_number);
-    static bool GetIsPlayerIgnored(const std::wstring& player_name);
+    static bool GetIsPlayerIgnored(std::wstring_view player_name);
 
     static void AddFriendAliasToMessage(wchar_t** message_ptr);
 
@@ -32,6 +32,7 @@
 #include <algorithm>
 #include <chrono>
 #include <sstream>
+#include <unordered_map>
 #include <unordered_set>
 
 #include <Modules/ChatFilter.h>
@@ -425,10 +426,58 @@ namespace {
 
     struct AvailableItem {
         const std::string* name;
+        std::string name_lower; // pre-lowercased once on receipt for search
         int sellOrders = 0;
         int buyOrders = 0;
     };
 
+    std::string ToLower(std::string_view str)
+    {
+        std::string out(str);
+        std::transform(out.begin(), out.end(), out.begin(), ::tolower);
+        return out;
+    }
+
+    // Trigram index over AvailableItem::name_lower; posting lists hold ascending indexes into available_items.
+    // Rebuilt only when the set of listed item names changes, not when order counts do.
+    struct ItemSearchIndex {
+        std::unordered_map<uint32_t, std::vector<uint32_t>> postings;
+
+        static uint32_t Trigram(const char* s)
+        {
+            return static_cast<uint8_t>(s[0]) | static_cast<uint8_t>(s[1]) << 8 | static_cast<uint8_t>(s[2]) << 16;
+        }
+
+        void Build(const std::vector<AvailableItem>& items)
+        {
+            postings.clear();
+            for (uint32_t idx = 0; idx < items.size(); idx++) {
+                const auto& name = items[idx].name_lower;
+                for (size_t i = 0; i + 3 <= name.size(); i++) {
+                    auto& list = postings[Trigram(name.data() + i)];
+                    if (list.empty() || list.back() != idx) 
+                        list.push_back(idx);
+                }
+            }
+        }
+
+        // Returns the smallest posting list covering every trigram of needle, or nullptr if the needle is too short to use the index.
+        // Caller still has to confirm the substring match on the candidates.
+        const std::vector<uint32_t>* Candidates(std::string_view needle_lower) const
+        {
+            static const std::vector<uint32_t> none;
+            const std::vector<uint32_t>* best = nullptr;
+            for (size_t i = 0; i + 3 <= needle_lower.size(); i++) {
+                const auto found = postings.find(Trigram(needle_lower.data() + i));
+                if (found == postings.end()) 
+                    return &none;
+                if (!best || found->second.size() < best->size()) 
+                    best = &found->second;
+            }
+            return best;
+        }
+    };
+
     // Settings
     bool auto_refresh = true;
     int refresh_interval = 60;
@@ -437,7 +486,10 @@ namespace {
     ThreadedWebSocket market_ws;
 
     // Data
-    std::vector<AvailableItem> available_items;
+    std::vector<AvailableItem> available_items; // sorted by name
+    ItemSearchIndex available_items_index;
+    std::vector<uint32_t> visible_items; // indexes into available_items after filter + search
+    bool visible_items_dirty = true;
     std::vector<MarketItem> last_items;
     std::vector<MarketItem> current_item_orders;
     std::string current_viewing_item;
@@ -446,8 +498,10 @@ namespace {
 
     // UI
     char search_buffer[256] = "";
+    std::string search_lower; // search_buffer lowercased; set by OnSearchChanged() whenever search_buffer changes
     enum FilterMode { SHOW_ALL, SHOW_SELL_ONLY, SHOW_BUY_ONLY };
     FilterMode filter_mode = SHOW_ALL;
+    FilterMode last_filter_mode = SHOW_ALL;
     float refresh_timer = 0.0f;
 
     // Socket.IO
@@ -457,7 +511,6 @@ namespace {
     int ping_timeout = 20000;
 
     OrderSortMode order_sort_mode = OrderSortMode::MostRecent;
-    bool available_items_needs_sort = true;
     bool current_orders_needs_sort = true;
 
     // Forward declarations
@@ -594,27 +647,48 @@ namespace {
 
     void OnGetAvailableOrders(const json& orders)
     {
-        available_items.clear();
-        if (!orders.is_object()) {
-            available_items_needs_sort = true;
-            Log::Log("Received 0 available items");
-            return;
+        std::vector<AvailableItem> incoming;
+        if (orders.is_object()) {
+            incoming.reserve(orders.size());
+            for (const auto& [key, j] : orders.get_object()) {
+                AvailableItem item;
+                item.name = InternString(key);
+                item.sellOrders = TextUtils::parseIntFromJson(j, "sellWeek", 0);
+                item.buyOrders = TextUtils::parseIntFromJson(j, "buyWeek", 0);
+                incoming.push_back(std::move(item));
+            }
+            std::ranges::sort(incoming, [](const AvailableItem& a, const AvailableItem& b) {
+                return *a.name < *b.name;
+            });
         }
-        available_items.reserve(orders.size());
+
         for (auto& i : favorite_items) {
             i.second = {};
         }
-        for (const auto& [key, j] : orders.get_object()) {
-            AvailableItem item;
-            item.name = InternString(key);
-            item.sellOrders = TextUtils::parseIntFromJson(j, "sellWeek", 0);
-            item.buyOrders = TextUtils::parseIntFromJson(j, "buyWeek", 0);
-            available_items.push_back(item);
+
+        // Names are interned, so an unchanged listing set can be detected by pointer and only the counts patched
+        const bool same_names = std::ranges::equal(incoming, available_items, [](const AvailableItem& a, const AvailableItem& b) {
+            return a.name == b.name;
+        });
+        if (same_names) {
+            for (size_t i = 0; i < incoming.size(); i++) {
+                available_items[i].sellOrders = incoming[i].sellOrders;
+                available_items[i].buyOrders = incoming[i].buyOrders;
+            }
+        }
+        else {
+            for (auto& item : incoming) {
+                item.name_lower = ToLower(*item.name);
+            }
+            available_items = std::move(incoming);
+            available_items_index.Build(available_items);
+        }
+        for (const auto& item : available_items) {
             if (favorite_items.contains(*item.name)) {
                 favorite_items[*item.name] = item;
             }
         }
-        available_items_needs_sort = true;
+        visible_items_dirty = true;
         Log::Log("Received %zu available items", available_items.size());
     }
 
@@ -913,53 +987,81 @@ namespace {
         socket_io_ready = false;
     }
 
-    void DrawItemList()
+    std::vector<AvailableItem>::iterator FindAvailableItem(std::string_view item_name)
     {
-        ImGui::Text("Available Listings (%zu)", available_items.size());
-        ImGui::Separator();
-        // Sort only when data changes
-        if (available_items_needs_sort) {
-            std::sort(available_items.begin(), available_items.end(), [](const AvailableItem& a, const AvailableItem& b) {
-                return *a.name < *b.name;
-            });
+        const auto found = std::ranges::lower_bound(available_items, item_name, {}, [](const AvailableItem& item) {
+            return std::string_view(*item.name);
+        });
+        return found != available_items.end() && *found->name == item_name ? found : available_items.end();
+    }
 
-            available_items_needs_sort = false;
-        }
+    void OnSearchChanged()
+    {
+        search_lower = ToLower(search_buffer);
+        visible_items_dirty = true;
+    }
 
-        for (const auto& item : available_items) {
-            // Apply filter mode
-            if (filter_mode == SHOW_SELL_ONLY && item.sellOrders == 0) continue;
-            if (filter_mode == SHOW_BUY_ONLY && item.buyOrders == 0) continue;
+    void RefreshVisibleItems()
+    {
+        if (!visible_items_dirty && filter_mode == last_filter_mode) 
+            return;
+        last_filter_mode = filter_mode;
+        visible_items_dirty = false;
+        visible_items.clear();
+
+        auto consider = [](const uint32_t idx) {
+            const auto& item = available_items[idx];
+            if (filter_mode == SHOW_SELL_ONLY && item.sellOrders == 0) return;
+            if (filter_mode == SHOW_BUY_ONLY && item.buyOrders == 0) return;
+            if (!search_lower.empty() && item.name_lower.find(search_lower) == std::string::npos) return;
+            visible_items.push_back(idx);
+        };
 
-            // Apply search filter
-            if (search_buffer[0] != '\0') {
-                std::string search_lower = search_buffer;
-                std::string name_lower = *item.name;
-                std::transform(search_lower.begin(), search_lower.end(), search_lower.begin(), ::tolower);
-                std::transform(name_lower.begin(), name_lower.end(), name_lower.begin(), ::tolower);
-                if (name_lower.find(search_lower) == std::string::npos) continue;
+        if (const auto candidates = available_items_index.Candidates(search_lower)) {
+            for (const auto idx : *candidates) {
+                consider(idx);
             }
+            return;
+        }
+        // Search shorter than a trigram; scan everything
+        for (uint32_t idx = 0; idx < available_items.size(); idx++) {
+            consider(idx);
+        }
+    }
 
-            ImGui::PushID(item.name);
-
-            bool selected = (current_viewing_item == *item.name);
-            if (ImGui::Selectable(item.name->c_str(), selected)) {
-                current_viewing_item = *item.name;
-                SendGetItemOrders(*item.name);
-            }
+    void DrawItemList()
+    {
+        ImGui::Text("Available Listings (%zu)", available_items.size());
+        ImGui::Separator();
+        RefreshVisibleItems();
+
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(visible_items.size()), ImGui::GetTextLineHeightWithSpacing());
+        while (clipper.Step()) {
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                const auto& item = available_items[visible_items[i]];
+                ImGui::PushID(item.name);
+
+                bool selected = (current_viewing_item == *item.name);
+                if (ImGui::Selectable(item.name->c_str(), selected)) {
+                    current_viewing_item = *item.name;
+                    SendGetItemOrders(*item.name);
+                }
 
-            ImGui::SameLine(300);
-            if (item.sellOrders > 0 && item.buyOrders > 0) {
-                ImGui::Text("%d  Seller%s, %d Buyer%s", item.sellOrders, item.sellOrders == 1 ? "" : "s", item.buyOrders, item.buyOrders == 1 ? "" : "s");
-            }
-            else if (item.sellOrders > 0) {
-                ImGui::Text("%d  Seller%s", item.sellOrders, item.sellOrders == 1 ? "" : "s");
-            }
-            else if (item.buyOrders > 0) {
-                ImGui::Text("%d  Buyer%s", item.buyOrders, item.buyOrders == 1 ? "" : "s");
+                ImGui::SameLine(300);
+                if (item.sellOrders > 0 && item.buyOrders > 0) {
+                    ImGui::Text("%d  Seller%s, %d Buyer%s", item.sellOrders, item.sellOrders == 1 ? "" : "s", item.buyOrders, item.buyOrders == 1 ? "" : "s");
+                }
+                else if (item.sellOrders > 0) {
+                    ImGui::Text("%d  Seller%s", item.sellOrders, item.sellOrders == 1 ? "" : "s");
+                }
+                else if (item.buyOrders > 0) {
+                    ImGui::Text("%d  Buyer%s", item.buyOrders, item.buyOrders == 1 ? "" : "s");
+                }
+                ImGui::PopID();
             }
-            ImGui::PopID();
         }
+        clipper.End();
     }
 
     void DrawFavoritesList()
@@ -1000,9 +1102,7 @@ namespace {
             favorite_items.erase(item_name);
         }
         else {
-            const auto found = std::ranges::find_if(available_items.begin(), available_items.end(), [item_name](auto& item) {
-                return *item.name == item_name;
-            });
+            const auto found = FindAvailableItem(item_name);
             favorite_items[item_name] = {};
             if (found != available_items.end()) {
                 favorite_items[item_name] = *found;
@@ -1443,9 +1543,7 @@ namespace {
                 strncpy(last_search_name, editing_item.name_buffer, sizeof(last_search_name) - 1);
 
                 // Find matching item in available_items
-                const auto found = std::ranges::find_if(available_items.begin(), available_items.end(), [](const AvailableItem& item) {
-                    return *item.name == last_search_name;
-                });
+                const auto found = FindAvailableItem(last_search_name);
 
                 if (found != available_items.end()) {
                     // Found a match, request order info
@@ -1724,6 +1822,7 @@ void GWMarketWindow::SearchItem(const std::string& item_name)
     instance.visible = true;
     strncpy(search_buffer, item_name.c_str(), sizeof(search_buffer) - 1);
     search_buffer[sizeof(search_buffer) - 1] = '\0';
+    OnSearchChanged();
     current_viewing_item = item_name;
     if (IsSocketIOReady()) {
         SendGetItemOrders(item_name);
@@ -1849,7 +1948,9 @@ void GWMarketWindow::Draw(IDirect3DDevice9*)
         if (ImGui::RadioButton("WTB", filter_mode == SHOW_BUY_ONLY)) filter_mode = SHOW_BUY_ONLY;
 
         ImGui::Separator();
-        ImGui::InputText("Search", search_buffer, sizeof(search_buffer));
+        if (ImGui::InputText("Search", search_buffer, sizeof(search_buffer))) {
+            OnSearchChanged();
+        }
         ImGui::Separator();
 
         // Calculate available width and height for the two-column layout
@@ -248,6 +248,9 @@ void HeroBuildsWindow::Draw(IDirect3DDevice9*)
                 }
                 filtered.push_back(&tbuild);
             }
+            // Ctrl turns every row's Load button into Send, which checks the length of that team build's chat code
+            if (ImGui::GetIO().KeyCtrl)
+                TeamBuild::CacheEncoded(filtered);
 
             // Build ordered group list
             std::vector<std::string> group_order;
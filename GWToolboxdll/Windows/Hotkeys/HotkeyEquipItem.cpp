@@ -83,6 +83,7 @@ bool HotkeyEquipItemAttributes::check(const GW::Item* item) const
 HotkeyEquipItem::HotkeyEquipItem(ToolboxIni* ini, const char* section)
     : TBHotkey(ini, section)
 {
+    can_be_ongoing = true;
     if (!ini) return;
     // @Cleanup: Add error handling
     bag_idx = static_cast<size_t>(ini->GetLongValue(section, "Bag", bag_idx));
@@ -20,6 +20,7 @@
 HotkeyGroup::HotkeyGroup(const ToolboxIni* ini, const char* section)
     : TBHotkey(ini, section)
 {
+    can_be_ongoing = true;
     auto found = hotkey_groups.find(label);
     if (found != hotkey_groups.end()) {
         hotkeys = found->second->hotkeys;
@@ -33,6 +34,7 @@ HotkeyGroup::HotkeyGroup(const ToolboxIni* ini, const char* section)
 }
 HotkeyGroup::HotkeyGroup(const char* _label) : TBHotkey(0, 0)
 {
+    can_be_ongoing = true;
     strncpy(label, _label, _countof(label));
     auto found = hotkey_groups.find(label);
     if (found != hotkey_groups.end()) {
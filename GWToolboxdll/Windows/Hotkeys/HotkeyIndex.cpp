@@ -0,0 +1,104 @@
+#include "stdafx.h"
+
+#include <Utils/TextUtils.h>
+
+#include <Windows/Hotkeys/HotkeyIndex.h>
+#include <Windows/Hotkeys/TBHotkey.h>
+
+void HotkeyIndex::Compile(const std::span<TBHotkey* const> hotkeys)
+{
+    compiled.clear();
+    player_name_ids.clear();
+    ongoing_candidates.clear();
+    compiled.reserve(hotkeys.size());
+    for (const auto hotkey : hotkeys) {
+        auto& conditions = compiled.emplace_back();
+        conditions.hotkey = hotkey;
+        for (const auto map_id : hotkey->map_ids) {
+            if (map_id < map_count) {
+                conditions.map_ids.set(map_id);
+            }
+        }
+        conditions.has_map_ids = !hotkey->map_ids.empty();
+        for (size_t i = 0; i < _countof(hotkey->prof_ids); i++) {
+            if (hotkey->prof_ids[i]) {
+                conditions.profession_mask |= static_cast<uint16_t>(1u << i);
+            }
+        }
+        for (const auto& name : hotkey->player_names) {
+            conditions.player_name_ids.push_back(InternPlayerName(name));
+        }
+        if (hotkey->can_be_ongoing) {
+            ongoing_candidates.push_back(hotkey);
+        }
+    }
+    // Nothing is valid until the next Select()
+    ClearSelection();
+}
+
+void HotkeyIndex::Select(const Context& context)
+{
+    ClearSelection();
+
+    const auto found = player_name_ids.find(std::wstring(context.player_name));
+    const auto player_name_id = found == player_name_ids.end() ? no_name_id : found->second;
+    const bool is_explorable = context.instance_type == GW::Constants::InstanceType::Explorable;
+    const bool is_outpost = context.instance_type == GW::Constants::InstanceType::Outpost;
+
+    for (const auto& conditions : compiled) {
+        if (!IsValid(conditions, player_name_id, context)) {
+            continue;
+        }
+        const auto hotkey = conditions.hotkey;
+        for (size_t vkey = 0; vkey < key_hotkeys.size(); vkey++) {
+            if (hotkey->key_combo.test(vkey)) {
+                key_hotkeys[vkey].push_back(hotkey);
+            }
+        }
+        if ((hotkey->trigger_on_explorable && is_explorable) || (hotkey->trigger_on_outpost && is_outpost)) {
+            map_change_hotkeys.push_back(hotkey);
+        }
+        if (hotkey->trigger_on_gain_focus) {
+            gain_focus_hotkeys.push_back(hotkey);
+        }
+        if (hotkey->trigger_on_lose_focus) {
+            lose_focus_hotkeys.push_back(hotkey);
+        }
+    }
+}
+
+void HotkeyIndex::Clear()
+{
+    Compile({});
+}
+
+void HotkeyIndex::ClearSelection()
+{
+    for (auto& list : key_hotkeys) {
+        list.clear();
+    }
+    map_change_hotkeys.clear();
+    gain_focus_hotkeys.clear();
+    lose_focus_hotkeys.clear();
+}
+
+bool HotkeyIndex::IsValid(const Conditions& conditions, const uint32_t player_name_id, const Context& context)
+{
+    const auto hotkey = conditions.hotkey;
+    const auto profession = static_cast<size_t>(context.primary);
+    const auto map_id = static_cast<size_t>(context.map_id);
+    // Bit 0 (no profession) on its own doesn't restrict the hotkey
+    const bool has_profession = (conditions.profession_mask & ~1u) != 0;
+    return hotkey->active
+           && (!context.is_pvp || hotkey->trigger_on_pvp_character)
+           && (hotkey->instance_type == -1 || static_cast<GW::Constants::InstanceType>(hotkey->instance_type) == context.instance_type)
+           && (!has_profession || (profession < 16 && (conditions.profession_mask >> profession & 1)))
+           && (!conditions.has_map_ids || (map_id < map_count && conditions.map_ids.test(map_id)))
+           && (conditions.player_name_ids.empty() || std::ranges::contains(conditions.player_name_ids, player_name_id));
+}
+
+uint32_t HotkeyIndex::InternPlayerName(const std::string& name)
+{
+    const auto [it, _] = player_name_ids.emplace(TextUtils::StringToWString(name), static_cast<uint32_t>(player_name_ids.size()));
+    return it->second;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <GWCA/Constants/Constants.h>
+#include <GWCA/Constants/Maps.h>
+
+class TBHotkey;
+
+/*
+Precompiled view over TBHotkey::all_hotkeys, used by HotkeysWindow to dispatch triggers.
+
+Compile() flattens each hotkey's conditions (map ids, professions, character names) into bitsets and interned ids;
+call it whenever hotkeys are added, removed or edited. Select() then filters the compiled hotkeys against the
+current character and map, and files the valid ones by every key in their combo and by trigger type, so a key event
+only looks at the few hotkeys that use that key. Call it whenever the character or map changes.
+
+The index holds raw pointers; recompile before any hotkey it has seen is deleted.
+*/
+class HotkeyIndex {
+public:
+    struct Context {
+        std::wstring_view player_name;
+        GW::Constants::InstanceType instance_type = GW::Constants::InstanceType::Loading;
+        GW::Constants::Profession primary = GW::Constants::Profession::None;
+        GW::Constants::MapID map_id = GW::Constants::MapID::None;
+        bool is_pvp = false;
+    };
+
+    void Compile(std::span<TBHotkey* const> hotkeys);
+    void Select(const Context& context);
+    void Clear();
+
+    // Valid hotkeys whose combo includes vkey, in list order
+    [[nodiscard]] const std::vector<TBHotkey*>& GetKeyHotkeys(const size_t vkey) const { return key_hotkeys[vkey]; }
+    // Valid hotkeys to run on entering the current map
+    [[nodiscard]] const std::vector<TBHotkey*>& GetMapChangeHotkeys() const { return map_change_hotkeys; }
+    [[nodiscard]] const std::vector<TBHotkey*>& GetFocusHotkeys(const bool gained) const { return gained ? gain_focus_hotkeys : lose_focus_hotkeys; }
+    // Every hotkey that can be left running, regardless of the current map; check TBHotkey::ongoing before executing
+    [[nodiscard]] const std::vector<TBHotkey*>& GetOngoingCandidates() const { return ongoing_candidates; }
+
+private:
+    static constexpr size_t map_count = static_cast<size_t>(GW::Constants::MapID::Count);
+    static constexpr uint32_t no_name_id = 0xffffffff;
+
+    struct Conditions {
+        TBHotkey* hotkey = nullptr;
+        std::bitset<map_count> map_ids; // Ids past MapID::Count are dropped
+        std::vector<uint32_t> player_name_ids;
+        uint16_t profession_mask = 0; // Bit per profession; 0 for any
+        bool has_map_ids = false;
+    };
+
+    void ClearSelection();
+    [[nodiscard]] static bool IsValid(const Conditions& conditions, uint32_t player_name_id, const Context& context);
+    uint32_t InternPlayerName(const std::string& name);
+
+    std::vector<Conditions> compiled;
+    std::unordered_map<std::wstring, uint32_t> player_name_ids;
+
+    std::array<std::vector<TBHotkey*>, 256> key_hotkeys;
+    std::vector<TBHotkey*> map_change_hotkeys;
+    std::vector<TBHotkey*> gain_focus_hotkeys;
+    std::vector<TBHotkey*> lose_focus_hotkeys;
+    std::vector<TBHotkey*> ongoing_candidates;
+};
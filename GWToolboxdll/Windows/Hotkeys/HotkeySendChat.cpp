@@ -6,8 +6,39 @@
 #include <ImGuiAddons.h>
 #include <Logger.h>
 
+#include <Modules/ChatCommands.h>
+#include <Utils/TextUtils.h>
 #include <Windows/Hotkeys/HotkeySendChat.h>
 
+namespace {
+    // Tab completes the toolbox command name being typed: a single match is filled in with a trailing space,
+    // several matches are extended to their longest common prefix.
+    int CompleteCommand(ImGuiInputTextCallbackData* data)
+    {
+        const std::string_view text(data->Buf, data->BufTextLen);
+        const auto word_end = std::min(text.find(' '), text.size());
+        if (word_end == 0 || word_end != static_cast<size_t>(data->CursorPos)) {
+            return 0;
+        }
+        const auto completions = ChatCommands::GetCommandCompletions(TextUtils::StringToWString(text.substr(0, word_end)));
+        if (completions.empty()) {
+            return 0;
+        }
+        auto completed = completions.front();
+        for (const auto& completion : completions) {
+            const auto [mismatch, _] = std::ranges::mismatch(completed, completion);
+            completed.erase(mismatch, completed.end());
+        }
+        auto replacement = TextUtils::WStringToString(completed);
+        if (completions.size() == 1 && text.size() == word_end) {
+            replacement.push_back(' ');
+        }
+        data->DeleteChars(0, static_cast<int>(word_end));
+        data->InsertChars(0, replacement.c_str());
+        return 0;
+    }
+}
+
 HotkeySendChat::HotkeySendChat(const ToolboxIni* ini, const char* section)
     : TBHotkey(ini, section)
 {
@@ -92,7 +123,13 @@ bool HotkeySendChat::DrawSettings()
                                         show_message_in_emote_channel;
         hotkey_changed = true;
     }
-    hotkey_changed |= ImGui::InputText("Message", message, _countof(message));
+    if (channel == '/') {
+        hotkey_changed |= ImGui::InputText("Message", message, _countof(message), ImGuiInputTextFlags_CallbackCompletion, CompleteCommand);
+        ImGui::ShowHelp("Press Tab to complete a toolbox command");
+    }
+    else {
+        hotkey_changed |= ImGui::InputText("Message", message, _countof(message));
+    }
     hotkey_changed |= channel == '/' && ImGui::Checkbox("Display message when triggered", &show_message_in_emote_channel);
     hotkey_changed = hotkey_changed || TBHotkey::DrawSettings();
     return hotkey_changed;
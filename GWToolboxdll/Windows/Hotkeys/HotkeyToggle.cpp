@@ -37,6 +37,7 @@ bool HotkeyToggle::IsValid(const ToolboxIni* ini, const char* section)
 HotkeyToggle::HotkeyToggle(const ToolboxIni* ini, const char* section)
     : TBHotkey(ini, section)
 {
+    can_be_ongoing = true;
     target = ini ? static_cast<ToggleTarget>(ini->GetLongValue(section, "ToggleID", target)) : target;
     static bool initialised = false;
     if (!initialised) {
@@ -222,16 +222,6 @@ size_t TBHotkey::HasProfession()
     return out;
 }
 
-bool TBHotkey::IsValid(const char* _player_name, const GW::Constants::InstanceType _instance_type, GW::Constants::Profession _profession, GW::Constants::MapID _map_id, const bool is_pvp_character)
-{
-    return active
-           && (!is_pvp_character || trigger_on_pvp_character)
-           && (instance_type == -1 || static_cast<GW::Constants::InstanceType>(instance_type) == _instance_type)
-           && (prof_ids[static_cast<size_t>(_profession)] || !HasProfession())
-           && (map_ids.empty() || std::ranges::contains(map_ids, std::to_underlying(_map_id)))
-           && (player_names.empty() || std::ranges::contains(player_names, _player_name));
-}
-
 bool TBHotkey::CanUse()
 {
     return !isLoading() && !GW::Map::GetIsObserving() && GW::Agents::GetControlledCharacter() && GW::MemoryMgr::GetGWWindowHandle() == GetActiveWindow() && IsInRangeOfNPC();
@@ -54,6 +54,7 @@ public:
     bool trigger_on_lose_focus = false;        // Trigger when GW window is no longer focussed
     bool trigger_on_gain_focus = false;        // Trigger when GW window is focussed
     bool can_trigger_on_map_change = true;     // Some hotkeys cant trigger on map change e.g. Guild Wars Key
+    bool can_be_ongoing = false;               // Hotkeys that may set `ongoing`; only these are polled every frame
     bool block_other_hotkeys_on_trigger = false; // If this hotkey is triggered, block any further hotkeys from being processed
 
     size_t sort_order = 0xffff;
@@ -79,8 +80,6 @@ public:
 
     // Whether this hotkey is limited to professions. Returns number of professions applicable
     size_t HasProfession();
-    // Whether this hotkey is valid for the current player/map
-    virtual bool IsValid(const char* _player_name, GW::Constants::InstanceType _instance_type, GW::Constants::Profession _profession, GW::Constants::MapID _map_id, bool is_pvp_character);
 
 
     virtual void Save(ToolboxIni* ini, const char* section) const;
@@ -17,6 +17,7 @@
 #include <Keys.h>
 
 #include <Windows/HotkeysWindow.h>
+#include <Windows/Hotkeys/HotkeyIndex.h>
 #include <GWCA/Utilities/Scanner.h>
 #include <Timer.h>
 #include <GWToolbox.h>
@@ -29,7 +30,7 @@ namespace {
 
     typedef std::bitset<256> KeysHeldBitset;
 
-    std::vector<TBHotkey*> valid_hotkeys;
+    HotkeyIndex hotkey_index;
 
     KeysHeldBitset keys_currently_held;
     KeysHeldBitset wndproc_keys_held;
@@ -154,19 +155,7 @@ namespace {
             && IsFrameCreated(GW::UI::GetFrameByLabel(L"Skillbar"));
     }
 
-    void AddHotkeyIfValid(TBHotkey* hotkey, const char* player_name, GW::Constants::InstanceType instance_type, GW::Constants::Profession primary, GW::Constants::MapID map_id, bool is_pvp, std::vector<TBHotkey*>& valid)
-    {
-        if (const auto* grp = dynamic_cast<HotkeyGroup*>(hotkey)) {
-            for (auto* child : grp->hotkeys) {
-                AddHotkeyIfValid(child, player_name,instance_type,primary,map_id,is_pvp,valid);
-            }
-        }
-        if (hotkey && hotkey->IsValid(player_name, instance_type, primary, map_id, is_pvp)) {
-            valid.push_back(hotkey);
-        }
-    }
-
-    // Repopulates applicable_hotkeys based on current character/map context.
+    // Reselects the valid hotkeys in hotkey_index based on current character/map context.
     // Used because its not necessary to check these vars on every keystroke, only when they change
     bool CheckSetValidHotkeys()
     {
@@ -178,19 +167,24 @@ namespace {
         if (!me) {
             return false;
         }
-        const std::string player_name = TextUtils::WStringToString(c->player_name);
-        const GW::Constants::InstanceType instance_type = GW::Map::GetInstanceType();
-        const GW::Constants::MapID map_id = GW::Map::GetMapID();
-        const auto primary = static_cast<GW::Constants::Profession>(me->primary);
-        const bool is_pvp = me->IsPvP();
-        valid_hotkeys.clear();
-        for (auto* hotkey : TBHotkey::all_hotkeys) {
-            AddHotkeyIfValid(hotkey, player_name.c_str(), instance_type, primary, map_id, is_pvp, valid_hotkeys);
-        }
+        HotkeyIndex::Context context;
+        context.player_name = c->player_name;
+        context.instance_type = GW::Map::GetInstanceType();
+        context.map_id = GW::Map::GetMapID();
+        context.primary = static_cast<GW::Constants::Profession>(me->primary);
+        context.is_pvp = me->IsPvP();
+        hotkey_index.Select(context);
 
         return true;
     }
 
+    // Call when hotkeys are added, removed, reordered or edited
+    void RecompileHotkeys()
+    {
+        hotkey_index.Compile(TBHotkey::all_hotkeys);
+        CheckSetValidHotkeys();
+    }
+
     bool OnMapChanged()
     {
         if (!IsMapReady()) {
@@ -207,11 +201,9 @@ namespace {
             return false;
         }
         bool is_in_controller_mode = GW::UI::IsInControllerMode();
-        // NB: CheckSetValidHotkeys() has already checked validity of char/map etc
-        for (TBHotkey* hk : valid_hotkeys) {
-            if (((hk->trigger_on_explorable && mt == GW::Constants::InstanceType::Explorable)
-                    || (hk->trigger_on_outpost && mt == GW::Constants::InstanceType::Outpost))
-                && !hk->pressed 
+        // NB: CheckSetValidHotkeys() has already checked validity of char/map etc, and filtered by instance type
+        for (TBHotkey* hk : hotkey_index.GetMapChangeHotkeys()) {
+            if (!hk->pressed
                 &&
                 ((is_in_controller_mode && hk->trigger_in_controller_mode) || (!is_in_controller_mode && hk->trigger_in_desktop_mode))) {
                 hk->pressed = true;
@@ -237,16 +229,13 @@ namespace {
             return false;
         }
         // NB: CheckSetValidHotkeys() has already checked validity of char/map etc
-        for (TBHotkey* hk : valid_hotkeys) {
-            if (((activated && hk->trigger_on_gain_focus)
-                    || (!activated && hk->trigger_on_lose_focus))) {
-                // Would be nice to use PushPendingHotkey here, but losing/gaining focus is a special case
-                hk->pressed = true;
-                current_hotkey = hk;
-                hk->Execute();
-                current_hotkey = nullptr;
-                hk->pressed = false;
-            }
+        for (TBHotkey* hk : hotkey_index.GetFocusHotkeys(activated)) {
+            // Would be nice to use PushPendingHotkey here, but losing/gaining focus is a special case
+            hk->pressed = true;
+            current_hotkey = hk;
+            hk->Execute();
+            current_hotkey = nullptr;
+            hk->pressed = false;
         }
         return true;
     }
@@ -307,6 +296,7 @@ namespace {
         ImGui::SameLine();
         if (ImGui::Button("Save")) {
             keys_being_assigned->key_combo = keys_selected;
+            CheckSetValidHotkeys();
             ImGui::CloseCurrentPopup();
         }
         ImGui::EndPopup();
@@ -347,6 +337,7 @@ const TBHotkey* HotkeysWindow::CurrentHotkey()
 void HotkeysWindow::Terminate()
 {
     ToolboxWindow::Terminate();
+    hotkey_index.Clear();
     while (TBHotkey::all_hotkeys.size())
         delete TBHotkey::all_hotkeys[0];
     HotkeyGWKey::control_labels.clear();
@@ -465,12 +456,15 @@ if (ImGui::Selectable("Equip Item")) {
         // Groups are first-class items in `hotkeys`; HotkeyGroup::Draw handles its children.
         // All moves at the top level are simple swaps — no rotation needed.
         for (auto hotkey : TBHotkey::top_level_hotkeys) {
-            if (hotkey->Draw()) break; // re-render next frame after list mutation
+            if (hotkey->Draw()) {
+                hotkeys_changed = true;
+                break; // re-render next frame after list mutation
+            }
         }
     }
     if (hotkeys_changed) {
         TBHotkey::SortHotkeys();
-        CheckSetValidHotkeys();
+        RecompileHotkeys();
     }
 
     ImGui::End();
@@ -492,6 +486,7 @@ void HotkeysWindow::LoadSettings(ToolboxIni* ini)
     TBHotkey::show_run_in_header = ini->GetBoolValue(Name(), "show_run_in_header", false);
     HotkeyToggle::clicker_delay_ms = ini->GetLongValue(Name(), "clicker_delay_ms", HotkeyToggle::clicker_delay_ms);
 
+    hotkey_index.Clear();
     while (TBHotkey::all_hotkeys.size())
         delete TBHotkey::all_hotkeys[0];
 
@@ -515,7 +510,7 @@ void HotkeysWindow::LoadSettings(ToolboxIni* ini)
     }
 
     TBHotkey::SortHotkeys();
-    CheckSetValidHotkeys();
+    RecompileHotkeys();
 }
 
 void HotkeysWindow::SaveSettings(ToolboxIni* ini)
@@ -554,10 +549,9 @@ bool HotkeysWindow::WndProc(const UINT Message, const WPARAM wParam, LPARAM)
         wndproc_keys_held.reset();
         return false;
     }
-    auto check_trigger = [](TBHotkey* hk, bool is_key_up, uint32_t keyData, bool is_in_controller_mode) {
+    auto check_trigger = [](TBHotkey* hk, bool is_key_up, bool is_in_controller_mode) {
         if (hk->pressed) return false;
         if (hk->trigger_on_key_up != is_key_up) return false;
-        if (!hk->key_combo.test(keyData)) return false; // The triggering key isn't included in this hotkey's combo
         if (hk->strict_key_combo) return hk->key_combo == wndproc_keys_held;
         if (is_in_controller_mode && !hk->trigger_in_controller_mode) return false;
         if (!is_in_controller_mode && !hk->trigger_in_desktop_mode) return false;
@@ -572,16 +566,16 @@ bool HotkeysWindow::WndProc(const UINT Message, const WPARAM wParam, LPARAM)
 
         bool is_in_controller_mode = GW::UI::IsInControllerMode();
 
-        // Step 1: Find all hotkeys that match the currently pressed keys
-        for (TBHotkey* hk : valid_hotkeys) {
+        // Step 1: Find all hotkeys that match the currently pressed keys.
+        // The index only lists hotkeys whose combo includes the key that was just pressed/released.
+        for (TBHotkey* hk : hotkey_index.GetKeyHotkeys(keyData)) {
             if (is_key_up) hk->pressed = false;
 
             // A hotkey is considered "matching" if:
             // - It hasn't already been triggered (`hk->pressed == false`)
             // - It should trigger on key-up (if we're processing a key-up event)
             // - All its required keys are currently held (`hk->key_combo & wndproc_keys_held == hk->key_combo`)
-            // - The key that was just pressed/released is part of this hotkey (`hk->key_combo.test(keyData)`)
-            if (check_trigger(hk, is_key_up, keyData, is_in_controller_mode)) {
+            if (check_trigger(hk, is_key_up, is_in_controller_mode)) {
                 // Count how many keys (modifiers + main key) are required for this hotkey
                 size_t modifier_count = hk->key_combo.count();
                 matching_hotkeys.push_back(hk);
@@ -656,7 +650,7 @@ void HotkeysWindow::Update(const float)
     if (!map_change_triggered) {
         map_change_triggered = OnMapChanged();
     }
-    for (auto hotkey : TBHotkey::all_hotkeys) {
+    for (auto hotkey : hotkey_index.GetOngoingCandidates()) {
         if (hotkey->ongoing) hotkey->Execute();
     }
     while (const auto hk = PopPendingHotkey()) {
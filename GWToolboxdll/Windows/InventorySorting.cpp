@@ -14,34 +14,21 @@
 #include <GWCA/Managers/MemoryMgr.h>
 
 #include <GWCA/GameEntities/Item.h>
+#include <GWCA/Managers/StoCMgr.h>
+#include <GWCA/Packets/Opcodes.h>
 
 #include <Logger.h>
 #include <Utils/GuiUtils.h>
+#include <Utils/InventorySortPlanner.h>
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <ctime>
 #include <Utils/ToolboxUtils.h>
 
 
 namespace {
-// Macro to wait for a game thread task to complete with timeout and cancellation checks
-#define WAIT_FOR_GAME_THREAD_TASK(task_done_flag, timeout_ms, error_message)               \
-    for (size_t i = 0; i < (timeout_ms) && !(task_done_flag) && !pending_cancel; i += 5) { \
-        Sleep(5);                                                                          \
-    }                                                                                      \
-    if (!(task_done_flag)) {                                                               \
-        Log::Warning(error_message);                                                       \
-        is_sorting = false;                                                                \
-        show_sort_popup = false;                                                           \
-        return false;                                                                      \
-    }                                                                                      \
-    if (pending_cancel) {                                                                  \
-        Log::Info("Sorting cancelled");                                                    \
-        is_sorting = false;                                                                \
-        show_sort_popup = false;                                                           \
-        return false;                                                                      \
-    }
-
     // Helper function to check if map is ready
     bool IsMapReady()
     {
@@ -55,9 +42,29 @@ namespace {
 
     // State variables
     bool show_sort_popup = false;
-    bool is_sorting = false;
-    bool pending_cancel = false;
-    size_t items_sorted_count = 0;
+    std::atomic<bool> is_sorting = false;
+    std::atomic<bool> pending_cancel = false;
+    std::atomic<size_t> items_sorted_count = 0;
+
+    // Signalled by game thread tasks finishing, inventory packets arriving and cancellation
+    std::mutex sort_mutex;
+    std::condition_variable sort_cv;
+    uint32_t inventory_packet_count = 0;
+    GW::HookEntry item_packet_entry;
+
+    constexpr uint32_t inventory_packets[] = {
+        GAME_SMSG_ITEM_UPDATE_QUANTITY, GAME_SMSG_ITEM_MOVED_TO_LOCATION, GAME_SMSG_ITEM_CHANGE_LOCATION,
+        GAME_SMSG_ITEM_REMOVE, GAME_SMSG_ITEM_GENERAL_INFO
+    };
+
+    void OnInventoryPacket(GW::HookStatus*, GW::Packet::StoC::PacketBase*)
+    {
+        {
+            std::lock_guard lock(sort_mutex);
+            inventory_packet_count++;
+        }
+        sort_cv.notify_all();
+    }
 
     // Chat command hook entries
     GW::HookEntry sort_inventory_cmd_entry;
@@ -102,20 +109,6 @@ namespace {
         return (static_cast<uint32_t>(priority_by_type & 0xFF) << 24) | secondary;
     }
 
-    /**
-     * Compares two items for sorting purposes.
-     * Returns true if item_a should come before item_b.
-     */
-    bool ShouldItemComeFirst(GW::Item* item_a, GW::Item* item_b)
-    {
-        if (!item_a || !item_b) return false;
-
-        const uint32_t priority_a = GetItemSortPriority(item_a);
-        const uint32_t priority_b = GetItemSortPriority(item_b);
-
-        return priority_a < priority_b;
-    }
-
     void CHAT_CMD_FUNC(CmdSortInventory)
     {
         pending_sortinventory_confirm = true;
@@ -165,7 +158,7 @@ namespace {
             }
 
             ImGui::TextUnformatted("Sorting inventory by type...");
-            ImGui::Text("Items sorted: %zu", items_sorted_count);
+            ImGui::Text("Items sorted: %zu", items_sorted_count.load());
 
             ImGui::Separator();
             ImGui::Spacing();
@@ -180,7 +173,6 @@ namespace {
             ImGui::SetCursorPosX((window_width - button_width) * 0.5f);
 
             if (ImGui::Button("Cancel", ImVec2(button_width, 0)) || ImGui::IsKeyPressed(ImGuiKey_Escape)) {
-                pending_cancel = true;
                 InventorySorting::CancelSort();
                 ImGui::CloseCurrentPopup();
             }
@@ -204,64 +196,196 @@ namespace {
         }
     }
 
+    struct SlotRef {
+        GW::Constants::Bag bag_id;
+        uint32_t slot;
+    };
+
     struct SlotExpectation {
         GW::Constants::Bag bag_id;
         uint32_t slot;
-        uint32_t expected_value; // item_id or quantity depending on check mode
+        uint32_t item_id;  // 0 means the slot should be empty
+        uint32_t quantity; // ignored for empty slots
     };
 
-    enum class ExpectationMode {
-        Quantity, // expected_value is quantity, 0 means slot should be empty
-        ItemId,   // expected_value is item_id
+    // Runs task on the game thread and blocks until it has run. Anything task touches must outlive a timeout, so pass shared state.
+    bool RunOnGameThread(std::function<void()> task, const uint32_t timeout_ms, const char* error_message)
+    {
+        const auto task_done = std::make_shared<bool>(false);
+        GW::GameThread::Enqueue([task = std::move(task), task_done] {
+            task();
+            {
+                std::lock_guard lock(sort_mutex);
+                *task_done = true;
+            }
+            sort_cv.notify_all();
+        });
+        std::unique_lock lock(sort_mutex);
+        sort_cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&task_done] {
+            return *task_done || pending_cancel;
+        });
+        if (pending_cancel) {
+            Log::Info("Sorting cancelled");
+            return false;
+        }
+        if (!*task_done) {
+            Log::Warning(error_message);
+            return false;
+        }
+        return true;
+    }
+
+    bool IsExpectationMet(const SlotExpectation& exp)
+    {
+        GW::Bag* bag = GW::Items::GetBag(exp.bag_id);
+        if (!bag || !bag->items.valid() || exp.slot >= bag->items.size()) {
+            return false;
+        }
+        const GW::Item* item = bag->items[exp.slot];
+        if (!exp.item_id) {
+            return item == nullptr;
+        }
+        return item && item->item_id == exp.item_id && item->quantity == exp.quantity;
+    }
+
+    // Waits until all slot expectations are met. The inventory is only re-checked when an item packet has arrived since the last check.
+    bool WaitForExpectations(const std::vector<SlotExpectation>& expectations, const uint32_t timeout_ms)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+        const auto all_done = std::make_shared<bool>(false);
+        const auto shared_expectations = std::make_shared<const std::vector<SlotExpectation>>(expectations);
+        while (true) {
+            uint32_t packets_seen;
+            {
+                std::lock_guard lock(sort_mutex);
+                packets_seen = inventory_packet_count;
+            }
+            const auto check = [shared_expectations, all_done] {
+                *all_done = std::ranges::all_of(*shared_expectations, IsExpectationMet);
+            };
+            if (!RunOnGameThread(check, 3000, "Failed to verify slot expectations")) {
+                return false;
+            }
+            if (*all_done) {
+                return true;
+            }
+            std::unique_lock lock(sort_mutex);
+            // The timeout on each wait is only a backstop in case a relevant packet isn't one we listen for
+            const auto woken = sort_cv.wait_until(lock, std::min(deadline, std::chrono::steady_clock::now() + std::chrono::milliseconds(500)), [packets_seen] {
+                return inventory_packet_count != packets_seen || pending_cancel;
+            });
+            if (pending_cancel) {
+                Log::Info("Sorting cancelled");
+                return false;
+            }
+            if (!woken && std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+        }
+    }
+
+    uint64_t GetStackKey(const GW::Item* item)
+    {
+        if (!item->GetIsStackable()) {
+            return 0;
+        }
+        // Same fields InventoryManager::IsSameItem compares
+        uint64_t key = std::hash<std::wstring_view>{}(item->name_enc ? item->name_enc : L"");
+        key ^= (static_cast<uint64_t>(item->model_file_id) << 1) + 0x9E3779B97F4A7C15ull + (key << 6) + (key >> 2);
+        if (item->type == GW::Constants::ItemType::Dye) {
+            uint32_t dye = 0;
+            static_assert(sizeof(item->dye) <= sizeof(dye));
+            memcpy(&dye, &item->dye, sizeof(item->dye));
+            key ^= dye + 0x9E3779B97F4A7C15ull + (key << 6) + (key >> 2);
+        }
+        return key | 1; // 0 means not stackable
+    }
+
+    struct InventorySnapshot {
+        std::vector<SlotRef> refs;
+        InventorySortPlanner::Snapshot slots;
     };
 
-    // Helper: wait until all slot expectations are met
-    bool WaitForExpectations(const std::vector<SlotExpectation>& expectations, ExpectationMode mode, uint32_t timeout_ms)
+    // Game thread only
+    void TakeSnapshot(GW::Constants::Bag start, GW::Constants::Bag end, InventorySnapshot& out)
     {
-        for (size_t t = 0; t < timeout_ms && !pending_cancel; t += 50) {
-            bool task_done = false;
-            bool all_done = true;
-
-            GW::GameThread::Enqueue([&expectations, &all_done, &task_done, mode]() {
-                for (const auto& exp : expectations) {
-                    GW::Bag* bag = GW::Items::GetBag(exp.bag_id);
-                    if (!bag || !bag->items.valid()) {
-                        all_done = false;
-                        break;
+        for (auto bag_id = start; bag_id <= end; bag_id = static_cast<GW::Constants::Bag>(std::to_underlying(bag_id) + 1)) {
+            GW::Bag* bag = GW::Items::GetBag(bag_id);
+            if (!bag || !bag->items.valid()) continue;
+            for (uint32_t slot = 0; slot < bag->items.size(); slot++) {
+                out.refs.push_back({bag_id, slot});
+                auto& entry = out.slots.emplace_back();
+                if (GW::Item* item = bag->items[slot]) {
+                    entry = {item->item_id, item->quantity, GetItemSortPriority(item), GetStackKey(item)};
+                }
+            }
+        }
+    }
+
+    // Sends each step's moves together and waits for the inventory packets confirming them before sending the next
+    bool ExecutePlan(const std::shared_ptr<const InventorySnapshot>& snapshot, const std::vector<InventorySortPlanner::Move>& moves, const char* error_message)
+    {
+        for (const auto& step : InventorySortPlanner::BuildSteps(snapshot->slots, moves)) {
+            const auto shared_step = std::make_shared<const InventorySortPlanner::Step>(step);
+            const auto sent = std::make_shared<bool>(true);
+            const auto send = [snapshot, shared_step, sent] {
+                for (const auto& move : shared_step->moves) {
+                    const auto& from = snapshot->refs[move.from];
+                    const auto& to = snapshot->refs[move.to];
+                    GW::Bag* from_bag = GW::Items::GetBag(from.bag_id);
+                    GW::Bag* to_bag = GW::Items::GetBag(to.bag_id);
+                    const GW::Item* item = from_bag && from_bag->items.valid() ? from_bag->items[from.slot] : nullptr;
+                    if (!item || item->item_id != move.item_id || !to_bag || !to_bag->items.valid()) {
+                        *sent = false; // Inventory changed under us
+                        return;
                     }
-                    GW::Item* item = bag->items[exp.slot];
-
-                    if (mode == ExpectationMode::Quantity) {
-                        if (exp.expected_value == 0) {
-                            if (item != nullptr) {
-                                all_done = false;
-                                break;
-                            }
-                        }
-                        else {
-                            if (!item || item->quantity != exp.expected_value) {
-                                all_done = false;
-                                break;
-                            }
-                        }
+                    const GW::Item* target = to_bag->items[to.slot];
+                    if (move.quantity && target) {
+                        GW::Items::MoveItem(item, target, move.quantity);
                     }
                     else {
-                        if (!item || item->item_id != exp.expected_value) {
-                            all_done = false;
-                            break;
-                        }
+                        GW::Items::MoveItem(item, to.bag_id, to.slot);
                     }
                 }
-                task_done = true;
-            });
-
-            WAIT_FOR_GAME_THREAD_TASK(task_done, 3000, "Failed to verify slot expectations");
+            };
+            if (!RunOnGameThread(send, 3000, error_message)) {
+                return false;
+            }
+            if (!*sent) {
+                Log::Warning("Inventory changed while sorting");
+                return false;
+            }
 
-            if (all_done) return true;
-            Sleep(50);
+            std::vector<SlotExpectation> expectations;
+            for (const auto& [slot, expected] : step.expected) {
+                expectations.push_back({snapshot->refs[slot].bag_id, snapshot->refs[slot].slot, expected.item_id, expected.quantity});
+            }
+            if (!WaitForExpectations(expectations, 5000)) {
+                return false;
+            }
+            items_sorted_count += step.moves.size();
         }
+        return true;
+    }
 
-        return false;
+    bool PlanAndExecute(GW::Constants::Bag start, GW::Constants::Bag end, const bool merge, const char* error_message)
+    {
+        const auto snapshot = std::make_shared<InventorySnapshot>();
+        const auto map_ready = std::make_shared<bool>(false);
+        const auto take_snapshot = [snapshot, map_ready, start, end] {
+            *map_ready = IsMapReady();
+            if (*map_ready) {
+                TakeSnapshot(start, end, *snapshot);
+            }
+        };
+        if (!RunOnGameThread(take_snapshot, 3000, "Sorting failed to read inventory")) {
+            return false;
+        }
+        if (!*map_ready) {
+            return false;
+        }
+        const auto moves = merge ? InventorySortPlanner::PlanMerges(snapshot->slots) : InventorySortPlanner::PlanSort(snapshot->slots);
+        return moves.empty() || ExecutePlan(snapshot, moves, error_message);
     }
 
 } // namespace
@@ -274,6 +398,10 @@ void InventorySorting::Initialize()
 
     GW::Chat::CreateCommand(&sort_inventory_cmd_entry, L"sortinventory", CmdSortInventory);
     GW::Chat::CreateCommand(&sort_storage_cmd_entry, L"sortstorage", CmdSortStorage);
+
+    for (const auto header : inventory_packets) {
+        GW::StoC::RegisterPacketCallback(&item_packet_entry, header, OnInventoryPacket, 0x8000);
+    }
 }
 
 void InventorySorting::Terminate()
@@ -281,6 +409,8 @@ void InventorySorting::Terminate()
     ToolboxUIElement::Terminate();
     GW::Chat::DeleteCommand(&sort_inventory_cmd_entry);
     GW::Chat::DeleteCommand(&sort_storage_cmd_entry);
+    GW::StoC::RemoveCallbacks(&item_packet_entry);
+    CancelSort();
 }
 
 void InventorySorting::LoadSettings(ToolboxIni* ini)
@@ -458,10 +588,13 @@ void InventorySorting::DrawSettingsInternal()
 
 void InventorySorting::CancelSort()
 {
-    is_sorting = false;
+    // The sorting thread notices, stops after the moves in flight and resets the popup state
+    {
+        std::lock_guard lock(sort_mutex);
+        pending_cancel = is_sorting.load();
+    }
+    sort_cv.notify_all();
     show_sort_popup = false;
-    pending_cancel = false;
-    items_sorted_count = 0;
 }
 
 void InventorySorting::RegisterSettingsContent()
@@ -479,93 +612,18 @@ void InventorySorting::RegisterSettingsContent()
 bool InventorySorting::CombineStacks(GW::Constants::Bag start, GW::Constants::Bag end)
 {
     ASSERT(!GW::GameThread::IsInGameThread());
-
-    std::vector<GW::Item*> stackable_items;
-    std::vector<std::vector<GW::Item*>> groups;
-    std::vector<SlotExpectation> expectations;
-    bool task_done = false;
-
-    GW::GameThread::Enqueue([&stackable_items, &groups, &task_done, start, end]() {
-        ForEachItemInBags(start, end, [&](GW::Bag*, GW::Constants::Bag, uint32_t, GW::Item* item) {
-            if (item->GetIsStackable() && item->quantity > 0 && item->quantity < 250) stackable_items.push_back(item);
-        });
-
-        std::vector<bool> assigned(stackable_items.size(), false);
-        for (size_t i = 0; i < stackable_items.size(); i++) {
-            if (assigned[i]) continue;
-            std::vector<GW::Item*> group = {stackable_items[i]};
-            assigned[i] = true;
-
-            for (size_t j = i + 1; j < stackable_items.size(); j++) {
-                if (assigned[j]) continue;
-                if (InventoryManager::IsSameItem(stackable_items[i], stackable_items[j])) {
-                    group.push_back(stackable_items[j]);
-                    assigned[j] = true;
-                }
-            }
-
-            if (group.size() > 1) groups.push_back(std::move(group));
-        }
-        task_done = true;
-    });
-
-    WAIT_FOR_GAME_THREAD_TASK(task_done, 3000, "Stack consolidation failed to collect items");
-    if (groups.empty() || pending_cancel) return !pending_cancel;
-
-    task_done = false;
-    GW::GameThread::Enqueue([&groups, &expectations, &task_done]() {
-        for (auto& items : groups) {
-            std::sort(items.begin(), items.end(), [](GW::Item* a, GW::Item* b) {
-                return a->quantity > b->quantity;
-            });
-
-            std::vector<uint32_t> quantities;
-            for (auto* item : items)
-                quantities.push_back(item->quantity);
-
-            size_t dst = 0;
-            size_t src = items.size() - 1;
-            while (dst < src) {
-                uint32_t space = 250 - quantities[dst];
-                if (space == 0) {
-                    dst++;
-                    continue;
-                }
-
-                uint32_t to_move = std::min(space, quantities[src]);
-                GW::Items::MoveItem(items[src], items[dst], to_move);
-
-                quantities[dst] += to_move;
-                quantities[src] -= to_move;
-
-                if (quantities[src] == 0) src--;
-                if (quantities[dst] >= 250) dst++;
-            }
-
-            for (size_t i = 0; i < items.size(); i++)
-                expectations.push_back({items[i]->bag->bag_id(), items[i]->slot, quantities[i]});
-        }
-        task_done = true;
-    });
-
-    WAIT_FOR_GAME_THREAD_TASK(task_done, 5000, "Stack consolidation failed to issue merge commands");
-    if (pending_cancel) return false;
-
-    return WaitForExpectations(expectations, ExpectationMode::Quantity, 5000);
+    return PlanAndExecute(start, end, true, "Stack consolidation failed to issue merge commands");
 }
 
 bool InventorySorting::StoreMaterials(GW::Constants::Bag start, GW::Constants::Bag end)
 {
     ASSERT(!GW::GameThread::IsInGameThread());
 
-    std::vector<SlotExpectation> expectations;
-    bool task_done = false;
-
-    GW::GameThread::Enqueue([&task_done, &expectations, start, end]() {
+    const auto expectations = std::make_shared<std::vector<SlotExpectation>>();
+    const auto store = [expectations, start, end] {
         const uint32_t max_stack = GW::Items::GetMaterialStorageStackSize();
         const auto material_storage_bag = GW::Items::GetBag(GW::Constants::Bag::Material_Storage);
         if (!material_storage_bag) {
-            task_done = true;
             return;
         }
 
@@ -584,62 +642,30 @@ bool InventorySorting::StoreMaterials(GW::Constants::Bag start, GW::Constants::B
             GW::Items::MoveItem(item, GW::Constants::Bag::Material_Storage, mat_slot, to_move);
 
             uint32_t remaining = item->quantity - to_move;
-            expectations.push_back({bag_id, slot, remaining});
+            expectations->push_back({bag_id, slot, remaining ? item->item_id : 0, remaining});
         });
+    };
 
-        task_done = true;
-    });
-
-    WAIT_FOR_GAME_THREAD_TASK(task_done, 3000, "Store materials failed to issue move commands");
-    if (expectations.empty() || pending_cancel) return !pending_cancel;
+    if (!RunOnGameThread(store, 3000, "Store materials failed to issue move commands")) return false;
+    if (expectations->empty()) return true;
 
-    return WaitForExpectations(expectations, ExpectationMode::Quantity, 5000);
+    return WaitForExpectations(*expectations, 5000);
 }
 
 bool InventorySorting::SortInventory(GW::Constants::Bag start, GW::Constants::Bag end)
 {
     ASSERT(!GW::GameThread::IsInGameThread());
-    if (!StoreMaterials(start, end)) return false;
-    if (!CombineStacks(start, end)) return false;
-
-    std::vector<SlotExpectation> expectations;
-    bool task_done = false;
-
-    GW::GameThread::Enqueue([&task_done, &expectations, start, end]() {
-        if (is_sorting || !IsMapReady()) {
-            task_done = true;
-            return;
-        }
-
-        std::vector<uint32_t> item_ids;
-        ForEachItemInBags(start, end, [&](GW::Bag*, GW::Constants::Bag, uint32_t, GW::Item* item) {
-            item_ids.push_back(item->item_id);
-        });
-
-        std::sort(item_ids.begin(), item_ids.end(), [](uint32_t a_id, uint32_t b_id) {
-            GW::Item* item_a = GW::Items::GetItemById(a_id);
-            GW::Item* item_b = GW::Items::GetItemById(b_id);
-            return ShouldItemComeFirst(item_a, item_b);
-        });
-
-        size_t idx = 0;
-        for (auto bag_id = start; bag_id <= end; bag_id = static_cast<GW::Constants::Bag>(std::to_underlying(bag_id) + 1)) {
-            GW::Bag* bag = GW::Items::GetBag(bag_id);
-            if (!bag || !bag->items.valid()) continue;
-
-            for (uint32_t slot = 0; slot < bag->items.size() && idx < item_ids.size(); slot++) {
-                GW::Item* item = GW::Items::GetItemById(item_ids[idx]);
-                if (item && (item->bag != bag || item->slot != slot)) GW::Items::MoveItem(item, bag_id, slot);
-                expectations.push_back({bag_id, slot, item_ids[idx]});
-                idx++;
-            }
-        }
-
-        task_done = true;
-    });
+    if (is_sorting.exchange(true)) return false;
+    pending_cancel = false;
+    items_sorted_count = 0;
+    show_sort_popup = true;
 
-    WAIT_FOR_GAME_THREAD_TASK(task_done, 3000, "Sorting failed to issue move commands");
-    if (expectations.empty() || pending_cancel) return !pending_cancel;
+    const bool sorted = StoreMaterials(start, end)
+        && CombineStacks(start, end)
+        && PlanAndExecute(start, end, false, "Sorting failed to issue move commands");
 
-    return WaitForExpectations(expectations, ExpectationMode::ItemId, 5000);
+    is_sorting = false;
+    show_sort_popup = false;
+    pending_cancel = false;
+    return sorted;
 }
@@ -15,6 +15,7 @@
 #include <Constants/EncStrings.h>
 
 #include <Windows/MaterialsWindow.h>
+#include <Modules/PriceCheckerModule.h>
 #include <Modules/GwDatTextureModule.h>
 #include <Timer.h>
 #include <GWCA/GameEntities/Frame.h>
@@ -298,6 +299,18 @@ namespace {
     }
 
 
+    // Kamadan trader price trend of each material over the last week, one line each; empty if nothing's been recorded
+    std::string TraderTrendLines(const GW::Constants::MaterialSlot mat1, const GW::Constants::MaterialSlot mat2)
+    {
+        std::string lines;
+        for (const auto mat : {mat1, mat2}) {
+            PriceHistory::Trend trend;
+            if (!(PriceCheckerModule::GetPriceTrend(mat, &trend) && trend.sample_count > 1)) continue;
+            lines += std::format("\n{}: {}g trader, {:+.0f}% this week (volatility {:.0f}%)", material_names[mat].string(), trend.last_price, trend.change * 100.f, trend.volatility * 100.f);
+        }
+        return lines;
+    }
+
     void FullConsPriceTooltip()
     {
         if (!ImGui::IsItemHovered())
@@ -491,7 +504,8 @@ void MaterialsWindow::Draw(IDirect3DDevice9*)
         ImGui::Image(*tex_essence, ImVec2(50, 50),
                      ImVec2(4.0f / 64, 9.0f / 64), ImVec2(47.0f / 64, 52.0f / 64));
         if (ImGui::IsItemHovered()) {
-            ImGui::SetTooltip("Essence of Celerity\n%s and %s", material_names[GW::Constants::MaterialSlot::Feather].string().c_str(), material_names[GW::Constants::MaterialSlot::PileofGlitteringDust].string().c_str());
+            ImGui::SetTooltip("Essence of Celerity\n%s and %s%s", material_names[GW::Constants::MaterialSlot::Feather].string().c_str(), material_names[GW::Constants::MaterialSlot::PileofGlitteringDust].string().c_str(),
+                              TraderTrendLines(GW::Constants::MaterialSlot::Feather, GW::Constants::MaterialSlot::PileofGlitteringDust).c_str());
         }
         ImGui::SameLine();
         float x = ImGui::GetCursorPosX();
@@ -543,7 +557,8 @@ void MaterialsWindow::Draw(IDirect3DDevice9*)
         ImGui::Image(*tex_grail, ImVec2(50, 50),
                      ImVec2(3.0f / 64, 11.0f / 64), ImVec2(49.0f / 64, 57.0f / 64));
         if (ImGui::IsItemHovered()) {
-            ImGui::SetTooltip("Grail of Might\n%s and %s", material_names[GW::Constants::MaterialSlot::IronIngot].string().c_str(), material_names[GW::Constants::MaterialSlot::PileofGlitteringDust].string().c_str());
+            ImGui::SetTooltip("Grail of Might\n%s and %s%s", material_names[GW::Constants::MaterialSlot::IronIngot].string().c_str(), material_names[GW::Constants::MaterialSlot::PileofGlitteringDust].string().c_str(),
+                              TraderTrendLines(GW::Constants::MaterialSlot::IronIngot, GW::Constants::MaterialSlot::PileofGlitteringDust).c_str());
         }
         ImGui::SameLine();
         x = ImGui::GetCursorPosX();
@@ -586,7 +601,8 @@ void MaterialsWindow::Draw(IDirect3DDevice9*)
         ImGui::Image(*tex_armor, ImVec2(50, 50),
                      ImVec2(0, 1.0f / 64), ImVec2(59.0f / 64, 60.0f / 64));
         if (ImGui::IsItemHovered()) {
-            ImGui::SetTooltip("Armor of Salvation\n%s and %s", material_names[GW::Constants::MaterialSlot::IronIngot].string().c_str(), material_names[GW::Constants::MaterialSlot::Bone].string().c_str());
+            ImGui::SetTooltip("Armor of Salvation\n%s and %s%s", material_names[GW::Constants::MaterialSlot::IronIngot].string().c_str(), material_names[GW::Constants::MaterialSlot::Bone].string().c_str(),
+                              TraderTrendLines(GW::Constants::MaterialSlot::IronIngot, GW::Constants::MaterialSlot::Bone).c_str());
         }
         ImGui::SameLine();
         x = ImGui::GetCursorPosX();
@@ -629,7 +645,8 @@ void MaterialsWindow::Draw(IDirect3DDevice9*)
         ImGui::Image(*tex_powerstone, ImVec2(50, 50),
                      ImVec2(0, 6.0f / 64), ImVec2(54.0f / 64, 60.0f / 64));
         if (ImGui::IsItemHovered()) {
-            ImGui::SetTooltip("Powerstone of Courage\n%s and %s", material_names[GW::Constants::MaterialSlot::GraniteSlab].string().c_str(), material_names[GW::Constants::MaterialSlot::PileofGlitteringDust].string().c_str());
+            ImGui::SetTooltip("Powerstone of Courage\n%s and %s%s", material_names[GW::Constants::MaterialSlot::GraniteSlab].string().c_str(), material_names[GW::Constants::MaterialSlot::PileofGlitteringDust].string().c_str(),
+                              TraderTrendLines(GW::Constants::MaterialSlot::GraniteSlab, GW::Constants::MaterialSlot::PileofGlitteringDust).c_str());
         }
         ImGui::SameLine();
         x = ImGui::GetCursorPosX();
@@ -671,7 +688,8 @@ void MaterialsWindow::Draw(IDirect3DDevice9*)
         ImGui::Image(*tex_resscroll, ImVec2(50, 50),
                      ImVec2(1.0f / 64, 4.0f / 64), ImVec2(56.0f / 64, 59.0f / 64));
         if (ImGui::IsItemHovered()) {
-            ImGui::SetTooltip("Scroll of Resurrection\n%s and %s", material_names[GW::Constants::MaterialSlot::PlantFiber].string().c_str(), material_names[GW::Constants::MaterialSlot::Bone].string().c_str());
+            ImGui::SetTooltip("Scroll of Resurrection\n%s and %s%s", material_names[GW::Constants::MaterialSlot::PlantFiber].string().c_str(), material_names[GW::Constants::MaterialSlot::Bone].string().c_str(),
+                              TraderTrendLines(GW::Constants::MaterialSlot::PlantFiber, GW::Constants::MaterialSlot::Bone).c_str());
         }
         ImGui::SameLine();
         x = ImGui::GetCursorPosX();
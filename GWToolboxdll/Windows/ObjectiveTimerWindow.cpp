@@ -40,12 +40,17 @@ namespace {
     bool show_start_column = true;
     bool show_end_column = true;
     bool show_time_column = true;
+    bool show_pb_column = true;
     bool show_start_date_time = false;
     bool save_to_disk = true;
     bool show_past_runs = false;
 
     bool loading = false;
 
+    // Every saved run; only the latest max_runs_in_memory are loaded into the window
+    RunHistory run_history;
+    constexpr size_t max_runs_in_memory = 200;
+
     bool map_load_pending = false;
     GW::Packet::StoC::InstanceLoadInfo* InstanceLoadInfo = nullptr;
     GW::Packet::StoC::InstanceLoadFile* InstanceLoadFile = nullptr;
@@ -159,7 +164,20 @@ namespace {
 
     void ComputeNColumns()
     {
-        n_columns = 0 + (show_start_column ? 1 : 0) + (show_end_column ? 1 : 0) + (show_time_column ? 1 : 0);
+        n_columns = 0 + (show_start_column ? 1 : 0) + (show_end_column ? 1 : 0) + (show_time_column ? 1 : 0) + (show_pb_column ? 1 : 0);
+    }
+
+    void PrintDelta(char* buf, const size_t size, const int delta)
+    {
+        const char sign = delta < 0 ? '-' : '+';
+        const DWORD time = static_cast<DWORD>(std::abs(delta));
+        const DWORD sec = time / 1000;
+        if (show_decimal) {
+            snprintf(buf, size, "%c%02lu:%02lu.%1lu", sign, sec / 60, sec % 60, time / 100 % 10);
+        }
+        else {
+            snprintf(buf, size, "%c%02lu:%02lu", sign, sec / 60, sec % 60);
+        }
     }
 
     float GetTimestampWidth() { return 65.0f * ImGui::FontScale(); }
@@ -274,6 +292,13 @@ void ObjectiveTimerWindow::Terminate() {
     for (size_t i = 0; i < 5000 && loading; i += 10) {
         Sleep(10);
     }
+    if (save_to_disk && !loading) {
+        // A run still going is saved as failed, the same as if it had been left
+        if (current_objective_set) {
+            current_objective_set->StopObjectives();
+        }
+        AppendFinishedRuns();
+    }
     ClearObjectiveSets();
     EnableWebsocketServer(false);
 }
@@ -1007,6 +1032,8 @@ void ObjectiveTimerWindow::DrawSettingsInternal()
     ImGui::NextSpacedElement();
     ImGui::Checkbox("Show 'Time' column", &show_time_column);
     ImGui::NextSpacedElement();
+    ImGui::CheckboxWithHelp("Show 'PB' column", &show_pb_column, "How far ahead or behind your fastest previous run of the same area you are at each objective");
+    ImGui::NextSpacedElement();
     ImGui::CheckboxWithHelp("Show detailed objectives", &show_detailed_objectives, "Currently only affects DoA objectives");
     ImGui::NextSpacedElement();
     ImGui::CheckboxWithHelp("Debug: log events", &show_debug_events,
@@ -1020,7 +1047,8 @@ void ObjectiveTimerWindow::DrawSettingsInternal()
         SaveRuns();
     }
     ImGui::ShowHelp(
-        "Keep a record or your runs in JSON format on disk, and load past runs from disk when starting GWToolbox.");
+        "Keep a record of your runs on disk, and load past runs from disk when starting GWToolbox.\n"
+        "Personal bests in the 'PB' column come from every run saved to disk.");
     ImGui::NextSpacedElement();
     ImGui::CheckboxWithHelp("Show past runs", &show_past_runs, "Display from previous days in the Objective Timer window.");
     ImGui::NextSpacedElement();
@@ -1063,6 +1091,7 @@ void ObjectiveTimerWindow::LoadSettings(ToolboxIni* ini)
     LOAD_BOOL(show_start_column);
     LOAD_BOOL(show_end_column);
     LOAD_BOOL(show_time_column);
+    LOAD_BOOL(show_pb_column);
     LOAD_BOOL(show_current_run_window);
     LOAD_BOOL(auto_send_age);
     LOAD_BOOL(save_to_disk);
@@ -1085,6 +1114,7 @@ void ObjectiveTimerWindow::SaveSettings(ToolboxIni* ini)
     SAVE_BOOL(show_start_column);
     SAVE_BOOL(show_end_column);
     SAVE_BOOL(show_time_column);
+    SAVE_BOOL(show_pb_column);
     SAVE_BOOL(show_current_run_window);
     SAVE_BOOL(auto_send_age);
     SAVE_BOOL(show_start_date_time);
@@ -1101,58 +1131,23 @@ void ObjectiveTimerWindow::LoadRuns()
     if (!save_to_disk) {
         return;
     }
-    // Because this does a load of file reads and JSON decoding, its on a separate thread; it could delay rendering by
-    // seconds
+    // Reading runs back from disk is on a separate thread; it could delay rendering by seconds
     while (loading) {
         Sleep(10);
     }
     loading = true;
     Resources::EnqueueWorkerTask([] {
         ObjectiveTimerWindow& instance = Instance();
-        // ClearObjectiveSets();
-        Resources::EnsureFolderExists(Resources::GetPath(L"runs"));
-        WIN32_FIND_DATAW FindFileData;
-        size_t max_objectives_in_memory = 200;
-        std::wstring file_match = Resources::GetPath(L"runs", L"ObjectiveTimerRuns_*.json");
-        std::wstring filename;
-        std::set<std::wstring> obj_timer_files;
-        HANDLE hFind = FindFirstFileW(file_match.c_str(), &FindFileData);
-        if (hFind != INVALID_HANDLE_VALUE) {
-            obj_timer_files.insert(FindFileData.cFileName);
-            while (FindNextFileW(hFind, &FindFileData) != 0) {
-                obj_timer_files.insert(FindFileData.cFileName);
-            }
-        }
-        FindClose(hFind);
-
-        // Output the list of names found
-        for (auto it = obj_timer_files.rbegin(); it != obj_timer_files.rend() && instance.objective_sets.size() < max_objectives_in_memory; ++it) {
-            try {
-                std::ifstream file;
-                std::wstring fn = Resources::GetPath(L"runs", *it);
-                file.open(fn);
-                if (file.is_open()) {
-                    std::stringstream ss;
-                    ss << file.rdbuf();
-                    std::vector<ObjectiveSet::Serialized> os_arr;
-                    constexpr glz::opts opts{.error_on_unknown_keys = false};
-                    if (auto ec = glz::read<opts>(os_arr, ss.str()); !ec) {
-                        for (const auto& elem : os_arr) {
-                            ObjectiveSet* os = ObjectiveSet::FromJson(elem);
-                            if (instance.objective_sets.contains(os->system_time)) {
-                                delete os;
-                                continue; // Don't load in a run that already exists
-                            }
-                            os->StopObjectives();
-                            os->need_to_collapse = true;
-                            os->from_disk = true;
-                            instance.objective_sets.emplace(os->system_time, os);
-                        }
-                    }
-                    file.close();
+        if (OpenRunHistory()) {
+            for (const auto& run : run_history.ReadLatest(max_runs_in_memory)) {
+                if (instance.objective_sets.contains(run.utc_start)) {
+                    continue; // Don't load in a run that already exists
                 }
-            } catch (const std::exception&) {
-                Log::Error("Failed to load ObjectiveSets from json");
+                ObjectiveSet* os = ObjectiveSet::FromRun(run);
+                os->need_to_collapse = true;
+                os->from_disk = true;
+                os->saved = true;
+                instance.objective_sets.emplace(os->system_time, os);
             }
         }
         loading = false;
@@ -1169,44 +1164,80 @@ void ObjectiveTimerWindow::SaveRuns()
     }
     loading = true;
     Resources::EnqueueWorkerTask([] {
-        ObjectiveTimerWindow& instance = Instance();
-        Resources::EnsureFolderExists(Resources::GetPath(L"runs"));
-        std::map<std::wstring, std::vector<ObjectiveSet*>> objective_sets_by_file;
-        wchar_t filename[36];
-        for (auto& os : instance.objective_sets) {
-            if (os.second->from_disk) {
-                continue; // No need to re-save a run.
-            }
-            time_t tt = os.second->system_time;
-            const tm* structtime = gmtime(&tt);
-            if (!structtime) {
-                continue;
-            }
-            swprintf(filename, 36, L"ObjectiveTimerRuns_%02d-%02d-%02d.json", structtime->tm_year + 1900, structtime->tm_mon + 1, structtime->tm_mday);
-            objective_sets_by_file[filename].push_back(os.second);
-        }
-        for (auto& it : objective_sets_by_file) {
-            try {
-                std::ofstream file;
-                file.open(Resources::GetPath(L"runs", it.first));
-                if (file.is_open()) {
-                    std::vector<ObjectiveSet::Serialized> os_arr;
-                    os_arr.reserve(it.second.size());
-                    for (const auto os : it.second) {
-                        os_arr.push_back(os->ToJson());
-                    }
-                    file << glz::write_json(os_arr).value_or(std::string{}) << std::endl;
-                    file.close();
-                }
-            } catch (const std::exception&) {
-                Log::Error("Failed to save ObjectiveSets to json");
-            }
+        if (OpenRunHistory()) {
+            Instance().AppendFinishedRuns();
         }
         runs_dirty = false;
         loading = false;
     });
 }
 
+bool ObjectiveTimerWindow::OpenRunHistory()
+{
+    if (run_history.IsOpen()) {
+        return true;
+    }
+    Resources::EnsureFolderExists(Resources::GetPath(L"runs"));
+    const auto path = Resources::GetPath(L"runs", L"ObjectiveTimerRuns.bin");
+    const bool import_json = !std::filesystem::exists(path);
+    if (!run_history.Open(path)) {
+        Log::Log("Failed to open objective timer run history %ls\n", path.c_str());
+        return false;
+    }
+    if (!import_json) {
+        return true;
+    }
+
+    WIN32_FIND_DATAW FindFileData;
+    const std::wstring file_match = Resources::GetPath(L"runs", L"ObjectiveTimerRuns_*.json");
+    std::set<std::wstring> obj_timer_files;
+    HANDLE hFind = FindFirstFileW(file_match.c_str(), &FindFileData);
+    if (hFind != INVALID_HANDLE_VALUE) {
+        obj_timer_files.insert(FindFileData.cFileName);
+        while (FindNextFileW(hFind, &FindFileData) != 0) {
+            obj_timer_files.insert(FindFileData.cFileName);
+        }
+    }
+    FindClose(hFind);
+
+    // Oldest first, so the log stays in the order runs were done in. The JSON files are left where they are.
+    size_t imported = 0;
+    for (const auto& filename : obj_timer_files) {
+        std::string json;
+        if (!Resources::ReadFile(Resources::GetPath(L"runs", filename), json)) {
+            continue;
+        }
+        std::vector<ObjectiveSet::Serialized> os_arr;
+        constexpr glz::opts opts{.error_on_unknown_keys = false};
+        if (glz::read<opts>(os_arr, json)) {
+            Log::Log("Failed to import ObjectiveSets from %ls\n", filename.c_str());
+            continue;
+        }
+        for (const auto& elem : os_arr) {
+            ObjectiveSet* os = ObjectiveSet::FromJson(elem);
+            imported += run_history.Append(os->ToRun()) ? 1 : 0;
+            delete os;
+        }
+    }
+    if (imported) {
+        Log::Log("Imported %zu objective timer runs from JSON\n", imported);
+    }
+    return true;
+}
+
+void ObjectiveTimerWindow::AppendFinishedRuns()
+{
+    for (const auto os : objective_sets | std::views::values) {
+        // Runs are only written once they're over; an append-only log can't take updates to a run
+        if (os->saved || os->active) {
+            continue;
+        }
+        if (run_history.Append(os->ToRun()) || run_history.Contains(os->system_time)) {
+            os->saved = true;
+        }
+    }
+}
+
 void ObjectiveTimerWindow::ClearObjectiveSets()
 {
     for (const auto& os : objective_sets) {
@@ -1361,6 +1392,27 @@ DWORD ObjectiveTimerWindow::Objective::GetDuration()
     return duration;
 }
 
+bool ObjectiveTimerWindow::Objective::GetPbDelta(int& delta)
+{
+    if (pb_done == TIME_UNKNOWN || !parent || parent->from_disk) {
+        return false;
+    }
+    if (IsDone()) {
+        delta = static_cast<int>(done - pb_done);
+        return true;
+    }
+    if (!parent->active) {
+        return false;
+    }
+    // Not done yet, but already slower than the PB
+    const DWORD elapsed = time_point_ms() - parent->run_start_time_point;
+    if (elapsed <= pb_done) {
+        return false;
+    }
+    delta = static_cast<int>(elapsed - pb_done);
+    return true;
+}
+
 void ObjectiveTimerWindow::Objective::Update()
 {
     // Cached times etc moved into Draw and GetDuration functions
@@ -1425,17 +1477,53 @@ void ObjectiveTimerWindow::Objective::Draw()
         if (ImGui::IsItemHovered()) {
             ImGui::SetTooltip("Time");
         }
+        offset += ts_width;
+    }
+    if (show_pb_column) {
+        ImGui::SameLine(offset);
+        int delta = 0;
+        if (GetPbDelta(delta)) {
+            char delta_str[16];
+            PrintDelta(delta_str, sizeof(delta_str), delta);
+            ImGui::TextColored(delta < 0 ? ImVec4(0.0f, 1.0f, 0.0f, 1.0f) : ImVec4(1.0f, 0.0f, 0.0f, 1.0f), "%s", delta_str);
+        }
+        else {
+            ImGui::TextDisabled("--:--");
+        }
+        if (ImGui::IsItemHovered() && parent) {
+            char best[16], median[16], slow[16];
+            PrintTime(best, sizeof(best), run_history.BestSplit(parent->name, name), show_decimal);
+            PrintTime(median, sizeof(median), run_history.MedianSplit(parent->name, name), show_decimal);
+            PrintTime(slow, sizeof(slow), run_history.PercentileSplit(parent->name, name, 90.f), show_decimal);
+            ImGui::SetTooltip("PB: %s\nMedian: %s\n90th percentile: %s\nDone in %zu saved runs",
+                              best, median, slow, run_history.SplitCount(parent->name, name));
+        }
     }
     for (auto i = 0; i < indent; i++) {
         ImGui::Unindent();
     }
 }
 
-void ObjectiveTimerWindow::ObjectiveSet::Update() const
+void ObjectiveTimerWindow::ObjectiveSet::Update()
 {
     if (!active) {
         return;
     }
+    // Personal bests are taken from the history once, while this run isn't in it; the name may still be decoding
+    if (!pbs_loaded && !name.empty() && run_history.IsOpen()) {
+        if (run_history.SplitsLoaded(name)) {
+            for (Objective* obj : objectives) {
+                obj->pb_done = run_history.BestSplit(name, obj->name);
+            }
+            pbs_loaded = true;
+        }
+        else if (!pbs_requested) {
+            pbs_requested = true;
+            Resources::EnqueueWorkerTask([run_name = name] {
+                run_history.LoadSplits(run_name);
+            });
+        }
+    }
 
     for (const Objective* obj : objectives) {
         obj->Update();
@@ -1582,33 +1670,59 @@ ObjectiveTimerWindow::ObjectiveSet* ObjectiveTimerWindow::ObjectiveSet::FromJson
     return os;
 }
 
-ObjectiveTimerWindow::ObjectiveSet::Serialized ObjectiveTimerWindow::ObjectiveSet::ToJson()
+ObjectiveTimerWindow::ObjectiveSet* ObjectiveTimerWindow::ObjectiveSet::FromRun(const RunHistory::Run& run)
+{
+    const auto os = new ObjectiveSet;
+    os->active = false;
+    os->system_time = run.utc_start;
+    os->name = run.name;
+    os->run_start_time_point = run.instance_start;
+    os->duration = run.duration;
+    for (const auto& split : run.splits) {
+        os->objectives.emplace_back(Objective::FromRun(split))->parent = os;
+    }
+    os->StopObjectives();
+    return os;
+}
+
+RunHistory::Run ObjectiveTimerWindow::ObjectiveSet::ToRun()
 {
-    Serialized out{
+    RunHistory::Run out{
         .name = name,
         .instance_start = run_start_time_point,
         .utc_start = system_time,
         .duration = GetDuration(),
     };
-    out.objectives.reserve(objectives.size());
+    out.splits.reserve(objectives.size());
     for (auto* obj : objectives) {
-        out.objectives.push_back(obj->ToJson());
+        out.splits.push_back(obj->ToRun());
     }
     return out;
 }
 
-ObjectiveTimerWindow::Objective::Serialized ObjectiveTimerWindow::Objective::ToJson()
+RunHistory::Split ObjectiveTimerWindow::Objective::ToRun()
 {
     return {
         .name = name,
         .status = static_cast<uint32_t>(std::to_underlying(status)),
         .start = start,
         .done = done,
-        .indent = static_cast<uint32_t>(indent),
         .duration = GetDuration(),
+        .indent = static_cast<uint32_t>(indent),
     };
 }
 
+ObjectiveTimerWindow::Objective* ObjectiveTimerWindow::Objective::FromRun(const RunHistory::Split& split)
+{
+    const auto obj = new Objective(split.name.c_str());
+    obj->status = static_cast<Status>(split.status);
+    obj->start = split.start;
+    obj->done = split.done;
+    obj->duration = split.duration;
+    obj->indent = static_cast<int>(split.indent);
+    return obj;
+}
+
 ObjectiveTimerWindow::Objective* ObjectiveTimerWindow::Objective::FromJson(const Serialized& json)
 {
     const auto obj = new Objective(json.name.c_str());
@@ -4,6 +4,7 @@
 #include <GWCA/GameContainers/GamePos.h>
 
 #include <ToolboxWindow.h>
+#include <Utils/RunHistory.h>
 #include <optional>
 #include <vector>
 
@@ -104,6 +105,8 @@ private:
         DWORD done = 0;
         DWORD start_time_point = 0;
         DWORD done_time_point = 0;
+        // Best time this objective was done by in previous runs of the set, taken when the run starts
+        DWORD pb_done = static_cast<DWORD>(-1);
 
         enum class Status {
             NotStarted,
@@ -116,6 +119,8 @@ private:
         const char* GetEndTimeStr();
         const char* GetDurationStr();
         DWORD GetDuration();
+        // Ms ahead (negative) or behind (positive) pb_done; false if there's nothing to compare yet
+        bool GetPbDelta(int& delta);
 
         Objective(const char* name);
 
@@ -135,7 +140,8 @@ private:
             std::optional<uint32_t> duration;
         };
         static Objective* FromJson(const Serialized& json);
-        Serialized ToJson();
+        static Objective* FromRun(const RunHistory::Split& split);
+        RunHistory::Split ToRun();
 
         [[nodiscard]] bool IsStarted() const;
         [[nodiscard]] bool IsDone() const;
@@ -166,6 +172,9 @@ private:
         bool active = true;
         bool failed = false;
         bool from_disk = false;
+        bool saved = false; // Appended to the run history
+        bool pbs_requested = false;
+        bool pbs_loaded = false;
         bool need_to_collapse = false;
         std::string name;
 
@@ -208,8 +217,9 @@ private:
             std::optional<uint32_t> duration;
         };
         static ObjectiveSet* FromJson(const Serialized& json);
-        Serialized ToJson();
-        void Update() const;
+        static ObjectiveSet* FromRun(const RunHistory::Run& run);
+        RunHistory::Run ToRun();
+        void Update();
         void GetStartTime(tm* timeinfo) const;
 
         const unsigned int ui_id = 0; // an internal id to ensure interface consistency
@@ -244,5 +254,9 @@ private:
     void AddDungeonObjectiveSet(const std::vector<GW::Constants::MapID>& levels);
 
     void ClearObjectiveSets();
+    // Opens the run history on disk, the first time importing the daily JSON files older versions saved runs to
+    static bool OpenRunHistory();
+    // Appends runs that have finished since the last save to the run history
+    void AppendFinishedRuns();
     void StopObjectives(); // called on partydefeated or back to outpost
 };
@@ -18,6 +18,7 @@
 #include <GWCA/Packets/StoC.h>
 
 #include <Modules/Resources.h>
+#include <Utils/CombatEvents.h>
 #include <Utils/GuiUtils.h>
 #include <Timer.h>
 #include <Windows/PartyStatisticsWindow.h>
@@ -97,8 +98,9 @@ namespace {
 
     /* Callbacks */
     GW::HookEntry MapLoaded_Entry;
-    GW::HookEntry GenericValueSelf_Entry;
-    GW::HookEntry GenericValueTarget_Entry;
+    CombatEvents::Subscriber combat_events{CombatEvents::TypeMask(
+        CombatEventType::InstantSkillActivated, CombatEventType::SkillActivated, CombatEventType::SkillFinished,
+        CombatEventType::AttackSkillActivated, CombatEventType::AttackSkillFinished)};
 
     /* Window settings */
     bool show_abs_values = true;
@@ -484,39 +486,31 @@ namespace {
     /* Callback Methods */
     /********************/
 
-    void MapLoadedCallback(GW::HookStatus*, GW::Packet::StoC::MapLoaded*)
+    void OnMapLoaded(const GW::Constants::InstanceType instance_type)
     {
         if (!in_explorable) {
             // Just left an outpost.
             UnsetPartyStatistics();
         }
         pending_party_members = true;
-        in_explorable = GW::Map::GetInstanceType() == GW::Constants::InstanceType::Explorable;
+        in_explorable = instance_type == GW::Constants::InstanceType::Explorable;
     }
 
-    void SkillCallback(const uint32_t value_id, const uint32_t caster_id, const uint32_t target_id,
-                       const uint32_t value, const bool no_target)
+    void MapLoadedCallback(GW::HookStatus*, GW::Packet::StoC::MapLoaded*)
     {
-        uint32_t agent_id = caster_id;
-        const auto activated_skill_id = static_cast<GW::Constants::SkillID>(value);
-
-        switch (value_id) {
-            case GW::Packet::StoC::GenericValueID::instant_skill_activated:
-            case GW::Packet::StoC::GenericValueID::skill_activated:
-            case GW::Packet::StoC::GenericValueID::skill_finished:
-            case GW::Packet::StoC::GenericValueID::attack_skill_activated:
-            case GW::Packet::StoC::GenericValueID::attack_skill_finished: {
-                if (!no_target) {
-                    agent_id = target_id;
-                }
-                break;
-            }
-            default: {
-                return;
-            }
+        // Handled once the skills from the previous map still queued have been counted
+        combat_events.Push({.type = CombatEventType::Marker, .value = static_cast<uint32_t>(GW::Map::GetInstanceType())});
+    }
+
+    void OnSkillEvent(const CombatEvent& event)
+    {
+        if (event.type == CombatEventType::Marker) {
+            return OnMapLoaded(static_cast<GW::Constants::InstanceType>(event.value));
         }
+        const uint32_t agent_id = event.agent_id;
+        const auto activated_skill_id = static_cast<GW::Constants::SkillID>(event.value);
 
-        if (NONE_SKILL == value) {
+        if (NONE_SKILL == event.value) {
             return;
         }
 
@@ -555,28 +549,7 @@ void PartyStatisticsWindow::Initialize()
 
     GW::StoC::RegisterPostPacketCallback<GW::Packet::StoC::MapLoaded>(&MapLoaded_Entry, &MapLoadedCallback);
 
-    /* Skill on self or party player */
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::GenericValue>(
-        &GenericValueSelf_Entry, [this](const GW::HookStatus*, const GW::Packet::StoC::GenericValue* packet) -> void {
-            const uint32_t value_id = packet->value_id;
-            const uint32_t caster_id = packet->agent_id;
-            constexpr uint32_t target_id = 0U;
-            const uint32_t value = packet->value;
-            constexpr bool no_target = true;
-            SkillCallback(value_id, caster_id, target_id, value, no_target);
-        });
-
-    /* Skill on enemy player */
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::GenericValueTarget>(
-        &GenericValueTarget_Entry,
-        [this](const GW::HookStatus*, const GW::Packet::StoC::GenericValueTarget* packet) -> void {
-            const uint32_t value_id = packet->Value_id;
-            const uint32_t caster_id = packet->caster;
-            const uint32_t target_id = packet->target;
-            const uint32_t value = packet->value;
-            constexpr bool no_target = false;
-            SkillCallback(value_id, caster_id, target_id, value, no_target);
-        });
+    combat_events.Subscribe();
 
     UnsetPartyStatistics();
     pending_party_members = true;
@@ -584,6 +557,8 @@ void PartyStatisticsWindow::Initialize()
 
 void PartyStatisticsWindow::Update(const float)
 {
+    combat_events.Drain(OnSkillEvent);
+
     if (pending_party_members && SetPartyMembers()) {
         pending_party_members = false;
     }
@@ -656,8 +631,7 @@ void PartyStatisticsWindow::Terminate()
     GW::Chat::DeleteCommand(&ChatCmd_HookEntry);
 
     GW::StoC::RemoveCallback<GW::Packet::StoC::MapLoaded>(&MapLoaded_Entry);
-    GW::StoC::RemoveCallback<GW::Packet::StoC::GenericValueTarget>(&GenericValueTarget_Entry);
-    GW::StoC::RemoveCallback<GW::Packet::StoC::GenericValue>(&GenericValueSelf_Entry);
+    combat_events.Unsubscribe();
 
     UnsetPartyStatistics();
 }
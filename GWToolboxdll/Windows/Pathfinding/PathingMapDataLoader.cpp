@@ -281,7 +281,7 @@ namespace Pathing {
 
         *out = std::move(result);
 
-        const auto map_info_chunk = (MapInfoChunk*)game_asset.FindChunk(ArenaNetFileParser::ChunkType::Map_Info);
+        const auto map_info_chunk = game_asset.FindChunkAs<MapInfoChunk>(ArenaNetFileParser::ChunkType::Map_Info);
         if (!map_info_chunk) return false;
 
         out->bounds_min = map_info_chunk->bounds[0];
@@ -4,6 +4,9 @@
 
 #include <GWToolbox.h>
 #include <Defines.h>
+#include <Modules/Resources.h>
+#include <Utils/GuiUtils.h>
+#include <Utils/TraceProfiler.h>
 #include <Windows/PerformanceWindow.h>
 
 namespace {
@@ -87,23 +90,42 @@ namespace {
     constexpr int WINDOW_SECONDS = 5;
 
     struct ModuleStats {
+        const char* name = nullptr;
         Stats update, draw;
     };
 
+    // Module stats are indexed by tracer zone id, so per-frame accumulation never hashes or allocates.
+    // A module's update times go in the slot of its Update zone and its draw times in the slot of its Draw zone.
+    using ModuleStatsList = std::vector<ModuleStats>;
+
+    ModuleStats& GetModuleStats(ModuleStatsList& list, const TraceProfiler::ZoneId slot, const ToolboxModule* m)
+    {
+        if (slot >= list.size()) {
+            list.resize(slot + 1);
+        }
+        auto& ms = list[slot];
+        ms.name = m->Name();
+        return ms;
+    }
+
     // Ring buffer of 1-second snapshots
     Stats hist_frame[WINDOW_SECONDS], hist_tb_update[WINDOW_SECONDS], hist_tb_draw[WINDOW_SECONDS], hist_present[WINDOW_SECONDS];
-    std::map<std::string, ModuleStats> hist_modules[WINDOW_SECONDS];
+    ModuleStatsList hist_modules[WINDOW_SECONDS];
     int hist_index = 0;
 
     // Displayed stats (merged from ring buffer)
     Stats displayed_frame, displayed_tb_update, displayed_tb_draw, displayed_present;
-    std::map<std::string, ModuleStats> displayed_modules;
+    ModuleStatsList displayed_modules;
 
     // Accumulating stats (current 1s window)
     Stats acc_frame, acc_tb_update, acc_tb_draw, acc_present;
-    std::map<std::string, ModuleStats> acc_modules;
+    ModuleStatsList acc_modules;
     DWORD window_start_tick = 0;
 
+    // Tracer zone summaries, refreshed (and the zone histograms reset) every WINDOW_SECONDS
+    std::vector<TraceProfiler::ZoneSummary> displayed_zones;
+    int zone_window_seconds = 0;
+
     void FlushWindow()
     {
         // Store current 1s snapshot into ring buffer
@@ -119,14 +141,22 @@ namespace {
         displayed_tb_update = {};
         displayed_tb_draw = {};
         displayed_present = {};
-        displayed_modules.clear();
+        for (auto& dm : displayed_modules) {
+            dm = {};
+        }
         for (int i = 0; i < WINDOW_SECONDS; i++) {
             displayed_frame.Merge(hist_frame[i]);
             displayed_tb_update.Merge(hist_tb_update[i]);
             displayed_tb_draw.Merge(hist_tb_draw[i]);
             displayed_present.Merge(hist_present[i]);
-            for (const auto& [name, ms] : hist_modules[i]) {
-                auto& dm = displayed_modules[name];
+            if (hist_modules[i].size() > displayed_modules.size()) {
+                displayed_modules.resize(hist_modules[i].size());
+            }
+            for (size_t j = 0; j < hist_modules[i].size(); j++) {
+                const auto& ms = hist_modules[i][j];
+                if (!ms.name) continue;
+                auto& dm = displayed_modules[j];
+                dm.name = ms.name;
                 dm.update.Merge(ms.update);
                 dm.draw.Merge(ms.draw);
             }
@@ -137,7 +167,35 @@ namespace {
         acc_tb_update = {};
         acc_tb_draw = {};
         acc_present = {};
-        acc_modules.clear();
+        for (auto& ms : acc_modules) {
+            ms = {};
+        }
+
+        if (++zone_window_seconds >= WINDOW_SECONDS) {
+            zone_window_seconds = 0;
+            displayed_zones.clear();
+            TraceProfiler::GetSummaries(displayed_zones);
+            TraceProfiler::ResetStats();
+        }
+    }
+
+    void ExportTrace()
+    {
+        SYSTEMTIME st;
+        GetLocalTime(&st);
+        char stamp[32];
+        snprintf(stamp, sizeof(stamp), "%04d%02d%02d-%02d%02d%02d",
+                 st.wYear, st.wMonth, st.wDay, st.wHour, st.wMinute, st.wSecond);
+
+        const auto folder = Resources::GetPath(L"traces");
+        Resources::EnsureFolderExists(folder);
+        const auto path = folder / (std::string("gwtoolbox_trace_") + stamp + ".json");
+        if (TraceProfiler::ExportChromeTrace(path)) {
+            Log::Info("Trace written to %s", path.string().c_str());
+        }
+        else {
+            Log::Error("Failed to write trace to %s", path.string().c_str());
+        }
     }
 
     ImU32 ColorForTime(uint64_t us)
@@ -171,6 +229,7 @@ void PerformanceWindow::Draw(IDirect3DDevice9* device)
         return;
     }
     HookPresent(device);
+    TraceProfiler::Collect();
 
     // Frame period tracking
     static LARGE_INTEGER prev_frame_qpc = {};
@@ -188,10 +247,12 @@ void PerformanceWindow::Draw(IDirect3DDevice9* device)
     uint64_t total_update_us = 0, total_draw_us = 0;
 
     for (const auto* m : GWToolbox::GetAllModules()) {
-        if (m->last_update_time_us_ == 0 && m->last_draw_time_us_ == 0) continue;
-        auto& ms = acc_modules[m->Name()];
-        ms.update.Record(m->last_update_time_us_);
-        ms.draw.Record(m->last_draw_time_us_);
+        if (m->last_update_time_us_ && m->update_zone_id_ != TraceProfiler::InvalidZone) {
+            GetModuleStats(acc_modules, m->update_zone_id_, m).update.Record(m->last_update_time_us_);
+        }
+        if (m->last_draw_time_us_ && m->draw_zone_id_ != TraceProfiler::InvalidZone) {
+            GetModuleStats(acc_modules, m->draw_zone_id_, m).draw.Record(m->last_draw_time_us_);
+        }
         total_update_us += m->last_update_time_us_;
         total_draw_us += m->last_draw_time_us_;
     }
@@ -267,8 +328,44 @@ void PerformanceWindow::Draw(IDirect3DDevice9* device)
         }
     }
 
+    if (TraceProfiler::IsCapturing()) {
+        if (ImGui::Button("Stop and export trace")) {
+            TraceProfiler::StopCapture();
+            ExportTrace();
+        }
+        ImGui::SameLine();
+        ImGui::Text("%zu samples", TraceProfiler::GetCaptureSize());
+    }
+    else if (ImGui::Button("Capture trace")) {
+        TraceProfiler::StartCapture();
+    }
+    ImGui::ShowHelp("Records every traced zone until stopped, then writes a Chrome trace (.json) that can be opened in ui.perfetto.dev or chrome://tracing");
+    if (const auto dropped = TraceProfiler::GetDroppedCount()) {
+        ImGui::SameLine();
+        ImGui::TextDisabled("%llu samples dropped", dropped);
+    }
+
     ImGui::Separator();
 
+    // Per-zone breakdown, including hooks and worker jobs that aren't tied to a module
+    if (ImGui::CollapsingHeader("Trace zones") && ImGui::BeginTable("##zone_timing", 5, ImGuiTableFlags_BordersInnerH | ImGuiTableFlags_SizingStretchProp)) {
+        ImGui::TableSetupColumn("Zone");
+        ImGui::TableSetupColumn("Count");
+        ImGui::TableSetupColumn("p50 (us)");
+        ImGui::TableSetupColumn("p99 (us)");
+        ImGui::TableSetupColumn("max (us)");
+        ImGui::TableHeadersRow();
+        for (const auto& z : displayed_zones) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(z.name);
+            ImGui::TableNextColumn(); ImGui::Text("%llu", z.count);
+            ImGui::TableNextColumn(); ImGui::TextColored(ImColor(ColorForTime(z.p50_us)).Value, "%llu", z.p50_us);
+            ImGui::TableNextColumn(); ImGui::TextColored(ImColor(ColorForTime(z.p99_us)).Value, "%llu", z.p99_us);
+            ImGui::TableNextColumn(); ImGui::TextColored(ImColor(ColorForTime(z.max_us)).Value, "%llu", z.max_us);
+        }
+        ImGui::EndTable();
+    }
+
     // Per-module breakdown
     enum SortCol : int { Col_Name, Col_UpdMin, Col_UpdAvg, Col_UpdMax, Col_DrawMin, Col_DrawAvg, Col_DrawMax };
 
@@ -279,8 +376,16 @@ void PerformanceWindow::Draw(IDirect3DDevice9* device)
     static std::vector<DisplayEntry> entries;
     entries.clear();
 
-    for (const auto& [name, ms] : displayed_modules) {
-        entries.push_back({name.c_str(), ms});
+    for (const auto* m : GWToolbox::GetAllModules()) {
+        DisplayEntry entry{m->Name(), {}};
+        if (m->update_zone_id_ < displayed_modules.size()) {
+            entry.stats.update = displayed_modules[m->update_zone_id_].update;
+        }
+        if (m->draw_zone_id_ < displayed_modules.size()) {
+            entry.stats.draw = displayed_modules[m->draw_zone_id_].draw;
+        }
+        if (!entry.stats.update.count && !entry.stats.draw.count) continue;
+        entries.push_back(entry);
     }
 
     if (ImGui::BeginTable("##module_timing", 7,
@@ -229,7 +229,7 @@ void SettingsWindow::Draw(IDirect3DDevice9*)
         sort_and_draw_settings();
 
         if (ImGui::Button("Save Now", ImVec2(w, 0))) {
-            GWToolbox::SaveSettings();
+            GWToolbox::SaveSettings(true);
         }
         if (ImGui::IsItemHovered()) {
             ImGui::SetTooltip("Toolbox normally saves settings on exit.\nClick to save to disk now.");
@@ -20,6 +20,7 @@
 #include <Logger.h>
 #include <Utils/GuiUtils.h>
 #include <Utils/RateLimiter.h>
+#include <Utils/TradeArchive.h>
 #include <CircurlarBuffer.h>
 
 #include <Modules/Resources.h>
@@ -118,6 +119,7 @@ namespace {
     std::vector<std::string> alert_words{};
     std::vector<std::string> searched_words{};
 
+    constexpr size_t max_messages = 100;
     CircularBuffer<Message> messages;
 
     bool ws_window_connecting = false;
@@ -128,8 +130,57 @@ namespace {
 
     bool external_trade_message = false;
 
+    // Every message received from the website, so trade chat can be searched offline
+    TradeArchive trade_archive;
+    std::filesystem::path trade_archive_folder;
+    bool archive_trade_chat = true;
+    bool search_local_archive = false;
+    // Set while the window is showing results from trade_archive rather than from the website
+    bool showing_archive_results = false;
+    // Archive searches run on a worker; results of a search that's been superseded are dropped
+    uint32_t archive_search_id = 0;
+    bool archive_search_pending = false;
+    constexpr uint32_t price_summary_days = 30;
+
+    void OpenTradeArchive()
+    {
+        if (!archive_trade_chat) {
+            trade_archive.Close();
+            trade_archive_folder.clear();
+            return;
+        }
+        const auto folder = Resources::GetPath(L"trade_archive", is_kamadan_chat ? L"kamadan" : L"ascalon");
+        if (trade_archive.IsOpen() && folder == trade_archive_folder) {
+            return;
+        }
+        trade_archive_folder = folder;
+        trade_archive.Open(folder);
+    }
+
+    // Searches from the window go to the archive when asked to, or when the website can't be reached
+    bool UseTradeArchive()
+    {
+        return trade_archive.IsOpen() && (search_local_archive || (!ws_window && !ws_window_connecting));
+    }
+
+    void PrintSearchResult(const Message& msg)
+    {
+        std::wstring name_ws = TextUtils::StringToWString(msg.name);
+        std::wstring msg_ws = TextUtils::StringToWString(msg.message);
+        time_t ts = msg.timestamp;
+        tm* local_tm = localtime(&ts);
+        if (local_tm) {
+            wchar_t buf[512];
+            swprintf(buf, 512, L"<a=1>%s</a> @ %S %d, %02d:%02d: <c=#f96677><quote>%s", name_ws.c_str(), months[local_tm->tm_mon], local_tm->tm_mday, local_tm->tm_hour, local_tm->tm_min, msg_ws.c_str());
+            WriteChat(GW::Chat::Channel::CHANNEL_TRADE, buf,nullptr,true);
+        }
+    }
+
     void search(const std::string& query, const bool print_results_in_chat = false)
     {
+        showing_archive_results = false;
+        archive_search_id++;
+        archive_search_pending = false;
         pending_query_string = query.empty() ? " " : query;
         print_search_results = print_results_in_chat;
         pending_query_sent = 0;
@@ -162,6 +213,88 @@ namespace {
     }
 
 
+    void search_archive(const std::string& query, const bool print_results_in_chat = false)
+    {
+        pending_query_string.clear();
+        showing_archive_results = true;
+        archive_search_pending = true;
+        const auto search_id = ++archive_search_id;
+        Resources::EnqueueWorkerTask([query, print_results_in_chat, search_id] {
+            auto results = std::make_shared<std::vector<TradeArchive::Message>>(trade_archive.Search(query, max_messages));
+            Resources::EnqueueMainTask([query, print_results_in_chat, search_id, results] {
+                if (search_id != archive_search_id) {
+                    return; // Different query has been made since this search.
+                }
+                archive_search_pending = false;
+                messages.clear();
+                if (print_results_in_chat && results->empty()) {
+                    Log::Warning("No results found in the trade archive for %s", query.c_str());
+                    return;
+                }
+                // Best match last, so that it's drawn at the top
+                for (auto it = results->rbegin(); it != results->rend(); ++it) {
+                    messages.add({it->timestamp, it->sender, it->text});
+                }
+                if (print_results_in_chat) {
+                    for (size_t i = std::min<size_t>(results->size(), 12); i-- > 0;) {
+                        PrintSearchResult({(*results)[i].timestamp, (*results)[i].sender, (*results)[i].text});
+                    }
+                }
+            });
+        });
+    }
+
+    // Searches from the window. An empty query goes back to the live feed, unless the website can't be reached.
+    void search_window(const std::string& query)
+    {
+        const bool offline = !ws_window && !ws_window_connecting;
+        if (trade_archive.IsOpen() && (query.empty() ? offline : UseTradeArchive())) {
+            search_archive(query);
+        }
+        else {
+            search(query);
+        }
+    }
+
+    // Median price quoted for the item in the archive, for sellers and buyers, in whichever currency it's quoted in most
+    void PrintArchivePrices(const std::string& item)
+    {
+        if (!trade_archive.IsOpen()) {
+            return;
+        }
+        Resources::EnqueueWorkerTask([item] {
+            const auto since = static_cast<uint32_t>(time(nullptr)) - price_summary_days * 24 * 60 * 60;
+            const auto quotes = trade_archive.GetPriceHistory(item, since);
+            std::vector<std::string> lines;
+            for (const bool selling : {true, false}) {
+                std::array<std::vector<float>, 4> amounts;
+                for (const auto& quote : quotes) {
+                    if (quote.selling == selling) {
+                        amounts[std::to_underlying(quote.currency)].push_back(quote.amount);
+                    }
+                }
+                const auto most_quoted = std::ranges::max_element(amounts, {}, [](const std::vector<float>& a) {
+                    return a.size();
+                });
+                if (most_quoted->empty()) {
+                    continue;
+                }
+                const auto currency = static_cast<TradeArchive::Currency>(most_quoted - amounts.begin());
+                const auto median = most_quoted->begin() + most_quoted->size() / 2;
+                std::nth_element(most_quoted->begin(), median, most_quoted->end());
+                lines.push_back(std::format("{} {}: {}{} (median of {} quotes in the last {} days)", selling ? "WTS" : "WTB", item, *median, TradeArchive::CurrencyName(currency), most_quoted->size(), price_summary_days));
+            }
+            if (lines.empty()) {
+                return;
+            }
+            Resources::EnqueueMainTask([lines] {
+                for (const auto& line : lines) {
+                    Log::Info("%s", line.c_str());
+                }
+            });
+        });
+    }
+
     void CHAT_CMD_FUNC(CmdPricecheck)
     {
         if (argc < 2) {
@@ -175,6 +308,10 @@ namespace {
             }
             item_to_search += TextUtils::WStringToString(argv[i]);
         }
+        PrintArchivePrices(item_to_search);
+        if (search_local_archive && trade_archive.IsOpen()) {
+            return search_archive(item_to_search, true);
+        }
         Log::Flash("Searching trade for \"%s\"...", item_to_search.c_str());
         search(item_to_search, true);
     }
@@ -251,7 +388,7 @@ void TradeWindow::Initialize()
 {
     ToolboxWindow::Initialize();
 
-    messages = CircularBuffer<Message>(100);
+    messages = CircularBuffer<Message>(max_messages);
 
     should_stop = false;
     worker = new std::thread([this] {
@@ -310,6 +447,8 @@ void TradeWindow::Terminate()
     }
     GW::Chat::DeleteCommand(&ChatCmd_HookEntry);
     GW::UI::RemoveUIMessageCallback(&OnUIMessage_Entry);
+    trade_archive.Close();
+    trade_archive_folder.clear();
 }
 bool TradeWindow::GetInKamadanAE1(const bool check_district)
 {
@@ -401,15 +540,7 @@ void TradeWindow::fetch()
                 }
                 messages.add(msg);
                 if (print_search_results && i < 12) {
-                    std::wstring name_ws = TextUtils::StringToWString(msg.name);
-                    std::wstring msg_ws = TextUtils::StringToWString(msg.message);
-                    time_t ts = msg.timestamp;
-                    tm* local_tm = localtime(&ts);
-                    if (local_tm) {
-                        wchar_t buf[512];
-                        swprintf(buf, 512, L"<a=1>%s</a> @ %S %d, %02d:%02d: <c=#f96677><quote>%s", name_ws.c_str(), months[local_tm->tm_mon], local_tm->tm_mday, local_tm->tm_hour, local_tm->tm_min, msg_ws.c_str());
-                        WriteChat(GW::Chat::Channel::CHANNEL_TRADE, buf,nullptr,true);
-                    }
+                    PrintSearchResult(msg);
                 }
             }
             print_search_results = false;
@@ -421,8 +552,11 @@ void TradeWindow::fetch()
         if (!fill_message(raw, &msg)) {
             return; // Not valid message object
         }
-        bool add_to_window = searched_words.empty();
-        if (!add_to_window) {
+        if (archive_trade_chat) {
+            trade_archive.Append(msg.timestamp, msg.name, msg.message);
+        }
+        bool add_to_window = !showing_archive_results && searched_words.empty();
+        if (!add_to_window && !showing_archive_results) {
             // Currently showing a search term in-window. Only add if it matches all words.
             add_to_window = true;
             std::string input(msg.message);
@@ -544,27 +678,36 @@ void TradeWindow::Draw(IDirect3DDevice9*)
         ImGui::Separator();
     }
     ImGuiInputTextFlags flags = ImGuiInputTextFlags_EnterReturnsTrue;
-    const bool searching = !pending_query_string.empty();
+    const bool searching = !pending_query_string.empty() || archive_search_pending;
     if (searching) {
         flags |= ImGuiInputTextFlags_ReadOnly;
         ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetStyleColorVec4(ImGuiCol_TextDisabled));
     }
     bool do_search = false;
+    const bool use_archive = UseTradeArchive();
+    const char* search_hint = is_kamadan_chat ? "Search Kamadan Trade Chat" : "Search Ascalon Trade Chat";
+    if (use_archive) {
+        search_hint = is_kamadan_chat ? "Search Kamadan Trade Archive" : "Search Ascalon Trade Archive";
+    }
     ImGui::PushItemWidth(search_bar_width);
-    do_search |= ImGui::InputTextWithHint("##trade_search_buffer", is_kamadan_chat ? "Search Kamadan Trade Chat" : "Search Ascalon Trade Chat", search_buffer, 256, flags);
+    do_search |= ImGui::InputTextWithHint("##trade_search_buffer", search_hint, search_buffer, 256, flags);
     ImGui::PopItemWidth();
     ImGui::SameLine();
     do_search |= ImGui::Button(searching ? "Searching" : "Search", ImVec2(btn_width, 0));
+    if (ImGui::IsItemHovered() && trade_archive.IsOpen()) {
+        ImGui::SetTooltip("%zu messages in the local trade archive%s%s", trade_archive.size(), trade_archive.IsLoading() ? " (loading)" : "",
+                          trade_archive.IsReadOnly() ? "\nAnother client is archiving trade chat; new messages aren't being added" : "");
+    }
     if (searching) {
         ImGui::PopStyleColor();
     }
     else if (do_search) {
-        search(search_buffer);
+        search_window(search_buffer);
     }
     ImGui::SameLine();
     if (ImGui::Button("Clear", ImVec2(btn_width, 0))) {
         std::snprintf(search_buffer, _countof(search_buffer), "");
-        search("");
+        search_window("");
     }
     ImGui::SameLine();
     if (ImGui::Button("Alerts", ImVec2(btn_width, 0))) {
@@ -590,7 +733,7 @@ void TradeWindow::Draw(IDirect3DDevice9*)
     /* Main trade chat area */
     ImGui::BeginChild("trade_scroll", ImVec2(0, -20.0f - ImGui::GetStyle().ItemInnerSpacing.y));
     /* Connection checks */
-    if (!ws_window && !ws_window_connecting) {
+    if (!showing_archive_results && !ws_window && !ws_window_connecting) {
         char buf[255];
         snprintf(buf, 255, "The connection to %s has timed out.", is_kamadan_chat ? ws_host_kmd : ws_host_asc);
         ImGui::SetCursorPosX((ImGui::GetWindowWidth() - ImGui::CalcTextSize(buf).x) / 2);
@@ -601,7 +744,7 @@ void TradeWindow::Draw(IDirect3DDevice9*)
             AsyncWindowConnect(true);
         }
     }
-    else if (ws_window_connecting || (ws_window && ws_window->getReadyState() == WebSocket::CONNECTING)) {
+    else if (!showing_archive_results && (ws_window_connecting || (ws_window && ws_window->getReadyState() == WebSocket::CONNECTING))) {
         ImGui::SetCursorPosX((ImGui::GetWindowWidth() - ImGui::CalcTextSize("Connecting...").x) / 2);
         ImGui::SetCursorPosY(ImGui::GetWindowHeight() / 2);
         ImGui::Text("Connecting...");
@@ -711,6 +854,11 @@ void TradeWindow::DrawChatSettings(const bool ownwindow)
 void TradeWindow::DrawSettingsInternal()
 {
     DrawAlertsWindowContent(false);
+    ImGui::Separator();
+    if (ImGui::CheckboxWithHelp("Keep a local archive of trade chat", &archive_trade_chat, "Messages received from the trade chat website are saved in the trade_archive folder,\nso that trade chat can be searched offline and /pc can show recent prices.")) {
+        OpenTradeArchive();
+    }
+    ImGui::CheckboxWithHelp("Search the local archive instead of the website", &search_local_archive, "The local archive is always searched when the website can't be reached.");
 }
 
 void TradeWindow::LoadSettings(ToolboxIni* ini)
@@ -721,6 +869,8 @@ void TradeWindow::LoadSettings(ToolboxIni* ini)
     LOAD_BOOL(filter_alerts);
     LOAD_BOOL(filter_local_trade);
     LOAD_BOOL(is_kamadan_chat);
+    LOAD_BOOL(archive_trade_chat);
+    LOAD_BOOL(search_local_archive);
 
     strncpy(player_party_search_text, ini->GetValue(Name(), "player_party_search_text", ""), _countof(player_party_search_text) - 1);
 
@@ -744,6 +894,8 @@ void TradeWindow::SaveSettings(ToolboxIni* ini)
     SAVE_BOOL(filter_alerts);
     SAVE_BOOL(filter_local_trade);
     SAVE_BOOL(is_kamadan_chat);
+    SAVE_BOOL(archive_trade_chat);
+    SAVE_BOOL(search_local_archive);
 
     ini->SetValue(Name(), "player_party_search_text", player_party_search_text);
 
@@ -805,7 +957,10 @@ void TradeWindow::AsyncWindowConnect(const bool force)
             printf("Couldn't connect to the host '%s'", is_kamadan_chat ? ws_host_kmd : ws_host_asc);
         }
         ws_window_connecting = false;
-        if (messages.size() == 0 && pending_query_string.empty()) {
+        if (ws_window && showing_archive_results && !search_local_archive) {
+            search(""); // Back to the live feed now that the website can be reached
+        }
+        else if (messages.size() == 0 && pending_query_string.empty()) {
             search(""); // Initial draw, gets latest N messages
         }
     });
@@ -831,5 +986,9 @@ void TradeWindow::SwitchSockets()
     DeleteWebSocket(ws_window);
     ws_window = nullptr;
     messages.clear();
+    showing_archive_results = false;
+    archive_search_id++;
+    archive_search_pending = false;
+    OpenTradeArchive();
     AsyncWindowConnect(true);
 }
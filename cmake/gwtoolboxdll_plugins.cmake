@@ -9,7 +9,8 @@ target_sources(plugin_base INTERFACE
     "plugins/Base/ToolboxUIPlugin.h"
     "plugins/Base/ToolboxUIPlugin.cpp"
     "GWToolboxdll/RectF.h"
-    "GWToolboxdll/MinimapPlugin.h")
+    "GWToolboxdll/MinimapPlugin.h"
+    "GWToolboxdll/GameSnapshot.h")
 target_include_directories(plugin_base INTERFACE
     "plugins/Base"
     "GWToolboxdll" # careful here, we only get access to exported and header functions!